@@ -0,0 +1,347 @@
+// orel2744@gmail.com
+// bench_actions.cpp - Micro-benchmarks of every Player action, of Game's turn and lookup calls at 2, 4 and 6
+// seats, of the performance overlay's and tracing's recording costs, and of whole-game throughput. Prints a
+// table and writes the results as JSON to diff between commits.
+// With --baseline it is also a regression gate: each benchmark is compared with the baseline JSON by a
+// one-sided Welch t-test, and the run fails naming every benchmark that got significantly slower.
+// Usage: bench_actions.exe [--json FILE] [--samples N] [--filter SUBSTRING] [--baseline FILE] [--tolerance F]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Game.hpp"
+#include "PerfStats.hpp"
+#include "Player.hpp"
+#include "Simulation.hpp"
+#include "StreamingStats.hpp"
+#include "Trace.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+// Results are written here so the compiler cannot drop the calls
+volatile uintptr_t sink = 0;
+
+struct Result {
+    std::string name;
+    int seats = 0;
+    uint64_t iterations = 0;  ///< Per sample
+    int samples = 0;
+    double nsPerOp = 0.0;     ///< Mean over the samples
+    double stddev = 0.0;      ///< Sample standard deviation of ns/op
+    double ci95 = 0.0;        ///< Half-width of the 95% confidence interval of the mean
+};
+
+Result summarise(const std::string& name, int seats, uint64_t iterations, const std::vector<double>& ns) {
+    Result r{name, seats, iterations, static_cast<int>(ns.size())};
+    for (double v : ns) r.nsPerOp += v / static_cast<double>(ns.size());
+    if (ns.size() > 1) {
+        double squares = 0.0;
+        for (double v : ns) squares += (v - r.nsPerOp) * (v - r.nsPerOp);
+        r.stddev = std::sqrt(squares / static_cast<double>(ns.size() - 1));
+        r.ci95 = studentTQuantile(0.975, static_cast<double>(ns.size() - 1)) * r.stddev / std::sqrt(static_cast<double>(ns.size()));
+    }
+    return r;
+}
+
+/**
+ * @brief A game seated with the given roles and players to act on it; `start` is where each timed op begins.
+ */
+struct Fixture {
+    Game game;
+    std::vector<std::unique_ptr<Player>> players;
+    GameSnapshot start;
+
+    /**
+     * @param roles Role of each seat.
+     * @param coins Starting coins of each seat (missing seats start with 0).
+     * @param setup Moves played from there (untimed) to reach `start`.
+     */
+    Fixture(const std::vector<Role>& roles, const std::vector<int>& coins = {},
+            const std::function<void(Fixture&)>& setup = nullptr) {
+        game.setLogging(false);
+        for (size_t s = 0; s < roles.size(); ++s)
+            players.emplace_back(Game::createPlayerWithRole("P" + std::to_string(s), &game, roles[s]));
+        GameSnapshot snap = game.snapshot();
+        for (size_t s = 0; s < coins.size() && s < snap.seats.size(); ++s) snap.seats[s].coins = coins[s];
+        game.restore(snap);
+        if (setup) setup(*this);
+        start = game.snapshot();
+    }
+
+    Player& operator[](size_t seat) { return *players[seat]; }
+};
+
+/**
+ * @brief Runs fn for `iterations` rounds and returns the nanoseconds per round.
+ */
+double sampleNs(const std::function<void()>& fn, uint64_t iterations) {
+    auto begin = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Picks an iteration count that makes one sample take about `target` nanoseconds.
+ */
+uint64_t calibrate(const std::function<void()>& fn, double target) {
+    uint64_t n = 1;
+    for (;;) {
+        auto begin = Clock::now();
+        for (uint64_t i = 0; i < n; ++i) fn();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        if (ns >= target / 8 || n >= (1ULL << 30)) return std::max<uint64_t>(1, static_cast<uint64_t>(n * target / std::max(ns, 1.0)));
+        n *= 2;
+    }
+}
+
+class Bench {
+public:
+    Bench(int samples, std::string filter) : samples(samples), filter(std::move(filter)) {}
+
+    /**
+     * @brief Times an op that leaves the fixture changed: each round restores `start` first, and each sample
+     *        subtracts a sample of bare restores taken right after it.
+     */
+    void action(const std::string& name, Fixture& f, const std::function<void(Fixture&)>& op) {
+        if (!wanted(name)) return;
+        f.game.restore(f.start);
+        op(f);  // throws here, untimed, if the fixture does not allow the op
+        auto round = [&] { f.game.restore(f.start); op(f); };
+        auto bare = [&] { f.game.restore(f.start); sink = sink + f.game.hash(); };
+        uint64_t n = calibrate(round, TARGET_NS);
+        std::vector<double> ns;
+        for (int s = 0; s < samples; ++s) {
+            double withOp = sampleNs(round, n);
+            ns.push_back(withOp - sampleNs(bare, n));
+        }
+        add(summarise(name, static_cast<int>(f.players.size()), n, ns));
+    }
+
+    /**
+     * @brief Times an op that can run back to back.
+     */
+    void repeat(const std::string& name, int seats, const std::function<void()>& op) {
+        if (!wanted(name)) return;
+        op();
+        uint64_t n = calibrate(op, TARGET_NS);
+        std::vector<double> ns;
+        for (int s = 0; s < samples; ++s) ns.push_back(sampleNs(op, n));
+        add(summarise(name, seats, n, ns));
+    }
+
+    const std::vector<Result>& results() const { return all; }
+
+private:
+    static constexpr double TARGET_NS = 2e7;  ///< About 20 ms per sample
+    int samples;
+    std::string filter;
+    std::vector<Result> all;
+
+    bool wanted(const std::string& name) const { return filter.empty() || name.find(filter) != std::string::npos; }
+
+    void add(const Result& r) {
+        all.push_back(r);
+        std::printf("%-28s %6d %14.1f %10.1f\n", r.name.c_str(), r.seats, r.nsPerOp, r.ci95);
+        std::fflush(stdout);
+    }
+};
+
+void writeJson(const std::vector<Result>& results, std::FILE* out) {
+    std::fprintf(out, "{\n  \"unit\": \"ns/op\",\n  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(out,
+                     "    {\"name\": \"%s\", \"seats\": %d, \"iterations\": %llu, \"samples\": %d, \"ns_per_op\": %.2f, "
+                     "\"stddev\": %.2f, \"ci95\": %.2f, \"per_sec\": %.0f}%s\n",
+                     r.name.c_str(), r.seats, static_cast<unsigned long long>(r.iterations), r.samples, r.nsPerOp, r.stddev,
+                     r.ci95, r.nsPerOp > 0 ? 1e9 / r.nsPerOp : 0.0, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+/**
+ * @brief Reads results written by writeJson (one result per line; other JSON layouts are not understood).
+ * @throws std::runtime_error if the file cannot be read or holds no results.
+ */
+std::vector<Result> readJson(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot read baseline " + path);
+    std::vector<Result> results;
+    auto number = [](const std::string& line, const char* key) {
+        size_t at = line.find(std::string("\"") + key + "\":");
+        return at == std::string::npos ? 0.0 : std::atof(line.c_str() + at + std::strlen(key) + 3);
+    };
+    for (std::string line; std::getline(in, line);) {
+        size_t at = line.find("\"name\": \"");
+        if (at == std::string::npos) continue;
+        at += 9;
+        Result r;
+        r.name = line.substr(at, line.find('"', at) - at);
+        r.seats = static_cast<int>(number(line, "seats"));
+        r.samples = static_cast<int>(number(line, "samples"));
+        r.nsPerOp = number(line, "ns_per_op");
+        r.stddev = number(line, "stddev");
+        results.push_back(r);
+    }
+    if (results.empty()) throw std::runtime_error("No results in baseline " + path);
+    return results;
+}
+
+/**
+ * @brief Compares results with a baseline. A benchmark regressed when it is more than `tolerance` slower and
+ *        a one-sided Welch t-test says so at the 1% level.
+ * @return The names of the regressed benchmarks.
+ */
+std::vector<std::string> compare(const std::vector<Result>& baseline, const std::vector<Result>& current, double tolerance) {
+    std::vector<std::string> regressed;
+    std::printf("\n%-28s %6s %12s %12s %8s %8s  %s\n", "benchmark", "seats", "base ns", "now ns", "change", "t", "verdict");
+    for (const Result& now : current) {
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+                                 [&](const Result& b) { return b.name == now.name && b.seats == now.seats; });
+        if (base == baseline.end()) {
+            std::printf("%-28s %6d %12s %12.1f %8s %8s  new\n", now.name.c_str(), now.seats, "-", now.nsPerOp, "-", "-");
+            continue;
+        }
+        const double change = base->nsPerOp > 0 ? now.nsPerOp / base->nsPerOp - 1.0 : 0.0;
+        const double va = base->samples > 0 ? base->stddev * base->stddev / base->samples : 0.0;
+        const double vb = now.samples > 0 ? now.stddev * now.stddev / now.samples : 0.0;
+        const double se = std::sqrt(va + vb);
+        const double t = se > 0 ? (now.nsPerOp - base->nsPerOp) / se : (now.nsPerOp > base->nsPerOp ? INFINITY : 0.0);
+        // Welch-Satterthwaite degrees of freedom
+        double df = 1.0;
+        if (va + vb > 0 && base->samples > 1 && now.samples > 1)
+            df = (va + vb) * (va + vb) / (va * va / (base->samples - 1) + vb * vb / (now.samples - 1));
+        const bool slower = change > tolerance && t > studentTQuantile(0.99, std::max(1.0, df));
+        if (slower) regressed.push_back(now.name + "/" + std::to_string(now.seats));
+        std::printf("%-28s %6d %12.1f %12.1f %+7.1f%% %8.2f  %s\n", now.name.c_str(), now.seats, base->nsPerOp, now.nsPerOp,
+                    100.0 * change, t, slower ? "REGRESSED" : change < -tolerance && t < -studentTQuantile(0.99, std::max(1.0, df)) ? "faster" : "ok");
+    }
+    return regressed;
+}
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+    int samples = 5;
+    double tolerance = 0.15;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--json") == 0 && hasValue) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--samples") == 0 && hasValue) samples = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--filter") == 0 && hasValue) filter = argv[++i];
+        else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) baselinePath = argv[++i];
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) tolerance = std::atof(argv[++i]);
+        else {
+            std::fprintf(stderr, "Usage: %s [--json FILE] [--samples N] [--filter SUBSTRING] [--baseline FILE] [--tolerance F]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Result> baseline;
+    Bench bench(samples, filter);
+    std::printf("%-28s %6s %14s %10s\n", "benchmark", "seats", "ns/op", "+/- 95%");
+    try {
+        if (baselinePath) baseline = readJson(baselinePath);
+
+        // Player actions, each from a state where the rules accept it
+        Fixture plain({Role::Spy, Role::Governor, Role::Judge}, {7, 2, 2});
+        bench.action("player.gather", plain, [](Fixture& f) { f[0].gather(); });
+        bench.action("player.tax", plain, [](Fixture& f) { f[0].tax(); });
+        bench.action("player.bribe", plain, [](Fixture& f) { f[0].bribe(); });
+        bench.action("player.arrest", plain, [](Fixture& f) { f[0].arrest(f[1]); });
+        bench.action("player.sanction", plain, [](Fixture& f) { f[0].sanction(f[1]); });
+        bench.action("player.coup", plain, [](Fixture& f) { f[0].coup(f[1]); });
+        bench.action("player.spyOn", plain, [](Fixture& f) { f[0].spyOn(f[1]); });
+        Fixture baron({Role::Baron, Role::Spy}, {3, 0});
+        bench.action("player.invest", baron, [](Fixture& f) { f[0].invest(); });
+        Fixture taxed({Role::Spy, Role::Governor}, {2, 0}, [](Fixture& f) { f[0].tax(); });
+        bench.action("player.blockTax", taxed, [](Fixture& f) { f[1].blockTax(f[0]); });
+        Fixture bribed({Role::Governor, Role::Judge}, {4, 0}, [](Fixture& f) { f[0].bribe(); });
+        bench.action("player.judgeBribe", bribed, [](Fixture& f) { f[1].judgeBribe(f[0]); });
+        // Eliminating a coup's target clears its attempt, so the pending attempt is put back by hand
+        Fixture couped({Role::Governor, Role::General, Role::Spy}, {7, 5, 0}, [](Fixture& f) {
+            f[0].coup(f[1]);
+            GameSnapshot snap = f.game.snapshot();
+            snap.attemptedCoup.push_back({1, 0});
+            f.game.restore(snap);
+        });
+        bench.action("player.generalBlockCoup", couped, [](Fixture& f) { f[1].generalBlockCoup(f[0]); });
+        // A rule check that fails: the cost of a rejected action
+        Fixture sanctioned({Role::Spy, Role::Governor}, {0, 3}, [](Fixture& f) {
+            f[0].gather();
+            f[1].sanction(f[0]);
+        });
+        bench.action("rule.rejectSanctionedGather", sanctioned, [](Fixture& f) {
+            try {
+                f[0].gather();
+            } catch (const std::logic_error&) {
+                sink = sink + 1;
+            }
+        });
+
+        // Turn order and lookups by table size
+        for (int seats : {2, 4, 6}) {
+            Fixture table(std::vector<Role>(seats, Role::Governor));
+            const std::string last = "P" + std::to_string(seats - 1);
+            bench.repeat("game.nextTurn", seats, [&] { table.game.nextTurn(); });
+            bench.repeat("game.currentPlayer", seats, [&] { sink = sink + reinterpret_cast<uintptr_t>(table.game.currentPlayer()); });
+            bench.repeat("game.getPlayer", seats, [&] { sink = sink + reinterpret_cast<uintptr_t>(table.game.getPlayer(last)); });
+        }
+
+        // Cost the GUI overlay adds to what it measures: one sample, and one timed scope around nothing
+        RollingSamples window;
+        bench.repeat("perf.record", 0, [&] { window.record(static_cast<double>(sink & 0xff)); });
+        bench.repeat("perf.scopedSample", 0, [&] { ScopedSample timing(window); });
+
+        // What one trace point adds to every action it wraps, with tracing off and on
+        bench.repeat("trace.scopeOff", 0, [&] { TraceScope trace("bench", "bench"); });
+        Trace::enable(true);
+        bench.repeat("trace.scopeOn", 0, [&] { TraceScope trace("bench", "bench"); });
+        Trace::enable(false);
+        Trace::clear();
+
+        // Whole games with the simple policy (ns per game)
+        const Role cycle[] = {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant};
+        for (int seats : {2, 4, 6}) {
+            std::vector<Role> roles(cycle, cycle + seats);
+            uint64_t seed = 0;
+            bench.repeat("game.fullGame", seats, [&] { sink = sink + static_cast<uintptr_t>(playGame(roles, ++seed).actions); });
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_actions: %s\n", e.what());
+        return 1;
+    }
+
+    if (jsonPath) {
+        std::FILE* out = std::strcmp(jsonPath, "-") == 0 ? stdout : std::fopen(jsonPath, "w");
+        if (!out) {
+            std::fprintf(stderr, "bench_actions: cannot write %s\n", jsonPath);
+            return 1;
+        }
+        writeJson(bench.results(), out);
+        if (out != stdout) std::fclose(out);
+    }
+    if (baselinePath) {
+        std::vector<std::string> regressed = compare(baseline, bench.results(), tolerance);
+        if (!regressed.empty()) {
+            std::fprintf(stderr, "bench_actions: %zu benchmark(s) regressed against %s:", regressed.size(), baselinePath);
+            for (const std::string& name : regressed) std::fprintf(stderr, " %s", name.c_str());
+            std::fprintf(stderr, "\n");
+            return 2;
+        }
+        std::printf("no significant regressions against %s\n", baselinePath);
+    }
+    return 0;
+}
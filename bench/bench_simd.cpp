@@ -0,0 +1,66 @@
+// orel2744@gmail.com
+// bench_simd.cpp - Times VecGame's legality-mask and coin kernels at every SIMD level.
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "LaneState.hpp"
+#include "SimdKernels.hpp"
+#include "VecGame.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Runs fn `reps` times and returns the nanoseconds per lane per call.
+ * @param fn The kernel call.
+ * @param reps Repetitions.
+ * @param lanes Lanes per call.
+ */
+template <class F>
+static double nsPerLane(F&& fn, int reps, size_t lanes) {
+    fn(); // warm-up
+    auto start = Clock::now();
+    for (int r = 0; r < reps; ++r) fn();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return ns / (static_cast<double>(reps) * static_cast<double>(lanes));
+}
+
+int main() {
+    const size_t LANES = 4096;
+    const int SEATS = 6;
+    const int REPS = 2000;
+
+    // Random mid-game states: coins and banks spread over every threshold the masks test
+    VecGame vec(LANES, SEATS, 1);
+    std::mt19937_64 rng(2);
+    for (size_t i = 0; i < LANES; ++i) {
+        LaneState s = vec.get(i);
+        s.bank = static_cast<int16_t>(rng() % 40);
+        s.turn = static_cast<int8_t>(rng() % SEATS);
+        for (int p = 0; p < SEATS; ++p) {
+            s.coins[p] = static_cast<int16_t>(rng() % 12);
+            s.sanction[p] = rng() % 4 == 0 ? static_cast<int8_t>((p + 1) % SEATS) : -1;
+            s.extra[p] = rng() % 3 == 0;
+        }
+        vec.set(i, s);
+    }
+
+    std::vector<uint16_t> masks(LANES);
+    std::vector<int16_t> plus(LANES, 1), minus(LANES, -1);
+    SimdLevel original = activeSimdLevel();
+    double scalarMask = 0, scalarPay = 0;
+    std::printf("%-8s %14s %14s %10s %10s\n", "level", "mask ns/lane", "pay ns/lane", "mask x", "pay x");
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (setSimdLevel(level) != level) continue;
+        double mask = nsPerLane([&] { vec.legalMasks(masks.data()); }, REPS, LANES);
+        bool flip = false;
+        double pay = nsPerLane([&] { vec.payFromBank(flip ? minus.data() : plus.data()); flip = !flip; }, REPS, LANES);
+        if (level == SimdLevel::Scalar) {
+            scalarMask = mask;
+            scalarPay = pay;
+        }
+        std::printf("%-8s %14.3f %14.3f %10.2f %10.2f\n", simdLevelName(level), mask, pay, scalarMask / mask, scalarPay / pay);
+    }
+    setSimdLevel(original);
+    return 0;
+}
@@ -0,0 +1,73 @@
+// orel2744@gmail.com
+// Action.hpp defines a seat-indexed description of a single player action.
+// Actions can be stored (replays), sent over the wire (server) or generated by bots,
+// and applied to a Game with applyAction(), which calls the matching Player method.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class Game;
+
+// enum listing every action a player can take, in the order of the Player interface.
+enum class ActionType : uint8_t {
+    Gather,
+    Tax,
+    Bribe,
+    Arrest,
+    Sanction,
+    Coup,
+    Invest,
+    SpyOn,
+    PreventCoup,
+    JudgeBribe,
+    GeneralBlockCoup,  // target is the attacker whose coup is blocked
+    BlockTax,
+    SkipTurn
+};
+
+constexpr int ACTION_TYPE_COUNT = static_cast<int>(ActionType::SkipTurn) + 1;
+
+/**
+ * @brief One action: who acts, what they do, and (for targeted actions) on whom.
+ */
+struct Action {
+    ActionType type = ActionType::SkipTurn;
+    int actor = 0;    ///< Seat of the acting player
+    int target = -1;  ///< Seat of the target, or -1 for untargeted actions
+
+    bool operator==(const Action& o) const { return type == o.type && actor == o.actor && target == o.target; }
+    bool operator!=(const Action& o) const { return !(*this == o); }
+};
+
+/**
+ * @brief Returns true if the action type needs a target seat.
+ * @param type The action type.
+ */
+bool actionNeedsTarget(ActionType type);
+
+/**
+ * @brief Converts an action type to its readable name (e.g. "gather", "blockTax").
+ * @param type The action type.
+ */
+std::string actionTypeToString(ActionType type);
+
+/**
+ * @brief Parses a readable action name produced by actionTypeToString().
+ * @param name The action name.
+ * @return The matching action type.
+ * @throws std::invalid_argument if the name is unknown.
+ */
+ActionType actionTypeFromString(const std::string& name);
+
+/**
+ * @brief Applies an action to a game by calling the matching method on the acting player.
+ *        All rule checks are the Player's; illegal actions throw exactly as the direct call would.
+ * @param game The game to act on.
+ * @param action The action to apply.
+ * @throws std::out_of_range if a seat does not exist.
+ * @throws std::invalid_argument if a targeted action has no target.
+ * @throws std::logic_error for actions the rules do not allow.
+ */
+void applyAction(Game& game, const Action& action);
@@ -0,0 +1,90 @@
+// orel2744@gmail.com
+// AllocTracker.hpp defines opt-in counting of heap allocations by scoped tag.
+// Built with -DCOUP_TRACK_ALLOCS, AllocTracker.cpp replaces the global operator new/delete, aligned overloads
+// included, and charges each allocation, its bytes and each free to the innermost AllocScope of the calling
+// thread (tag 0 outside any scope). Without the flag nothing is replaced, enabled() is false and every count stays 0.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class AllocTracker
+ * @brief Process-wide allocation counts per tag; counters are relaxed atomics, safe from any thread.
+ */
+class AllocTracker {
+public:
+    static constexpr int MAX_TAGS = 64;
+    static constexpr int UNTAGGED = 0;
+
+    /**
+     * @brief Allocation counts of one tag.
+     */
+    struct Counts {
+        uint64_t scopes = 0;       ///< Times a scope with the tag was entered
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;        ///< Bytes requested
+        uint64_t frees = 0;
+    };
+
+    /**
+     * @brief Returns true if this program was built with -DCOUP_TRACK_ALLOCS (the counts are live).
+     */
+    static bool enabled();
+
+    /**
+     * @brief Returns the tag with a name, registering it the first time (takes a lock; call outside hot loops).
+     * @param name The tag's name.
+     * @throws std::length_error once MAX_TAGS tags exist.
+     */
+    static int tag(const std::string& name);
+
+    /**
+     * @brief Returns a registered tag's name ("untagged" for tag 0).
+     * @throws std::out_of_range if the tag was never registered.
+     */
+    static std::string name(int tag);
+
+    static int tagCount();
+
+    /**
+     * @brief Returns a tag's counts so far.
+     * @throws std::out_of_range if the tag is out of range.
+     */
+    static Counts counts(int tag);
+
+    /**
+     * @brief Returns the counts of the calling thread across all tags, for before/after deltas.
+     */
+    static Counts thisThread();
+
+    /**
+     * @brief Zeroes every tag's counts (tags stay registered).
+     */
+    static void reset();
+
+    // Called by the replaced operator new/delete
+    static void recordAllocation(size_t bytes);
+    static void recordFree();
+
+private:
+    friend class AllocScope;
+    static void enter(int tag);
+};
+
+/**
+ * @class AllocScope
+ * @brief Charges the calling thread's allocations to a tag until destroyed; scopes nest.
+ */
+class AllocScope {
+public:
+    explicit AllocScope(int tag);
+    ~AllocScope();
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    int previous;
+};
@@ -0,0 +1,139 @@
+// orel2744@gmail.com
+// Cfr.hpp defines a Monte Carlo counterfactual regret minimisation (MCCFR) trainer for 2-player Coup.
+// The trained game is an abstraction of the real rules (LaneState): a fixed number of plies from a chosen
+// coin split, information sets that bucket coins and keep the own Role, the public flags and the opponent's
+// last action, and a coin-lead payoff at the horizon. Threads sample games and add regrets to one shared
+// lock-free table; the average strategy converges towards an equilibrium of the abstraction. Its
+// exploitability there is estimated by a best response computed ply by ply over the abstract game tree.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Action.hpp"
+#include "LaneState.hpp"
+
+/**
+ * @brief The abstract game and the trainer's resources.
+ */
+struct CfrConfig {
+    int16_t startCoins = 5;      ///< Coins of each seat at the root (all 36 role pairings are dealt)
+    int16_t bank = 50;           ///< Bank at the root
+    int horizon = 4;             ///< Plies until the game is scored by coin lead (at most 30)
+    double exploration = 0.6;    ///< Share of uniform sampling at the updating seat's decisions
+    unsigned threads = 0;        ///< Worker threads (0 = one per core)
+    unsigned tableBits = 18;     ///< Information-set capacity is 2^tableBits
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief A decision point of the abstract game: the real state plus the public history it keeps.
+ */
+struct CfrPosition {
+    LaneState state;
+    int ply = 0;                        ///< Decisions made since the root
+    int8_t lastAction[2] = {-1, -1};    ///< ActionType of each seat's last accepted action, -1 if none
+
+    /**
+     * @brief Applies an action of the seat to act and records it.
+     * @param action The action.
+     * @return False if the rules rejected it (the position is then unusable, as a rejected action may change it).
+     */
+    bool play(const Action& action);
+};
+
+/**
+ * @class CfrTrainer
+ * @brief Outcome-sampling MCCFR with a shared regret table.
+ *
+ * Each iteration deals a random role pairing, then samples one game for each seat in turn. The updating
+ * seat explores with probability `exploration`. Regrets and average-strategy sums are updated along the
+ * trajectory with importance weights. Updates use atomic adds to floats, so threads never lock. Payoff for
+ * seat 0: +1 win, -1 loss, and at the horizon (coins0 - coins1) / 14 clamped to [-0.5, 0.5].
+ */
+class CfrTrainer {
+public:
+    /**
+     * @brief Allocates an empty regret table.
+     * @param config The abstract game and resources.
+     * @throws std::invalid_argument if the horizon, coins, bank or table size are out of range.
+     */
+    explicit CfrTrainer(const CfrConfig& config = CfrConfig());
+    ~CfrTrainer();
+
+    CfrTrainer(const CfrTrainer&) = delete;
+    CfrTrainer& operator=(const CfrTrainer&) = delete;
+
+    /**
+     * @brief Runs more iterations on all threads.
+     * @param iterations Iterations to add (each updates both seats once).
+     * @throws std::runtime_error if the regret table filled up (raise tableBits).
+     */
+    void train(uint64_t iterations);
+
+    /**
+     * @brief Estimates the exploitability of the average strategy in the abstract game: the mean of what a
+     *        best response gains over the game value for each seat (0 at an equilibrium, at most 2).
+     *
+     * Coin buckets make the abstraction forget exact coins it once saw (imperfect recall), so the
+     * response built ply by ply is a good strategy but not always the best one. The result is a lower bound
+     * on the abstraction's exploitability, and says nothing about exploitability in the real game.
+     */
+    double exploitability() const;
+
+    /**
+     * @brief Returns the average strategy at a position: each legal action with its probability
+     *        (uniform where the information set was never trained). The information set depends only on
+     *        what the acting seat knows; moves the opponent's hidden role refuses here are left out and the
+     *        rest renormalised.
+     * @param position A position of the abstract game (ply below the horizon, game not over).
+     * @throws std::invalid_argument if the position is terminal.
+     */
+    std::vector<std::pair<Action, double>> averageStrategy(const CfrPosition& position) const;
+
+    /**
+     * @brief Returns the root position of a role pairing.
+     * @param first Role of seat 0.
+     * @param second Role of seat 1.
+     */
+    CfrPosition root(Role first, Role second) const;
+
+    /**
+     * @brief Writes the regret and strategy tables with the iteration count.
+     * @param path Output file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Replaces the tables with a checkpoint written by save() under the same abstract game.
+     * @param path Checkpoint file.
+     * @throws std::runtime_error if the file cannot be read, is not a checkpoint, or was written for
+     *         another abstract game or does not fit the table.
+     */
+    void load(const std::string& path);
+
+    uint64_t iterations() const;
+    size_t infoSets() const;
+
+    /**
+     * @brief Returns the wall time spent in train() in seconds.
+     */
+    double seconds() const;
+
+    /**
+     * @brief Returns iterations per second of train() wall time (iterations loaded from a checkpoint excluded).
+     */
+    double iterationsPerSecond() const;
+
+    const CfrConfig& getConfig() const { return config; }
+
+private:
+    struct Impl;
+    CfrConfig config;
+    std::unique_ptr<Impl> impl;
+};
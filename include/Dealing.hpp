@@ -0,0 +1,108 @@
+// orel2744@gmail.com
+// Dealing.hpp defines how roles are dealt across a batch of games and how role win rates are estimated.
+// Independent dealing draws every seat like Game::getRandomRole(); stratified dealing spreads the batch
+// over every role composition in proportion to its probability and rotates seats within each composition,
+// then reweights so the estimates stay unbiased for independent dealing.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Role.hpp"
+#include "Simulation.hpp"
+
+// enum listing the supported dealing modes.
+enum class DealMode { Independent, Stratified };
+
+/**
+ * @brief Roles of one game in a batch, with its estimator weight and composition stratum.
+ */
+struct Deal {
+    std::vector<Role> roles;  ///< Role per seat
+    double weight = 0.0;      ///< Estimator weight; the weights of a batch sum to 1
+    size_t stratum = 0;       ///< Index of the role composition (multiset of roles)
+};
+
+/**
+ * @class BatchDealer
+ * @brief Deals the roles of a batch of games.
+ *
+ * Strata are the role compositions (multisets of 6 roles over k seats), each with its multinomial
+ * probability W_h under independent dealing. Stratified mode gives every composition at least one game
+ * and the rest in proportion to W_h (largest remainders), so each game weighs W_h / n_h. Within a
+ * composition the seats follow a random base arrangement rotated by one seat per game (Latin-square
+ * style), so every role of the composition sits in every seat equally often.
+ */
+class BatchDealer {
+public:
+    /**
+     * @brief Deals a batch.
+     * @param tableSize Seats per game (2 to 6).
+     * @param games Number of games in the batch (stratified mode needs at least one per composition).
+     * @param mode Dealing mode.
+     * @param seed Random seed.
+     * @throws std::invalid_argument if the table size is out of range or the batch is too small.
+     */
+    BatchDealer(size_t tableSize, size_t games, DealMode mode, uint64_t seed);
+
+    const std::vector<Deal>& getDeals() const { return deals; }
+    DealMode getMode() const { return mode; }
+    size_t tableSize() const { return seats; }
+
+    /**
+     * @brief Returns the number of role compositions for this table size.
+     */
+    size_t strataCount() const { return strata.size(); }
+
+    /**
+     * @brief Returns the probability of composition h under independent dealing.
+     * @param h Stratum index.
+     */
+    double stratumProbability(size_t h) const { return probabilities[h]; }
+
+    /**
+     * @brief Returns all role compositions (sorted multisets) for a table size, in a fixed order.
+     * @param tableSize Seats per game.
+     */
+    static std::vector<std::vector<Role>> compositions(size_t tableSize);
+
+private:
+    size_t seats;
+    DealMode mode;
+    std::vector<std::vector<Role>> strata;
+    std::vector<double> probabilities;
+    std::vector<Deal> deals;
+
+    size_t stratumOf(std::vector<Role> roles) const;
+};
+
+/**
+ * @brief Estimated probability that the winner of a game holds a given role.
+ */
+struct RoleEstimate {
+    Role role = Role::Unknown;
+    double winRate = 0.0;    ///< Weighted estimate of P(winner has this role)
+    double variance = 0.0;   ///< Estimated variance of winRate
+    size_t games = 0;        ///< Games in the batch
+
+    /**
+     * @brief Games needed for a confidence interval of the given half-width with this dealing mode.
+     * @param halfWidth Desired half-width of the interval (e.g. 0.01).
+     * @param z Normal quantile (1.96 for 95%).
+     */
+    double gamesNeeded(double halfWidth, double z = 1.96) const {
+        return variance * static_cast<double>(games) * z * z / (halfWidth * halfWidth);
+    }
+};
+
+/**
+ * @brief Estimates the win rate of every role from a dealt batch and its results.
+ *        Independent batches use the plain mean and s^2/N; stratified batches use the weighted mean
+ *        and the stratified variance sum_h W_h^2 s_h^2 / n_h.
+ * @param dealer The dealer that dealt the batch.
+ * @param results Result of each game, in deal order.
+ * @return One estimate per role (Governor..Merchant).
+ * @throws std::invalid_argument if the number of results does not match the batch.
+ */
+std::vector<RoleEstimate> estimateRoleWinRates(const BatchDealer& dealer, const std::vector<GameResult>& results);
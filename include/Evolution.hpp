@@ -0,0 +1,116 @@
+// orel2744@gmail.com
+// Evolution.hpp defines a genetic algorithm that tunes HeuristicBot weights.
+// Each generation, every genome plays a batch of games against bots with the baseline weights, seated in
+// turn at every seat with random roles. The games of one generation use the same deals and random streams
+// for every genome (common random numbers), so fitness differences come from the weights. The batches run
+// on all cores, on preallocated buffers and LaneState copies, so evaluation allocates nothing.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "HeuristicBot.hpp"
+
+/**
+ * @brief Size and operators of the search.
+ */
+struct EvolutionConfig {
+    size_t population = 32;
+    size_t gamesPerGenome = 400;    ///< Games per genome and generation
+    int seats = 3;                  ///< Seats per game (the genome holds one, baseline bots the others)
+    size_t elite = 2;               ///< Best genomes copied unchanged into the next generation
+    size_t tournament = 3;          ///< Genomes drawn per parent selection
+    double mutationRate = 0.25;     ///< Chance per gene of a Gaussian step
+    double mutationScale = 0.15;    ///< Step size as a share of the gene's range
+    size_t maxActions = 400;        ///< Cap on attempted actions per game
+    unsigned threads = 0;           ///< Worker threads (0 = one per core)
+    uint64_t seed = 1;
+    BotWeights baseline = BotWeights::defaults();  ///< Opponents' weights
+};
+
+/**
+ * @brief A candidate bot and its last measured win rate.
+ */
+struct Genome {
+    BotWeights weights;
+    double fitness = 0.0;  ///< Share of games won against the baseline
+};
+
+/**
+ * @brief Summary of one evaluated generation.
+ */
+struct GenerationStats {
+    int generation = 0;
+    double best = 0.0;     ///< Best fitness
+    double mean = 0.0;     ///< Mean fitness
+    uint64_t games = 0;
+    double seconds = 0.0;  ///< Evaluation wall time
+
+    double gamesPerSecond() const { return seconds > 0 ? games / seconds : 0.0; }
+};
+
+/**
+ * @class Evolution
+ * @brief Tournament selection, uniform crossover, Gaussian mutation and elitism over BotWeights.
+ *
+ * The first population holds the baseline and random genomes.
+ */
+class Evolution {
+public:
+    /**
+     * @brief Creates the first population.
+     * @param config Size and operators.
+     * @throws std::invalid_argument if the population, games, seats, elite or tournament are out of range.
+     */
+    explicit Evolution(const EvolutionConfig& config = EvolutionConfig());
+
+    /**
+     * @brief Evaluates the population, sorts it best first, then breeds the next one.
+     * @return The evaluated generation's summary.
+     */
+    GenerationStats step();
+
+    /**
+     * @brief Returns the last evaluated population, best first (empty before the first step()).
+     */
+    const std::vector<Genome>& population() const { return evaluated; }
+
+    /**
+     * @brief Returns the best genome of the last evaluated generation.
+     * @throws std::logic_error before the first step().
+     */
+    const Genome& best() const;
+
+    /**
+     * @brief Measures a bot's win rate against the baseline on all cores.
+     * @param weights The bot.
+     * @param games Games to play (seats rotate).
+     * @param seed Seed of the deals and random streams.
+     */
+    double winRate(const BotWeights& weights, size_t games, uint64_t seed) const;
+
+    int generation() const { return generations; }
+    const EvolutionConfig& getConfig() const { return config; }
+
+private:
+    EvolutionConfig config;
+    std::vector<Genome> evaluated;  ///< Last evaluated population, best first
+    std::vector<Genome> offspring;  ///< Next population, evaluated by the next step()
+    std::unique_ptr<std::atomic<uint32_t>[]> wins;
+    LaneState dealt;  ///< Seats dealt once; every game copies it and draws the roles
+    std::mt19937_64 rng;
+    int generations = 0;
+
+    /**
+     * @brief Plays `games` games per genome on all cores and adds genome i's wins to out[i].
+     */
+    void evaluate(const Genome* genomes, size_t count, size_t games, uint64_t seed, std::atomic<uint32_t>* out) const;
+
+    /**
+     * @brief Draws `tournament` genomes of the evaluated population and returns the fittest.
+     */
+    const Genome& select();
+};
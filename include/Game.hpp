@@ -11,6 +11,9 @@
 #include <random>
 #include <memory>
 #include "Role.hpp"
+#include "GameSnapshot.hpp"
+#include "Observation.hpp"
+#include "Zobrist.hpp"
 
 class Player;
 //
@@ -35,6 +38,33 @@ private:
     std::unordered_map<Player*, Player*> attemptedCoup;  ///< Tracks coup attempts
     std::unordered_map<Player*, Player*> arrestLog;      ///< Tracks arrest actions
     std::unordered_map<Player*, int> taxLog;    ///< Tracks tax actions for blockTax
+    bool logging = true;                        ///< Whether players print their actions
+    uint64_t hashValue = 0;                     ///< Zobrist hash of the state, kept current by every mutation
+    std::vector<int> eliminations;              ///< Seats in the order eliminate() removed them
+
+    friend class Player; // Players toggle the keys of their own fields through toggleHash()
+
+    /**
+     * @brief XORs one field value's key into the hash (once to add it, again to remove it).
+     */
+    void toggleHash(ZobristField field, int seat, int value) { hashValue ^= zobristKey(field, seat, value); }
+
+    /**
+     * @brief Sets a log entry, replacing the old entry's key in the hash with the new one.
+     */
+    template <typename V>
+    void putLog(std::unordered_map<Player*, V>& log, ZobristField field, Player* key, V value);
+
+    /**
+     * @brief Erases a log entry (if any) and its key from the hash.
+     */
+    template <typename V>
+    void eraseLog(std::unordered_map<Player*, V>& log, ZobristField field, Player* key);
+
+    /**
+     * @brief Sets currentTurnIndex and updates the hash.
+     */
+    void setTurnIndex(int index);
 
 public:
     /**
@@ -61,6 +91,72 @@ public:
      */
     std::vector<std::string> playersNames() const;
 
+    /**
+     * @brief Returns the number of seats (alive or not) in the game.
+     */
+    size_t playerCount() const { return players.size(); }
+
+    /**
+     * @brief Returns the player sitting in a seat.
+     * @param seat Zero-based seat index.
+     * @return Pointer to the player.
+     */
+    Player* playerAt(int seat) const;
+
+    /**
+     * @brief Returns all seats in turn order, including eliminated players.
+     */
+    const std::vector<Player*>& getPlayers() const { return players; }
+
+    /**
+     * @brief Returns the seats that are out, in the order they were eliminated (a General who blocked the
+     *        coup against them is not out).
+     */
+    std::vector<int> getEliminationOrder() const;
+
+    /**
+     * @brief Turns the players' action messages on or off (off for batch runs and replays).
+     * @param on True to print actions to std::cout.
+     */
+    void setLogging(bool on) { logging = on; }
+
+    /**
+     * @brief Returns the stream action messages go to: std::cout, or a discarding stream when logging is off.
+     */
+    std::ostream& log() const;
+
+    /**
+     * @brief Returns what one seat may legally know, as a non-owning view over this game (no copying).
+     * @param seat The observing seat.
+     * @return The seat's observation; valid as long as the game and its players.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    Observation viewFor(int seat) const { return Observation(*this, seat); }
+
+    /**
+     * @brief Captures the complete mutable state of the game and its players.
+     * @return Seat-indexed snapshot.
+     */
+    GameSnapshot snapshot() const;
+
+    /**
+     * @brief Restores a snapshot taken from this game (or one seated the same way).
+     * @param snap The snapshot to restore.
+     */
+    void restore(const GameSnapshot& snap);
+
+    /**
+     * @brief Returns the 64-bit Zobrist hash of the game state (seats, bank, turn and all logs),
+     *        maintained incrementally in O(1) per mutation. Equal states of games dealt the same roles
+     *        hash equally, and zobristHash(LaneState::fromGame(game)) == game.hash().
+     */
+    uint64_t hash() const { return hashValue; }
+
+    /**
+     * @brief Recomputes the hash from scratch (what hash() must equal; for checks and after bulk changes).
+     */
+    uint64_t computeHash() const;
+
     /**
      * @brief Advances the turn to the next player.
      */
@@ -0,0 +1,38 @@
+// orel2744@gmail.com
+// GameSnapshot.hpp defines a full, seat-indexed copy of a Game's mutable state.
+// Used as a keyframe: Game::snapshot() captures it and Game::restore() puts a game with the same seats back into it.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Complete mutable state of a Game and its players, keyed by seat instead of Player pointers.
+ *
+ * Player identity (names, roles) is not part of the snapshot; it can only be restored into
+ * the game it was taken from, or one seated the same way.
+ */
+struct GameSnapshot {
+    /**
+     * @brief Mutable state of a single player.
+     */
+    struct Seat {
+        int coins = 0;
+        bool alive = true;
+        bool extraAction = false;
+        int pendingAction = 0;   ///< Player::PendingAction as int (None, Tax, Bribe)
+    };
+
+    std::vector<Seat> seats;
+    int currentTurnIndex = -1;
+    int bank = 0;
+    std::vector<std::pair<int, int>> sanctions;     ///< seat -> turn index
+    std::vector<std::pair<int, int>> arrestBlocks;  ///< seat -> turn index
+    std::vector<std::pair<int, int>> coupBlocks;    ///< seat -> turn index
+    std::vector<std::pair<int, int>> bribeLog;      ///< seat -> turn index
+    std::vector<std::pair<int, int>> taxLog;        ///< seat -> turn index
+    std::vector<int> recentCoupTargets;             ///< seats
+    std::vector<std::pair<int, int>> attemptedCoup; ///< target seat -> attacker seat
+    std::vector<std::pair<int, int>> arrestLog;     ///< source seat -> target seat
+};
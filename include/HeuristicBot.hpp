@@ -0,0 +1,90 @@
+// orel2744@gmail.com
+// HeuristicBot.hpp defines a rule-of-thumb bot whose habits are a vector of tunable weights: how often it
+// taxes, gathers, arrests, sanctions, bribes or invests, when it coups, and whether it picks on the richest
+// opponent. It reads only what its seat can see of a LaneState (coins, who is alive, its own role) and
+// allocates nothing, so millions of games can be played with it (see Evolution.hpp).
+
+#pragma once
+
+#include <array>
+#include <random>
+#include <vector>
+#include "Action.hpp"
+#include "LaneState.hpp"
+
+/**
+ * @brief The parameters of a heuristic bot, as genes with fixed ranges.
+ */
+struct BotWeights {
+    enum Gene {
+        Tax,              ///< Preference for tax
+        Gather,           ///< Preference for gather
+        Arrest,           ///< Preference for arrest (when an opponent has coins)
+        Sanction,         ///< Preference for sanction (at SanctionReserve coins or more)
+        Bribe,            ///< Preference for bribe (at 4 coins or more)
+        Invest,           ///< Preference for invest (Baron at 3 coins or more)
+        CoupAt,           ///< Coins from which the bot considers a coup (7 to 10; it must at 10)
+        CoupChance,       ///< Chance to coup once it can
+        CoupRichest,      ///< Chance to coup the richest opponent rather than a random one
+        ArrestRichest,    ///< Chance to arrest the richest opponent rather than a random one
+        SanctionRichest,  ///< Chance to sanction the richest opponent rather than a random one
+        SanctionReserve,  ///< Coins the bot needs before it sanctions (3 to 9)
+        COUNT
+    };
+
+    std::array<float, COUNT> gene = {};
+
+    float& operator[](int g) { return gene[g]; }
+    float operator[](int g) const { return gene[g]; }
+
+    /**
+     * @brief Returns the smallest value of a gene.
+     * @param g The gene.
+     */
+    static float lowest(int g);
+
+    /**
+     * @brief Returns the largest value of a gene.
+     * @param g The gene.
+     */
+    static float highest(int g);
+
+    /**
+     * @brief Returns weights close to the habits of chooseSimpleAction (see Simulation.hpp).
+     */
+    static BotWeights defaults();
+
+    /**
+     * @brief Returns weights drawn uniformly within every gene's range.
+     * @param rng Random source.
+     */
+    static BotWeights random(std::mt19937_64& rng);
+
+    /**
+     * @brief Clamps every gene into its range.
+     */
+    void clamp();
+};
+
+/**
+ * @brief Picks an action for the seat to act, weighing its options by the bot's weights.
+ *        It never reads another seat's role. The action may still be rejected by the rules.
+ * @param state The game (must have a seat to act).
+ * @param weights The bot.
+ * @param rng Random source.
+ */
+Action chooseHeuristicAction(const LaneState& state, const BotWeights& weights, std::mt19937_64& rng);
+
+/**
+ * @brief Plays one game to completion (or to the action cap) with a bot per seat. Rejected actions fall
+ *        back to gather, then skipTurn, as in playGame(). Nothing is allocated unless the
+ *        elimination order is asked for.
+ * @param state The dealt game; played in place.
+ * @param bots One bot per seat.
+ * @param rng Random source.
+ * @param maxActions Cap on attempted actions.
+ * @param eliminationOrder If non-null, receives the seats that are out at the end, in elimination order.
+ * @return The winning seat, or -1 if the cap was hit.
+ */
+int playHeuristicGame(LaneState& state, const BotWeights* const* bots, std::mt19937_64& rng, size_t maxActions = 1000,
+                      std::vector<int>* eliminationOrder = nullptr);
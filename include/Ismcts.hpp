@@ -0,0 +1,63 @@
+// orel2744@gmail.com
+// Ismcts.hpp defines an information-set Monte Carlo tree search for one seat that cannot see the others' roles.
+// Each iteration draws a determinisation (hidden roles sampled from RoleConstraints), descends a tree whose
+// nodes are the observer's information sets (states keyed by the Zobrist hash of what the observer can see),
+// and finishes with a rollout. Workers search independent trees in parallel; their statistics are merged
+// information set by information set before the move is chosen.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Action.hpp"
+#include "LaneState.hpp"
+#include "RoleConstraints.hpp"
+
+/**
+ * @brief Budget and tuning of a search.
+ */
+struct IsmctsConfig {
+    uint64_t determinisations = 4000;  ///< Iterations in total, each on a fresh determinisation
+    unsigned threads = 0;              ///< Worker threads (0 = one per core)
+    double exploration = 0.7;          ///< UCB exploration constant (rewards are in [0, 1])
+    int maxPlies = 120;                ///< Plies per iteration (tree and rollout); survivors share the reward after
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief Merged statistics of one move at the root.
+ */
+struct IsmctsMove {
+    Action action;
+    uint64_t visits = 0;
+    uint64_t available = 0;  ///< Determinisations in which the move was legal
+    double meanReward = 0.0;
+};
+
+/**
+ * @brief Outcome of a search.
+ */
+struct IsmctsResult {
+    Action best;                     ///< Most visited root move
+    std::vector<IsmctsMove> moves;   ///< Root moves, most visited first
+    uint64_t determinisations = 0;
+    size_t infoSets = 0;             ///< Information sets in the merged tree
+    double seconds = 0.0;
+
+    double determinisationsPerSecond() const { return seconds > 0 ? determinisations / seconds : 0.0; }
+};
+
+/**
+ * @brief Searches for the observer's move.
+ *
+ * Moves are the actions the rules accept from the seat to act; opponents' reactions are part of their
+ * own turns. A node's moves differ between determinisations (roles decide what is legal), so UCB
+ * counts a move's availability instead of its parent's visits (subset-armed bandit).
+ * @param state The game; the observer must be the seat to act. Hidden roles are never read.
+ * @param knowledge The observer's role constraints.
+ * @param config Budget and tuning.
+ * @return The chosen move and root statistics.
+ * @throws std::invalid_argument if the game is over or it is not the observer's turn.
+ */
+IsmctsResult ismctsSearch(const LaneState& state, const RoleConstraints& knowledge, const IsmctsConfig& config = IsmctsConfig());
@@ -0,0 +1,135 @@
+// orel2744@gmail.com
+// LaneState.hpp defines a flat, fixed-size copy of a game's state and a rules engine that runs on it.
+// The rules mirror Game/Player exactly (including the state a rejected action leaves behind) but use
+// seat indices and plain arrays instead of Player objects and hash maps, so states are cheap to copy,
+// compare and hash. LaneRef lets the same rules run on a LaneState or on one lane of a VecGame.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Action.hpp"
+#include "GameSnapshot.hpp"
+#include "Role.hpp"
+
+class Game;
+
+/**
+ * @brief Strided references to the fields of one game, wherever they are stored.
+ *
+ * Per-seat fields of seat p live at `field[p * stride]`; scalar fields at `*field`.
+ * A LaneState uses stride 1; a VecGame lane uses the number of lanes.
+ */
+struct LaneRef {
+    size_t stride = 1;
+    uint8_t* seats = nullptr;
+    int8_t* turn = nullptr;         ///< Game::currentTurnIndex
+    int16_t* bank = nullptr;
+    uint8_t* role = nullptr;        ///< Role as int
+    int16_t* coins = nullptr;
+    uint8_t* alive = nullptr;
+    uint8_t* extra = nullptr;       ///< Extra action from a bribe
+    uint8_t* pending = nullptr;     ///< Pending action (0 none, 1 tax, 2 bribe)
+    int8_t* sanction = nullptr;     ///< Turn index the sanction was applied in, -1 if none
+    int8_t* arrestBlock = nullptr;  ///< Turn index of the Spy's block, -1 if none
+    int8_t* coupBlock = nullptr;    ///< Turn index of the General's block, -1 if none
+    int8_t* bribe = nullptr;        ///< Turn index of the bribe, -1 if none
+    int8_t* tax = nullptr;          ///< Turn index of the tax, -1 if none
+    int8_t* arrestTarget = nullptr; ///< Seat this seat last arrested, -1 if none
+};
+
+/**
+ * @brief Applies an action to a game through a LaneRef, with exactly the rules of applyAction() on a Game.
+ * @param g The game.
+ * @param action The action.
+ * @return True if the action was accepted. A rejected action may still have changed the state,
+ *         exactly where the corresponding Player method mutates before throwing.
+ */
+bool applyLaneAction(const LaneRef& g, const Action& action);
+
+/**
+ * @struct LaneState
+ * @brief A complete game (2 to MAX_SEATS seats) in one trivially copyable struct.
+ *
+ * Game also tracks attempted coups and recent coup targets, but no action leaves entries in them
+ * (a coup's target is erased from attemptedCoup when it is eliminated, and nothing marks coup targets),
+ * so they are always empty in states reachable through actions and are not stored here.
+ */
+struct LaneState {
+    static constexpr int MAX_SEATS = 6;
+    static constexpr int16_t START_BANK = 50;
+    static constexpr int MAX_ACTIONS = 5 + 7 * MAX_SEATS;  ///< Untargeted types + targeted types per seat
+
+    uint8_t seats = 0;
+    int8_t turn = -1;
+    int16_t bank = START_BANK;
+    uint8_t role[MAX_SEATS] = {};
+    int16_t coins[MAX_SEATS] = {};
+    uint8_t alive[MAX_SEATS] = {};
+    uint8_t extra[MAX_SEATS] = {};
+    uint8_t pending[MAX_SEATS] = {};
+    int8_t sanction[MAX_SEATS] = {};
+    int8_t arrestBlock[MAX_SEATS] = {};
+    int8_t coupBlock[MAX_SEATS] = {};
+    int8_t bribe[MAX_SEATS] = {};
+    int8_t tax[MAX_SEATS] = {};
+    int8_t arrestTarget[MAX_SEATS] = {};
+
+    /**
+     * @brief Returns the starting state of a game with the given roles (like a fresh Game with these players).
+     * @param roles Role of each seat (2 to MAX_SEATS).
+     * @throws std::invalid_argument if the number of seats is out of range or a role is Unknown.
+     */
+    static LaneState deal(const std::vector<Role>& roles);
+
+    /**
+     * @brief Copies the state of a Game.
+     * @param game The game (2 to MAX_SEATS seats).
+     * @throws std::invalid_argument if the game has too few or too many seats, or holds coup
+     *         bookkeeping that actions never leave behind (e.g. after restoring a hand-made snapshot).
+     */
+    static LaneState fromGame(const Game& game);
+
+    /**
+     * @brief Returns the state as a GameSnapshot, to restore into a Game seated with the same roles.
+     */
+    GameSnapshot toSnapshot() const;
+
+    /**
+     * @brief Returns a stride-1 reference to this state.
+     */
+    LaneRef ref();
+
+    /**
+     * @brief Applies an action (see applyLaneAction).
+     * @param action The action.
+     * @return True if the action was accepted.
+     */
+    bool apply(const Action& action) { return applyLaneAction(ref(), action); }
+
+    /**
+     * @brief Returns the seat whose turn it is, or -1 if nobody is alive.
+     */
+    int currentSeat() const;
+
+    /**
+     * @brief Lists every action of the seat to act that the rules accept (GeneralBlockCoup never is).
+     * @param out Receives up to MAX_ACTIONS actions, in ActionType then target order.
+     * @return Number of actions written (0 once the game is over).
+     */
+    int legalActions(Action* out) const;
+
+    /**
+     * @brief Returns the number of players still alive.
+     */
+    int aliveCount() const;
+
+    /**
+     * @brief Returns the winning seat when exactly one player is alive, otherwise -1.
+     */
+    int winner() const;
+
+    bool operator==(const LaneState& other) const;
+    bool operator!=(const LaneState& other) const { return !(*this == other); }
+};
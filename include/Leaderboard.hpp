@@ -0,0 +1,84 @@
+// orel2744@gmail.com
+// Leaderboard.hpp defines an order-statistic treap that ranks players by score.
+// Nodes live in arrays indexed by player id (no allocation per update once every id was seen), and each
+// node keeps its subtree size, so moving a player, finding a player's rank and finding the player at a
+// rank all take O(log n) expected time however many results have been recorded.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class Leaderboard
+ * @brief Players ordered by descending score (lower id first on ties); rank 0 is the best.
+ */
+class Leaderboard {
+public:
+    /**
+     * @brief Adds a player or moves it to a new score.
+     * @param id Player id (ids should be small and dense; storage grows to the largest id).
+     * @param score The player's score.
+     * @throws std::out_of_range if id is negative.
+     */
+    void set(int id, double score);
+
+    /**
+     * @brief Removes a player (nothing happens if it is absent).
+     * @param id Player id.
+     */
+    void erase(int id);
+
+    /**
+     * @brief Returns whether a player is ranked.
+     * @param id Player id.
+     */
+    bool contains(int id) const;
+
+    /**
+     * @brief Returns a player's score.
+     * @param id Player id.
+     * @throws std::out_of_range if the player is absent.
+     */
+    double score(int id) const;
+
+    /**
+     * @brief Returns a player's rank (0 = highest score).
+     * @param id Player id.
+     * @throws std::out_of_range if the player is absent.
+     */
+    size_t rankOf(int id) const;
+
+    /**
+     * @brief Returns the player at a rank.
+     * @param rank 0 for the highest score.
+     * @throws std::out_of_range if rank >= size().
+     */
+    int atRank(size_t rank) const;
+
+    /**
+     * @brief Returns the best k players (fewer if there are fewer), best first.
+     * @param k Number of players.
+     */
+    std::vector<int> top(size_t k) const;
+
+    size_t size() const { return root < 0 ? 0 : nodes[root].size; }
+
+private:
+    struct Node {
+        double score = 0.0;
+        uint64_t priority = 0;
+        int left = -1, right = -1;
+        uint32_t size = 0;  ///< Nodes in the subtree; 0 while the player is not ranked
+    };
+    std::vector<Node> nodes;
+    int root = -1;
+
+    bool before(int a, int b) const;
+    void update(int t);
+    int merge(int a, int b);
+    void split(int t, int id, int& left, int& right);
+    int insert(int t, int id);
+    int remove(int t, int id);
+};
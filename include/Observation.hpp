@@ -0,0 +1,148 @@
+// orel2744@gmail.com
+// Observation.hpp defines what one seat may legally know about a game.
+// An Observation is a non-owning view over the live Game: building one is O(1) and every query
+// reads the shared state directly, so views for all seats cost O(seats) per action.
+// Hidden information (other players' roles while they are alive) is never exposed.
+// ObservationEncoder.hpp turns an Observation into a fixed-size tensor for training.
+
+#pragma once
+
+#include <string>
+#include "Role.hpp"
+
+class Game;
+class Player;
+
+/**
+ * @class Observation
+ * @brief A seat's view of a game: public state plus that seat's private knowledge.
+ *
+ * Coins, alive flags, sanctions, blocks, the bank and the turn are public. A player's role is only
+ * visible to that player, and to everyone once the player has been eliminated (the card is turned over).
+ * The view reads the game live; it must not outlive the game and its players.
+ */
+class Observation {
+public:
+    /**
+     * @brief Creates the view of one seat.
+     * @param game The game to observe.
+     * @param seat The observing seat.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    Observation(const Game& game, int seat);
+
+    /**
+     * @brief Returns the observing seat.
+     */
+    int getSeat() const { return seat; }
+
+    /**
+     * @brief Returns the number of seats (alive or not).
+     */
+    int seatCount() const;
+
+    /**
+     * @brief Returns the seat whose turn it is, or -1 if nobody can act.
+     */
+    int turn() const;
+
+    /**
+     * @brief Returns true if it is the observing seat's turn.
+     */
+    bool isMyTurn() const { return turn() == seat; }
+
+    /**
+     * @brief Returns the coins in the bank.
+     */
+    int bank() const;
+
+    /**
+     * @brief Returns the observing seat's own role.
+     */
+    Role myRole() const;
+
+    /**
+     * @brief Returns a seat's role as far as the observer knows it.
+     * @param s Seat index.
+     * @return The role for the observer's own seat or an eliminated seat, otherwise Role::Unknown.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    Role role(int s) const;
+
+    /**
+     * @brief Returns a seat's display name.
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    const std::string& name(int s) const;
+
+    /**
+     * @brief Returns a seat's coins (public).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    int coins(int s) const;
+
+    /**
+     * @brief Returns whether a seat is still in the game.
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool alive(int s) const;
+
+    /**
+     * @brief Returns whether a seat is sanctioned (cannot gather or tax).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool sanctioned(int s) const;
+
+    /**
+     * @brief Returns whether arrests against a seat are blocked (by a Spy).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool arrestBlocked(int s) const;
+
+    /**
+     * @brief Returns whether coups against a seat are blocked (by a General).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool coupBlocked(int s) const;
+
+    /**
+     * @brief Returns whether a seat's last tax can still be blocked (a Governor may cancel it).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool taxPending(int s) const;
+
+    /**
+     * @brief Returns whether a seat's last bribe can still be cancelled (by a Judge).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool bribePending(int s) const;
+
+    /**
+     * @brief Returns whether `source` arrested `target` with its most recent arrest (arrests are public).
+     * @param source Arresting seat.
+     * @param target Arrested seat.
+     * @throws std::out_of_range if a seat does not exist.
+     */
+    bool arrested(int source, int target) const;
+
+    /**
+     * @brief Returns whether the observer arrested a seat on its previous turn (and so may not arrest it again).
+     * @param s Seat index.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    bool arrestedByMeLastTurn(int s) const;
+
+private:
+    const Game* game;
+    int seat;
+
+    Player* at(int s) const;
+};
@@ -0,0 +1,66 @@
+// orel2744@gmail.com
+// ObservationEncoder.hpp defines a fixed-layout tensor encoding of a seat's Observation for training agents.
+// The encoder writes into a caller-provided contiguous buffer (float or uint8) and never allocates, so a
+// trainer can encode a whole batch into one preallocated array of batch * ObservationEncoder::SIZE values.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Observation.hpp"
+
+/**
+ * @class ObservationEncoder
+ * @brief Encodes an Observation into SIZE values with a fixed layout.
+ *
+ * Layout (all values are counts or 0/1 flags; uint8 buffers saturate at 255):
+ * - [BANK] bank, [ALIVE_COUNT] alive seats, [SEAT_COUNT] seats, [MY_TURN] observer to act
+ * - [MY_ROLE .. +6) one-hot of the observer's role
+ * - MAX_SEATS slots of SLOT_SIZE values starting at SLOTS, ordered relative to the observer
+ *   (slot 0 is the observer, slot k the seat k places after it); slots past the seat count are all zero.
+ *   Each slot holds the fields at the SLOT_* offsets, ending with a one-hot of the seat's role when the
+ *   observer may know it (own seat or eliminated), otherwise all zero.
+ */
+class ObservationEncoder {
+public:
+    static constexpr int MAX_SEATS = 6;
+    static constexpr int ROLE_COUNT = 6;
+
+    // Global fields
+    static constexpr size_t BANK = 0, ALIVE_COUNT = 1, SEAT_COUNT = 2, MY_TURN = 3, MY_ROLE = 4;
+    static constexpr size_t SLOTS = MY_ROLE + ROLE_COUNT;
+
+    // Per-seat slot fields
+    static constexpr size_t SLOT_PRESENT = 0, SLOT_ALIVE = 1, SLOT_COINS = 2, SLOT_TURN = 3,
+                            SLOT_SANCTIONED = 4, SLOT_ARREST_BLOCKED = 5, SLOT_COUP_BLOCKED = 6,
+                            SLOT_TAX_PENDING = 7, SLOT_BRIBE_PENDING = 8,
+                            SLOT_ARRESTED_BY_ME = 9,   ///< the observer's last arrest hit this seat
+                            SLOT_ARRESTED_ME = 10,     ///< this seat's last arrest hit the observer
+                            SLOT_ROLE = 11;
+    static constexpr size_t SLOT_SIZE = SLOT_ROLE + ROLE_COUNT;
+
+    static constexpr size_t SIZE = SLOTS + MAX_SEATS * SLOT_SIZE;
+
+    /**
+     * @brief Writes the observation into SIZE floats.
+     * @param obs The observation (at most MAX_SEATS seats).
+     * @param out Buffer of at least SIZE floats.
+     * @throws std::invalid_argument if the game has more than MAX_SEATS seats.
+     */
+    static void encode(const Observation& obs, float* out);
+
+    /**
+     * @brief Writes the observation into SIZE bytes (counts saturate at 255).
+     * @param obs The observation (at most MAX_SEATS seats).
+     * @param out Buffer of at least SIZE bytes.
+     * @throws std::invalid_argument if the game has more than MAX_SEATS seats.
+     */
+    static void encode(const Observation& obs, uint8_t* out);
+
+    /**
+     * @brief Returns the buffer offset of a field of the slot k places after the observer.
+     * @param slot Relative slot (0 = observer).
+     * @param field One of the SLOT_* offsets.
+     */
+    static constexpr size_t slotOffset(int slot, size_t field) { return SLOTS + static_cast<size_t>(slot) * SLOT_SIZE + field; }
+};
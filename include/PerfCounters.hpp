@@ -0,0 +1,113 @@
+// orel2744@gmail.com
+// PerfCounters.hpp defines hardware performance counters around code regions (Linux perf_event_open).
+// A PerfCounters opens whatever counters the kernel allows for the calling thread (cycles, instructions,
+// cache and branch events) and measures regions with start()/stop(). Counters that cannot be opened (other
+// systems, containers, perf_event_paranoid) are reported unavailable with the reason; wall time always works.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    CacheReferences,  ///< Last-level cache accesses
+    CacheMisses,      ///< Last-level cache misses
+    Branches,
+    BranchMisses,
+    COUNT
+};
+
+/**
+ * @brief Returns a readable name for a counter ("cycles", "cache-misses", ...).
+ */
+const char* perfEventName(PerfEvent event);
+
+/**
+ * @brief Counter values of one measured region (scaled up when the kernel multiplexed a counter).
+ */
+struct PerfSample {
+    static constexpr int COUNT = static_cast<int>(PerfEvent::COUNT);
+
+    double seconds = 0.0;
+    bool available[COUNT] = {};
+    uint64_t value[COUNT] = {};
+
+    bool has(PerfEvent e) const { return available[static_cast<int>(e)]; }
+    uint64_t operator[](PerfEvent e) const { return value[static_cast<int>(e)]; }
+
+    /**
+     * @brief Returns instructions per cycle, or 0 if either counter is unavailable.
+     */
+    double ipc() const;
+
+    /**
+     * @brief Returns a counter per million operations, or -1 if it is unavailable.
+     * @param e The counter.
+     * @param operations Operations done in the region (e.g. actions applied).
+     */
+    double perMillion(PerfEvent e, uint64_t operations) const;
+};
+
+/**
+ * @class PerfCounters
+ * @brief Counters of the calling thread (user space only), opened once and reused for many regions.
+ */
+class PerfCounters {
+public:
+    /**
+     * @brief Opens every counter it can; never throws.
+     */
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Returns true if at least one hardware counter is open.
+     */
+    bool available() const;
+    bool available(PerfEvent e) const { return fds[static_cast<int>(e)] >= 0; }
+
+    /**
+     * @brief Returns why counters are missing ("" if all opened).
+     */
+    const std::string& unavailableReason() const { return reason; }
+
+    /**
+     * @brief Zeroes and starts the counters.
+     */
+    void start();
+
+    /**
+     * @brief Stops the counters and returns their values since start().
+     * @throws std::logic_error if start() was not called.
+     */
+    PerfSample stop();
+
+    /**
+     * @brief Measures one call of fn.
+     */
+    template <class F>
+    PerfSample measure(F&& fn) {
+        start();
+        fn();
+        return stop();
+    }
+
+private:
+    int fds[PerfSample::COUNT];
+    std::string reason;
+    bool running = false;
+    std::chrono::steady_clock::time_point began;
+};
+
+/**
+ * @brief Formats a sample as one line per counter: total, per million operations, plus IPC and miss rates.
+ * @param sample The sample.
+ * @param operations Operations done in the region.
+ */
+std::string formatPerfSample(const PerfSample& sample, uint64_t operations);
@@ -0,0 +1,96 @@
+// orel2744@gmail.com
+// PerfStats.hpp defines small, allocation-free helpers for measuring where time goes at runtime.
+// RollingSamples keeps the last N samples of a metric and answers percentile queries;
+// ScopedSample times a block of code into a RollingSamples window.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class RollingSamples
+ * @brief Fixed-size window of the most recent samples of a metric (frame time, latency, counts).
+ *
+ * Recording is O(1) and never allocates; percentiles are computed on demand from a scratch copy,
+ * so the cost is paid only while somebody is looking at the numbers. bench_actions measures the
+ * recording side as perf.record and perf.scopedSample.
+ */
+class RollingSamples {
+public:
+    /**
+     * @brief Constructs a window that remembers the last `window` samples.
+     * @param window Number of samples kept.
+     * @throws std::invalid_argument if window is zero.
+     */
+    explicit RollingSamples(size_t window = 240);
+
+    /**
+     * @brief Records a sample, overwriting the oldest one when the window is full.
+     * @param value The sample value.
+     */
+    void record(double value);
+
+    /**
+     * @brief Returns the number of samples currently in the window.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Returns the window capacity.
+     */
+    size_t capacity() const { return ring.size(); }
+
+    /**
+     * @brief Returns the i-th sample from oldest (0) to newest (size()-1).
+     * @param i Sample index.
+     */
+    double sampleAt(size_t i) const;
+
+    /**
+     * @brief Returns the most recent sample, or 0 if empty.
+     */
+    double latest() const;
+
+    /**
+     * @brief Returns the largest sample in the window, or 0 if empty.
+     */
+    double max() const;
+
+    /**
+     * @brief Returns the p-th percentile (nearest rank) of the window, or 0 if empty.
+     * @param p Percentile in [0, 100].
+     */
+    double percentile(double p) const;
+
+    /**
+     * @brief Forgets all samples.
+     */
+    void clear() { head = 0; count = 0; }
+
+private:
+    std::vector<double> ring;
+    mutable std::vector<double> scratch; ///< Reused buffer for percentile selection
+    size_t head = 0;                     ///< Next slot to write
+    size_t count = 0;
+};
+
+/**
+ * @class ScopedSample
+ * @brief Records the wall time (in microseconds) spent in its scope into a RollingSamples window.
+ */
+class ScopedSample {
+public:
+    explicit ScopedSample(RollingSamples& samples)
+        : samples(samples), start(std::chrono::steady_clock::now()) {}
+    ~ScopedSample() {
+        samples.record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    ScopedSample(const ScopedSample&) = delete;
+    ScopedSample& operator=(const ScopedSample&) = delete;
+
+private:
+    RollingSamples& samples;
+    std::chrono::steady_clock::time_point start;
+};
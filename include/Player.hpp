@@ -2,6 +2,7 @@
 #pragma once
 
 #include <string>
+#include <iosfwd>
 #include "Role.hpp"
 class Game;
 
@@ -18,6 +19,8 @@ class Game;
  * The Player class is central to the game logic, ensuring all rules and player actions are enforced.
  */
 class Player {
+    friend class Game; // Game assigns seats and saves/restores player state for snapshots
+
 private:
     std::string name;
     Role role;
@@ -25,10 +28,17 @@ private:
     bool alive;
     Game* game;
     bool extraAction;
+    int seat = -1;      ///< Position in the game's turn order, assigned by Game::addPlayer
 
     enum class PendingAction { None, Tax, Bribe };
     PendingAction pendingAction = PendingAction::None;
 
+    // State writes go through these so the game's Zobrist hash follows every change
+    void setCoins(int value);
+    void setAlive(bool value);
+    void setExtraAction(bool value);
+    void setPending(PendingAction value);
+
 public:
     virtual ~Player() = default;
     /**
@@ -60,6 +70,11 @@ public:
      * @return True if alive, false if eliminated.
      */
     bool isAlive() const;
+    /**
+     * @brief Gets the player's seat (position in turn order) in its game.
+     * @return Zero-based seat index.
+     */
+    int getSeat() const { return seat; }
 
     /**
      * @brief Allows the player to gather 1 coin. Merchants may receive a bonus. Throws if dead, not your turn, or sanctioned.
@@ -171,9 +186,16 @@ public:
      */
     virtual void skipTurn() = 0;
 
-    void resetPendingAction() { pendingAction = PendingAction::None; }
+protected:
+    /**
+     * @brief Returns the stream action messages are written to (silent when the game's logging is off).
+     */
+    std::ostream& log() const;
+
+public:
+    void resetPendingAction() { setPending(PendingAction::None); }
     PendingAction getPendingAction() const { return pendingAction; }
-    void setPendingAction(PendingAction act) { pendingAction = act; }
+    void setPendingAction(PendingAction act) { setPending(act); }
 
 ////
 };
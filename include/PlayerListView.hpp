@@ -0,0 +1,131 @@
+// orel2744@gmail.com
+// PlayerListView.hpp defines a virtualised, scrollable model of the GUI player list.
+// Keeps a filtered/sorted index of players and exposes only the rows that fit in the viewport,
+// so drawing the list costs the same for 5 seats or 200.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Role.hpp"
+
+class Player;
+
+/**
+ * @class PlayerListView
+ * @brief Rendering-independent model of the scrollable player list panel.
+ *
+ * The view holds an index of the players that pass the current filter, ordered by the
+ * current sort key. The index is rebuilt only when marked dirty (after an action), while
+ * every frame only asks for the handful of rows inside the viewport.
+ */
+class PlayerListView {
+public:
+    /**
+     * @brief Keys the list can be ordered by.
+     */
+    enum class SortKey { Seat, Coins, Role };
+
+    /**
+     * @brief Constructs a view for a panel of the given viewport height.
+     * @param rowHeight Height of a single row in pixels.
+     * @param viewportHeight Height of the visible area in pixels.
+     * @throws std::invalid_argument if either height is not positive.
+     */
+    PlayerListView(float rowHeight, float viewportHeight);
+
+    /**
+     * @brief Shows only players with the given role. Role::Unknown shows everyone.
+     * @param role The role to filter by.
+     */
+    void setRoleFilter(Role role);
+
+    /**
+     * @brief Returns the active role filter (Role::Unknown when not filtering).
+     */
+    Role getRoleFilter() const { return roleFilter; }
+
+    /**
+     * @brief Sets the sort key and direction of the list.
+     * @param key The key to sort by.
+     * @param descending True to sort from high to low.
+     */
+    void setSort(SortKey key, bool descending);
+
+    /**
+     * @brief Returns the active sort key.
+     */
+    SortKey getSortKey() const { return sortKey; }
+
+    /**
+     * @brief Marks the index as stale so the next rebuild() recomputes it.
+     */
+    void markDirty() { dirty = true; }
+
+    /**
+     * @brief Recomputes the filtered/sorted index if it is stale. O(n log n), called once per action.
+     * @param players All seats of the game, in seat order.
+     */
+    void rebuild(const std::vector<Player*>& players);
+
+    /**
+     * @brief Scrolls the list by a number of pixels, clamped to the content.
+     * @param dy Pixels to scroll (positive scrolls down).
+     */
+    void scrollBy(float dy);
+
+    /**
+     * @brief Scrolls so that the given player is inside the viewport, if it is listed.
+     * @param p The player to reveal.
+     */
+    void scrollTo(const Player* p);
+
+    /**
+     * @brief Returns the number of rows that pass the filter.
+     */
+    size_t rowCount() const { return rows.size(); }
+
+    /**
+     * @brief Returns the index of the first row inside the viewport.
+     */
+    size_t firstVisible() const;
+
+    /**
+     * @brief Returns the number of rows inside the viewport (including a partially visible last row).
+     */
+    size_t visibleCount() const;
+
+    /**
+     * @brief Returns the player shown in the given row.
+     * @param row Row index in [0, rowCount()).
+     */
+    Player* rowAt(size_t row) const { return rows[row]; }
+
+    /**
+     * @brief Returns the y offset of a row relative to the top of the viewport.
+     * @param row Row index.
+     */
+    float rowOffset(size_t row) const;
+
+    /**
+     * @brief Returns the largest number of rows that can be visible at once (for pre-allocating row widgets).
+     */
+    size_t maxVisibleRows() const;
+
+    /**
+     * @brief Returns the current scroll offset in pixels.
+     */
+    float getScroll() const { return scroll; }
+
+private:
+    float rowHeight;
+    float viewportHeight;
+    float scroll = 0.f;
+    Role roleFilter = Role::Unknown;
+    SortKey sortKey = SortKey::Seat;
+    bool descending = false;
+    bool dirty = true;
+    std::vector<Player*> rows;   ///< Players passing the filter, in display order
+
+    float maxScroll() const;
+};
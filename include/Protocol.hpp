@@ -0,0 +1,138 @@
+// orel2744@gmail.com
+// Protocol.hpp defines the compact binary wire protocol of coup_server.
+// Every message is a frame: u32 payload length (little-endian), then the payload,
+// whose first byte is the MsgType and next four bytes a client-chosen tag echoed in the reply.
+// Spectators receive pushed frames (tag 0): a Keyframe with the full public state, then one Delta
+// per change carrying only the fields that changed; every delta and keyframe has a sequence number.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Action.hpp"
+#include "Role.hpp"
+
+// enum listing the message types; requests are below 64, replies from 64.
+enum class MsgType : uint8_t {
+    CreateTable = 1,  // count = number of seats
+    JoinTable = 2,    // table, seat
+    Act = 3,          // table, action
+    GetState = 4,     // table
+    CloseTable = 5,   // table
+    Watch = 6,        // table
+    TableCreated = 64,// table
+    Joined = 65,      // table, seat, role
+    ActResult = 66,   // table, text (empty when accepted), state
+    State = 67,       // table, state
+    Closed = 68,      // table (also pushed to spectators)
+    Watching = 69,    // table; followed by a Keyframe
+    Keyframe = 70,    // pushed: table, sequence, state
+    Delta = 71,       // pushed: table, sequence, delta against the state at sequence - 1
+    Error = 127       // text
+};
+
+/**
+ * @brief Public state of one seat as sent to clients.
+ */
+struct SeatState {
+    int16_t coins = 0;
+    bool alive = true;
+};
+
+/**
+ * @brief Public state of a table as sent to clients.
+ */
+struct TableState {
+    uint8_t status = 0;     ///< Table::Status as int (Lobby, Playing, Finished)
+    int16_t bank = 0;
+    int8_t turn = -1;       ///< Seat whose turn it is, -1 when nobody can act
+    std::vector<SeatState> seats;
+};
+
+/**
+ * @brief One changed seat in a StateDelta.
+ */
+struct SeatChange {
+    uint8_t seat = 0;
+    SeatState state;
+};
+
+/**
+ * @brief Difference between two public table states: the changed scalar fields (flagged in `fields`)
+ *        and the seats whose coins or alive flag changed.
+ */
+struct StateDelta {
+    static constexpr uint8_t STATUS = 1, BANK = 2, TURN = 4;
+    uint8_t fields = 0;     ///< Bitmask of STATUS, BANK, TURN
+    uint8_t status = 0;
+    int16_t bank = 0;
+    int8_t turn = -1;
+    std::vector<SeatChange> seats;
+
+    bool empty() const { return fields == 0 && seats.empty(); }
+};
+
+/**
+ * @brief Computes the delta that turns `before` into `after`.
+ * @param before Previous state.
+ * @param after Current state (same number of seats).
+ * @return The delta (empty when nothing changed).
+ * @throws std::invalid_argument if the seat counts differ.
+ */
+StateDelta diffState(const TableState& before, const TableState& after);
+
+/**
+ * @brief Applies a delta to a state in place.
+ * @param state State at the delta's previous sequence number.
+ * @param delta The delta.
+ * @throws ProtocolError if the delta names a seat the state does not have.
+ */
+void applyDelta(TableState& state, const StateDelta& delta);
+
+/**
+ * @brief A decoded protocol message. Only the fields used by `type` are meaningful.
+ */
+struct Message {
+    MsgType type = MsgType::Error;
+    uint32_t tag = 0;
+    uint32_t table = 0;
+    uint8_t count = 0;
+    uint8_t seat = 0;
+    Role role = Role::Unknown;
+    Action action;
+    std::string text;
+    TableState state;
+    uint32_t sequence = 0;  ///< Keyframe/Delta sequence number
+    StateDelta delta;
+};
+
+/**
+ * @brief Thrown when a frame is malformed.
+ */
+class ProtocolError : public std::runtime_error {
+public:
+    explicit ProtocolError(const std::string& what) : std::runtime_error(what) {}
+};
+
+constexpr size_t FRAME_HEADER_SIZE = 4;
+constexpr size_t MAX_FRAME_SIZE = 64 * 1024;
+
+/**
+ * @brief Appends one encoded frame for `msg` to `out`.
+ * @param msg The message.
+ * @param out Buffer to append to.
+ */
+void encodeMessage(const Message& msg, std::vector<uint8_t>& out);
+
+/**
+ * @brief Decodes one frame from the start of a buffer.
+ * @param data Buffer start.
+ * @param len Bytes available.
+ * @param msg Receives the message.
+ * @return Bytes consumed, or 0 if the buffer does not yet hold a complete frame.
+ * @throws ProtocolError if the frame is malformed or too large.
+ */
+size_t decodeMessage(const uint8_t* data, size_t len, Message& msg);
@@ -0,0 +1,127 @@
+// orel2744@gmail.com
+// Ratings.hpp defines a TrueSkill-style rating engine for free-for-all games between bots.
+// Each player's skill is a Gaussian (mu, sigma). A game's finishing order (winner first, then the seats in
+// reverse elimination order) updates every participant against every other with the Thurstone-Mosteller
+// full-pair approximation of Weng & Lin (JMLR 2011), which matches TrueSkill's factor-graph updates for
+// two players and needs no iterative message passing. Results can be streamed one game at a time; a
+// Leaderboard keeps players ordered by conservative skill (mu - 3 sigma) for O(log n) rank queries.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Leaderboard.hpp"
+#include "Simulation.hpp"
+
+/**
+ * @brief Prior and noise of the skill model (TrueSkill's defaults).
+ */
+struct RatingConfig {
+    double mu = 25.0;             ///< Prior mean
+    double sigma = 25.0 / 3;      ///< Prior standard deviation
+    double beta = 25.0 / 6;       ///< Performance noise per game
+    double tau = 25.0 / 300;      ///< Skill drift added before each game
+    double drawMargin = 0.5;      ///< Performance gap counted as a tie (games stopped by the action cap)
+};
+
+/**
+ * @brief A skill estimate.
+ */
+struct Rating {
+    double mu = 25.0;
+    double sigma = 25.0 / 3;
+
+    /**
+     * @brief Returns mu - 3 sigma, a skill the player exceeds with about 99.9% confidence.
+     */
+    double conservative() const { return mu - 3.0 * sigma; }
+};
+
+/**
+ * @brief Returns each seat's finishing rank (0 = best) in a game: the winner first, then seats in reverse
+ *        elimination order. Seats still in when the action cap hit tie for the best rank.
+ * @param result The game's outcome.
+ * @param seats Number of seats.
+ * @throws std::invalid_argument if the elimination order names a seat that does not exist.
+ */
+std::vector<int> finishingRanks(const GameResult& result, size_t seats);
+
+/**
+ * @class RatingEngine
+ * @brief Ratings of any number of players, updated from a stream of game results.
+ */
+class RatingEngine {
+public:
+    /**
+     * @brief Creates an engine with no players.
+     * @param config Prior and noise.
+     * @throws std::invalid_argument if a deviation is not positive or the draw margin is negative.
+     */
+    explicit RatingEngine(const RatingConfig& config = RatingConfig());
+
+    /**
+     * @brief Adds a player with the prior rating.
+     * @param name Display name.
+     * @return The player's id (ids are 0, 1, 2, ...).
+     */
+    int addPlayer(const std::string& name);
+
+    /**
+     * @brief Records a game from its finishing ranks.
+     * @param players Player id of each participant (at least 2, all different).
+     * @param ranks Rank of each participant (0 = best; equal ranks are ties).
+     * @throws std::invalid_argument if the sizes differ, fewer than 2 or repeated players take part, or a rank is negative.
+     * @throws std::out_of_range if a player id does not exist.
+     */
+    void record(const std::vector<int>& players, const std::vector<int>& ranks);
+
+    /**
+     * @brief Records a simulated game.
+     * @param seats Player id of each seat.
+     * @param result The game's outcome (see finishingRanks).
+     * @throws std::invalid_argument or std::out_of_range as record(players, ranks).
+     */
+    void record(const std::vector<int>& seats, const GameResult& result);
+
+    /**
+     * @brief Returns a player's rating.
+     * @param id Player id.
+     * @throws std::out_of_range if the player does not exist.
+     */
+    const Rating& rating(int id) const;
+
+    /**
+     * @brief Returns a player's name.
+     * @param id Player id.
+     * @throws std::out_of_range if the player does not exist.
+     */
+    const std::string& name(int id) const;
+
+    /**
+     * @brief Returns a player's rank by conservative skill (0 = best) in O(log n).
+     * @param id Player id.
+     * @throws std::out_of_range if the player does not exist.
+     */
+    size_t rankOf(int id) const { return board.rankOf(id); }
+
+    /**
+     * @brief Returns the player at a rank in O(log n).
+     * @param rank 0 for the best.
+     * @throws std::out_of_range if there is no such rank.
+     */
+    int atRank(size_t rank) const { return board.atRank(rank); }
+
+    const Leaderboard& leaderboard() const { return board; }
+    size_t playerCount() const { return ratings.size(); }
+    uint64_t gamesRecorded() const { return games; }
+
+private:
+    RatingConfig config;
+    std::vector<Rating> ratings;
+    std::vector<std::string> names;
+    Leaderboard board;
+    uint64_t games = 0;
+    std::vector<double> variance, meanStep, varianceShrink;  ///< Scratch space of record(), reused
+};
@@ -0,0 +1,149 @@
+// orel2744@gmail.com
+// Replay.hpp defines recording and viewing of complete games.
+// Replay stores the seating (names, roles) and the stream of attempted actions of one game;
+// ReplayViewer re-plays it with periodic keyframes so any step can be reached in O(keyframe interval).
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Action.hpp"
+#include "Game.hpp"
+#include "GameSnapshot.hpp"
+#include "Role.hpp"
+
+class Player;
+
+/**
+ * @class Replay
+ * @brief Recording of one game: who sat where, and every action that was attempted, in order.
+ *
+ * Actions that threw are recorded too: some rules mutate state before they throw,
+ * so re-applying exactly what was attempted reproduces the game exactly.
+ */
+class Replay {
+public:
+    /**
+     * @brief A seat of the recorded game.
+     */
+    struct Seat {
+        std::string name;
+        Role role;
+    };
+
+    /**
+     * @brief Adds the next seat of the recorded game.
+     * @param name Player name.
+     * @param role Player role.
+     */
+    void addSeat(const std::string& name, Role role);
+
+    /**
+     * @brief Appends an attempted action to the recording.
+     * @param action The action.
+     */
+    void record(const Action& action);
+
+    /**
+     * @brief Removes all seats and actions (for a new game).
+     */
+    void clear();
+
+    const std::vector<Seat>& getSeats() const { return seats; }
+    const std::vector<Action>& getActions() const { return actions; }
+
+    /**
+     * @brief Writes the recording in the line-based replay format.
+     * @param out Output stream.
+     */
+    void save(std::ostream& out) const;
+
+    /**
+     * @brief Reads a recording written by save().
+     * @param in Input stream.
+     * @return The loaded replay.
+     * @throws std::runtime_error if the input is not a valid replay.
+     */
+    static Replay load(std::istream& in);
+
+private:
+    std::vector<Seat> seats;
+    std::vector<Action> actions;
+};
+
+/**
+ * @class ReplayViewer
+ * @brief Plays a Replay back on its own Game with instant seeking.
+ *
+ * On construction the whole replay is run once with logging off and a full GameSnapshot is kept
+ * every `keyframeInterval` actions. seek() restores the closest keyframe at or before the target
+ * and re-applies at most `keyframeInterval - 1` actions, so jumping to step 900 costs the same as
+ * jumping to step 10. Moving forward by less than a keyframe interval just applies the actions.
+ */
+class ReplayViewer {
+public:
+    /**
+     * @brief Builds the viewer and its keyframes; the viewer starts at step 0.
+     * @param replay The recording to play (copied).
+     * @param keyframeInterval Actions between keyframes.
+     * @throws std::invalid_argument if the replay has fewer than 2 seats or the interval is zero.
+     */
+    explicit ReplayViewer(const Replay& replay, size_t keyframeInterval = 64);
+    ~ReplayViewer();
+    ReplayViewer(const ReplayViewer&) = delete;
+    ReplayViewer& operator=(const ReplayViewer&) = delete;
+
+    /**
+     * @brief Returns the number of recorded actions (the last valid position).
+     */
+    size_t length() const { return replay.getActions().size(); }
+
+    /**
+     * @brief Returns the number of actions applied so far.
+     */
+    size_t position() const { return pos; }
+
+    /**
+     * @brief Moves to the state after `step` actions (clamped to length()).
+     * @param step Target position.
+     */
+    void seek(size_t step);
+
+    /**
+     * @brief Applies the next action.
+     * @return False if already at the end.
+     */
+    bool step();
+
+    /**
+     * @brief Returns the last applied action, or nullptr at step 0.
+     */
+    const Action* lastAction() const;
+
+    /**
+     * @brief Returns the error message of the last applied action if it was rejected, else an empty string.
+     */
+    const std::string& lastError() const { return error; }
+
+    /**
+     * @brief Returns the number of keyframes kept.
+     */
+    size_t keyframeCount() const { return keyframes.size(); }
+
+    const Game& getGame() const { return game; }
+    const std::vector<Player*>& getPlayers() const { return game.getPlayers(); }
+    const Replay& getReplay() const { return replay; }
+
+private:
+    Replay replay;
+    size_t interval;
+    Game game;
+    std::vector<std::unique_ptr<Player>> owned;
+    std::vector<GameSnapshot> keyframes;  ///< keyframes[k] is the state after k * interval actions
+    size_t pos = 0;
+    std::string error;
+
+    void applyNext();
+};
@@ -35,4 +35,13 @@ inline std::string roleToString(Role role) {
     }
 }
 
+// utility function to parse a name produced by roleToString back into a Role.
+// returns Role::Unknown for names that do not match any role.
+inline Role roleFromString(const std::string& name) {
+    for (Role r : {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant}) {
+        if (roleToString(r) == name) return r;
+    }
+    return Role::Unknown;
+}
+
 #endif // ROLE_HPP
@@ -0,0 +1,93 @@
+// orel2744@gmail.com
+// RoleBeliefs.hpp defines a Bayesian tracker of the probability of each seat's hidden role.
+// Every observed action is a piece of evidence whose likelihood under each role comes from the rules
+// themselves: the action is replayed with the seat holding that role and the outcome compared with what
+// was seen (only a Baron can invest, an arrested Merchant pays 2 coins to the bank, ...).
+// Beliefs start from the deal's prior (each role 1/6, independently per seat) and update in place.
+
+#pragma once
+
+#include <array>
+#include <random>
+#include "Action.hpp"
+#include "LaneState.hpp"
+#include "Role.hpp"
+
+/**
+ * @class RoleBeliefs
+ * @brief Per-seat role distributions from one observer's (or a spectator's) point of view.
+ *
+ * An update replays the action once per role still possible for the actor, with the target holding its
+ * most likely role, then once per role still possible for the target, with the actor holding its most
+ * likely role: O(roles) replays per action. Likelihoods are 0 or 1, so an update only rules roles out and
+ * renormalises the rest. Under these rules an outcome depends on the actor's and the target's roles through
+ * separate checks, so the set of roles still possible for each seat is exact. The probabilities are not an
+ * exact posterior: seats are kept independent, and each pass holds the other seat at its most likely role
+ * instead of summing over its distribution.
+ * Observations with likelihood 0 under every role (not made under these rules) leave a seat unchanged.
+ */
+class RoleBeliefs {
+public:
+    static constexpr int ROLES = 6;
+    using Distribution = std::array<float, ROLES>;  ///< Probability per Role
+
+    /**
+     * @brief Starts from the deal: the observer's own role and eliminated seats' roles are certain,
+     *        every other seat holds each role with probability 1/6.
+     * @param state The game (roles of hidden seats are not read).
+     * @param observer The observing seat, or -1 for a spectator who sees no role until it is shown.
+     * @throws std::out_of_range if the observer seat does not exist.
+     */
+    RoleBeliefs(const LaneState& state, int observer);
+
+    /**
+     * @brief Updates the actor's and target's beliefs after an action was tried.
+     * @param before The game before the action (roles of hidden seats are not read).
+     * @param action The action.
+     * @param accepted Whether the rules accepted it.
+     * @param after The game after the action; eliminated seats' roles are read (their cards are shown).
+     */
+    void observe(const LaneState& before, const Action& action, bool accepted, const LaneState& after);
+
+    /**
+     * @brief Returns the probability that seat s holds a role.
+     * @param s Seat index.
+     * @param role The role.
+     */
+    double probability(int s, Role role) const { return beliefs[s][static_cast<int>(role)]; }
+
+    /**
+     * @brief Returns the role distribution of seat s.
+     * @param s Seat index.
+     */
+    const Distribution& distribution(int s) const { return beliefs[s]; }
+
+    /**
+     * @brief Returns the most likely role of seat s (lowest Role on ties).
+     * @param s Seat index.
+     */
+    Role mostLikely(int s) const;
+
+    /**
+     * @brief Returns the mask of roles seat s may hold (bit r set when Role r has probability above 0).
+     * @param s Seat index.
+     */
+    uint8_t support(int s) const;
+
+    /**
+     * @brief Returns a copy of the state with every uncertain role drawn from its distribution.
+     * @param state The game (roles of uncertain seats are overwritten).
+     * @param rng Random source.
+     */
+    LaneState sample(const LaneState& state, std::mt19937_64& rng) const;
+
+private:
+    Distribution beliefs[LaneState::MAX_SEATS] = {};
+    int seats;
+
+    /**
+     * @brief Multiplies seat s's distribution by the likelihood of each role and renormalises.
+     */
+    template <class Likelihood>
+    void update(int s, Likelihood&& likelihood);
+};
@@ -0,0 +1,75 @@
+// orel2744@gmail.com
+// RoleConstraints.hpp defines what one seat can rule out about the other seats' hidden roles.
+// Every observed action is replayed under each role the actor and target could still hold; roles under
+// which the rules would not have produced the observed outcome (a blockTax only a Governor can make,
+// a Governor's third tax coin, a General's arrest refund, a Merchant's bonus, ...) are eliminated.
+// Determinisations for search draw the remaining roles independently, as the deal does.
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include "Action.hpp"
+#include "LaneState.hpp"
+#include "Role.hpp"
+
+/**
+ * @class RoleConstraints
+ * @brief Per-seat sets of roles consistent with one observer's observations.
+ */
+class RoleConstraints {
+public:
+    static constexpr uint8_t ALL_ROLES = 0x3F;  ///< Bit r set: Role r is still possible
+
+    /**
+     * @brief Starts from the observer's knowledge at the deal: its own role and eliminated seats' roles.
+     * @param state The game (roles of other live seats are not read).
+     * @param observer The observing seat.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    RoleConstraints(const LaneState& state, int observer);
+
+    /**
+     * @brief Narrows the actor's and target's roles after an action was tried.
+     * @param before The game before the action (roles of hidden seats are not read).
+     * @param action The action.
+     * @param accepted Whether the rules accepted it.
+     * @param after The game after the action; eliminated seats' roles are read (their cards are shown).
+     */
+    void observe(const LaneState& before, const Action& action, bool accepted, const LaneState& after);
+
+    /**
+     * @brief Returns the mask of roles seat s may hold (bit r for Role r).
+     * @param s Seat index.
+     */
+    uint8_t allowed(int s) const { return masks[s]; }
+
+    /**
+     * @brief Returns the role of seat s if only one remains, otherwise Role::Unknown.
+     * @param s Seat index.
+     */
+    Role known(int s) const;
+
+    /**
+     * @brief Returns the observing seat.
+     */
+    int observer() const { return seat; }
+
+    /**
+     * @brief Returns a copy of the state with every hidden role drawn uniformly from its allowed set.
+     * @param state The game (roles of hidden seats are overwritten).
+     * @param rng Random source.
+     */
+    LaneState determinise(const LaneState& state, std::mt19937_64& rng) const;
+
+    /**
+     * @brief Returns a copy of the state with roles the observer does not know set to Role::Unknown,
+     *        so that states the observer cannot tell apart compare (and hash) equal.
+     * @param state The game.
+     */
+    LaneState hide(const LaneState& state) const;
+
+private:
+    uint8_t masks[LaneState::MAX_SEATS] = {};
+    int seat;
+};
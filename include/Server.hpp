@@ -0,0 +1,104 @@
+// orel2744@gmail.com
+// Server.hpp defines coup_server: an epoll-based host for many concurrent game tables (Linux only).
+// Each reactor thread runs its own epoll loop and owns the tables whose id maps to it (id % threads);
+// requests for a table owned by another reactor are handed over through that reactor's inbox.
+// Spectators of a table get every state change pushed as a delta (with periodic keyframes); each
+// pushed frame is encoded once and shared by all of its recipients.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Listening endpoints and threading of a Server.
+ */
+struct ServerConfig {
+    std::string tcpHost = "127.0.0.1";
+    int tcpPort = -1;          ///< -1 disables TCP, 0 picks a free port
+    std::string unixPath;      ///< Empty disables the Unix-domain socket
+    int threads = 1;           ///< Number of reactor threads
+    uint32_t keyframeInterval = 32;          ///< Every Nth pushed update is a full Keyframe instead of a Delta
+    size_t maxQueuedBytes = 1024 * 1024;     ///< Connections with more unsent output are dropped
+};
+
+/**
+ * @class Server
+ * @brief Multi-table game server speaking the binary protocol of Protocol.hpp.
+ *
+ * One reactor thread can serve thousands of tables: every table is a Table state machine touched
+ * only by its owning reactor, so no locks are taken on the game path. Connections are accepted by
+ * whichever reactor wins the (EPOLLEXCLUSIVE) wakeup and may talk to tables on any reactor.
+ */
+class Server {
+public:
+    /**
+     * @brief Opens the listening sockets.
+     * @param config Endpoints and thread count.
+     * @throws std::runtime_error if a socket cannot be created or bound.
+     */
+    explicit Server(const ServerConfig& config);
+
+    /**
+     * @brief Stops the reactors and closes all sockets.
+     */
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * @brief Starts the reactor threads. Returns immediately.
+     */
+    void start();
+
+    /**
+     * @brief Signals the reactors to stop and waits for them.
+     */
+    void stop();
+
+    /**
+     * @brief Returns the bound TCP port (useful when configured with port 0), or -1 if TCP is disabled.
+     */
+    int tcpPort() const { return boundPort; }
+
+    /**
+     * @brief Returns the number of open tables across all reactors.
+     */
+    size_t tableCount() const { return tables.load(); }
+
+    /**
+     * @brief Returns the number of open client connections across all reactors.
+     */
+    size_t connectionCount() const { return connections.load(); }
+
+    /**
+     * @brief Returns how many push frames (deltas and keyframes) have been encoded for spectators.
+     */
+    size_t pushedFrames() const { return framesEncoded.load(); }
+
+    /**
+     * @brief Returns how many push frames have been queued to spectator connections (one per recipient).
+     */
+    size_t pushedDeliveries() const { return framesDelivered.load(); }
+
+private:
+    struct Reactor;
+    friend struct Reactor;
+
+    ServerConfig config;
+    int tcpFd = -1;
+    int unixFd = -1;
+    int boundPort = -1;
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    std::atomic<uint32_t> nextTableId{1};
+    std::atomic<uint64_t> nextConnectionId{16};
+    std::atomic<size_t> tables{0};
+    std::atomic<size_t> connections{0};
+    std::atomic<size_t> framesEncoded{0};
+    std::atomic<size_t> framesDelivered{0};
+    bool started = false;
+};
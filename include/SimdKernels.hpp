@@ -0,0 +1,74 @@
+// orel2744@gmail.com
+// SimdKernels.hpp defines data-parallel kernels over VecGame's per-seat columns:
+// legality masks for the seat to act (coins/bank thresholds, sanctions, pending actions, roles)
+// and coin/bank transfers. Each kernel has scalar, SSE2 and AVX2 versions; the widest one the
+// CPU supports is picked at runtime, so the build needs no -mavx2 flag.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// enum listing the kernel implementations, narrowest first.
+enum class SimdLevel : uint8_t { Scalar, SSE2, AVX2 };
+
+/**
+ * @brief Read-only columns of one seat across n lanes (see VecGame), plus per-lane bank and turn.
+ */
+struct SeatColumns {
+    const int16_t* coins = nullptr;
+    const int16_t* bank = nullptr;
+    const int8_t* turn = nullptr;
+    const int8_t* sanction = nullptr;  ///< -1 when not sanctioned
+    const uint8_t* alive = nullptr;
+    const uint8_t* extra = nullptr;
+    const uint8_t* pending = nullptr;
+    const uint8_t* role = nullptr;
+};
+
+/**
+ * @brief Returns the widest implementation this CPU supports.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @brief Returns the implementation the kernels currently use (detectSimdLevel() by default).
+ */
+SimdLevel activeSimdLevel();
+
+/**
+ * @brief Selects the kernel implementation (for benchmarks and tests); not thread-safe.
+ * @param level Requested level; clamped to what the CPU supports.
+ * @return The level actually selected.
+ */
+SimdLevel setSimdLevel(SimdLevel level);
+
+/**
+ * @brief Returns "scalar", "sse2" or "avx2".
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief For every lane where it is `seat`'s turn, writes that seat's action mask; other lanes are left untouched.
+ *
+ * Bit `1 << ActionType` is set when the actor-side preconditions of Player hold: for Gather, Tax,
+ * Bribe, Invest and SkipTurn that is exactly whether the action would be accepted; for targeted
+ * actions the target's own conditions (alive, not self, Spy blocks, ...) must still be checked.
+ * GeneralBlockCoup is never set (no coup is ever left to block).
+ * @param c Columns of `seat`.
+ * @param seat The seat.
+ * @param out One mask per lane.
+ * @param n Number of lanes.
+ */
+void seatActionMasks(const SeatColumns& c, int seat, uint16_t* out, size_t n);
+
+/**
+ * @brief For every lane where it is `seat`'s turn, moves amount[i] coins from the lane's bank to the seat.
+ * @param coins Coins column of `seat`.
+ * @param bank Bank of every lane.
+ * @param turn Seat to act in every lane.
+ * @param seat The seat.
+ * @param amount Coins per lane (negative pays into the bank).
+ * @param n Number of lanes.
+ */
+void payFromBank(int16_t* coins, int16_t* bank, const int8_t* turn, int seat, const int16_t* amount, size_t n);
@@ -0,0 +1,46 @@
+// orel2744@gmail.com
+// Simulation.hpp defines headless play of complete games for batch experiments.
+// playGame() seats the given roles in a fresh Game, lets a simple randomised policy act for every
+// seat through applyAction(), and reports who won and in what order players were eliminated.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Action.hpp"
+#include "Role.hpp"
+
+class Game;
+
+/**
+ * @brief Outcome of one simulated game.
+ */
+struct GameResult {
+    int winner = -1;                  ///< Winning seat, or -1 if the action cap was hit
+    Role winnerRole = Role::Unknown;
+    size_t actions = 0;               ///< Actions attempted (including rejected ones)
+    std::vector<int> eliminationOrder; ///< Seats out at the end, in elimination order (Game::getEliminationOrder)
+};
+
+/**
+ * @brief Picks an action for the player whose turn it is, using a simple randomised heuristic
+ *        (must coup at 10+, often coup at 7+, Barons invest, otherwise tax/gather/arrest/sanction).
+ *        It reads only the acting seat's Game::viewFor() observation.
+ * @param game The game (must have a current player).
+ * @param rng Random source.
+ * @return The chosen action; it may still be rejected by the rules.
+ */
+Action chooseSimpleAction(const Game& game, std::mt19937_64& rng);
+
+/**
+ * @brief Plays one game to completion (or to the action cap) with chooseSimpleAction for every seat.
+ *        Rejected actions fall back to gather, then skipTurn. Logging is off.
+ * @param roles Role of each seat, in seat order (at least 2).
+ * @param seed Seed of the policy's random source.
+ * @param maxActions Cap on attempted actions.
+ * @return The game's outcome.
+ * @throws std::invalid_argument if fewer than 2 roles are given.
+ */
+GameResult playGame(const std::vector<Role>& roles, uint64_t seed, size_t maxActions = 1000);
@@ -0,0 +1,178 @@
+// orel2744@gmail.com
+// Solver.hpp defines an exact solver for 2-player games with known roles.
+// It enumerates every state reachable from the deal by copying and advancing LaneStates (whose rules
+// are differential-tested against Game), memoises them in a concurrent hash table, and labels each one
+// win / loss / draw by retrograde analysis, using all cores for both the enumeration and the labelling frontier.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Action.hpp"
+#include "LaneState.hpp"
+#include "Role.hpp"
+
+/**
+ * @brief Size limits and parallelism of a solve.
+ */
+struct SolverConfig {
+    int16_t bank = 14;       ///< Coins in the bank at the deal (a coup needs 7 coins and 7 in the bank)
+    int16_t coinCap = 16;    ///< States where a seat or the bank holds more are left unexpanded (at most 120)
+    unsigned threads = 0;    ///< Worker threads (0 = one per core)
+};
+
+/**
+ * @brief Solved value of one state.
+ */
+struct SolvedValue {
+    int winner = -1;   ///< Seat that wins with optimal play, or -1 if neither can force a win
+    int plies = 0;     ///< Decisions until the game ends with optimal play (fastest win, slowest loss)
+    bool exact = true; ///< False if the value depends on states beyond the coin cap (winner is then -1)
+};
+
+/**
+ * @class TwoPlayerSolver
+ * @brief Solves one 2-player game (seat 0 acts first) with the roles known to both players.
+ *
+ * A decision is either the seat to act choosing any action the rules accept, or, right after it,
+ * the opponent's reaction window: an action without a turn check (spyOn, preventCoup, judgeBribe,
+ * blockTax) or passing. The window is skipped when the opponent has no accepted reaction, and a
+ * reaction never opens another window. Actions the rules reject are not moves, even where the
+ * rules change the state before rejecting them.
+ *
+ * States are exact up to `coinCap`: a state beyond it is kept as an unexpanded leaf, counted in
+ * cappedStates(), and never resolved. A value whose outcome hinges on such leaves has winner -1 and
+ * `exact` false; every forced win is exact, and so is a draw (winner -1, `exact` true): a game either
+ * player can keep going forever, whatever happens beyond the cap. With cappedStates() == 0 every value is exact.
+ */
+class TwoPlayerSolver {
+public:
+    /**
+     * @brief Prepares a solve.
+     * @param first Role of seat 0.
+     * @param second Role of seat 1.
+     * @param config Bank, coin cap and threads.
+     * @throws std::invalid_argument if a role is Unknown, the bank is negative or above the cap, or the cap is above 120.
+     */
+    TwoPlayerSolver(Role first, Role second, const SolverConfig& config = SolverConfig());
+    ~TwoPlayerSolver();
+
+    TwoPlayerSolver(const TwoPlayerSolver&) = delete;
+    TwoPlayerSolver& operator=(const TwoPlayerSolver&) = delete;
+
+    /**
+     * @brief Enumerates and labels every state reachable from the deal (once; later calls do nothing).
+     */
+    void solve();
+
+    /**
+     * @brief Enumerates and labels every state reachable from the given states instead of the deal
+     *        (once; later calls do nothing), e.g. every coin split of an endgame.
+     * @param roots 2-seat states with this pairing's roles, the seat to act about to decide.
+     * @throws std::invalid_argument if a root has other roles or seats, or a field beyond the coin cap.
+     */
+    void solve(const std::vector<LaneState>& roots);
+
+    /**
+     * @brief Returns the dealt starting state.
+     */
+    const LaneState& start() const { return root; }
+
+    /**
+     * @brief Returns the value of a state.
+     * @param state A state reached by the solve.
+     * @param reacting True for the opponent's reaction window before the seat to act continues.
+     * @throws std::logic_error if solve() has not run.
+     * @throws std::out_of_range if the state was not reached.
+     */
+    SolvedValue value(const LaneState& state, bool reacting = false) const;
+
+    /**
+     * @brief Finds an optimal decision in a state.
+     * @param state A non-final state reached by the solve.
+     * @param reacting True for the opponent's reaction window.
+     * @param out Receives the action.
+     * @return False if the best decision is to pass the reaction window (out is untouched).
+     * @throws std::logic_error if solve() has not run or the game is over.
+     * @throws std::out_of_range if the state was not reached.
+     */
+    bool bestMove(const LaneState& state, bool reacting, Action& out) const;
+
+    /**
+     * @brief Calls f(state, reacting, value) for every solved state (capped leaves included), in no particular order.
+     * @param f The callback.
+     * @throws std::logic_error if solve() has not run.
+     */
+    void forEachState(const std::function<void(const LaneState&, bool, const SolvedValue&)>& f) const;
+
+    /**
+     * @brief Returns true if, after a move by the seat to act that led to `state`, the opponent gets a
+     *        reaction window (value(state, true)) before the seat to act continues.
+     * @param state A state of this pairing.
+     */
+    bool reactionWindow(const LaneState& state) const;
+
+    /**
+     * @brief Returns the number of decision states (final states included).
+     */
+    uint64_t stateCount() const;
+
+    /**
+     * @brief Returns the number of states left unexpanded by the coin cap.
+     */
+    uint64_t cappedStates() const;
+
+    /**
+     * @brief Returns the wall time of solve() in seconds.
+     */
+    double seconds() const;
+
+    /**
+     * @brief Returns states solved per second of wall time.
+     */
+    double statesPerSecond() const;
+
+    /**
+     * @brief Returns the peak bytes held by the hash table, the move graph and the labels during solve().
+     */
+    size_t memoryBytes() const;
+
+private:
+    struct Impl;
+    LaneState root;
+    SolverConfig config;
+    std::unique_ptr<Impl> impl;
+};
+
+/**
+ * @brief Solved outcome of one role pairing.
+ */
+struct PairingResult {
+    Role first = Role::Unknown;    ///< Role of seat 0 (acts first)
+    Role second = Role::Unknown;   ///< Role of seat 1
+    SolvedValue start;             ///< Value of the deal
+    uint64_t states = 0;
+    uint64_t capped = 0;
+    double seconds = 0.0;
+    size_t bytes = 0;
+};
+
+/**
+ * @brief Solves every ordered pairing of the 6 roles (36 games).
+ * @param config Bank, coin cap and threads.
+ * @return One result per pairing, first role major.
+ */
+std::vector<PairingResult> solveRolePairings(const SolverConfig& config = SolverConfig());
+
+/**
+ * @brief Returns how often role a wins against role b with optimal play, averaged over who acts first
+ *        (a draw, or a start whose value is not exact, counts as half a win).
+ * @param results Output of solveRolePairings().
+ * @param a A role.
+ * @param b A role.
+ * @throws std::invalid_argument if a pairing is missing.
+ */
+double pairingWinProbability(const std::vector<PairingResult>& results, Role a, Role b);
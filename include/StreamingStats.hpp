@@ -0,0 +1,232 @@
+// orel2744@gmail.com
+// StreamingStats.hpp defines constant-memory, mergeable aggregates for long simulations.
+// RunningMoments (Welford), QuantileSketch (log-bucketed, relative error) and CountMinSketch each fold in
+// one value at a time and merge with another of their kind, so every thread keeps its own and the totals
+// are combined at the end or periodically. GameStats bundles them for games played on LaneState, and
+// StatsHub hands finished accumulators from workers to a reader without locks. studentTQuantile gives the
+// critical values for confidence intervals and t-tests on the means.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Action.hpp"
+#include "LaneState.hpp"
+#include "Role.hpp"
+
+/**
+ * @class RunningMoments
+ * @brief Count, mean, variance, minimum and maximum of a stream (Welford; merged with Chan et al.).
+ */
+class RunningMoments {
+public:
+    void add(double value);
+    void merge(const RunningMoments& other);
+
+    uint64_t count() const { return n; }
+    double mean() const { return n ? average : 0.0; }
+
+    /**
+     * @brief Returns the sample variance (0 with fewer than 2 values).
+     */
+    double variance() const { return n > 1 ? m2 / static_cast<double>(n - 1) : 0.0; }
+    double stddev() const;
+    double min() const { return n ? lowest : 0.0; }
+    double max() const { return n ? highest : 0.0; }
+
+private:
+    uint64_t n = 0;
+    double average = 0.0;
+    double m2 = 0.0;  ///< Sum of squared deviations from the mean
+    double lowest = 0.0, highest = 0.0;
+};
+
+/**
+ * @brief Returns the Student t quantile t(p, df): exact (to 4 decimals, from a table) for df <= 30, and a
+ *        Cornish-Fisher expansion around the normal quantile above that, where it is within 1e-3.
+ *        Fractional df (Welch-Satterthwaite) interpolate linearly in 1/df between table rows.
+ * @param p Probability; one of 0.95, 0.975, 0.99 or 0.995.
+ * @param df Degrees of freedom, at least 1.
+ * @throws std::invalid_argument if p is not one of the tabulated probabilities or df < 1.
+ */
+double studentTQuantile(double p, double df);
+
+/**
+ * @class QuantileSketch
+ * @brief Quantiles of non-negative values within a relative error, in a fixed array of log-spaced buckets.
+ *
+ * A value x > 0 lands in bucket ceil(log_gamma x) with gamma = (1 + a) / (1 - a), so any quantile is
+ * returned within a relative error a (DDSketch). Buckets cover about 6e-3 to 8e8 at a = 1%; smaller values
+ * count in the lowest bucket and larger ones in the highest. Merging adds the bucket counts.
+ */
+class QuantileSketch {
+public:
+    static constexpr int BUCKETS = 1280;
+
+    /**
+     * @brief Creates an empty sketch.
+     * @param relativeAccuracy Relative error a of quantiles, in (0, 0.5).
+     * @throws std::invalid_argument if the accuracy is out of range.
+     */
+    explicit QuantileSketch(double relativeAccuracy = 0.01);
+
+    /**
+     * @brief Adds a value (negative values count as 0).
+     * @param value The value.
+     * @param count How many times.
+     */
+    void add(double value, uint64_t count = 1);
+
+    /**
+     * @brief Adds another sketch's values.
+     * @throws std::invalid_argument if the sketches have different accuracies.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Returns the q-quantile (0 = minimum, 1 = maximum), or 0 if empty.
+     * @param q Quantile in [0, 1].
+     */
+    double quantile(double q) const;
+
+    uint64_t count() const { return total; }
+    double accuracy() const { return relativeAccuracy; }
+
+private:
+    double relativeAccuracy;
+    double gamma;
+    double logGamma;
+    uint64_t zeros = 0;
+    uint64_t total = 0;
+    std::array<uint64_t, BUCKETS> buckets = {};
+};
+
+/**
+ * @class CountMinSketch
+ * @brief Approximate counts of many keys in DEPTH rows of WIDTH counters: never under the true count, and
+ *        over it by at most e / WIDTH of the total with probability 1 - e^-DEPTH.
+ */
+class CountMinSketch {
+public:
+    static constexpr int WIDTH = 2048;
+    static constexpr int DEPTH = 4;
+
+    void add(uint64_t key, uint64_t count = 1);
+    void merge(const CountMinSketch& other);
+
+    /**
+     * @brief Returns the estimated count of a key (the smallest of its counters).
+     * @param key The key.
+     */
+    uint64_t estimate(uint64_t key) const;
+
+    uint64_t total() const { return added; }
+
+private:
+    std::array<uint64_t, WIDTH * DEPTH> counters = {};
+    uint64_t added = 0;
+};
+
+/**
+ * @class GameStats
+ * @brief Aggregates of many games: length, win rate and action frequency per Role, coins held when
+ *        eliminated, and counts of three-action sequences. Memory does not grow with the number of games.
+ */
+class GameStats {
+public:
+    static constexpr int ROLES = 6;
+
+    /**
+     * @brief Records an action tried in the current game.
+     * @param before The game before the action.
+     * @param action The action.
+     * @param accepted Whether the rules accepted it (only accepted actions are counted).
+     * @param after The game after the action.
+     */
+    void observe(const LaneState& before, const Action& action, bool accepted, const LaneState& after);
+
+    /**
+     * @brief Closes the current game.
+     * @param final The game at its end (the winner, if any, is the one seat alive).
+     * @param actions Actions attempted in the game.
+     */
+    void endGame(const LaneState& final, size_t actions);
+
+    /**
+     * @brief Adds another accumulator's games (its current game, if unfinished, is ignored).
+     */
+    void merge(const GameStats& other);
+
+    uint64_t games() const { return length.count(); }
+    const RunningMoments& gameLength() const { return length; }
+    const QuantileSketch& gameLengthQuantiles() const { return lengthSketch; }
+    const RunningMoments& coinsAtElimination() const { return coins; }
+    const QuantileSketch& coinsAtEliminationQuantiles() const { return coinsSketch; }
+
+    /**
+     * @brief Returns the share of seats dealt a role that won, or 0 if the role was never dealt.
+     * @param role The role.
+     */
+    double winRate(Role role) const;
+
+    uint64_t seatsDealt(Role role) const { return dealt[static_cast<int>(role)]; }
+
+    /**
+     * @brief Returns how often players of a role had an action type accepted.
+     */
+    uint64_t actionCount(Role role, ActionType type) const { return actions[static_cast<int>(role)][static_cast<int>(type)]; }
+
+    /**
+     * @brief Returns the estimated count of three consecutive accepted actions in a game.
+     * @param roles Role of each actor, in order.
+     * @param types Each action's type, in order.
+     */
+    uint64_t sequenceCount(const std::array<Role, 3>& roles, const std::array<ActionType, 3>& types) const;
+
+private:
+    RunningMoments length, coins;
+    QuantileSketch lengthSketch, coinsSketch;
+    uint64_t dealt[ROLES] = {};
+    uint64_t wins[ROLES] = {};
+    uint64_t actions[ROLES][ACTION_TYPE_COUNT] = {};
+    CountMinSketch sequences;
+    int recent[2] = {-1, -1};  ///< The current game's last two (role, type) codes, oldest first
+};
+
+/**
+ * @class StatsHub
+ * @brief Lock-free hand-off of GameStats from worker threads to a reader.
+ *
+ * Workers publish() full accumulators (a push onto a lock-free stack) and carry on with fresh ones; the
+ * reader drain()s the whole stack with one atomic exchange and merges it into its totals, whenever it likes.
+ */
+class StatsHub {
+public:
+    StatsHub() = default;
+    ~StatsHub();
+    StatsHub(const StatsHub&) = delete;
+    StatsHub& operator=(const StatsHub&) = delete;
+
+    /**
+     * @brief Hands an accumulator over (safe from any thread).
+     * @param stats The accumulator; ignored if null.
+     */
+    void publish(std::unique_ptr<GameStats> stats);
+
+    /**
+     * @brief Merges every accumulator published so far into `into` and frees them.
+     * @param into The totals.
+     * @return How many accumulators were merged.
+     */
+    size_t drain(GameStats& into);
+
+private:
+    struct Node {
+        std::unique_ptr<GameStats> stats;
+        Node* next = nullptr;
+    };
+    std::atomic<Node*> head{nullptr};
+};
@@ -0,0 +1,110 @@
+// orel2744@gmail.com
+// Table.hpp defines a hosted game table: one Game, its players, and the seat owners.
+// A Table is a small state machine (Lobby -> Playing -> Finished) driven by join and act requests,
+// independent of how requests arrive (used by coup_server).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Action.hpp"
+#include "Game.hpp"
+#include "Protocol.hpp"
+#include "Role.hpp"
+
+class Player;
+
+/**
+ * @class Table
+ * @brief A game hosted for remote clients.
+ *
+ * Seats are dealt when the table is created. In the Lobby state clients claim seats;
+ * once every seat is claimed the table is Playing and each owner may act for its own seats.
+ * A seat whose owner leaves during play forfeits. When one player remains the table is Finished.
+ */
+class Table {
+public:
+    /**
+     * @brief Lifecycle states of a table.
+     */
+    enum class Status : uint8_t { Lobby, Playing, Finished };
+
+    /**
+     * @brief Creates a table with one seat per role; seats are named "Seat 1", "Seat 2", ...
+     * @param id Table id.
+     * @param roles Role of each seat (2 to 6 seats).
+     * @throws std::invalid_argument if the number of seats is out of range.
+     */
+    Table(uint32_t id, const std::vector<Role>& roles);
+    ~Table();
+    Table(const Table&) = delete;
+    Table& operator=(const Table&) = delete;
+
+    uint32_t getId() const { return id; }
+    Status getStatus() const { return status; }
+    size_t seatCount() const { return players.size(); }
+
+    /**
+     * @brief Claims a seat for an owner. Starts the game when the last seat is claimed.
+     * @param seat The seat to claim.
+     * @param owner Opaque id of the claiming client (non-zero).
+     * @return The role of the claimed seat (only revealed to its owner).
+     * @throws std::logic_error if the table is not in the lobby or the seat is taken.
+     * @throws std::out_of_range if the seat does not exist.
+     */
+    Role join(int seat, uint64_t owner);
+
+    /**
+     * @brief Applies an action on behalf of an owner.
+     * @param action The action; its actor must be a seat the owner holds.
+     * @param owner Opaque id of the acting client.
+     * @throws std::logic_error if the table is not playing, the owner does not hold the actor's seat,
+     *         or the rules reject the action.
+     */
+    void act(const Action& action, uint64_t owner);
+
+    /**
+     * @brief Releases every seat held by an owner (client disconnected). In the lobby the seats can be
+     *        claimed again; while playing they forfeit, so the game never waits on a seat nobody holds.
+     * @param owner Opaque id of the client.
+     * @return True if a seat forfeited (the public state changed and should be published).
+     */
+    bool release(uint64_t owner);
+
+    /**
+     * @brief Returns the public state of the table.
+     */
+    TableState state() const;
+
+    /**
+     * @brief Diffs the public state against the last published one and, if anything changed,
+     *        advances the sequence number. Called after every join/act so spectators can be sent deltas.
+     * @return The delta since the previous publish (empty if nothing changed).
+     */
+    StateDelta publish();
+
+    /**
+     * @brief Returns the sequence number of the last published state (0 at creation).
+     */
+    uint32_t getSequence() const { return sequence; }
+
+    /**
+     * @brief Returns the state as of the last publish(), i.e. the state at getSequence().
+     */
+    const TableState& getPublished() const { return published; }
+
+    const Game& getGame() const { return game; }
+
+private:
+    int aliveCount() const;
+
+    uint32_t id;
+    Status status = Status::Lobby;
+    Game game;
+    std::vector<std::unique_ptr<Player>> players;
+    std::vector<uint64_t> owners;   ///< Owner of each seat, 0 when unclaimed
+    size_t claimed = 0;
+    TableState published;           ///< State as of the last publish()
+    uint32_t sequence = 0;
+};
@@ -0,0 +1,102 @@
+// orel2744@gmail.com
+// Tablebase.hpp defines 2-player endgame tablebases: for every role pairing, the solved value of every
+// position that can follow a table shrinking to two players with up to `coinCap` coins per seat and in
+// the bank. generate() solves them by retrograde analysis (TwoPlayerSolver) and writes one file;
+// a Tablebase memory-maps that file and answers probes with a direct cell index and a short search.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LaneState.hpp"
+#include "Role.hpp"
+#include "Solver.hpp"
+
+/**
+ * @brief What to generate.
+ */
+struct TablebaseConfig {
+    int16_t coinCap = 8;      ///< Largest coin count of a seat or the bank covered (at most 120)
+    unsigned threads = 0;     ///< Solver threads (0 = one per core)
+    std::vector<Role> roles;  ///< Every ordered pairing of these roles is solved (empty = all 6)
+};
+
+/**
+ * @class Tablebase
+ * @brief A read-only, memory-mapped endgame tablebase.
+ *
+ * File layout (little-endian, sections 8-byte aligned): a header with the magic "COUPTB1", the version,
+ * the coin cap and 36 directory entries, one per ordered role pairing (first role major; pairings not
+ * generated hold no positions), then per generated pairing:
+ * - cells: uint32 start offsets, one per (reacting, turn, bank, coins of seat 0, coins of seat 1) plus one;
+ * - keys: uint32 per position, the remaining fields (16 bits per seat), sorted within each cell;
+ * - values: uint16 per position, the winner + 1 in the top 2 bits (0: a draw) and the plies
+ *   to the end in the low 14 bits (saturated).
+ * Positions whose value depends on play beyond the coin cap are not stored (see SolvedValue::exact), so a
+ * stored 0 is a real draw. A probe indexes its cell directly and binary-searches the few positions that share it.
+ */
+class Tablebase {
+public:
+    /**
+     * @brief Solves every role pairing from every 2-player position with cleared flags and writes the file.
+     * @param path Output file.
+     * @param config Coin cap and threads.
+     * @return Number of positions written.
+     * @throws std::invalid_argument if the coin cap is out of range or a role is Unknown.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static uint64_t generate(const std::string& path, const TablebaseConfig& config = TablebaseConfig());
+
+    /**
+     * @brief Maps a tablebase file.
+     * @param path File written by generate().
+     * @throws std::runtime_error if the file cannot be read or is not a valid tablebase: a wrong header, a
+     *         section that overlaps another or runs past the end of the file, or cell offsets that do not
+     *         rise from 0 to the pairing's position count.
+     */
+    explicit Tablebase(const std::string& path);
+    ~Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    /**
+     * @brief Looks up a 2-seat position.
+     * @param state The position (see endgameOf() for larger tables).
+     * @param reacting True for the opponent's reaction window (see TwoPlayerSolver).
+     * @param out Receives the value if found.
+     * @return False if the position is not covered (beyond the coin cap, not reachable from a covered start,
+     *         or its value depends on play beyond the cap).
+     */
+    bool probe(const LaneState& state, bool reacting, SolvedValue& out) const;
+
+    /**
+     * @brief Converts a position with exactly two players alive to a 2-seat position (seats in table order,
+     *        seat references remapped, references to eliminated seats cleared).
+     * @param state The position.
+     * @throws std::invalid_argument if not exactly two players are alive.
+     */
+    static LaneState endgameOf(const LaneState& state);
+
+    int coinCap() const { return cap; }
+
+    /**
+     * @brief Returns the number of positions stored.
+     */
+    uint64_t positions() const;
+
+    /**
+     * @brief Returns the size of the mapped file in bytes.
+     */
+    size_t sizeBytes() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    int cap = 0;
+
+    void release();
+};
@@ -0,0 +1,62 @@
+// orel2744@gmail.com
+// ThreadPool.hpp defines a fixed set of worker threads that run queued tasks in submission order.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Workers that take tasks from one shared queue until the pool is destroyed.
+ *
+ * A task that throws does not stop its worker; the first exception is kept and rethrown by wait().
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threads Worker count (0 = one per core).
+     */
+    explicit ThreadPool(unsigned threads = 0);
+
+    /**
+     * @brief Finishes the queued tasks, then joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task.
+     * @param task The task.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     * @throws The first exception a task threw since the last wait().
+     */
+    void wait();
+
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex mutex;
+    std::condition_variable ready;  ///< Signalled when a task is queued or the pool stops
+    std::condition_variable idle;   ///< Signalled when the last running task finishes
+    size_t running = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+
+    void work();
+};
@@ -0,0 +1,126 @@
+// orel2744@gmail.com
+// Tournament.hpp defines tournaments between heuristic bots at tables of 2 to 6 seats.
+// TournamentScheduler deals each round's tables (round-robin, Swiss or random) and seats every table so
+// that each entrant spreads its games over the seat positions: seat 0 acts first, which matters. A
+// Tournament plays the tables on a ThreadPool and streams each finished game to a callback.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include "HeuristicBot.hpp"
+#include "Simulation.hpp"
+
+enum class TournamentFormat : uint8_t {
+    RoundRobin,  ///< Circle method: with 2 seats everyone meets everyone once; larger tables cut the same order
+    Swiss,       ///< Entrants sorted by points each round (O(n log n)), neighbours share tables
+    Random       ///< A fresh shuffle each round
+};
+
+/**
+ * @brief Format and size of a tournament.
+ */
+struct TournamentConfig {
+    TournamentFormat format = TournamentFormat::Swiss;
+    int tableSize = 4;         ///< Seats per table (2 to 6); when entrants do not divide evenly the last table is smaller
+    size_t rounds = 5;         ///< Rounds of Swiss and Random (round-robin always plays its full cycle)
+    size_t gamesPerTable = 1;  ///< Games each table plays, rotating the seats by one between games
+    size_t maxActions = 1000;  ///< Cap on attempted actions per game
+    unsigned threads = 0;      ///< Worker threads (0 = one per core)
+    uint64_t seed = 1;
+};
+
+/**
+ * @class TournamentScheduler
+ * @brief Deals rounds of tables for K entrants; every pass over the entrants is O(n), Swiss adds one sort.
+ */
+class TournamentScheduler {
+public:
+    /**
+     * @brief Prepares a tournament.
+     * @param entrants Number of entrants (at least 2).
+     * @param config Format and table size.
+     * @throws std::invalid_argument if there are fewer than 2 entrants or the table size is out of range.
+     */
+    TournamentScheduler(size_t entrants, const TournamentConfig& config);
+
+    /**
+     * @brief Returns the number of rounds (n - 1 or n for round-robin, config.rounds otherwise).
+     */
+    size_t rounds() const { return totalRounds; }
+
+    size_t round() const { return dealt; }
+
+    /**
+     * @brief Deals the next round: tables of entrant ids in seat order. An entrant left alone sits out.
+     * @throws std::logic_error once every round was dealt.
+     */
+    std::vector<std::vector<int>> nextRound();
+
+    /**
+     * @brief Credits a finished game: tableSize - 1 - rank points to each seat, scaled to 0..1.
+     * @param table Entrant ids in seat order.
+     * @param ranks Finishing rank per seat (see finishingRanks).
+     * @throws std::invalid_argument if the sizes differ or an entrant does not exist.
+     */
+    void report(const std::vector<int>& table, const std::vector<int>& ranks);
+
+    double points(int entrant) const { return static_cast<double>(score[entrant]) / POINT; }
+
+    /**
+     * @brief Returns how many tables seated an entrant at a seat.
+     * @param entrant Entrant id.
+     * @param seat Seat index (0 acts first).
+     */
+    uint32_t seatCount(int entrant, int seat) const { return seats[static_cast<size_t>(entrant) * MAX_TABLE + seat]; }
+
+    static constexpr int MAX_TABLE = 6;
+
+private:
+    TournamentConfig config;
+    size_t entrants;
+    size_t totalRounds;
+    size_t dealt = 0;
+    static constexpr uint64_t POINT = 60;  ///< Points are counted in 1/60ths, exact for every table size
+    std::vector<uint64_t> score;            ///< So the Swiss order does not depend on the order games finish
+    std::vector<uint32_t> seats;             ///< seatCount per entrant and seat
+    std::vector<int> order;                  ///< Scratch: entrants in dealing order
+    std::unordered_set<uint64_t> met;        ///< Pairs that shared a 2-seat table (Swiss avoids rematches)
+    std::mt19937_64 rng;
+
+    void dealOrder();
+    void avoidRematches();
+
+    /**
+     * @brief Rotates a table so its entrants sit where they have sat least, and counts the seats.
+     */
+    void seat(std::vector<int>& table);
+};
+
+/**
+ * @brief One finished game of a tournament.
+ */
+struct TournamentGame {
+    size_t round = 0;
+    size_t table = 0;
+    std::vector<int> seats;  ///< Entrant id per seat (seat 0 acted first)
+    GameResult result;       ///< Seats refer to positions in `seats`; actions are not counted
+};
+
+/**
+ * @brief Plays a tournament between bots on a thread pool.
+ *
+ * Tables of a round are independent tasks; a Swiss round waits for the previous round's points, the other
+ * formats queue every round at once. Games get random roles, the same for every seat rotation of a table.
+ * @param bots One bot per entrant.
+ * @param config Format and size.
+ * @param onGame Called once per finished game, never concurrently, in completion order.
+ * @return The scheduler, with points and seat counts.
+ * @throws std::invalid_argument as TournamentScheduler.
+ */
+TournamentScheduler playTournament(const std::vector<BotWeights>& bots, const TournamentConfig& config,
+                                   const std::function<void(const TournamentGame&)>& onGame);
@@ -0,0 +1,100 @@
+// orel2744@gmail.com
+// Trace.hpp defines scoped trace points that record into per-thread ring buffers and export Chrome
+// trace-event JSON (chrome://tracing, ui.perfetto.dev). Tracing is off until Trace::enable(true); while off,
+// a TraceScope costs one relaxed atomic load. While on, each scope writes one fixed-size event into its
+// thread's own buffer without locks, and the oldest events are overwritten once the buffer is full.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @class Trace
+ * @brief Process-wide trace control and export.
+ */
+class Trace {
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 16;  ///< Ring size; each thread's buffer is allocated on its first event
+
+    /**
+     * @brief Turns recording on or off (already recorded events stay until clear()).
+     */
+    static void enable(bool on) { active.store(on, std::memory_order_relaxed); }
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns nanoseconds since the trace clock started (steady clock).
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Records a complete event on the calling thread.
+     * @param name Event name; must outlive the trace (a string literal).
+     * @param category Event category; must outlive the trace.
+     * @param start Start time from now().
+     * @param end End time from now().
+     */
+    static void record(const char* name, const char* category, uint64_t start, uint64_t end);
+
+    /**
+     * @brief Names the calling thread in exported traces.
+     * @param name The name.
+     */
+    static void nameThread(const std::string& name);
+
+    /**
+     * @brief Writes every thread's buffered events as Chrome trace-event JSON. Safe while other threads
+     *        record: events overwritten during the copy are dropped, not torn.
+     * @param out The stream.
+     * @return Number of events written.
+     */
+    static size_t writeChromeJson(std::ostream& out);
+
+    /**
+     * @brief Writes the trace to a file (see the stream overload).
+     * @param path The file.
+     * @return Number of events written.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static size_t writeChromeJson(const std::string& path);
+
+    /**
+     * @brief Drops every buffered event (buffers stay allocated). Call while no thread is recording.
+     */
+    static void clear();
+
+private:
+    static inline std::atomic<bool> active{false};
+};
+
+/**
+ * @class TraceScope
+ * @brief Records the wall time of its scope as one trace event, if tracing was on when it began.
+ *
+ * Its destructor is an unwind cleanup even while tracing is off, so an exception thrown past a live scope
+ * costs extra. Open it after a function's rule checks, not before them.
+ */
+class TraceScope {
+public:
+    /**
+     * @param name Event name; must outlive the trace (a string literal).
+     * @param category Event category; must outlive the trace.
+     */
+    explicit TraceScope(const char* name, const char* category = "game")
+        : name(name), category(category), recording(Trace::enabled()), start(recording ? Trace::now() : 0) {}
+    ~TraceScope() {
+        if (recording) Trace::record(name, category, start, Trace::now());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    bool recording;
+    uint64_t start;
+};
@@ -0,0 +1,100 @@
+// orel2744@gmail.com
+// TranspositionTable.hpp defines a fixed-size hash table of search results keyed by Zobrist hashes
+// (Game::hash(), zobristHash()), shared by any number of search threads without locks.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Action.hpp"
+
+/**
+ * @brief How a stored value bounds the true value of a position.
+ */
+enum class TTBound : uint8_t { None, Exact, Lower, Upper };
+
+/**
+ * @brief One stored search result.
+ */
+struct TTEntry {
+    int16_t value = 0;              ///< Searcher-defined score
+    uint8_t depth = 0;              ///< Search depth behind the value (deeper entries are kept longer)
+    TTBound bound = TTBound::None;
+    bool hasMove = false;           ///< Whether `move` holds a best move
+    Action move;                    ///< Best move found (actor and target are seats 0-14)
+};
+
+/**
+ * @class TranspositionTable
+ * @brief A lock-free transposition table of 4-entry buckets, one cache line each.
+ *
+ * Each slot holds the packed entry and the key XOR-ed with it, each in one 64-bit atomic. Writers store
+ * both without locking; a reader that sees halves of two different writes finds that they do not XOR
+ * back to its key and treats the slot as a miss, so a probe never returns another position's entry.
+ * A store replaces the position's own slot, else an empty slot, else the shallowest entry, counting
+ * entries from earlier searches (see newSearch()) as shallower.
+ */
+class TranspositionTable {
+public:
+    /**
+     * @brief Allocates an empty table.
+     * @param megabytes Size in MiB, rounded down to a power-of-two number of buckets.
+     * @throws std::invalid_argument if the size is below one bucket.
+     */
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Looks up a position.
+     * @param key The position's Zobrist hash.
+     * @param out Receives the entry if found.
+     * @return True if the position is stored.
+     */
+    bool probe(uint64_t key, TTEntry& out) const;
+
+    /**
+     * @brief Stores a search result, keeping the previous best move if the new entry has none.
+     * @param key The position's Zobrist hash.
+     * @param entry The result.
+     */
+    void store(uint64_t key, const TTEntry& entry);
+
+    /**
+     * @brief Starts a new search: entries stored so far become the first to be replaced.
+     */
+    void newSearch() { generation.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Empties the table (not safe while other threads use it).
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of entries the table holds.
+     */
+    size_t capacity() const { return bucketCount * BUCKET_SLOTS; }
+
+    /**
+     * @brief Returns the table's size in bytes.
+     */
+    size_t sizeBytes() const { return bucketCount * sizeof(Bucket); }
+
+private:
+    static constexpr size_t BUCKET_SLOTS = 4;
+
+    struct Slot {
+        std::atomic<uint64_t> check;  ///< key ^ data
+        std::atomic<uint64_t> data;   ///< Packed entry, 0 when empty
+    };
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SLOTS];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    std::atomic<uint8_t> generation{0};
+};
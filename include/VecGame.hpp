@@ -0,0 +1,133 @@
+// orel2744@gmail.com
+// VecGame.hpp defines a batch of independent games ("lanes") stored as structure-of-arrays.
+// step() applies one action per lane with the LaneState rules, then finds finished lanes and
+// resets them in passes over contiguous per-seat columns that the compiler can vectorise.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Action.hpp"
+#include "LaneState.hpp"
+#include "Role.hpp"
+
+/**
+ * @class VecGame
+ * @brief N games of the same table size stepped together, e.g. for training agents.
+ *
+ * Every per-seat field is a column of `seats * lanes` values with seat p of lane i at `p * lanes + i`,
+ * so a pass over one seat of all lanes touches contiguous memory. Finished lanes (one player left)
+ * are re-dealt automatically with uniformly random roles.
+ */
+class VecGame {
+public:
+    /**
+     * @brief Creates and deals the lanes.
+     * @param lanes Number of games.
+     * @param seats Seats per game (2 to LaneState::MAX_SEATS).
+     * @param seed Seed for dealing roles.
+     * @throws std::invalid_argument if lanes is 0 or seats is out of range.
+     */
+    VecGame(size_t lanes, int seats, uint64_t seed);
+
+    size_t size() const { return lanes; }
+    int seatCount() const { return seats; }
+
+    /**
+     * @brief Applies one action per lane, then resets the lanes that finished.
+     * @param actions One action per lane.
+     * @param accepted If non-null, receives 1 per lane whose action the rules accepted, else 0.
+     * @param winners If non-null, receives the winning seat of each lane that finished on this step
+     *        (and was reset), else -1.
+     */
+    void step(const Action* actions, uint8_t* accepted = nullptr, int8_t* winners = nullptr);
+
+    /**
+     * @brief Writes, for every lane, the action mask of the seat to act (see seatActionMasks in
+     *        SimdKernels.hpp: bit `1 << ActionType`, exact for untargeted actions). Runs the SIMD kernel
+     *        once per seat column.
+     * @param out One mask per lane.
+     */
+    void legalMasks(uint16_t* out) const;
+
+    /**
+     * @brief Moves amount[i] coins from lane i's bank to the seat to act, with the SIMD coin kernel
+     *        (no rule checks; for handicaps and curriculum set-ups).
+     * @param amount Coins per lane (negative pays into the bank).
+     */
+    void payFromBank(const int16_t* amount);
+
+    /**
+     * @brief Re-deals one lane with random roles.
+     * @param lane Lane index.
+     */
+    void reset(size_t lane);
+
+    /**
+     * @brief Re-deals one lane with the given roles.
+     * @param lane Lane index.
+     * @param roles One role per seat.
+     * @throws std::invalid_argument if the number of roles is not seatCount().
+     */
+    void reset(size_t lane, const std::vector<Role>& roles);
+
+    /**
+     * @brief Returns a copy of one lane's state.
+     * @param lane Lane index.
+     */
+    LaneState get(size_t lane) const;
+
+    /**
+     * @brief Overwrites one lane's state.
+     * @param lane Lane index.
+     * @param state A state with seatCount() seats.
+     * @throws std::invalid_argument if the seat count differs.
+     */
+    void set(size_t lane, const LaneState& state);
+
+    /**
+     * @brief Returns the seat to act in a lane.
+     * @param lane Lane index.
+     */
+    int currentSeat(size_t lane) const { return turn[lane]; }
+
+    /**
+     * @brief Returns the coins column of a seat (one value per lane).
+     * @param seat Seat index.
+     */
+    const int16_t* coinsOf(int seat) const { return &coins[static_cast<size_t>(seat) * lanes]; }
+
+    /**
+     * @brief Returns the alive column of a seat (one 0/1 value per lane).
+     * @param seat Seat index.
+     */
+    const uint8_t* aliveOf(int seat) const { return &alive[static_cast<size_t>(seat) * lanes]; }
+
+    /**
+     * @brief Returns the bank of every lane.
+     */
+    const int16_t* banks() const { return bank.data(); }
+
+    /**
+     * @brief Returns the total number of games finished (and reset) so far.
+     */
+    uint64_t gamesFinished() const { return finished; }
+
+private:
+    size_t lanes;
+    int seats;
+    std::mt19937_64 rng;
+    uint64_t finished = 0;
+
+    std::vector<uint8_t> seatCounts;   ///< seats, per lane (LaneRef needs an addressable count)
+    std::vector<int8_t> turn;
+    std::vector<int16_t> bank;
+    std::vector<uint8_t> role, alive, extra, pending;
+    std::vector<int16_t> coins;
+    std::vector<int8_t> sanction, arrestBlock, coupBlock, bribe, tax, arrestTarget;
+    std::vector<uint8_t> aliveCount;   ///< Scratch for step()
+
+    LaneRef lane(size_t i);
+};
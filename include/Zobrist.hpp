@@ -0,0 +1,55 @@
+// orel2744@gmail.com
+// Zobrist.hpp defines the 64-bit Zobrist keys of a game state: one pseudo-random key per (field, seat, value),
+// XOR-ed together over the state. Game keeps its hash current by toggling the old and new key of every field
+// it changes, so hashing costs O(1) per mutation; zobristHash() computes the same value for a LaneState.
+
+#pragma once
+
+#include <cstdint>
+#include "LaneState.hpp"
+
+/**
+ * @brief The hashed fields of a game. Per-seat fields are keyed by seat; Bank and Turn use seat -1.
+ *        Log fields (Sanction to ArrestTarget) contribute a key only while the seat has an entry.
+ */
+enum class ZobristField : uint8_t {
+    Role,          ///< Role of the seat
+    Coins,
+    Alive,
+    Extra,         ///< Extra action from a bribe
+    Pending,       ///< Pending action (0 none, 1 tax, 2 bribe)
+    Bank,
+    Turn,          ///< Game::currentTurnIndex
+    Sanction,      ///< Turn index the sanction was applied in
+    ArrestBlock,
+    CoupBlock,
+    Bribe,
+    Tax,
+    ArrestTarget,  ///< Seat this seat last arrested
+    CoupTarget,    ///< Recently targeted by a coup (value 1)
+    CoupAttempt    ///< Seat of the attacker of a pending coup
+};
+
+/**
+ * @brief Returns the key of one field value.
+ *
+ * Keys are computed rather than looked up (splitmix64 of the packed triple), so coin counts and the bank
+ * need no table bound; the mix is a handful of multiplies, cheaper than a cache miss on a large table.
+ * @param field The field.
+ * @param seat The seat, or -1 for Bank and Turn.
+ * @param value The field's value.
+ */
+inline uint64_t zobristKey(ZobristField field, int seat, int value) {
+    uint64_t x = (static_cast<uint64_t>(field) << 48) ^ (static_cast<uint64_t>(static_cast<uint16_t>(seat + 1)) << 32) ^
+                 static_cast<uint32_t>(value);
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Returns the hash of a lane state, equal to Game::hash() of the same game.
+ * @param state The state.
+ */
+uint64_t zobristHash(const LaneState& state);
@@ -0,0 +1,87 @@
+// orel2744@gmail.com
+// Action.cpp - Conversion helpers and dispatch of seat-indexed actions onto Player methods.
+#include "Action.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include <stdexcept>
+
+namespace {
+const char* const ACTION_NAMES[ACTION_TYPE_COUNT] = {
+    "gather", "tax", "bribe", "arrest", "sanction", "coup", "invest",
+    "spyOn", "preventCoup", "judgeBribe", "generalBlockCoup", "blockTax", "skipTurn"
+};
+}
+
+/**
+ * @brief Returns true if the action type needs a target seat.
+ * @param type The action type.
+ */
+bool actionNeedsTarget(ActionType type) {
+    switch (type) {
+        case ActionType::Arrest:
+        case ActionType::Sanction:
+        case ActionType::Coup:
+        case ActionType::SpyOn:
+        case ActionType::PreventCoup:
+        case ActionType::JudgeBribe:
+        case ActionType::GeneralBlockCoup:
+        case ActionType::BlockTax:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Converts an action type to its readable name.
+ * @param type The action type.
+ */
+std::string actionTypeToString(ActionType type) {
+    int i = static_cast<int>(type);
+    if (i < 0 || i >= ACTION_TYPE_COUNT) return "invalid";
+    return ACTION_NAMES[i];
+}
+
+/**
+ * @brief Parses a readable action name.
+ * @param name The action name.
+ * @throws std::invalid_argument if the name is unknown.
+ */
+ActionType actionTypeFromString(const std::string& name) {
+    for (int i = 0; i < ACTION_TYPE_COUNT; ++i) {
+        if (name == ACTION_NAMES[i]) return static_cast<ActionType>(i);
+    }
+    throw std::invalid_argument("Unknown action: " + name);
+}
+
+/**
+ * @brief Applies an action to a game by calling the matching method on the acting player.
+ * @param game The game to act on.
+ * @param action The action to apply.
+ * @throws std::out_of_range if a seat does not exist.
+ * @throws std::invalid_argument if a targeted action has no target.
+ * @throws std::logic_error for actions the rules do not allow.
+ */
+void applyAction(Game& game, const Action& action) {
+    Player* actor = game.playerAt(action.actor);
+    Player* target = nullptr;
+    if (actionNeedsTarget(action.type)) {
+        if (action.target < 0) throw std::invalid_argument("Action needs a target.");
+        target = game.playerAt(action.target);
+    }
+    switch (action.type) {
+        case ActionType::Gather:           actor->gather(); break;
+        case ActionType::Tax:              actor->tax(); break;
+        case ActionType::Bribe:            actor->bribe(); break;
+        case ActionType::Arrest:           actor->arrest(*target); break;
+        case ActionType::Sanction:         actor->sanction(*target); break;
+        case ActionType::Coup:             actor->coup(*target); break;
+        case ActionType::Invest:           actor->invest(); break;
+        case ActionType::SpyOn:            actor->spyOn(*target); break;
+        case ActionType::PreventCoup:      actor->preventCoup(*target); break;
+        case ActionType::JudgeBribe:       actor->judgeBribe(*target); break;
+        case ActionType::GeneralBlockCoup: actor->generalBlockCoup(*target); break;
+        case ActionType::BlockTax:         actor->blockTax(*target); break;
+        case ActionType::SkipTurn:         actor->skipTurn(); break;
+    }
+}
@@ -0,0 +1,201 @@
+// orel2744@gmail.com
+// AllocTracker.cpp - Per-tag allocation counters and, with -DCOUP_TRACK_ALLOCS, the global new/delete that feed them.
+#include "AllocTracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#if defined(COUP_TRACK_ALLOCS) && defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace {
+// Zero-initialised before any constructor runs, so allocations made during static initialisation count too
+std::atomic<uint64_t> scopeCount[AllocTracker::MAX_TAGS];
+std::atomic<uint64_t> allocationCount[AllocTracker::MAX_TAGS];
+std::atomic<uint64_t> byteCount[AllocTracker::MAX_TAGS];
+std::atomic<uint64_t> freeCount[AllocTracker::MAX_TAGS];
+std::atomic<int> registered{1};
+
+thread_local int currentTag = AllocTracker::UNTAGGED;
+thread_local AllocTracker::Counts threadCounts;
+
+std::mutex& registryLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+std::string* tagNames() {
+    static std::string names[AllocTracker::MAX_TAGS] = {"untagged"};
+    return names;
+}
+}
+
+bool AllocTracker::enabled() {
+#ifdef COUP_TRACK_ALLOCS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the tag with a name, registering it the first time.
+ * @throws std::length_error once MAX_TAGS tags exist.
+ */
+int AllocTracker::tag(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryLock());
+    const int count = registered.load();
+    for (int t = 0; t < count; ++t) {
+        if (tagNames()[t] == name) return t;
+    }
+    if (count == MAX_TAGS) throw std::length_error("Too many allocation tags");
+    tagNames()[count] = name;
+    registered.store(count + 1);
+    return count;
+}
+
+std::string AllocTracker::name(int tag) {
+    std::lock_guard<std::mutex> lock(registryLock());
+    if (tag < 0 || tag >= registered.load()) throw std::out_of_range("No such allocation tag");
+    return tagNames()[tag];
+}
+
+int AllocTracker::tagCount() { return registered.load(); }
+
+AllocTracker::Counts AllocTracker::counts(int tag) {
+    if (tag < 0 || tag >= MAX_TAGS) throw std::out_of_range("No such allocation tag");
+    Counts c;
+    c.scopes = scopeCount[tag].load(std::memory_order_relaxed);
+    c.allocations = allocationCount[tag].load(std::memory_order_relaxed);
+    c.bytes = byteCount[tag].load(std::memory_order_relaxed);
+    c.frees = freeCount[tag].load(std::memory_order_relaxed);
+    return c;
+}
+
+AllocTracker::Counts AllocTracker::thisThread() { return threadCounts; }
+
+void AllocTracker::reset() {
+    for (int t = 0; t < MAX_TAGS; ++t) {
+        scopeCount[t].store(0, std::memory_order_relaxed);
+        allocationCount[t].store(0, std::memory_order_relaxed);
+        byteCount[t].store(0, std::memory_order_relaxed);
+        freeCount[t].store(0, std::memory_order_relaxed);
+    }
+}
+
+void AllocTracker::recordAllocation(size_t bytes) {
+    allocationCount[currentTag].fetch_add(1, std::memory_order_relaxed);
+    byteCount[currentTag].fetch_add(bytes, std::memory_order_relaxed);
+    ++threadCounts.allocations;
+    threadCounts.bytes += bytes;
+}
+
+void AllocTracker::recordFree() {
+    freeCount[currentTag].fetch_add(1, std::memory_order_relaxed);
+    ++threadCounts.frees;
+}
+
+void AllocTracker::enter(int tag) {
+    scopeCount[tag].fetch_add(1, std::memory_order_relaxed);
+    ++threadCounts.scopes;
+    currentTag = tag;
+}
+
+/**
+ * @brief Charges the calling thread's allocations to a tag until destroyed.
+ * @throws std::out_of_range if the tag is out of range.
+ */
+AllocScope::AllocScope(int tag) : previous(currentTag) {
+    if (tag < 0 || tag >= AllocTracker::MAX_TAGS) throw std::out_of_range("No such allocation tag");
+    AllocTracker::enter(tag);
+}
+
+AllocScope::~AllocScope() { currentTag = previous; }
+
+#ifdef COUP_TRACK_ALLOCS
+// The replaced allocation functions: malloc/free underneath, counted on the way through
+
+void* operator new(size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    AllocTracker::recordAllocation(size);
+    return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    void* p = std::malloc(size ? size : 1);
+    if (p) AllocTracker::recordAllocation(size);
+    return p;
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    AllocTracker::recordFree();
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { operator delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { operator delete(p); }
+
+// Over-aligned types (alignas above 16, e.g. the transposition table's cache-line buckets) come here instead
+
+namespace {
+void* alignedMalloc(size_t size, size_t alignment) {
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, alignment);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, std::max(alignment, sizeof(void*)), size ? size : 1) == 0 ? p : nullptr;
+#endif
+}
+
+void alignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* p = alignedMalloc(size, static_cast<size_t>(alignment));
+    if (!p) throw std::bad_alloc();
+    AllocTracker::recordAllocation(size);
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    void* p = alignedMalloc(size, static_cast<size_t>(alignment));
+    if (p) AllocTracker::recordAllocation(size);
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept {
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    if (!p) return;
+    AllocTracker::recordFree();
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete(p, alignment); }
+#endif
@@ -0,0 +1,534 @@
+// orel2744@gmail.com
+// Cfr.cpp - Outcome-sampling MCCFR over an abstracted 2-player game, with a lock-free regret table,
+// checkpoints, and a best-response exploitability computed ply by ply.
+#include "Cfr.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+const int MAX_HORIZON = 30;
+const unsigned MIN_TABLE_BITS = 8, MAX_TABLE_BITS = 28;
+const uint64_t OCCUPIED = 1ULL << 63;
+const uint32_t UNUSABLE = ~0u;              // offset of an entry that did not fit the pool
+const size_t POOL_FLOATS_PER_SLOT = 16;     // pool budget per table slot (regrets + strategy sums)
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'C', 'F', 'R', '1'};
+const uint32_t VERSION = 2;  // 1 keyed information sets on the legal moves, which leak the opponent's role
+
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Coin buckets: 0, 1, 2, 3 exact, then 4-5, 6, 7-9 (a coup is affordable), 10+
+int bucket(int coins) {
+    if (coins <= 3) return coins;
+    if (coins <= 5) return 4;
+    if (coins == 6) return 5;
+    return coins <= 9 ? 6 : 7;
+}
+
+void atomicAdd(std::atomic<float>& a, float v) {
+    float cur = a.load(std::memory_order_relaxed);
+    while (!a.compare_exchange_weak(cur, cur + v, std::memory_order_relaxed)) {}
+}
+
+/**
+ * @brief The acting seat's information set at a non-terminal position, its candidate moves and which of
+ *        them the rules accept here.
+ *
+ * The candidates are every move that is legal against some role of the opponent, so they depend only on
+ * what the actor knows (the public state and its own role) and are the same at every position of the
+ * information set. The mask is what the hidden role allows: an arrest is refused against a Merchant with
+ * fewer than 2 coins, for example. Strategies are renormalised over the legal candidates.
+ */
+struct Decision {
+    int actor = 0;
+    int count = 0;                          ///< Candidates
+    int legalCount = 0;
+    uint64_t key = 0;
+    Action moves[LaneState::MAX_ACTIONS];   ///< Candidates, in ActionType then target order
+    bool legal[LaneState::MAX_ACTIONS];
+};
+
+// Index of a 2-seat move among every (type, target) pair
+int slotOf(const Action& a) { return static_cast<int>(a.type) * 3 + a.target + 1; }
+
+/**
+ * @brief Fills the decision at a position; false if the position is terminal (won, at the horizon, or stuck).
+ */
+bool decide(const CfrPosition& p, int horizon, Decision& d) {
+    const LaneState& s = p.state;
+    if (p.ply >= horizon || s.winner() >= 0) return false;
+    Action moves[LaneState::MAX_ACTIONS];
+    int n = s.legalActions(moves);
+    if (n == 0) return false;
+    const int me = s.currentSeat(), opp = 1 - me;
+    d.actor = me;
+    uint64_t legal = 0, candidates = 0;
+    for (int i = 0; i < n; ++i) legal |= 1ULL << slotOf(moves[i]);
+    candidates = legal;
+    // The opponent's role only matters to moves that target it, so only those are tried against the others
+    LaneState other = s;
+    for (int r = 0; r < 6; ++r) {
+        if (r == s.role[opp]) continue;
+        other.role[opp] = static_cast<uint8_t>(r);
+        for (int t = 0; t < ACTION_TYPE_COUNT; ++t) {
+            const Action a{static_cast<ActionType>(t), me, opp};
+            if (a.type == ActionType::GeneralBlockCoup || !actionNeedsTarget(a.type) || candidates >> slotOf(a) & 1) continue;
+            LaneState copy = other;
+            if (copy.apply(a)) candidates |= 1ULL << slotOf(a);
+        }
+    }
+    d.count = d.legalCount = 0;
+    for (int slot = 0; slot < ACTION_TYPE_COUNT * 3; ++slot) {
+        if (!(candidates >> slot & 1)) continue;
+        d.moves[d.count] = {static_cast<ActionType>(slot / 3), me, slot % 3 - 1};
+        d.legal[d.count] = legal >> slot & 1;
+        d.legalCount += d.legal[d.count];
+        ++d.count;
+    }
+    uint64_t k = s.role[me];
+    k = k * 8 + bucket(s.coins[me]);
+    k = k * 8 + bucket(s.coins[opp]);
+    k = k * 8 + bucket(s.bank);
+    k = k * 32 + static_cast<uint64_t>(p.ply);
+    k = k * 16 + static_cast<uint64_t>(p.lastAction[opp] + 1);
+    k = k * 16 + static_cast<uint64_t>(p.lastAction[me] + 1);
+    k = k * 2 + (s.sanction[me] >= 0);
+    k = k * 2 + (s.sanction[opp] >= 0);
+    k = k * 2 + s.extra[me];
+    k = k * 3 + s.pending[me];
+    k = k * 3 + s.pending[opp];
+    k = k * 3 + static_cast<uint64_t>(s.arrestTarget[me] + 1);
+    // The candidates come from public facts the buckets blur (exact coins, blocks), never from the hidden role
+    d.key = (mix(k) ^ mix(candidates ^ 0xC0FFEEULL)) & ~OCCUPIED;
+    if (d.key == 0) d.key = 1;
+    return true;
+}
+
+// Payoff of seat 0 at a terminal position
+double payoff(const CfrPosition& p) {
+    int w = p.state.winner();
+    if (w >= 0) return w == 0 ? 1.0 : -1.0;
+    double lead = (p.state.coins[0] - p.state.coins[1]) / 14.0;
+    return std::max(-0.5, std::min(0.5, lead));
+}
+
+/**
+ * @brief Open-addressing map from information set to its regrets and strategy sums, with lock-free
+ *        inserts and a bump-allocated float pool. Entries are never removed.
+ */
+class RegretTable {
+public:
+    explicit RegretTable(unsigned bits)
+        : mask((size_t(1) << bits) - 1), keys(new std::atomic<uint64_t>[mask + 1]), counts(new uint8_t[mask + 1]),
+          offsets(new std::atomic<uint32_t>[mask + 1]), poolSize((mask + 1) * POOL_FLOATS_PER_SLOT),
+          pool(new std::atomic<float>[poolSize]) {
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; ++i) {
+            keys[i].store(0, std::memory_order_relaxed);
+            offsets[i].store(0, std::memory_order_relaxed);
+            counts[i] = 0;
+        }
+        for (size_t i = 0; i < poolSize; ++i) pool[i].store(0.0f, std::memory_order_relaxed);
+        used.store(0);
+        size.store(0);
+        overflow.store(false);
+    }
+
+    // Returns the entry's 2 * count floats (regrets, then strategy sums), or nullptr if absent
+    std::atomic<float>* find(uint64_t key) const {
+        const uint64_t tagged = key | OCCUPIED;
+        for (size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            uint64_t seen = keys[i].load(std::memory_order_relaxed);
+            if (seen == 0) return nullptr;
+            if (seen == tagged) return entry(i);
+        }
+    }
+
+    // Returns the entry, inserting it with zeroed values; nullptr if the table or pool is full
+    std::atomic<float>* insert(uint64_t key, int count) {
+        const uint64_t tagged = key | OCCUPIED;
+        for (size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            uint64_t seen = keys[i].load(std::memory_order_relaxed);
+            if (seen == 0) {
+                if (size.load(std::memory_order_relaxed) * 10 >= (mask + 1) * 9) {
+                    overflow.store(true, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                if (!keys[i].compare_exchange_strong(seen, tagged, std::memory_order_relaxed)) {
+                    if (seen != tagged) continue;
+                    return entry(i);
+                }
+                size.fetch_add(1, std::memory_order_relaxed);
+                counts[i] = static_cast<uint8_t>(count);
+                size_t off = used.fetch_add(2 * static_cast<size_t>(count), std::memory_order_relaxed);
+                if (off + 2 * static_cast<size_t>(count) > poolSize) {
+                    overflow.store(true, std::memory_order_relaxed);
+                    offsets[i].store(UNUSABLE, std::memory_order_release);
+                    return nullptr;
+                }
+                offsets[i].store(static_cast<uint32_t>(off + 1), std::memory_order_release);
+                return &pool[off];
+            }
+            if (seen == tagged) return entry(i);
+        }
+    }
+
+    // Calls f(key, count, values) for every usable entry
+    template <class F>
+    void forEach(F&& f) const {
+        for (size_t i = 0; i <= mask; ++i) {
+            uint64_t k = keys[i].load(std::memory_order_relaxed);
+            uint32_t off = offsets[i].load(std::memory_order_acquire);
+            if (k && off && off != UNUSABLE) f(k & ~OCCUPIED, counts[i], &pool[off - 1]);
+        }
+    }
+
+    size_t entries() const { return size.load(std::memory_order_relaxed); }
+    bool overflowed() const { return overflow.load(std::memory_order_relaxed); }
+
+private:
+    const size_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> keys;
+    std::unique_ptr<uint8_t[]> counts;
+    std::unique_ptr<std::atomic<uint32_t>[]> offsets;  // pool offset + 1; 0 while the inserter allocates
+    const size_t poolSize;
+    std::unique_ptr<std::atomic<float>[]> pool;
+    std::atomic<size_t> used{0};
+    std::atomic<size_t> size{0};
+    std::atomic<bool> overflow{false};
+
+    std::atomic<float>* entry(size_t i) const {
+        uint32_t off;
+        while ((off = offsets[i].load(std::memory_order_acquire)) == 0) std::this_thread::yield();
+        return off == UNUSABLE ? nullptr : &pool[off - 1];
+    }
+};
+
+// Regret matching over the legal candidates: positive regrets normalised, uniform if none; 0 if illegal
+void currentStrategy(const std::atomic<float>* values, const Decision& d, double* sigma) {
+    double total = 0.0;
+    for (int a = 0; a < d.count; ++a) {
+        sigma[a] = values && d.legal[a] ? std::max(0.0f, values[a].load(std::memory_order_relaxed)) : 0.0;
+        total += sigma[a];
+    }
+    for (int a = 0; a < d.count; ++a) sigma[a] = !d.legal[a] ? 0.0 : total > 0 ? sigma[a] / total : 1.0 / d.legalCount;
+}
+
+// Normalised strategy sums over the legal candidates, uniform if none
+void averageOf(const std::atomic<float>* values, const Decision& d, double* sigma) {
+    currentStrategy(values ? values + d.count : nullptr, d, sigma);
+}
+}
+
+struct CfrTrainer::Impl {
+    const CfrConfig& config;
+    RegretTable table;
+    uint64_t iterations = 0;
+    uint64_t trained = 0;  // iterations run by train() in this process, for the rate
+    double seconds = 0.0;
+
+    Impl(const CfrConfig& config) : config(config), table(config.tableBits) {}
+
+    struct Sample {
+        double value;  ///< Payoff of the updating seat divided by the sampling probability of the game
+        double tail;   ///< Probability of the rest of the game under the current strategies
+    };
+
+    /**
+     * @brief Samples one game below p for the updating seat i and updates i's regrets along it.
+     * @param reachI Probability of i's own moves so far; reachO of the opponent's; q of the sampling.
+     */
+    Sample traverse(const CfrPosition& p, int i, double reachI, double reachO, double q, std::mt19937_64& rng) {
+        Decision d;
+        if (!decide(p, config.horizon, d)) {
+            double u = payoff(p);
+            return {(i == 0 ? u : -u) / q, 1.0};
+        }
+        std::atomic<float>* values = table.insert(d.key, d.count);
+        double sigma[LaneState::MAX_ACTIONS], sample[LaneState::MAX_ACTIONS];
+        currentStrategy(values, d, sigma);
+        const bool mine = d.actor == i;
+        for (int a = 0; a < d.count; ++a) {
+            sample[a] = !d.legal[a] ? 0.0
+                        : mine      ? config.exploration / d.legalCount + (1.0 - config.exploration) * sigma[a]
+                                    : sigma[a];
+        }
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        int pick = -1;
+        for (int a = 0; a < d.count; ++a) {
+            if (!d.legal[a]) continue;
+            pick = a;  // the last legal one takes any rounding left over
+            if ((u -= sample[a]) < 0) break;
+        }
+        CfrPosition child = p;
+        child.play(d.moves[pick]);
+        Sample r = traverse(child, i, mine ? reachI * sigma[pick] : reachI, mine ? reachO : reachO * sigma[pick],
+                            q * sample[pick], rng);
+        if (mine && values) {
+            const double w = r.value * reachO;
+            for (int a = 0; a < d.count; ++a) {
+                if (!d.legal[a]) continue;  // no counterfactual value where the rules refuse it
+                double regret = a == pick ? w * r.tail * (1.0 - sigma[pick]) : -w * r.tail * sigma[pick];
+                atomicAdd(values[a], static_cast<float>(regret));
+                atomicAdd(values[d.count + a], static_cast<float>(reachI / q * sigma[a]));
+            }
+        }
+        return {r.value, r.tail * sigma[pick]};
+    }
+
+    /**
+     * @brief One pass of the best response of seat i against the average strategy.
+     *
+     * Information sets at ply `level` accumulate reach-weighted values of each candidate into `cfv`;
+     * deeper ones play the legal candidate ranked highest in `best` (a refused move falls through to the
+     * next, as it would at the table); shallower ones of seat i explore every legal move.
+     * With level -1 every decision of seat i is a best one and the value of p is returned.
+     */
+    double bestResponse(const CfrPosition& p, int i, double reach, int level,
+                        std::unordered_map<uint64_t, std::vector<double>>& cfv,
+                        const std::unordered_map<uint64_t, std::vector<double>>& best) const {
+        Decision d;
+        if (!decide(p, config.horizon, d)) return i == 0 ? payoff(p) : -payoff(p);
+        if (d.actor == i) {
+            if (p.ply > level) {
+                auto it = best.find(d.key);
+                int pick = -1;
+                for (int a = 0; a < d.count; ++a) {
+                    if (d.legal[a] && (pick < 0 || (it != best.end() && it->second[a] > it->second[pick]))) pick = a;
+                }
+                CfrPosition child = p;
+                child.play(d.moves[pick]);
+                return bestResponse(child, i, reach, level, cfv, best);
+            }
+            std::vector<double>* values = nullptr;
+            if (p.ply == level) {
+                values = &cfv[d.key];
+                values->resize(static_cast<size_t>(d.count), 0.0);
+            }
+            for (int a = 0; a < d.count; ++a) {
+                if (!d.legal[a]) continue;
+                CfrPosition child = p;
+                child.play(d.moves[a]);
+                double v = bestResponse(child, i, reach, level, cfv, best);
+                if (values) (*values)[a] += reach * v;
+            }
+            return 0.0;  // only values of plies below `level` are used
+        }
+        double sigma[LaneState::MAX_ACTIONS];
+        averageOf(table.find(d.key), d, sigma);
+        double v = 0.0;
+        for (int a = 0; a < d.count; ++a) {
+            if (sigma[a] <= 0.0) continue;
+            CfrPosition child = p;
+            child.play(d.moves[a]);
+            v += sigma[a] * bestResponse(child, i, reach * sigma[a], level, cfv, best);
+        }
+        return v;
+    }
+};
+
+/**
+ * @brief Applies an action of the seat to act and records it.
+ * @param action The action.
+ * @return False if the rules rejected it.
+ */
+bool CfrPosition::play(const Action& action) {
+    if (!state.apply(action)) return false;
+    if (action.actor == 0 || action.actor == 1) lastAction[action.actor] = static_cast<int8_t>(action.type);
+    ++ply;
+    return true;
+}
+
+/**
+ * @brief Allocates an empty regret table.
+ * @param cfg The abstract game and resources.
+ * @throws std::invalid_argument if the horizon, coins, bank or table size are out of range.
+ */
+CfrTrainer::CfrTrainer(const CfrConfig& cfg) : config(cfg) {
+    if (config.horizon < 1 || config.horizon > MAX_HORIZON) throw std::invalid_argument("Horizon must be 1 to 30 plies");
+    if (config.startCoins < 0 || config.bank < 0) throw std::invalid_argument("Coins and bank must not be negative");
+    if (config.tableBits < MIN_TABLE_BITS || config.tableBits > MAX_TABLE_BITS) throw std::invalid_argument("Table bits must be 8 to 28");
+    if (config.exploration <= 0.0 || config.exploration > 1.0) throw std::invalid_argument("Exploration must be in (0, 1]");
+    if (config.threads == 0) config.threads = std::max(1u, std::thread::hardware_concurrency());
+    impl.reset(new Impl(config));
+}
+
+CfrTrainer::~CfrTrainer() = default;
+
+/**
+ * @brief Returns the root position of a role pairing.
+ * @param first Role of seat 0.
+ * @param second Role of seat 1.
+ */
+CfrPosition CfrTrainer::root(Role first, Role second) const {
+    CfrPosition p;
+    p.state = LaneState::deal({first, second});
+    p.state.coins[0] = p.state.coins[1] = config.startCoins;
+    p.state.bank = config.bank;
+    return p;
+}
+
+/**
+ * @brief Runs more iterations on all threads.
+ * @param iterations Iterations to add.
+ * @throws std::runtime_error if the regret table filled up.
+ */
+void CfrTrainer::train(uint64_t iterations) {
+    auto begin = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> next{0};
+    const uint64_t base = impl->iterations;
+    auto worker = [&](unsigned me) {
+        std::mt19937_64 rng(config.seed * 0x9E3779B97F4A7C15ULL + base * 31 + me);
+        std::uniform_int_distribution<int> role(0, 5);
+        while (next.fetch_add(1, std::memory_order_relaxed) < iterations) {
+            CfrPosition p = root(static_cast<Role>(role(rng)), static_cast<Role>(role(rng)));
+            for (int i = 0; i < 2; ++i) impl->traverse(p, i, 1.0, 1.0, 1.0, rng);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < config.threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& t : pool) t.join();
+    impl->iterations += iterations;
+    impl->trained += iterations;
+    impl->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (impl->table.overflowed()) throw std::runtime_error("Regret table is full; raise tableBits");
+}
+
+/**
+ * @brief Computes the exploitability of the average strategy in the abstract game.
+ */
+double CfrTrainer::exploitability() const {
+    double total = 0.0;
+    for (int i = 0; i < 2; ++i) {
+        std::unordered_map<uint64_t, std::vector<double>> best;
+        for (int level = config.horizon - 1; level >= 0; --level) {
+            std::unordered_map<uint64_t, std::vector<double>> cfv;
+            for (int a = 0; a < 6; ++a)
+                for (int b = 0; b < 6; ++b) impl->bestResponse(root(static_cast<Role>(a), static_cast<Role>(b)), i, 1.0, level, cfv, best);
+            for (auto& kv : cfv) best[kv.first] = std::move(kv.second);
+        }
+        std::unordered_map<uint64_t, std::vector<double>> unused;
+        for (int a = 0; a < 6; ++a)
+            for (int b = 0; b < 6; ++b) total += impl->bestResponse(root(static_cast<Role>(a), static_cast<Role>(b)), i, 1.0, -1, unused, best) / 36.0;
+    }
+    return total / 2.0;
+}
+
+/**
+ * @brief Returns the average strategy at a position.
+ * @param position A position of the abstract game.
+ * @throws std::invalid_argument if the position is terminal.
+ */
+std::vector<std::pair<Action, double>> CfrTrainer::averageStrategy(const CfrPosition& position) const {
+    Decision d;
+    if (!decide(position, config.horizon, d)) throw std::invalid_argument("Position is terminal");
+    double sigma[LaneState::MAX_ACTIONS];
+    averageOf(impl->table.find(d.key), d, sigma);
+    std::vector<std::pair<Action, double>> out;
+    for (int a = 0; a < d.count; ++a) {
+        if (d.legal[a]) out.emplace_back(d.moves[a], sigma[a]);
+    }
+    return out;
+}
+
+/**
+ * @brief Writes the regret and strategy tables with the iteration count.
+ * @param path Output file.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void CfrTrainer::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    auto put = [&out](const void* p, size_t n) { out.write(static_cast<const char*>(p), static_cast<std::streamsize>(n)); };
+    put(MAGIC, sizeof(MAGIC));
+    put(&VERSION, sizeof(VERSION));
+    const int32_t game[3] = {config.startCoins, config.bank, config.horizon};
+    put(game, sizeof(game));
+    put(&impl->iterations, sizeof(impl->iterations));
+    uint64_t count = 0;
+    impl->table.forEach([&](uint64_t, int, const std::atomic<float>*) { ++count; });
+    put(&count, sizeof(count));
+    std::vector<float> values;
+    impl->table.forEach([&](uint64_t key, int n, const std::atomic<float>* v) {
+        uint8_t actions = static_cast<uint8_t>(n);
+        put(&key, sizeof(key));
+        put(&actions, sizeof(actions));
+        values.resize(2 * static_cast<size_t>(n));
+        for (size_t j = 0; j < values.size(); ++j) values[j] = v[j].load(std::memory_order_relaxed);
+        put(values.data(), values.size() * sizeof(float));
+    });
+    if (!out) throw std::runtime_error("Cannot write " + path);
+}
+
+/**
+ * @brief Replaces the tables with a checkpoint written by save() under the same abstract game.
+ * @param path Checkpoint file.
+ * @throws std::runtime_error if the file cannot be read, is not a checkpoint, or does not match.
+ */
+void CfrTrainer::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot read " + path);
+    auto get = [&in, &path](void* p, size_t n) {
+        if (!in.read(static_cast<char*>(p), static_cast<std::streamsize>(n))) throw std::runtime_error("Truncated checkpoint " + path);
+    };
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    int32_t game[3];
+    uint64_t iterations = 0, count = 0;
+    get(magic, sizeof(magic));
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error(path + " is not a CFR checkpoint");
+    get(&version, sizeof(version));
+    if (version != VERSION) throw std::runtime_error(path + " has an unsupported version");
+    get(game, sizeof(game));
+    if (game[0] != config.startCoins || game[1] != config.bank || game[2] != config.horizon)
+        throw std::runtime_error(path + " was trained on another abstract game");
+    get(&iterations, sizeof(iterations));
+    get(&count, sizeof(count));
+
+    impl->table.clear();
+    std::vector<float> values;
+    for (uint64_t e = 0; e < count; ++e) {
+        uint64_t key = 0;
+        uint8_t actions = 0;
+        get(&key, sizeof(key));
+        get(&actions, sizeof(actions));
+        if (actions == 0 || actions > LaneState::MAX_ACTIONS) throw std::runtime_error("Corrupt checkpoint " + path);
+        values.resize(2 * static_cast<size_t>(actions));
+        get(values.data(), values.size() * sizeof(float));
+        std::atomic<float>* v = impl->table.insert(key, actions);
+        if (!v) throw std::runtime_error("Checkpoint " + path + " does not fit the table; raise tableBits");
+        for (size_t j = 0; j < values.size(); ++j) v[j].store(values[j], std::memory_order_relaxed);
+    }
+    impl->iterations = iterations;
+}
+
+uint64_t CfrTrainer::iterations() const { return impl->iterations; }
+
+size_t CfrTrainer::infoSets() const { return impl->table.entries(); }
+
+/**
+ * @brief Returns the wall time spent in train() in seconds.
+ */
+double CfrTrainer::seconds() const { return impl->seconds; }
+
+/**
+ * @brief Returns iterations per second of train() wall time.
+ */
+double CfrTrainer::iterationsPerSecond() const {
+    return impl->seconds > 0 ? static_cast<double>(impl->trained) / impl->seconds : 0.0;
+}
@@ -0,0 +1,176 @@
+// orel2744@gmail.com
+// Dealing.cpp - Independent and stratified role dealing for batches of games, and win-rate estimation.
+#include "Dealing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace {
+const Role ROLES[] = {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant};
+const int ROLE_COUNT = 6;
+
+// Appends every non-decreasing sequence of role indices of the remaining length
+void enumerate(std::vector<Role>& current, int minRole, size_t left, std::vector<std::vector<Role>>& out) {
+    if (left == 0) { out.push_back(current); return; }
+    for (int r = minRole; r < ROLE_COUNT; ++r) {
+        current.push_back(ROLES[r]);
+        enumerate(current, r, left - 1, out);
+        current.pop_back();
+    }
+}
+
+// Multinomial probability of a sorted composition when every seat is dealt uniformly
+double compositionProbability(const std::vector<Role>& comp) {
+    double p = std::tgamma(static_cast<double>(comp.size()) + 1);
+    size_t i = 0;
+    while (i < comp.size()) {
+        size_t j = i;
+        while (j < comp.size() && comp[j] == comp[i]) ++j;
+        p /= std::tgamma(static_cast<double>(j - i) + 1);
+        i = j;
+    }
+    return p / std::pow(ROLE_COUNT, static_cast<double>(comp.size()));
+}
+}
+
+/**
+ * @brief Returns all role compositions (sorted multisets) for a table size, in a fixed order.
+ * @param tableSize Seats per game.
+ */
+std::vector<std::vector<Role>> BatchDealer::compositions(size_t tableSize) {
+    std::vector<std::vector<Role>> out;
+    std::vector<Role> current;
+    enumerate(current, 0, tableSize, out);
+    return out;
+}
+
+/**
+ * @brief Deals a batch.
+ * @param tableSize Seats per game (2 to 6).
+ * @param games Number of games in the batch.
+ * @param dealMode Dealing mode.
+ * @param seed Random seed.
+ * @throws std::invalid_argument if the table size is out of range or the batch is too small.
+ */
+BatchDealer::BatchDealer(size_t tableSize, size_t games, DealMode dealMode, uint64_t seed)
+    : seats(tableSize), mode(dealMode) {
+    if (tableSize < 2 || tableSize > 6) throw std::invalid_argument("Table size must be 2 to 6");
+    if (games == 0) throw std::invalid_argument("Batch must contain games");
+    strata = compositions(tableSize);
+    for (const auto& comp : strata) probabilities.push_back(compositionProbability(comp));
+    std::mt19937_64 rng(seed);
+    deals.reserve(games);
+
+    if (mode == DealMode::Independent) {
+        std::uniform_int_distribution<int> dist(0, ROLE_COUNT - 1);
+        for (size_t g = 0; g < games; ++g) {
+            Deal d;
+            for (size_t s = 0; s < seats; ++s) d.roles.push_back(ROLES[dist(rng)]);
+            d.weight = 1.0 / static_cast<double>(games);
+            d.stratum = stratumOf(d.roles);
+            deals.push_back(std::move(d));
+        }
+        return;
+    }
+
+    if (games < strata.size())
+        throw std::invalid_argument("Stratified dealing needs at least " + std::to_string(strata.size()) +
+                                    " games for tables of " + std::to_string(tableSize));
+    // One game per composition, the rest proportional to probability (largest remainders)
+    size_t spare = games - strata.size();
+    std::vector<size_t> counts(strata.size(), 1);
+    std::vector<std::pair<double, size_t>> remainders;
+    size_t given = 0;
+    for (size_t h = 0; h < strata.size(); ++h) {
+        double exact = static_cast<double>(spare) * probabilities[h];
+        size_t whole = static_cast<size_t>(exact);
+        counts[h] += whole;
+        given += whole;
+        remainders.emplace_back(exact - static_cast<double>(whole), h);
+    }
+    std::sort(remainders.begin(), remainders.end(), [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (size_t i = 0; given < spare; ++i, ++given) ++counts[remainders[i].second];
+
+    // Within a composition: random base arrangement, rotated one seat per game
+    for (size_t h = 0; h < strata.size(); ++h) {
+        std::vector<Role> base = strata[h];
+        std::shuffle(base.begin(), base.end(), rng);
+        for (size_t j = 0; j < counts[h]; ++j) {
+            Deal d;
+            d.roles.resize(seats);
+            for (size_t s = 0; s < seats; ++s) d.roles[s] = base[(s + j) % seats];
+            d.weight = probabilities[h] / static_cast<double>(counts[h]);
+            d.stratum = h;
+            deals.push_back(std::move(d));
+        }
+    }
+    // Interleave strata so a partially played batch is still spread over compositions
+    std::shuffle(deals.begin(), deals.end(), rng);
+}
+
+/**
+ * @brief Finds the stratum (composition index) of a seat assignment.
+ * @param roles Role per seat.
+ */
+size_t BatchDealer::stratumOf(std::vector<Role> roles) const {
+    std::sort(roles.begin(), roles.end());
+    return static_cast<size_t>(std::lower_bound(strata.begin(), strata.end(), roles) - strata.begin());
+}
+
+/**
+ * @brief Estimates the win rate of every role from a dealt batch and its results.
+ * @param dealer The dealer that dealt the batch.
+ * @param results Result of each game, in deal order.
+ * @return One estimate per role.
+ * @throws std::invalid_argument if the number of results does not match the batch.
+ */
+std::vector<RoleEstimate> estimateRoleWinRates(const BatchDealer& dealer, const std::vector<GameResult>& results) {
+    const std::vector<Deal>& deals = dealer.getDeals();
+    if (results.size() != deals.size()) throw std::invalid_argument("One result per dealt game is required");
+    const double n = static_cast<double>(deals.size());
+    std::vector<RoleEstimate> out;
+    for (Role role : ROLES) {
+        RoleEstimate est;
+        est.role = role;
+        est.games = deals.size();
+        if (dealer.getMode() == DealMode::Independent) {
+            double sum = 0, sumSq = 0;
+            for (const GameResult& r : results) {
+                double y = r.winnerRole == role ? 1.0 : 0.0;
+                sum += y;
+                sumSq += y * y;
+            }
+            est.winRate = sum / n;
+            double s2 = n > 1 ? (sumSq - sum * sum / n) / (n - 1) : 0.0;
+            est.variance = s2 / n;
+        } else {
+            // Per-stratum sums; strata with a single game borrow the pooled within-stratum variance
+            std::vector<double> cnt(dealer.strataCount(), 0), sum(dealer.strataCount(), 0), sumSq(dealer.strataCount(), 0);
+            for (size_t i = 0; i < deals.size(); ++i) {
+                double y = results[i].winnerRole == role ? 1.0 : 0.0;
+                est.winRate += deals[i].weight * y;
+                cnt[deals[i].stratum] += 1;
+                sum[deals[i].stratum] += y;
+                sumSq[deals[i].stratum] += y * y;
+            }
+            double pooledNum = 0, pooledDen = 0;
+            for (size_t h = 0; h < cnt.size(); ++h) {
+                if (cnt[h] < 2) continue;
+                pooledNum += sumSq[h] - sum[h] * sum[h] / cnt[h];
+                pooledDen += cnt[h] - 1;
+            }
+            double pooled = pooledDen > 0 ? pooledNum / pooledDen : 0.0;
+            for (size_t h = 0; h < cnt.size(); ++h) {
+                if (cnt[h] == 0) continue;
+                double s2 = cnt[h] >= 2 ? (sumSq[h] - sum[h] * sum[h] / cnt[h]) / (cnt[h] - 1) : pooled;
+                double w = dealer.stratumProbability(h);
+                est.variance += w * w * s2 / cnt[h];
+            }
+        }
+        out.push_back(est);
+    }
+    return out;
+}
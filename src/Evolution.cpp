@@ -0,0 +1,155 @@
+// orel2744@gmail.com
+// Evolution.cpp - Genetic algorithm over HeuristicBot weights with parallel, allocation-free fitness.
+#include "Evolution.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+const size_t GAMES_PER_TASK = 16;  // games a worker claims at once
+
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+}
+
+/**
+ * @brief Creates the first population: the baseline, then random genomes.
+ * @param cfg Size and operators.
+ * @throws std::invalid_argument if the population, games, seats, elite or tournament are out of range.
+ */
+Evolution::Evolution(const EvolutionConfig& cfg) : config(cfg), rng(cfg.seed) {
+    if (config.population < 2) throw std::invalid_argument("Population needs at least 2 genomes");
+    if (config.gamesPerGenome == 0 || config.maxActions == 0) throw std::invalid_argument("Games and action cap must be positive");
+    if (config.seats < 2 || config.seats > LaneState::MAX_SEATS) throw std::invalid_argument("A game has 2 to 6 seats");
+    if (config.elite >= config.population) throw std::invalid_argument("Elite must be smaller than the population");
+    if (config.tournament == 0) throw std::invalid_argument("Tournament needs at least 1 genome");
+    if (config.threads == 0) config.threads = std::max(1u, std::thread::hardware_concurrency());
+    config.baseline.clamp();
+    dealt = LaneState::deal(std::vector<Role>(static_cast<size_t>(config.seats), Role::Governor));
+    evaluated.reserve(config.population);
+    offspring.resize(config.population);
+    wins.reset(new std::atomic<uint32_t>[config.population]);
+    offspring[0].weights = config.baseline;
+    for (size_t i = 1; i < offspring.size(); ++i) offspring[i].weights = BotWeights::random(rng);
+}
+
+/**
+ * @brief Plays `games` games per genome on all cores; genome i's wins are added to out[i].
+ *        Game g deals the same roles and uses the same random stream for every genome; the genome
+ *        sits at seat g % seats.
+ */
+void Evolution::evaluate(const Genome* genomes, size_t count, size_t games, uint64_t seed, std::atomic<uint32_t>* out) const {
+    const size_t tasksPerGenome = (games + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+    const size_t tasks = count * tasksPerGenome;
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        const BotWeights* bots[LaneState::MAX_SEATS];
+        std::uniform_int_distribution<int> role(0, 5);
+        for (size_t task; (task = next.fetch_add(1, std::memory_order_relaxed)) < tasks;) {
+            const size_t genome = task / tasksPerGenome;
+            const size_t first = (task % tasksPerGenome) * GAMES_PER_TASK, last = std::min(games, first + GAMES_PER_TASK);
+            uint32_t won = 0;
+            for (size_t g = first; g < last; ++g) {
+                std::mt19937_64 stream(mix(seed ^ mix(g)));
+                LaneState state = dealt;
+                const int seat = static_cast<int>(g % static_cast<size_t>(config.seats));
+                for (int p = 0; p < config.seats; ++p) {
+                    state.role[p] = static_cast<uint8_t>(role(stream));
+                    bots[p] = p == seat ? &genomes[genome].weights : &config.baseline;
+                }
+                won += playHeuristicGame(state, bots, stream, config.maxActions) == seat;
+            }
+            out[genome].fetch_add(won, std::memory_order_relaxed);
+        }
+    };
+    const unsigned threads = static_cast<unsigned>(std::min<size_t>(config.threads, tasks));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+}
+
+/**
+ * @brief Evaluates the population, sorts it best first, then breeds the next one.
+ * @return The evaluated generation's summary.
+ */
+GenerationStats Evolution::step() {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < offspring.size(); ++i) wins[i].store(0, std::memory_order_relaxed);
+    evaluate(offspring.data(), offspring.size(), config.gamesPerGenome, mix(config.seed + static_cast<uint64_t>(generations)), wins.get());
+
+    GenerationStats stats;
+    stats.generation = generations++;
+    stats.games = static_cast<uint64_t>(offspring.size() * config.gamesPerGenome);
+    for (size_t i = 0; i < offspring.size(); ++i) {
+        offspring[i].fitness = static_cast<double>(wins[i].load()) / static_cast<double>(config.gamesPerGenome);
+        stats.mean += offspring[i].fitness / static_cast<double>(offspring.size());
+    }
+    std::sort(offspring.begin(), offspring.end(), [](const Genome& a, const Genome& b) { return a.fitness > b.fitness; });
+    stats.best = offspring[0].fitness;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    // Both buffers were reserved up front, so swapping and refilling them never allocates
+    std::swap(evaluated, offspring);
+    offspring.resize(evaluated.size());
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+    for (size_t i = 0; i < offspring.size(); ++i) {
+        if (i < config.elite) {
+            offspring[i] = evaluated[i];
+            continue;
+        }
+        const Genome& mother = select();
+        const Genome& father = select();
+        BotWeights& child = offspring[i].weights;
+        for (int g = 0; g < BotWeights::COUNT; ++g) {
+            child[g] = unit(rng) < 0.5 ? mother.weights[g] : father.weights[g];
+            if (unit(rng) < config.mutationRate) {
+                const float range = BotWeights::highest(g) - BotWeights::lowest(g);
+                child[g] += gaussian(rng) * static_cast<float>(config.mutationScale) * range;
+            }
+        }
+        child.clamp();
+        offspring[i].fitness = 0.0;
+    }
+    return stats;
+}
+
+/**
+ * @brief Draws `tournament` genomes of the evaluated population and returns the fittest.
+ */
+const Genome& Evolution::select() {
+    std::uniform_int_distribution<size_t> pick(0, evaluated.size() - 1);
+    size_t winner = pick(rng);
+    for (size_t i = 1; i < config.tournament; ++i) winner = std::min(winner, pick(rng));  // sorted: lower is fitter
+    return evaluated[winner];
+}
+
+/**
+ * @brief Returns the best genome of the last evaluated generation.
+ * @throws std::logic_error before the first step().
+ */
+const Genome& Evolution::best() const {
+    if (evaluated.empty()) throw std::logic_error("No generation has been evaluated yet");
+    return evaluated[0];
+}
+
+/**
+ * @brief Measures a bot's win rate against the baseline on all cores.
+ * @param weights The bot.
+ * @param games Games to play (seats rotate).
+ * @param seed Seed of the deals and random streams.
+ */
+double Evolution::winRate(const BotWeights& weights, size_t games, uint64_t seed) const {
+    if (games == 0) return 0.0;
+    Genome genome;
+    genome.weights = weights;
+    std::atomic<uint32_t> won{0};
+    evaluate(&genome, 1, games, mix(seed), &won);
+    return static_cast<double>(won.load()) / static_cast<double>(games);
+}
@@ -7,12 +7,16 @@
 #include "General.hpp"
 #include "Judge.hpp"
 #include "Merchant.hpp"
+#include "Trace.hpp"
 #include <stdexcept>
 #include <algorithm>
 #include <random>
 #include <ctime>
+#include <iostream>
 
-Game::Game() : bank(50) {}
+Game::Game() : bank(50) {
+    hashValue = computeHash();
+}
 Game::~Game() = default;
 Game::Game(const Game& other) = default;
 Game& Game::operator=(const Game& other) = default;
@@ -24,8 +28,14 @@ Game& Game::operator=(const Game& other) = default;
  */
 void Game::addPlayer(Player* p) {
     if (!p) throw std::invalid_argument("Null player");
+    p->seat = static_cast<int>(players.size());
     players.push_back(p);
-    if (currentTurnIndex == -1) currentTurnIndex = 0;
+    toggleHash(ZobristField::Role, p->seat, static_cast<int>(p->role));
+    toggleHash(ZobristField::Coins, p->seat, p->coins);
+    toggleHash(ZobristField::Alive, p->seat, p->alive ? 1 : 0);
+    toggleHash(ZobristField::Extra, p->seat, p->extraAction ? 1 : 0);
+    toggleHash(ZobristField::Pending, p->seat, static_cast<int>(p->pendingAction));
+    if (currentTurnIndex == -1) setTurnIndex(0);
 }
 
 /**
@@ -64,25 +74,207 @@ std::vector<std::string> Game::playersNames() const {
     return names;
 }
 
+/**
+ * @brief Returns the player sitting in a seat.
+ * @param seat Zero-based seat index.
+ * @return Pointer to the player.
+ * @throws std::out_of_range if the seat does not exist.
+ */
+Player* Game::playerAt(int seat) const {
+    if (seat < 0 || static_cast<size_t>(seat) >= players.size()) throw std::out_of_range("No such seat.");
+    return players[seat];
+}
+
+/**
+ * @brief Returns the stream action messages go to.
+ * @return std::cout when logging is on, otherwise a stream that discards everything. The discard stream is
+ *         per thread: every write sets its badbit, so one shared stream would be written by games on many threads.
+ */
+std::ostream& Game::log() const {
+    thread_local std::ostream discard(nullptr);
+    return logging ? std::cout : discard;
+}
+
+namespace {
+// Helpers converting the Player*-keyed logs to seat-keyed pairs and back
+template <typename V>
+std::vector<std::pair<int, int>> toSeats(const std::unordered_map<Player*, V>& m) {
+    std::vector<std::pair<int, int>> out;
+    out.reserve(m.size());
+    for (const auto& kv : m) out.emplace_back(kv.first->getSeat(), static_cast<int>(kv.second));
+    return out;
+}
+
+std::vector<std::pair<int, int>> toSeats(const std::unordered_map<Player*, Player*>& m) {
+    std::vector<std::pair<int, int>> out;
+    out.reserve(m.size());
+    for (const auto& kv : m) out.emplace_back(kv.first->getSeat(), kv.second->getSeat());
+    return out;
+}
+
+// The value a log entry contributes to the hash: turn indices as is, coup marks as 1, players as their seat
+int hashed(int v) { return v; }
+int hashed(bool) { return 1; }
+int hashed(const Player* p) { return p->getSeat(); }
+}
+
+/**
+ * @brief Sets a log entry, replacing the old entry's key in the hash with the new one.
+ * @param log The log.
+ * @param field The log's hash field.
+ * @param key The player the entry belongs to.
+ * @param value The entry.
+ */
+template <typename V>
+void Game::putLog(std::unordered_map<Player*, V>& log, ZobristField field, Player* key, V value) {
+    auto it = log.find(key);
+    if (it != log.end()) {
+        toggleHash(field, key->seat, hashed(it->second));
+        it->second = value;
+    } else {
+        log.emplace(key, value);
+    }
+    toggleHash(field, key->seat, hashed(value));
+}
+
+/**
+ * @brief Erases a log entry (if any) and its key from the hash.
+ * @param log The log.
+ * @param field The log's hash field.
+ * @param key The player the entry belongs to.
+ */
+template <typename V>
+void Game::eraseLog(std::unordered_map<Player*, V>& log, ZobristField field, Player* key) {
+    auto it = log.find(key);
+    if (it == log.end()) return;
+    toggleHash(field, key->seat, hashed(it->second));
+    log.erase(it);
+}
+
+/**
+ * @brief Sets currentTurnIndex and updates the hash.
+ * @param index The new turn index.
+ */
+void Game::setTurnIndex(int index) {
+    toggleHash(ZobristField::Turn, -1, currentTurnIndex);
+    currentTurnIndex = index;
+    toggleHash(ZobristField::Turn, -1, currentTurnIndex);
+}
+
+/**
+ * @brief Recomputes the hash from scratch.
+ * @return The hash hash() must equal.
+ */
+uint64_t Game::computeHash() const {
+    uint64_t h = zobristKey(ZobristField::Bank, -1, bank) ^ zobristKey(ZobristField::Turn, -1, currentTurnIndex);
+    for (const Player* p : players) {
+        h ^= zobristKey(ZobristField::Role, p->seat, static_cast<int>(p->role));
+        h ^= zobristKey(ZobristField::Coins, p->seat, p->coins);
+        h ^= zobristKey(ZobristField::Alive, p->seat, p->alive ? 1 : 0);
+        h ^= zobristKey(ZobristField::Extra, p->seat, p->extraAction ? 1 : 0);
+        h ^= zobristKey(ZobristField::Pending, p->seat, static_cast<int>(p->pendingAction));
+    }
+    auto add = [&h](const auto& log, ZobristField field) {
+        for (const auto& kv : log) h ^= zobristKey(field, kv.first->getSeat(), hashed(kv.second));
+    };
+    add(sanctions, ZobristField::Sanction);
+    add(arrestBlocks, ZobristField::ArrestBlock);
+    add(coupBlocks, ZobristField::CoupBlock);
+    add(bribeLog, ZobristField::Bribe);
+    add(taxLog, ZobristField::Tax);
+    add(arrestLog, ZobristField::ArrestTarget);
+    add(recentCoupTargets, ZobristField::CoupTarget);
+    add(attemptedCoup, ZobristField::CoupAttempt);
+    return h;
+}
+
+/**
+ * @brief Captures the complete mutable state of the game and its players.
+ * @return Seat-indexed snapshot.
+ */
+GameSnapshot Game::snapshot() const {
+    GameSnapshot snap;
+    snap.seats.reserve(players.size());
+    for (const Player* p : players) {
+        snap.seats.push_back({p->coins, p->alive, p->extraAction, static_cast<int>(p->pendingAction)});
+    }
+    snap.currentTurnIndex = currentTurnIndex;
+    snap.bank = bank;
+    snap.sanctions = toSeats(sanctions);
+    snap.arrestBlocks = toSeats(arrestBlocks);
+    snap.coupBlocks = toSeats(coupBlocks);
+    snap.bribeLog = toSeats(bribeLog);
+    snap.taxLog = toSeats(taxLog);
+    for (const auto& kv : recentCoupTargets) snap.recentCoupTargets.push_back(kv.first->getSeat());
+    snap.attemptedCoup = toSeats(attemptedCoup);
+    snap.arrestLog = toSeats(arrestLog);
+    return snap;
+}
+
+/**
+ * @brief Restores a snapshot taken from this game (or one seated the same way).
+ * @param snap The snapshot to restore.
+ * @throws std::invalid_argument if the snapshot has a different number of seats.
+ */
+void Game::restore(const GameSnapshot& snap) {
+    if (snap.seats.size() != players.size()) throw std::invalid_argument("Snapshot does not match the game's seats.");
+    for (size_t i = 0; i < players.size(); ++i) {
+        Player* p = players[i];
+        p->coins = snap.seats[i].coins;
+        p->alive = snap.seats[i].alive;
+        p->extraAction = snap.seats[i].extraAction;
+        p->pendingAction = static_cast<Player::PendingAction>(snap.seats[i].pendingAction);
+    }
+    currentTurnIndex = snap.currentTurnIndex;
+    bank = snap.bank;
+    auto fill = [this](std::unordered_map<Player*, int>& m, const std::vector<std::pair<int, int>>& v) {
+        m.clear();
+        for (const auto& kv : v) m[players[kv.first]] = kv.second;
+    };
+    fill(sanctions, snap.sanctions);
+    fill(arrestBlocks, snap.arrestBlocks);
+    fill(coupBlocks, snap.coupBlocks);
+    fill(bribeLog, snap.bribeLog);
+    fill(taxLog, snap.taxLog);
+    recentCoupTargets.clear();
+    for (int seat : snap.recentCoupTargets) recentCoupTargets[players[seat]] = true;
+    attemptedCoup.clear();
+    for (const auto& kv : snap.attemptedCoup) attemptedCoup[players[kv.first]] = players[kv.second];
+    arrestLog.clear();
+    for (const auto& kv : snap.arrestLog) arrestLog[players[kv.first]] = players[kv.second];
+    // Snapshots do not record the elimination order: keep the known order, then seats in seat order
+    eliminations.erase(std::remove_if(eliminations.begin(), eliminations.end(), [this](int s) { return players[s]->isAlive(); }),
+                       eliminations.end());
+    for (size_t i = 0; i < players.size(); ++i) {
+        int seat = static_cast<int>(i);
+        if (!players[i]->isAlive() && std::find(eliminations.begin(), eliminations.end(), seat) == eliminations.end())
+            eliminations.push_back(seat);
+    }
+    hashValue = computeHash();
+}
+
 /**
  * @brief Advances the turn to the next alive player and clears temporary effects.
  */
 void Game::nextTurn() {
+    TraceScope trace("Game::nextTurn");
     if (players.empty()) return;
     // Remember the player whose turn just ended
     Player* prev = players[currentTurnIndex];
     // advance to next alive player
+    int index = currentTurnIndex;
     do {
-        currentTurnIndex = (currentTurnIndex + 1) % players.size();
-    } while (!players[currentTurnIndex]->isAlive());
+        index = (index + 1) % static_cast<int>(players.size());
+    } while (!players[index]->isAlive());
+    setTurnIndex(index);
     // Clear sanction for the player who just finished their turn
-    sanctions.erase(prev);
+    eraseLog(sanctions, ZobristField::Sanction, prev);
     Player* next = players[currentTurnIndex];
-    arrestBlocks.erase(next);
-    coupBlocks.erase(next);
+    eraseLog(arrestBlocks, ZobristField::ArrestBlock, next);
+    eraseLog(coupBlocks, ZobristField::CoupBlock, next);
     clearCoupMarks();
-    bribeLog.erase(next);  // clear bribe logs at new turn (now for next player)
-    taxLog.erase(next);    // clear tax logs at new turn (now for next player)
+    eraseLog(bribeLog, ZobristField::Bribe, next);  // clear bribe logs at new turn (now for next player)
+    eraseLog(taxLog, ZobristField::Tax, next);      // clear tax logs at new turn (now for next player)
 }
 
 /**
@@ -92,20 +284,34 @@ void Game::nextTurn() {
  */
 void Game::eliminate(Player* p) {
     if (!p || !p->isAlive()) throw std::logic_error("Cannot eliminate.");
+    TraceScope trace("Game::eliminate");
     // If the eliminated player is the current player, advance the turn
     if (currentPlayer() == p) {
         nextTurn();
     }
     p->eliminate();
+    eliminations.erase(std::remove(eliminations.begin(), eliminations.end(), p->getSeat()), eliminations.end());
+    eliminations.push_back(p->getSeat());
     // Remove from all logs and blocks
-    sanctions.erase(p);
-    arrestBlocks.erase(p);
-    coupBlocks.erase(p);
-    recentCoupTargets.erase(p);
-    attemptedCoup.erase(p);
-    arrestLog.erase(p);
-    taxLog.erase(p);
-    bribeLog.erase(p);
+    eraseLog(sanctions, ZobristField::Sanction, p);
+    eraseLog(arrestBlocks, ZobristField::ArrestBlock, p);
+    eraseLog(coupBlocks, ZobristField::CoupBlock, p);
+    eraseLog(recentCoupTargets, ZobristField::CoupTarget, p);
+    eraseLog(attemptedCoup, ZobristField::CoupAttempt, p);
+    eraseLog(arrestLog, ZobristField::ArrestTarget, p);
+    eraseLog(taxLog, ZobristField::Tax, p);
+    eraseLog(bribeLog, ZobristField::Bribe, p);
+}
+
+/**
+ * @brief Returns the seats that are out, in the order they were eliminated.
+ */
+std::vector<int> Game::getEliminationOrder() const {
+    std::vector<int> order;
+    for (int seat : eliminations) {
+        if (!players[seat]->isAlive()) order.push_back(seat);
+    }
+    return order;
 }
 
 /**
@@ -141,7 +347,7 @@ bool Game::isPlayerTurn(Player* p) const {
  */
 void Game::applySanction(Player* target) {
     if (!target || !target->isAlive()) throw std::logic_error("Invalid sanction target");
-    sanctions[target] = currentTurnIndex;
+    putLog(sanctions, ZobristField::Sanction, target, currentTurnIndex);
 }
 
 /**
@@ -171,7 +377,7 @@ Player* Game::getPlayer(const std::string& name) {
  * @param target Pointer to the player to protect.
  */
 void Game::blockArrest(Player* target) {
-    arrestBlocks[target] = currentTurnIndex;
+    putLog(arrestBlocks, ZobristField::ArrestBlock, target, currentTurnIndex);
 }
 
 /**
@@ -188,7 +394,7 @@ bool Game::isArrestBlocked(Player* target) const {
  * @param target Pointer to the player to protect.
  */
 void Game::blockCoup(Player* target) {
-    coupBlocks[target] = currentTurnIndex;
+    putLog(coupBlocks, ZobristField::CoupBlock, target, currentTurnIndex);
 }
 
 /**
@@ -205,7 +411,7 @@ bool Game::isCoupBlocked(Player* target) const {
  * @param p Pointer to the player.
  */
 void Game::markBribe(Player* p) {
-    bribeLog[p] = currentTurnIndex;
+    putLog(bribeLog, ZobristField::Bribe, p, currentTurnIndex);
 }
 
 /**
@@ -224,7 +430,7 @@ bool Game::wasBribeUsedBy(Player* p) const {
  * @param p Pointer to the player.
  */
 void Game::cancelBribe(Player* p) {
-    bribeLog.erase(p);
+    eraseLog(bribeLog, ZobristField::Bribe, p);
     p->clearExtraAction();
 }
 
@@ -233,7 +439,9 @@ void Game::cancelBribe(Player* p) {
  * @param amount Number of coins to add.
  */
 void Game::addCoinsToBank(int amount) {
+    toggleHash(ZobristField::Bank, -1, bank);
     bank += amount;
+    toggleHash(ZobristField::Bank, -1, bank);
 }
 
 /**
@@ -241,7 +449,7 @@ void Game::addCoinsToBank(int amount) {
  * @param target Pointer to the player.
  */
 void Game::markCoupTarget(Player* target) {
-    recentCoupTargets[target] = true;
+    putLog(recentCoupTargets, ZobristField::CoupTarget, target, true);
 }
 
 /**
@@ -257,6 +465,7 @@ bool Game::wasCoupTargeted(Player* target) const {
  * @brief Clears all coup target marks for the new turn.
  */
 void Game::clearCoupMarks() {
+    for (const auto& kv : recentCoupTargets) toggleHash(ZobristField::CoupTarget, kv.first->seat, hashed(kv.second));
     recentCoupTargets.clear();
 }
 
@@ -266,7 +475,7 @@ void Game::clearCoupMarks() {
  * @param target Pointer to the target player.
  */
 void Game::registerCoupAttempt(Player* attacker, Player* target) {
-    attemptedCoup[target] = attacker;
+    putLog(attemptedCoup, ZobristField::CoupAttempt, target, attacker);
 }
 
 /**
@@ -283,7 +492,7 @@ bool Game::canBlockCoup(Player* target) {
  * @param target Pointer to the player.
  */
 void Game::cancelCoup(Player* target) {
-    attemptedCoup.erase(target);
+    eraseLog(attemptedCoup, ZobristField::CoupAttempt, target);
 }
 
 /**
@@ -292,7 +501,7 @@ void Game::cancelCoup(Player* target) {
  * @param target Pointer to the player who was arrested.
  */
 void Game::markArrest(Player* from, Player* target) {
-    arrestLog[from] = target;
+    putLog(arrestLog, ZobristField::ArrestTarget, from, target);
 }
 
 /**
@@ -311,7 +520,7 @@ bool Game::wasArrestedByMeLastTurn(Player* source, Player* target) const {
  * @param p Pointer to the player.
  */
 void Game::markTax(Player* p) {
-    taxLog[p] = currentTurnIndex;
+    putLog(taxLog, ZobristField::Tax, p, currentTurnIndex);
 }
 
 /**
@@ -333,7 +542,7 @@ void Game::cancelTax(Player* p) {
     if (!wasTaxUsedBy(p)) return;
     int amount = (p->getRole() == Role::Governor) ? 3 : 2;
     p->removeCoins(amount);
-    taxLog.erase(p);
+    eraseLog(taxLog, ZobristField::Tax, p);
 }
 
 /**
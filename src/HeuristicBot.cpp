@@ -0,0 +1,138 @@
+// orel2744@gmail.com
+// HeuristicBot.cpp - A weighted rule-of-thumb bot over LaneState.
+#include "HeuristicBot.hpp"
+#include <algorithm>
+
+namespace {
+const float LOWEST[BotWeights::COUNT] = {0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 3};
+const float HIGHEST[BotWeights::COUNT] = {1, 1, 1, 1, 1, 1, 10, 1, 1, 1, 1, 9};
+
+// Picks the richest alive opponent (lowest seat on ties) with probability `richest`, otherwise a random one
+int pickTarget(const LaneState& s, int me, float richest, std::mt19937_64& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    int best = -1, count = 0;
+    for (int p = 0; p < s.seats; ++p) {
+        if (p == me || !s.alive[p]) continue;
+        ++count;
+        if (best < 0 || s.coins[p] > s.coins[best]) best = p;
+    }
+    if (count <= 1 || unit(rng) < richest) return best;
+    int pick = std::uniform_int_distribution<int>(0, count - 1)(rng);
+    for (int p = 0; p < s.seats; ++p) {
+        if (p == me || !s.alive[p]) continue;
+        if (pick-- == 0) return p;
+    }
+    return best;
+}
+}
+
+float BotWeights::lowest(int g) { return LOWEST[g]; }
+
+float BotWeights::highest(int g) { return HIGHEST[g]; }
+
+/**
+ * @brief Returns weights close to the habits of chooseSimpleAction.
+ */
+BotWeights BotWeights::defaults() {
+    BotWeights w;
+    w[Tax] = 0.35f;
+    w[Gather] = 0.25f;
+    w[Arrest] = 0.15f;
+    w[Sanction] = 0.10f;
+    w[Bribe] = 0.0f;
+    w[Invest] = 0.5f;
+    w[CoupAt] = 7.0f;
+    w[CoupChance] = 0.6f;
+    w[CoupRichest] = 0.0f;
+    w[ArrestRichest] = 0.0f;
+    w[SanctionRichest] = 0.0f;
+    w[SanctionReserve] = 3.0f;
+    return w;
+}
+
+/**
+ * @brief Returns weights drawn uniformly within every gene's range.
+ * @param rng Random source.
+ */
+BotWeights BotWeights::random(std::mt19937_64& rng) {
+    BotWeights w;
+    for (int g = 0; g < COUNT; ++g) w[g] = std::uniform_real_distribution<float>(LOWEST[g], HIGHEST[g])(rng);
+    return w;
+}
+
+/**
+ * @brief Clamps every gene into its range.
+ */
+void BotWeights::clamp() {
+    for (int g = 0; g < COUNT; ++g) gene[g] = std::min(HIGHEST[g], std::max(LOWEST[g], gene[g]));
+}
+
+/**
+ * @brief Picks an action for the seat to act, weighing its options by the bot's weights.
+ * @param state The game (must have a seat to act).
+ * @param weights The bot.
+ * @param rng Random source.
+ */
+Action chooseHeuristicAction(const LaneState& state, const BotWeights& weights, std::mt19937_64& rng) {
+    const int me = state.currentSeat();
+    const int coins = state.coins[me];
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    if (coins >= 10 || (coins >= weights[BotWeights::CoupAt] && unit(rng) < weights[BotWeights::CoupChance]))
+        return {ActionType::Coup, me, pickTarget(state, me, weights[BotWeights::CoupRichest], rng)};
+
+    bool opponentHasCoins = false;
+    for (int p = 0; p < state.seats; ++p) opponentHasCoins |= p != me && state.alive[p] && state.coins[p] > 0;
+    const ActionType types[] = {ActionType::Tax, ActionType::Gather, ActionType::Arrest,
+                                ActionType::Sanction, ActionType::Bribe, ActionType::Invest};
+    float score[6] = {
+        weights[BotWeights::Tax],
+        weights[BotWeights::Gather],
+        opponentHasCoins ? weights[BotWeights::Arrest] : 0.0f,
+        coins >= weights[BotWeights::SanctionReserve] ? weights[BotWeights::Sanction] : 0.0f,
+        coins >= 4 ? weights[BotWeights::Bribe] : 0.0f,
+        state.role[me] == static_cast<uint8_t>(Role::Baron) && coins >= 3 ? weights[BotWeights::Invest] : 0.0f,
+    };
+    float total = 0.0f;
+    for (float s : score) total += s;
+    Action a{ActionType::Gather, me, -1};
+    if (total <= 0.0f) return a;
+    float u = unit(rng) * total;
+    for (int i = 0; i < 6; ++i) {
+        if (score[i] <= 0.0f) continue;
+        a.type = types[i];
+        if ((u -= score[i]) < 0.0f) break;
+    }
+    if (a.type == ActionType::Arrest) a.target = pickTarget(state, me, weights[BotWeights::ArrestRichest], rng);
+    if (a.type == ActionType::Sanction) a.target = pickTarget(state, me, weights[BotWeights::SanctionRichest], rng);
+    return a;
+}
+
+/**
+ * @brief Plays one game to completion (or to the action cap) with a bot per seat.
+ * @param state The dealt game; played in place.
+ * @param bots One bot per seat.
+ * @param rng Random source.
+ * @param maxActions Cap on attempted actions.
+ * @param eliminationOrder If non-null, receives the seats that are out at the end, in elimination order.
+ * @return The winning seat, or -1 if the cap was hit.
+ */
+int playHeuristicGame(LaneState& state, const BotWeights* const* bots, std::mt19937_64& rng, size_t maxActions,
+                      std::vector<int>* eliminationOrder) {
+    if (eliminationOrder) eliminationOrder->clear();
+    for (size_t n = 0; n < maxActions && state.winner() < 0; ++n) {
+        const int me = state.currentSeat();
+        if (me < 0) break;
+        uint8_t wasAlive[LaneState::MAX_SEATS];
+        if (eliminationOrder) std::copy(state.alive, state.alive + LaneState::MAX_SEATS, wasAlive);
+        Action a = chooseHeuristicAction(state, *bots[me], rng);
+        if (!state.apply(a) && !state.apply({ActionType::Gather, me, -1})) state.apply({ActionType::SkipTurn, me, -1});
+        if (!eliminationOrder) continue;
+        for (int p = 0; p < state.seats; ++p) {
+            if (wasAlive[p] && !state.alive[p]) eliminationOrder->push_back(p);
+            // A General who blocks the coup against them is back in
+            if (!wasAlive[p] && state.alive[p])
+                eliminationOrder->erase(std::remove(eliminationOrder->begin(), eliminationOrder->end(), p), eliminationOrder->end());
+        }
+    }
+    return state.winner();
+}
@@ -0,0 +1,188 @@
+// orel2744@gmail.com
+// Ismcts.cpp - Single-observer information-set MCTS over LaneState determinisations,
+// root-parallel with per-information-set merging of the workers' trees.
+#include "Ismcts.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+struct Edge {
+    Action action;
+    uint64_t visits = 0;
+    uint64_t available = 0;
+    double reward = 0.0;  ///< Sum of the rewards of the seat that made the move
+};
+
+struct Node {
+    std::vector<Edge> edges;
+
+    size_t edgeFor(const Action& a) {
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (edges[i].action == a) return i;
+        }
+        edges.push_back(Edge{a});
+        return edges.size() - 1;
+    }
+};
+
+// Information set -> node; node references stay valid while the map grows
+using Tree = std::unordered_map<uint64_t, Node>;
+
+struct Step {
+    Node* node;
+    size_t edge;
+    int actor;
+};
+
+/**
+ * @brief Plays one rollout ply: a coup when affordable, otherwise a random accepted action
+ *        (rejection-sampled on copies, falling back to the full list).
+ */
+void rolloutPly(LaneState& s, std::mt19937_64& rng) {
+    const int cur = s.currentSeat();
+    std::uniform_int_distribution<int> seat(0, s.seats - 1);
+    if (s.coins[cur] >= 7) {
+        LaneState copy = s;
+        if (copy.apply({ActionType::Coup, cur, seat(rng)})) {
+            s = copy;
+            return;
+        }
+    }
+    std::uniform_int_distribution<int> type(0, ACTION_TYPE_COUNT - 1);
+    for (int tries = 0; tries < 8; ++tries) {
+        ActionType t = static_cast<ActionType>(type(rng));
+        Action a{t, cur, actionNeedsTarget(t) ? seat(rng) : -1};
+        LaneState copy = s;
+        if (copy.apply(a)) {
+            s = copy;
+            return;
+        }
+    }
+    Action moves[LaneState::MAX_ACTIONS];
+    int n = s.legalActions(moves);
+    if (n > 0) s.apply(moves[std::uniform_int_distribution<int>(0, n - 1)(rng)]);
+}
+
+/**
+ * @brief Runs `iterations` determinised iterations into one worker's tree.
+ */
+void searchWorker(const LaneState& root, const RoleConstraints& knowledge, const IsmctsConfig& config,
+                  uint64_t iterations, uint64_t seed, Tree& tree) {
+    std::mt19937_64 rng(seed);
+    std::vector<Step> path;
+    Action moves[LaneState::MAX_ACTIONS];
+    size_t untried[LaneState::MAX_ACTIONS];
+    for (uint64_t it = 0; it < iterations; ++it) {
+        LaneState s = knowledge.determinise(root, rng);
+        path.clear();
+        int ply = 0;
+        bool expanded = false;
+
+        // Selection and expansion over the observer's information sets
+        while (!expanded && ply < config.maxPlies) {
+            int n = s.legalActions(moves);
+            if (n == 0) break;
+            Node& node = tree[zobristHash(knowledge.hide(s))];
+            int open = 0;
+            for (int i = 0; i < n; ++i) {
+                size_t e = node.edgeFor(moves[i]);
+                ++node.edges[e].available;
+                if (node.edges[e].visits == 0) untried[open++] = e;
+            }
+            size_t pick;
+            if (open > 0) {
+                pick = untried[std::uniform_int_distribution<int>(0, open - 1)(rng)];
+                expanded = true;
+            } else {
+                pick = 0;
+                double bestScore = -1.0;
+                for (int i = 0; i < n; ++i) {
+                    size_t e = node.edgeFor(moves[i]);
+                    const Edge& edge = node.edges[e];
+                    double score = edge.reward / edge.visits +
+                                   config.exploration * std::sqrt(std::log(static_cast<double>(edge.available)) / edge.visits);
+                    if (score > bestScore) bestScore = score, pick = e;
+                }
+            }
+            path.push_back({&node, pick, s.currentSeat()});
+            s.apply(node.edges[pick].action);
+            ++ply;
+        }
+
+        // Rollout
+        while (s.winner() < 0 && ply < config.maxPlies) {
+            rolloutPly(s, rng);
+            ++ply;
+        }
+
+        // Backpropagation: the winner takes 1; at the ply cap the survivors share it
+        double reward[LaneState::MAX_SEATS] = {};
+        int alive = s.aliveCount();
+        for (int p = 0; p < s.seats; ++p) reward[p] = s.alive[p] ? 1.0 / alive : 0.0;
+        for (const Step& step : path) {
+            Edge& edge = step.node->edges[step.edge];
+            ++edge.visits;
+            edge.reward += reward[step.actor];
+        }
+    }
+}
+}
+
+/**
+ * @brief Searches for the observer's move.
+ * @param state The game; the observer must be the seat to act.
+ * @param knowledge The observer's role constraints.
+ * @param config Budget and tuning.
+ * @return The chosen move and root statistics.
+ * @throws std::invalid_argument if the game is over or it is not the observer's turn.
+ */
+IsmctsResult ismctsSearch(const LaneState& state, const RoleConstraints& knowledge, const IsmctsConfig& config) {
+    if (state.winner() >= 0 || state.currentSeat() < 0) throw std::invalid_argument("The game is over");
+    if (state.currentSeat() != knowledge.observer()) throw std::invalid_argument("It is not the observer's turn");
+    auto t0 = std::chrono::steady_clock::now();
+
+    unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(threads, config.determinisations)));
+    std::vector<Tree> trees(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        uint64_t share = config.determinisations / threads + (t < config.determinisations % threads ? 1 : 0);
+        uint64_t seed = config.seed * 0x9E3779B97F4A7C15ULL + t;
+        if (t + 1 < threads) pool.emplace_back(searchWorker, std::cref(state), std::cref(knowledge), std::cref(config), share, seed, std::ref(trees[t]));
+        else searchWorker(state, knowledge, config, share, seed, trees[t]);
+    }
+    for (std::thread& th : pool) th.join();
+
+    // Merge the workers' statistics information set by information set
+    Tree merged = std::move(trees[0]);
+    for (unsigned t = 1; t < threads; ++t) {
+        for (auto& kv : trees[t]) {
+            Node& into = merged[kv.first];
+            for (const Edge& e : kv.second.edges) {
+                Edge& sum = into.edges[into.edgeFor(e.action)];
+                sum.visits += e.visits;
+                sum.available += e.available;
+                sum.reward += e.reward;
+            }
+        }
+        trees[t].clear();
+    }
+
+    IsmctsResult result;
+    result.determinisations = config.determinisations;
+    result.infoSets = merged.size();
+    Node& root = merged[zobristHash(knowledge.hide(state))];
+    for (const Edge& e : root.edges) {
+        result.moves.push_back({e.action, e.visits, e.available, e.visits ? e.reward / e.visits : 0.0});
+    }
+    std::stable_sort(result.moves.begin(), result.moves.end(),
+                     [](const IsmctsMove& a, const IsmctsMove& b) { return a.visits > b.visits; });
+    if (!result.moves.empty()) result.best = result.moves.front().action;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
@@ -0,0 +1,410 @@
+// orel2744@gmail.com
+// LaneState.cpp - Flat game state and the seat-indexed rules engine mirroring Player/Game.
+#include "LaneState.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+const uint8_t PENDING_NONE = 0, PENDING_TAX = 1, PENDING_BRIBE = 2;
+const uint8_t GOVERNOR = static_cast<uint8_t>(Role::Governor), SPY = static_cast<uint8_t>(Role::Spy),
+              BARON = static_cast<uint8_t>(Role::Baron), GENERAL = static_cast<uint8_t>(Role::General),
+              JUDGE = static_cast<uint8_t>(Role::Judge), MERCHANT = static_cast<uint8_t>(Role::Merchant);
+
+/**
+ * @brief Seat-indexed versions of the Game/Player operations the actions are built from.
+ *        Each helper names the method it mirrors.
+ */
+class Rules {
+public:
+    explicit Rules(const LaneRef& g) : g(g), n(*g.seats) {}
+
+    int16_t& coins(int p) const { return g.coins[p * g.stride]; }
+    uint8_t& alive(int p) const { return g.alive[p * g.stride]; }
+    uint8_t& extra(int p) const { return g.extra[p * g.stride]; }
+    uint8_t& pending(int p) const { return g.pending[p * g.stride]; }
+    uint8_t role(int p) const { return g.role[p * g.stride]; }
+    int8_t& sanction(int p) const { return g.sanction[p * g.stride]; }
+    int8_t& arrestBlock(int p) const { return g.arrestBlock[p * g.stride]; }
+    int8_t& coupBlock(int p) const { return g.coupBlock[p * g.stride]; }
+    int8_t& bribe(int p) const { return g.bribe[p * g.stride]; }
+    int8_t& tax(int p) const { return g.tax[p * g.stride]; }
+    int8_t& arrestTarget(int p) const { return g.arrestTarget[p * g.stride]; }
+    int16_t& bank() const { return *g.bank; }
+    int8_t& turn() const { return *g.turn; }
+
+    // Game::currentPlayer (skips eliminated seats)
+    int current() const {
+        int idx = turn();
+        for (int count = 0; !alive(idx); ++count) {
+            if (count >= n) return -1;
+            idx = (idx + 1) % n;
+        }
+        return idx;
+    }
+
+    bool isTurn(int p) const { return current() == p; }
+
+    // Game::nextTurn
+    void nextTurn() const {
+        int prev = turn();
+        int idx = prev;
+        do { idx = (idx + 1) % n; } while (!alive(idx));
+        turn() = static_cast<int8_t>(idx);
+        sanction(prev) = -1;
+        arrestBlock(idx) = -1;
+        coupBlock(idx) = -1;
+        bribe(idx) = -1;
+        tax(idx) = -1;
+    }
+
+    // Player::endTurn
+    void endTurn(int p) const {
+        if (extra(p)) { extra(p) = 0; return; }
+        nextTurn();
+    }
+
+    // Game::eliminate (the eliminated seat is never the current one when reached through an action)
+    void eliminate(int p) const {
+        if (current() == p) nextTurn();
+        alive(p) = 0;
+        sanction(p) = -1;
+        arrestBlock(p) = -1;
+        coupBlock(p) = -1;
+        arrestTarget(p) = -1;
+        tax(p) = -1;
+        bribe(p) = -1;
+    }
+
+    // Merchant::merchantBonus
+    void merchantBonus(int p) const {
+        if (role(p) == MERCHANT && coins(p) >= 3) coins(p) += 1;
+    }
+
+    bool gather(int me) const {
+        if (!alive(me) || !isTurn(me) || sanction(me) >= 0) return false;
+        if (pending(me) != PENDING_NONE) { pending(me) = PENDING_NONE; extra(me) = 0; }
+        merchantBonus(me);
+        if (bank() <= 0) return false;
+        coins(me) += 1;
+        bank() -= 1;
+        endTurn(me);
+        return true;
+    }
+
+    bool taxAction(int me) const {
+        if (!alive(me) || !isTurn(me) || sanction(me) >= 0 || pending(me) != PENDING_NONE) return false;
+        merchantBonus(me);
+        int amount = role(me) == GOVERNOR ? 3 : 2;
+        if (bank() < amount) return false;
+        coins(me) += amount;
+        bank() -= amount;
+        tax(me) = turn();
+        pending(me) = PENDING_TAX;
+        if (!extra(me)) endTurn(me);
+        return true;
+    }
+
+    bool bribeAction(int me) const {
+        if (!alive(me) || !isTurn(me) || bank() < 4 || coins(me) < 4 || extra(me) || pending(me) != PENDING_NONE) return false;
+        coins(me) -= 4;
+        bank() += 4;
+        extra(me) = 1;
+        bribe(me) = turn();
+        pending(me) = PENDING_BRIBE;
+        return true;
+    }
+
+    bool arrest(int me, int t) const {
+        if (!alive(me) || !alive(t) || !isTurn(me) || arrestTarget(me) == t) return false;
+        if (role(t) == SPY && arrestBlock(t) >= 0) return false;
+        arrestTarget(me) = static_cast<int8_t>(t);
+        if (role(t) == GENERAL) { endTurn(me); return true; }
+        if (role(t) == MERCHANT) {
+            if (coins(t) < 2) return false;
+            coins(t) -= 2;
+            bank() += 2;
+            endTurn(me);
+            return true;
+        }
+        if (coins(t) > 0) { coins(t) -= 1; coins(me) += 1; }
+        endTurn(me);
+        return true;
+    }
+
+    bool sanctionAction(int me, int t) const {
+        if (me == t || !alive(me) || !alive(t) || !isTurn(me) || bank() < 3 || coins(me) < 3) return false;
+        if (role(t) == JUDGE) bank() += 1;
+        coins(me) -= 3;
+        bank() += 3;
+        sanction(t) = turn();
+        endTurn(me);
+        return true;
+    }
+
+    bool coup(int me, int t) const {
+        if (me == t || !alive(me) || !alive(t) || !isTurn(me) || bank() < 7 || coins(me) < 7) return false;
+        coins(me) -= 7;
+        bank() += 7;
+        eliminate(t);
+        endTurn(me);
+        return true;
+    }
+
+    bool invest(int me) const {
+        if (role(me) != BARON) return false;
+        if (!alive(me) || !isTurn(me) || coins(me) < 3 || bank() < 3) return false;
+        coins(me) -= 3;
+        bank() += 3;
+        if (bank() < 6) return false;
+        coins(me) += 6;
+        bank() -= 6;
+        endTurn(me);
+        return true;
+    }
+
+    bool spyOn(int me, int t) const {
+        if (role(me) != SPY || !alive(me) || !alive(t) || me == t) return false;
+        arrestBlock(t) = turn();
+        return true;
+    }
+
+    bool preventCoup(int me, int t) const {
+        if (role(me) != GENERAL || !alive(me) || !alive(t) || coins(me) < 5) return false;
+        coins(me) -= 5;
+        coupBlock(t) = turn();
+        endTurn(me);
+        return true;
+    }
+
+    bool judgeBribe(int me, int t) const {
+        if (role(me) != JUDGE || !alive(me) || !alive(t)) return false;
+        if (bribe(t) != turn() || pending(t) != PENDING_BRIBE) return false;
+        extra(t) = 0;
+        pending(t) = PENDING_NONE;
+        bribe(t) = -1;
+        endTurn(t);
+        return true;
+    }
+
+    bool blockTax(int me, int t) const {
+        if (role(me) != GOVERNOR || !alive(me) || !alive(t)) return false;
+        if (tax(t) < 0 || pending(t) != PENDING_TAX) return false;
+        int amount = role(t) == GOVERNOR ? 3 : 2;
+        if (coins(t) < amount) return false;
+        coins(t) -= amount;
+        pending(t) = PENDING_NONE;
+        extra(t) = 0;
+        // Game::cancelTax takes the tax back a second time
+        if (coins(t) < amount) return false;
+        coins(t) -= amount;
+        tax(t) = -1;
+        endTurn(t);
+        return true;
+    }
+
+    bool skipTurn(int me) const {
+        if (!alive(me) || !isTurn(me)) return false;
+        if (extra(me)) { extra(me) = 0; return true; }
+        nextTurn();
+        return true;
+    }
+
+private:
+    const LaneRef& g;
+    int n;
+};
+}
+
+/**
+ * @brief Applies an action to a game through a LaneRef, with exactly the rules of applyAction() on a Game.
+ * @param g The game.
+ * @param a The action.
+ * @return True if the action was accepted.
+ */
+bool applyLaneAction(const LaneRef& g, const Action& a) {
+    const int n = *g.seats;
+    if (a.actor < 0 || a.actor >= n) return false;
+    const bool targeted = actionNeedsTarget(a.type);
+    if (targeted && (a.target < 0 || a.target >= n)) return false;
+    Rules r(g);
+    switch (a.type) {
+        case ActionType::Gather:           return r.gather(a.actor);
+        case ActionType::Tax:              return r.taxAction(a.actor);
+        case ActionType::Bribe:            return r.bribeAction(a.actor);
+        case ActionType::Arrest:           return r.arrest(a.actor, a.target);
+        case ActionType::Sanction:         return r.sanctionAction(a.actor, a.target);
+        case ActionType::Coup:             return r.coup(a.actor, a.target);
+        case ActionType::Invest:           return r.invest(a.actor);
+        case ActionType::SpyOn:            return r.spyOn(a.actor, a.target);
+        case ActionType::PreventCoup:      return r.preventCoup(a.actor, a.target);
+        case ActionType::JudgeBribe:       return r.judgeBribe(a.actor, a.target);
+        case ActionType::GeneralBlockCoup: return false; // attemptedCoup is always empty (see LaneState)
+        case ActionType::BlockTax:         return r.blockTax(a.actor, a.target);
+        case ActionType::SkipTurn:         return r.skipTurn(a.actor);
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the starting state of a game with the given roles.
+ * @param roles Role of each seat (2 to MAX_SEATS).
+ * @throws std::invalid_argument if the number of seats is out of range or a role is Unknown.
+ */
+LaneState LaneState::deal(const std::vector<Role>& roles) {
+    if (roles.size() < 2 || roles.size() > static_cast<size_t>(MAX_SEATS)) throw std::invalid_argument("A lane has 2 to 6 seats");
+    LaneState s;
+    s.seats = static_cast<uint8_t>(roles.size());
+    s.turn = 0;
+    for (int p = 0; p < MAX_SEATS; ++p) {
+        s.sanction[p] = s.arrestBlock[p] = s.coupBlock[p] = s.bribe[p] = s.tax[p] = s.arrestTarget[p] = -1;
+    }
+    for (size_t p = 0; p < roles.size(); ++p) {
+        if (roles[p] == Role::Unknown) throw std::invalid_argument("Cannot deal an Unknown role");
+        s.role[p] = static_cast<uint8_t>(roles[p]);
+        s.alive[p] = 1;
+    }
+    return s;
+}
+
+/**
+ * @brief Copies the state of a Game.
+ * @param game The game (2 to MAX_SEATS seats).
+ * @throws std::invalid_argument if the game has too few or too many seats, or holds coup bookkeeping.
+ */
+LaneState LaneState::fromGame(const Game& game) {
+    std::vector<Role> roles;
+    for (const Player* p : game.getPlayers()) roles.push_back(p->getRole());
+    LaneState s = deal(roles);
+    GameSnapshot snap = game.snapshot();
+    if (!snap.attemptedCoup.empty() || !snap.recentCoupTargets.empty())
+        throw std::invalid_argument("Game holds coup bookkeeping a lane cannot represent");
+    s.turn = static_cast<int8_t>(snap.currentTurnIndex);
+    s.bank = static_cast<int16_t>(snap.bank);
+    for (size_t p = 0; p < snap.seats.size(); ++p) {
+        s.coins[p] = static_cast<int16_t>(snap.seats[p].coins);
+        s.alive[p] = snap.seats[p].alive ? 1 : 0;
+        s.extra[p] = snap.seats[p].extraAction ? 1 : 0;
+        s.pending[p] = static_cast<uint8_t>(snap.seats[p].pendingAction);
+    }
+    for (const auto& kv : snap.sanctions) s.sanction[kv.first] = static_cast<int8_t>(kv.second);
+    for (const auto& kv : snap.arrestBlocks) s.arrestBlock[kv.first] = static_cast<int8_t>(kv.second);
+    for (const auto& kv : snap.coupBlocks) s.coupBlock[kv.first] = static_cast<int8_t>(kv.second);
+    for (const auto& kv : snap.bribeLog) s.bribe[kv.first] = static_cast<int8_t>(kv.second);
+    for (const auto& kv : snap.taxLog) s.tax[kv.first] = static_cast<int8_t>(kv.second);
+    for (const auto& kv : snap.arrestLog) s.arrestTarget[kv.first] = static_cast<int8_t>(kv.second);
+    return s;
+}
+
+/**
+ * @brief Returns the state as a GameSnapshot, to restore into a Game seated with the same roles.
+ */
+GameSnapshot LaneState::toSnapshot() const {
+    GameSnapshot snap;
+    for (int p = 0; p < seats; ++p) {
+        snap.seats.push_back({coins[p], alive[p] != 0, extra[p] != 0, pending[p]});
+        if (sanction[p] >= 0) snap.sanctions.emplace_back(p, sanction[p]);
+        if (arrestBlock[p] >= 0) snap.arrestBlocks.emplace_back(p, arrestBlock[p]);
+        if (coupBlock[p] >= 0) snap.coupBlocks.emplace_back(p, coupBlock[p]);
+        if (bribe[p] >= 0) snap.bribeLog.emplace_back(p, bribe[p]);
+        if (tax[p] >= 0) snap.taxLog.emplace_back(p, tax[p]);
+        if (arrestTarget[p] >= 0) snap.arrestLog.emplace_back(p, arrestTarget[p]);
+    }
+    snap.currentTurnIndex = turn;
+    snap.bank = bank;
+    return snap;
+}
+
+/**
+ * @brief Returns a stride-1 reference to this state.
+ */
+LaneRef LaneState::ref() {
+    LaneRef r;
+    r.stride = 1;
+    r.seats = &seats;
+    r.turn = &turn;
+    r.bank = &bank;
+    r.role = role;
+    r.coins = coins;
+    r.alive = alive;
+    r.extra = extra;
+    r.pending = pending;
+    r.sanction = sanction;
+    r.arrestBlock = arrestBlock;
+    r.coupBlock = coupBlock;
+    r.bribe = bribe;
+    r.tax = tax;
+    r.arrestTarget = arrestTarget;
+    return r;
+}
+
+/**
+ * @brief Returns the seat whose turn it is, or -1 if nobody is alive.
+ */
+int LaneState::currentSeat() const {
+    if (turn < 0) return -1;
+    int idx = turn;
+    for (int count = 0; !alive[idx]; ++count) {
+        if (count >= seats) return -1;
+        idx = (idx + 1) % seats;
+    }
+    return idx;
+}
+
+/**
+ * @brief Lists every action of the seat to act that the rules accept, by applying each to a copy.
+ * @param out Receives up to MAX_ACTIONS actions.
+ * @return Number of actions written.
+ */
+int LaneState::legalActions(Action* out) const {
+    const int cur = currentSeat();
+    if (cur < 0 || winner() >= 0) return 0;
+    int count = 0;
+    for (int t = 0; t < ACTION_TYPE_COUNT; ++t) {
+        ActionType type = static_cast<ActionType>(t);
+        if (type == ActionType::GeneralBlockCoup) continue;
+        bool targeted = actionNeedsTarget(type);
+        for (int target = targeted ? 0 : -1; target < (targeted ? seats : 0); ++target) {
+            LaneState copy = *this;
+            Action a{type, cur, target};
+            if (copy.apply(a)) out[count++] = a;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the number of players still alive.
+ */
+int LaneState::aliveCount() const {
+    int count = 0;
+    for (int p = 0; p < seats; ++p) count += alive[p];
+    return count;
+}
+
+/**
+ * @brief Returns the winning seat when exactly one player is alive, otherwise -1.
+ */
+int LaneState::winner() const {
+    if (aliveCount() != 1) return -1;
+    for (int p = 0; p < seats; ++p) {
+        if (alive[p]) return p;
+    }
+    return -1;
+}
+
+/**
+ * @brief Compares every field (unused seat slots included, which deal() always zeroes).
+ */
+bool LaneState::operator==(const LaneState& o) const {
+    return seats == o.seats && turn == o.turn && bank == o.bank &&
+           std::memcmp(role, o.role, sizeof(role)) == 0 && std::memcmp(coins, o.coins, sizeof(coins)) == 0 &&
+           std::memcmp(alive, o.alive, sizeof(alive)) == 0 && std::memcmp(extra, o.extra, sizeof(extra)) == 0 &&
+           std::memcmp(pending, o.pending, sizeof(pending)) == 0 &&
+           std::memcmp(sanction, o.sanction, sizeof(sanction)) == 0 &&
+           std::memcmp(arrestBlock, o.arrestBlock, sizeof(arrestBlock)) == 0 &&
+           std::memcmp(coupBlock, o.coupBlock, sizeof(coupBlock)) == 0 &&
+           std::memcmp(bribe, o.bribe, sizeof(bribe)) == 0 && std::memcmp(tax, o.tax, sizeof(tax)) == 0 &&
+           std::memcmp(arrestTarget, o.arrestTarget, sizeof(arrestTarget)) == 0;
+}
@@ -0,0 +1,167 @@
+// orel2744@gmail.com
+// Leaderboard.cpp - Order-statistic treap over player ids.
+#include "Leaderboard.hpp"
+#include <stdexcept>
+
+namespace {
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+}
+
+// True if a ranks above b
+bool Leaderboard::before(int a, int b) const {
+    if (nodes[a].score != nodes[b].score) return nodes[a].score > nodes[b].score;
+    return a < b;
+}
+
+void Leaderboard::update(int t) {
+    Node& n = nodes[t];
+    n.size = 1 + (n.left >= 0 ? nodes[n.left].size : 0) + (n.right >= 0 ? nodes[n.right].size : 0);
+}
+
+// Joins two treaps where every node of a ranks above every node of b
+int Leaderboard::merge(int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (nodes[a].priority > nodes[b].priority) {
+        nodes[a].right = merge(nodes[a].right, b);
+        update(a);
+        return a;
+    }
+    nodes[b].left = merge(a, nodes[b].left);
+    update(b);
+    return b;
+}
+
+// Splits t into the nodes ranking above id and the rest
+void Leaderboard::split(int t, int id, int& left, int& right) {
+    if (t < 0) {
+        left = right = -1;
+        return;
+    }
+    if (before(t, id)) {
+        split(nodes[t].right, id, nodes[t].right, right);
+        left = t;
+    } else {
+        split(nodes[t].left, id, left, nodes[t].left);
+        right = t;
+    }
+    update(t);
+}
+
+int Leaderboard::insert(int t, int id) {
+    if (t < 0 || nodes[id].priority > nodes[t].priority) {
+        split(t, id, nodes[id].left, nodes[id].right);
+        update(id);
+        return id;
+    }
+    if (before(id, t)) nodes[t].left = insert(nodes[t].left, id);
+    else nodes[t].right = insert(nodes[t].right, id);
+    update(t);
+    return t;
+}
+
+int Leaderboard::remove(int t, int id) {
+    if (t == id) return merge(nodes[t].left, nodes[t].right);
+    if (before(id, t)) nodes[t].left = remove(nodes[t].left, id);
+    else nodes[t].right = remove(nodes[t].right, id);
+    update(t);
+    return t;
+}
+
+/**
+ * @brief Adds a player or moves it to a new score.
+ * @param id Player id.
+ * @param score The player's score.
+ * @throws std::out_of_range if id is negative.
+ */
+void Leaderboard::set(int id, double score) {
+    if (id < 0) throw std::out_of_range("Player id must not be negative");
+    if (static_cast<size_t>(id) >= nodes.size()) nodes.resize(static_cast<size_t>(id) + 1);
+    erase(id);
+    Node& n = nodes[id];
+    n.score = score;
+    n.priority = mix(static_cast<uint64_t>(id));
+    n.left = n.right = -1;
+    root = insert(root, id);
+}
+
+/**
+ * @brief Removes a player (nothing happens if it is absent).
+ * @param id Player id.
+ */
+void Leaderboard::erase(int id) {
+    if (!contains(id)) return;
+    root = remove(root, id);
+    nodes[id].size = 0;
+    nodes[id].left = nodes[id].right = -1;
+}
+
+bool Leaderboard::contains(int id) const {
+    return id >= 0 && static_cast<size_t>(id) < nodes.size() && nodes[id].size > 0;
+}
+
+/**
+ * @brief Returns a player's score.
+ * @param id Player id.
+ * @throws std::out_of_range if the player is absent.
+ */
+double Leaderboard::score(int id) const {
+    if (!contains(id)) throw std::out_of_range("Player is not ranked");
+    return nodes[id].score;
+}
+
+/**
+ * @brief Returns a player's rank (0 = highest score).
+ * @param id Player id.
+ * @throws std::out_of_range if the player is absent.
+ */
+size_t Leaderboard::rankOf(int id) const {
+    if (!contains(id)) throw std::out_of_range("Player is not ranked");
+    size_t rank = 0;
+    int t = root;
+    while (t != id) {
+        if (before(id, t)) {
+            t = nodes[t].left;
+        } else {
+            rank += 1 + (nodes[t].left >= 0 ? nodes[nodes[t].left].size : 0);
+            t = nodes[t].right;
+        }
+    }
+    return rank + (nodes[id].left >= 0 ? nodes[nodes[id].left].size : 0);
+}
+
+/**
+ * @brief Returns the player at a rank.
+ * @param rank 0 for the highest score.
+ * @throws std::out_of_range if rank >= size().
+ */
+int Leaderboard::atRank(size_t rank) const {
+    if (rank >= size()) throw std::out_of_range("No player at that rank");
+    int t = root;
+    for (;;) {
+        size_t left = nodes[t].left >= 0 ? nodes[nodes[t].left].size : 0;
+        if (rank < left) {
+            t = nodes[t].left;
+        } else if (rank == left) {
+            return t;
+        } else {
+            rank -= left + 1;
+            t = nodes[t].right;
+        }
+    }
+}
+
+/**
+ * @brief Returns the best k players, best first.
+ * @param k Number of players.
+ */
+std::vector<int> Leaderboard::top(size_t k) const {
+    std::vector<int> out;
+    for (size_t r = 0; r < k && r < size(); ++r) out.push_back(atRank(r));
+    return out;
+}
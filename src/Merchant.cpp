@@ -70,7 +70,7 @@ void Merchant::generalBlockCoup(Player& attacker) { throw std::logic_error("Merc
 void Merchant::merchantBonus() {
     if (getCoins() >= 3) {
         addCoins(1);
-        std::cout << getName() << " (Merchant) gained 1 bonus coin for starting with 3+.\n";
+        log() << getName() << " (Merchant) gained 1 bonus coin for starting with 3+.\n";
     }
 }
 /**
@@ -0,0 +1,65 @@
+// orel2744@gmail.com
+// Observation.cpp - A seat's non-owning view of a game.
+#include "Observation.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include <stdexcept>
+
+/**
+ * @brief Creates the view of one seat.
+ * @param g The game to observe.
+ * @param s The observing seat.
+ * @throws std::out_of_range if the seat does not exist.
+ */
+Observation::Observation(const Game& g, int s) : game(&g), seat(s) {
+    g.playerAt(s); // validates the seat
+}
+
+Player* Observation::at(int s) const { return game->playerAt(s); }
+
+int Observation::seatCount() const { return static_cast<int>(game->playerCount()); }
+
+/**
+ * @brief Returns the seat whose turn it is, or -1 if nobody can act.
+ */
+int Observation::turn() const {
+    try {
+        return game->currentPlayer()->getSeat();
+    } catch (const std::logic_error&) {
+        return -1;
+    }
+}
+
+int Observation::bank() const { return game->getBank(); }
+
+Role Observation::myRole() const { return at(seat)->getRole(); }
+
+/**
+ * @brief Returns a seat's role as far as the observer knows it.
+ * @param s Seat index.
+ * @return The role for the observer's own seat or an eliminated seat, otherwise Role::Unknown.
+ */
+Role Observation::role(int s) const {
+    const Player* p = at(s);
+    return (s == seat || !p->isAlive()) ? p->getRole() : Role::Unknown;
+}
+
+const std::string& Observation::name(int s) const { return at(s)->getName(); }
+
+int Observation::coins(int s) const { return at(s)->getCoins(); }
+
+bool Observation::alive(int s) const { return at(s)->isAlive(); }
+
+bool Observation::sanctioned(int s) const { return game->isSanctioned(at(s)); }
+
+bool Observation::arrestBlocked(int s) const { return game->isArrestBlocked(at(s)); }
+
+bool Observation::coupBlocked(int s) const { return game->isCoupBlocked(at(s)); }
+
+bool Observation::taxPending(int s) const { return game->wasTaxUsedBy(at(s)); }
+
+bool Observation::bribePending(int s) const { return game->wasBribeUsedBy(at(s)); }
+
+bool Observation::arrested(int source, int target) const { return game->wasArrestedByMeLastTurn(at(source), at(target)); }
+
+bool Observation::arrestedByMeLastTurn(int s) const { return arrested(seat, s); }
@@ -0,0 +1,62 @@
+// orel2744@gmail.com
+// ObservationEncoder.cpp - Fixed-layout, allocation-free tensor encoding of observations.
+#include "ObservationEncoder.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+// Converts a count to the buffer's element type (uint8 saturates)
+template <typename T> T value(int v) { return static_cast<T>(v); }
+template <> uint8_t value<uint8_t>(int v) { return static_cast<uint8_t>(std::min(std::max(v, 0), 255)); }
+
+template <typename T>
+void encodeInto(const Observation& obs, T* out) {
+    const int n = obs.seatCount();
+    if (n > ObservationEncoder::MAX_SEATS) throw std::invalid_argument("Too many seats to encode");
+    std::fill(out, out + ObservationEncoder::SIZE, T(0));
+
+    const int me = obs.getSeat();
+    const int turn = obs.turn();
+    int alive = 0;
+    for (int s = 0; s < n; ++s) alive += obs.alive(s) ? 1 : 0;
+    out[ObservationEncoder::BANK] = value<T>(obs.bank());
+    out[ObservationEncoder::ALIVE_COUNT] = value<T>(alive);
+    out[ObservationEncoder::SEAT_COUNT] = value<T>(n);
+    out[ObservationEncoder::MY_TURN] = value<T>(turn == me);
+    out[ObservationEncoder::MY_ROLE + static_cast<size_t>(obs.myRole())] = T(1);
+
+    for (int k = 0; k < n; ++k) {
+        const int s = (me + k) % n;
+        T* slot = out + ObservationEncoder::slotOffset(k, 0);
+        slot[ObservationEncoder::SLOT_PRESENT] = T(1);
+        slot[ObservationEncoder::SLOT_ALIVE] = value<T>(obs.alive(s));
+        slot[ObservationEncoder::SLOT_COINS] = value<T>(obs.coins(s));
+        slot[ObservationEncoder::SLOT_TURN] = value<T>(turn == s);
+        slot[ObservationEncoder::SLOT_SANCTIONED] = value<T>(obs.sanctioned(s));
+        slot[ObservationEncoder::SLOT_ARREST_BLOCKED] = value<T>(obs.arrestBlocked(s));
+        slot[ObservationEncoder::SLOT_COUP_BLOCKED] = value<T>(obs.coupBlocked(s));
+        slot[ObservationEncoder::SLOT_TAX_PENDING] = value<T>(obs.taxPending(s));
+        slot[ObservationEncoder::SLOT_BRIBE_PENDING] = value<T>(obs.bribePending(s));
+        slot[ObservationEncoder::SLOT_ARRESTED_BY_ME] = value<T>(obs.arrested(me, s));
+        slot[ObservationEncoder::SLOT_ARRESTED_ME] = value<T>(obs.arrested(s, me));
+        Role r = obs.role(s);
+        if (r != Role::Unknown) slot[ObservationEncoder::SLOT_ROLE + static_cast<size_t>(r)] = T(1);
+    }
+}
+}
+
+/**
+ * @brief Writes the observation into SIZE floats.
+ * @param obs The observation.
+ * @param out Buffer of at least SIZE floats.
+ * @throws std::invalid_argument if the game has more than MAX_SEATS seats.
+ */
+void ObservationEncoder::encode(const Observation& obs, float* out) { encodeInto(obs, out); }
+
+/**
+ * @brief Writes the observation into SIZE bytes (counts saturate at 255).
+ * @param obs The observation.
+ * @param out Buffer of at least SIZE bytes.
+ * @throws std::invalid_argument if the game has more than MAX_SEATS seats.
+ */
+void ObservationEncoder::encode(const Observation& obs, uint8_t* out) { encodeInto(obs, out); }
@@ -0,0 +1,160 @@
+// orel2744@gmail.com
+// PerfCounters.cpp - perf_event_open counters on Linux; elsewhere every counter is reported unavailable.
+#include "PerfCounters.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define COUP_PERF_EVENTS
+#endif
+
+namespace {
+#ifdef COUP_PERF_EVENTS
+const uint64_t CONFIGS[PerfSample::COUNT] = {PERF_COUNT_HW_CPU_CYCLES,       PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+                                             PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES};
+
+int openCounter(uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;  // allowed at perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+}
+
+const char* perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::CacheReferences: return "cache-references";
+        case PerfEvent::CacheMisses: return "cache-misses";
+        case PerfEvent::Branches: return "branches";
+        case PerfEvent::BranchMisses: return "branch-misses";
+        default: return "unknown";
+    }
+}
+
+double PerfSample::ipc() const {
+    if (!has(PerfEvent::Cycles) || !has(PerfEvent::Instructions) || (*this)[PerfEvent::Cycles] == 0) return 0.0;
+    return static_cast<double>((*this)[PerfEvent::Instructions]) / static_cast<double>((*this)[PerfEvent::Cycles]);
+}
+
+double PerfSample::perMillion(PerfEvent e, uint64_t operations) const {
+    if (!has(e)) return -1.0;
+    return operations ? static_cast<double>((*this)[e]) * 1e6 / static_cast<double>(operations) : 0.0;
+}
+
+/**
+ * @brief Opens every counter it can; never throws. The first failure's reason is kept.
+ */
+PerfCounters::PerfCounters() {
+    for (int& fd : fds) fd = -1;
+#ifdef COUP_PERF_EVENTS
+    for (int e = 0; e < PerfSample::COUNT; ++e) {
+        fds[e] = openCounter(CONFIGS[e]);
+        if (fds[e] < 0 && reason.empty())
+            reason = std::string("perf_event_open(") + perfEventName(static_cast<PerfEvent>(e)) + "): " + std::strerror(errno);
+    }
+#else
+    reason = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef COUP_PERF_EVENTS
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef COUP_PERF_EVENTS
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    running = true;
+    began = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Stops the counters and returns their values since start().
+ * @throws std::logic_error if start() was not called.
+ */
+PerfSample PerfCounters::stop() {
+    const auto ended = std::chrono::steady_clock::now();
+    if (!running) throw std::logic_error("PerfCounters::stop() without start()");
+    running = false;
+    PerfSample sample;
+    sample.seconds = std::chrono::duration<double>(ended - began).count();
+#ifdef COUP_PERF_EVENTS
+    for (int e = 0; e < PerfSample::COUNT; ++e) {
+        if (fds[e] < 0) continue;
+        ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t data[3] = {};  // value, time enabled, time running
+        if (read(fds[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+        // The kernel time-shares counters when there are more than registers; scale to the whole region
+        sample.value[e] = data[2] < data[1] ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) : data[0];
+        sample.available[e] = true;
+    }
+#endif
+    return sample;
+}
+
+/**
+ * @brief Formats a sample as one line per counter: total, per million operations, plus IPC and miss rates.
+ */
+std::string formatPerfSample(const PerfSample& sample, uint64_t operations) {
+    std::string out;
+    char line[128];
+    std::snprintf(line, sizeof(line), "  %-18s %14.3f ms  %12.1f ns/op\n", "wall time", sample.seconds * 1e3,
+                  operations ? sample.seconds * 1e9 / static_cast<double>(operations) : 0.0);
+    out += line;
+    for (int e = 0; e < PerfSample::COUNT; ++e) {
+        const PerfEvent event = static_cast<PerfEvent>(e);
+        if (sample.has(event))
+            std::snprintf(line, sizeof(line), "  %-18s %17llu  %12.0f per million ops\n", perfEventName(event),
+                          static_cast<unsigned long long>(sample[event]), sample.perMillion(event, operations));
+        else
+            std::snprintf(line, sizeof(line), "  %-18s %17s\n", perfEventName(event), "n/a");
+        out += line;
+    }
+    if (sample.ipc() > 0) {
+        std::snprintf(line, sizeof(line), "  %-18s %17.2f\n", "IPC", sample.ipc());
+        out += line;
+    }
+    if (sample.has(PerfEvent::CacheMisses) && sample.has(PerfEvent::CacheReferences) && sample[PerfEvent::CacheReferences] > 0) {
+        std::snprintf(line, sizeof(line), "  %-18s %16.2f%%\n", "cache miss rate",
+                      100.0 * sample[PerfEvent::CacheMisses] / sample[PerfEvent::CacheReferences]);
+        out += line;
+    }
+    if (sample.has(PerfEvent::BranchMisses) && sample.has(PerfEvent::Branches) && sample[PerfEvent::Branches] > 0) {
+        std::snprintf(line, sizeof(line), "  %-18s %16.2f%%\n", "branch miss rate",
+                      100.0 * sample[PerfEvent::BranchMisses] / sample[PerfEvent::Branches]);
+        out += line;
+    }
+    return out;
+}
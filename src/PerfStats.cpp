@@ -0,0 +1,73 @@
+// orel2744@gmail.com
+// PerfStats.cpp - Implementation of the rolling sample window used by the GUI performance overlay.
+#include "PerfStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Constructs a window that remembers the last `window` samples.
+ * @param window Number of samples kept.
+ * @throws std::invalid_argument if window is zero.
+ */
+RollingSamples::RollingSamples(size_t window) : ring(window), scratch() {
+    if (window == 0) throw std::invalid_argument("Sample window must be positive");
+    scratch.reserve(window);
+}
+
+/**
+ * @brief Records a sample, overwriting the oldest one when the window is full.
+ * @param value The sample value.
+ */
+void RollingSamples::record(double value) {
+    ring[head] = value;
+    head = (head + 1) % ring.size();
+    if (count < ring.size()) ++count;
+}
+
+/**
+ * @brief Returns the i-th sample from oldest (0) to newest (size()-1).
+ * @param i Sample index.
+ * @throws std::out_of_range if i >= size().
+ */
+double RollingSamples::sampleAt(size_t i) const {
+    if (i >= count) throw std::out_of_range("Sample index out of range");
+    size_t oldest = (head + ring.size() - count) % ring.size();
+    return ring[(oldest + i) % ring.size()];
+}
+
+/**
+ * @brief Returns the most recent sample, or 0 if empty.
+ */
+double RollingSamples::latest() const {
+    if (count == 0) return 0.0;
+    return ring[(head + ring.size() - 1) % ring.size()];
+}
+
+/**
+ * @brief Returns the largest sample in the window, or 0 if empty.
+ */
+double RollingSamples::max() const {
+    if (count == 0) return 0.0;
+    size_t oldest = (head + ring.size() - count) % ring.size();
+    double best = ring[oldest];
+    for (size_t i = 1; i < count; ++i) best = std::max(best, ring[(oldest + i) % ring.size()]);
+    return best;
+}
+
+/**
+ * @brief Returns the p-th percentile (nearest rank) of the window, or 0 if empty.
+ *        O(window) using nth_element on a reused scratch buffer.
+ * @param p Percentile in [0, 100].
+ */
+double RollingSamples::percentile(double p) const {
+    if (count == 0) return 0.0;
+    p = std::max(0.0, std::min(100.0, p));
+    size_t oldest = (head + ring.size() - count) % ring.size();
+    scratch.clear();
+    for (size_t i = 0; i < count; ++i) scratch.push_back(ring[(oldest + i) % ring.size()]);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * count));
+    size_t idx = rank == 0 ? 0 : rank - 1;
+    std::nth_element(scratch.begin(), scratch.begin() + idx, scratch.end());
+    return scratch[idx];
+}
@@ -3,6 +3,7 @@
 
 #include "Player.hpp"
 #include "Game.hpp"
+#include "Trace.hpp"
 
 #include <iostream>
 #include <stdexcept>
@@ -23,6 +24,51 @@ Player::Player(const std::string& name, Role role, Game* game)
     game->addPlayer(this);
 }
 
+/**
+ * @brief Returns the stream action messages are written to (silent when the game's logging is off).
+ */
+std::ostream& Player::log() const { return game->log(); }
+
+/**
+ * @brief Sets the coin count, updating the game's hash (seated players only).
+ * @param value The new coin count.
+ */
+void Player::setCoins(int value) {
+    if (seat >= 0) game->toggleHash(ZobristField::Coins, seat, coins);
+    coins = value;
+    if (seat >= 0) game->toggleHash(ZobristField::Coins, seat, coins);
+}
+
+/**
+ * @brief Sets the alive flag, updating the game's hash (seated players only).
+ * @param value True if alive.
+ */
+void Player::setAlive(bool value) {
+    if (seat >= 0) game->toggleHash(ZobristField::Alive, seat, alive ? 1 : 0);
+    alive = value;
+    if (seat >= 0) game->toggleHash(ZobristField::Alive, seat, alive ? 1 : 0);
+}
+
+/**
+ * @brief Sets the extra-action flag, updating the game's hash (seated players only).
+ * @param value True if the player has an extra action.
+ */
+void Player::setExtraAction(bool value) {
+    if (seat >= 0) game->toggleHash(ZobristField::Extra, seat, extraAction ? 1 : 0);
+    extraAction = value;
+    if (seat >= 0) game->toggleHash(ZobristField::Extra, seat, extraAction ? 1 : 0);
+}
+
+/**
+ * @brief Sets the pending action, updating the game's hash (seated players only).
+ * @param value The new pending action.
+ */
+void Player::setPending(PendingAction value) {
+    if (seat >= 0) game->toggleHash(ZobristField::Pending, seat, static_cast<int>(pendingAction));
+    pendingAction = value;
+    if (seat >= 0) game->toggleHash(ZobristField::Pending, seat, static_cast<int>(pendingAction));
+}
+
 /**
  * @brief Gets the name of the player.
  * @return Reference to the player's name string.
@@ -60,12 +106,13 @@ void Player::bribe() {
     if (extraAction) throw std::logic_error("Already bribed this turn");
     if (pendingAction != PendingAction::None) throw std::logic_error("You must resolve previous action (tax/bribe) before new action.");
 
-    coins -= 4;
+    TraceScope trace("Player::bribe", "player");
+    setCoins(coins - 4);
     game->addCoinsToBank(4); // Bribe coins go to the bank
-    extraAction = true;
+    setExtraAction(true);
     game->markBribe(this);
-    std::cout << name << " paid 4 coins to bribe and earned an extra action.\n";
-    pendingAction = PendingAction::Bribe;
+    log() << name << " paid 4 coins to bribe and earned an extra action.\n";
+    setPending(PendingAction::Bribe);
     // לא מסיים תור, כי מותר לבצע פעולה נוספת
 }
 
@@ -81,13 +128,14 @@ void Player::sanction(Player& target) {
     if (!game->isPlayerTurn(this)) throw std::logic_error("Not your turn");
     if (game->getBank() < 3) throw std::logic_error("Not enough coins in the bank for sanction");
     if (coins < 3) throw std::logic_error("Not enough coins to sanction");
+    TraceScope trace("Player::sanction", "player");
     if (target.getRole() == Role::Judge) {
         game->addCoinsToBank(1); // Judge gets 1 extra coin to the bank
     }
-    coins -= 3;
+    setCoins(coins - 3);
     game->addCoinsToBank(3); // Sanction coins go to the bank
     game->applySanction(&target);
-    std::cout << name << " sanctioned " << target.getName() << ".\n";
+    log() << name << " sanctioned " << target.getName() << ".\n";
     endTurn();
 }
 
@@ -104,10 +152,11 @@ void Player::coup(Player& target) {
     if (!game->isPlayerTurn(this)) throw std::logic_error("Not your turn");
     if (game->getBank() < 7) throw std::logic_error("Not enough coins in the bank for coup");
     if (coins < 7) throw std::logic_error("Not enough coins to perform a coup");
-    coins -= 7;
+    TraceScope trace("Player::coup", "player");
+    setCoins(coins - 7);
     game->addCoinsToBank(7); // Coup coins go to the bank
     game->registerCoupAttempt(this, &target); // Use the correct public method
-    std::cout << name << " performed a coup on " << target.getName() << ".\n";
+    log() << name << " performed a coup on " << target.getName() << ".\n";
     game->eliminate(&target); // Ensure the target is eliminated in the game state
     endTurn();
 }
@@ -122,12 +171,13 @@ void Player::invest() {
     if (role != Role::Baron) throw std::logic_error("Only a Baron can invest");
     if (coins < 3) throw std::logic_error("Not enough coins to invest");
     if (game->getBank() < 3) throw std::logic_error("Not enough coins in the bank to invest");
-    coins -= 3;
+    TraceScope trace("Player::invest", "player");
+    setCoins(coins - 3);
     game->addCoinsToBank(3); // השקעה - 3 מטבעות לבנק
     if (game->getBank() < 6) throw std::logic_error("Not enough coins in the bank to pay investment return");
-    coins += 6;
+    setCoins(coins + 6);
     game->addCoinsToBank(-6); // קבלת 6 מטבעות מהבנק
-    std::cout << name << " invested and gained 6 coins" << std::endl;
+    log() << name << " invested and gained 6 coins" << std::endl;
     endTurn();
 }
 
@@ -144,7 +194,8 @@ void Player::spyOn(Player& target) {
     if (&target == this)
         throw std::logic_error("Cannot spy on yourself.");
 
-    std::cout << name << " spies on " << target.getName() << ": " << target.getCoins() << " coins." << std::endl;
+    TraceScope trace("Player::spyOn", "player");
+    log() << name << " spies on " << target.getName() << ": " << target.getCoins() << " coins." << std::endl;
     game->blockArrest(&target);
     
 }
@@ -159,9 +210,10 @@ void Player::preventCoup(Player& target) {
     if (role != Role::General) throw std::logic_error("Only General can prevent coup.");
     if (coins < 5) throw std::logic_error("Not enough coins to block coup.");
 
-    coins -= 5;
+    TraceScope trace("Player::preventCoup", "player");
+    setCoins(coins - 5);
     game->blockCoup(&target);
-    std::cout << name << " (General) blocked coup against " << target.getName() << "." << std::endl;
+    log() << name << " (General) blocked coup against " << target.getName() << "." << std::endl;
     endTurn();
 }
 
@@ -172,15 +224,15 @@ void Player::preventCoup(Player& target) {
  */
 void Player::removeCoins(int amount) {
     if (coins < amount) throw std::logic_error("Not enough coins.");
-    coins -= amount;
+    setCoins(coins - amount);
 }
 
 /**
  * @brief Eliminates the player from the game, setting their alive status to false.
  */
 void Player::eliminate() {
-    alive = false;
-    std::cout << name << " has been eliminated." << std::endl;
+    setAlive(false);
+    log() << name << " has been eliminated." << std::endl;
 }
 
 /**
@@ -188,7 +240,7 @@ void Player::eliminate() {
  */
 void Player::endTurn() {
     if (extraAction) {
-        extraAction = false;
+        setExtraAction(false);
         return;
     }
     game->clearCoupMarks();
@@ -208,10 +260,11 @@ void Player::judgeBribe(Player& target) {
     if (!game->wasBribeUsedBy(&target))
         throw std::logic_error("No bribe to cancel.");
     if (target.pendingAction == PendingAction::Bribe) {
-        target.extraAction = false;
-        target.pendingAction = PendingAction::None;
+        TraceScope trace("Player::judgeBribe", "player");
+        target.setExtraAction(false);
+        target.setPending(PendingAction::None);
         game->cancelBribe(&target);
-        std::cout << name << " canceled bribe by " << target.getName() << std::endl;
+        log() << name << " canceled bribe by " << target.getName() << std::endl;
         target.endTurn();
     } else {
         throw std::logic_error("No pending bribe to block.");
@@ -222,7 +275,7 @@ void Player::judgeBribe(Player& target) {
  * @brief Clears the player's extra action status (used when a bribe is canceled).
  */
 void Player::clearExtraAction() {
-    extraAction = false;
+    setExtraAction(false);
 }
 
 /**
@@ -234,7 +287,8 @@ void Player::generalBlockCoup(Player& attacker) {
     if (this->role != Role::General) throw std::logic_error("Only General can block coups.");
     if (!game->canBlockCoup(this)) throw std::logic_error("No coup to block.");
     if (coins < 5) throw std::logic_error("General needs 5 coins to block coup.");
-    coins -= 5;
+    TraceScope trace("Player::generalBlockCoup", "player");
+    setCoins(coins - 5);
     // החזר בדיוק 7 מטבעות לתוקף (רק אם ירדו לו)
     // נוודא שהתוקף לא מקבל יותר מדי מטבעות
     if (attacker.getCoins() < 7) {
@@ -243,8 +297,8 @@ void Player::generalBlockCoup(Player& attacker) {
         attacker.addCoins(0); // לא להחזיר אם יש לו כבר 7 או יותר
     }
     game->cancelCoup(this);
-    alive = true;
-    std::cout << name << " blocked the coup by " << attacker.getName() << " and paid 5 coins.\n";
+    setAlive(true);
+    log() << name << " blocked the coup by " << attacker.getName() << " and paid 5 coins.\n";
 }
 
 /**
@@ -255,16 +309,17 @@ void Player::gather() {
     if (!alive) throw std::logic_error("Dead player cannot gather.");
     if (!game->isPlayerTurn(this)) throw std::logic_error("Not your turn.");
     if (game->isSanctioned(this)) throw std::logic_error("You are sanctioned and cannot gather.");
+    TraceScope trace("Player::gather", "player");
     if (pendingAction != PendingAction::None) {
-        pendingAction = PendingAction::None;
-        extraAction = false;
+        setPending(PendingAction::None);
+        setExtraAction(false);
     }
     merchantBonus();
     // Take coin from central bank if available
     if (game->getBank() <= 0) throw std::logic_error("Bank is empty. Cannot gather.");
-    coins += 1;
+    setCoins(coins + 1);
     game->addCoinsToBank(-1);
-    std::cout << name << " gathered 1 coin.\n";
+    log() << name << " gathered 1 coin.\n";
     endTurn();
 }
 
@@ -281,11 +336,12 @@ void Player::tax() {
     int amount = 2;
     if (role == Role::Governor) amount = 3;
     if (game->getBank() < amount) throw std::logic_error("Bank does not have enough coins for tax.");
-    coins += amount;
+    TraceScope trace("Player::tax", "player");
+    setCoins(coins + amount);
     game->addCoinsToBank(-amount);
-    std::cout << name << " taxed and got " << amount << " coins.\n";
+    log() << name << " taxed and got " << amount << " coins.\n";
     game->markTax(this);
-    pendingAction = PendingAction::Tax;
+    setPending(PendingAction::Tax);
     if (!extraAction) {
         endTurn();
     }
@@ -305,9 +361,10 @@ void Player::arrest(Player& target) {
     // חסימת arrest ע"י Spy
     if (target.getRole() == Role::Spy && game->isArrestBlocked(&target)) 
         throw logic_error("You have been blocked from using arrest this turn.");
+    TraceScope trace("Player::arrest", "player");
     game->markArrest(this, &target);
     if (target.getRole() == Role::General) {
-        cout << target.getName() << " is a General and negated the arrest.\n";
+        log() << target.getName() << " is a General and negated the arrest.\n";
         endTurn();
         return;
     }
@@ -315,7 +372,7 @@ void Player::arrest(Player& target) {
         if (target.getCoins() < 2) throw logic_error("Merchant doesn't have enough to pay arrest penalty.");
         target.removeCoins(2);
         game->addCoinsToBank(2); // Merchant pays 2 coins to the bank
-        cout << target.getName() << " is a Merchant and paid 2 coins to bank (arrest).\n";
+        log() << target.getName() << " is a Merchant and paid 2 coins to bank (arrest).\n";
         endTurn();
         return;
     }
@@ -324,7 +381,7 @@ void Player::arrest(Player& target) {
         this->addCoins(1);
         // arrest לא משפיע על הקופה המרכזית (העברת מטבע בין שחקנים)
     }
-    cout << getName() << " arrested " << target.getName() << " and took 1 coin.\n";
+    log() << getName() << " arrested " << target.getName() << " and took 1 coin.\n";
     endTurn();
 }
 
@@ -333,7 +390,7 @@ void Player::arrest(Player& target) {
  * @param amount The number of coins to add.
  */
 void Player::addCoins(int amount) {
-    coins += amount;
+    setCoins(coins + amount);
 }
 
 /**
@@ -349,12 +406,13 @@ void Player::blockTax(Player& target) {
     if (!game->wasTaxUsedBy(&target))
         throw std::logic_error("No tax to block.");
     if (target.pendingAction == PendingAction::Tax) {
+        TraceScope trace("Player::blockTax", "player");
         int amount = (target.role == Role::Governor) ? 3 : 2;
         target.removeCoins(amount);
-        target.pendingAction = PendingAction::None;
-        target.extraAction = false;
+        target.setPending(PendingAction::None);
+        target.setExtraAction(false);
         game->cancelTax(&target);
-        std::cout << name << " blocked tax by " << target.getName() << std::endl;
+        log() << name << " blocked tax by " << target.getName() << std::endl;
         target.endTurn();
     } else {
         throw std::logic_error("No pending tax to block.");
@@ -368,8 +426,9 @@ void Player::blockTax(Player& target) {
 void Player::skipTurn() {
     if (!alive) throw std::logic_error("Dead player cannot skip turn.");
     if (!game->isPlayerTurn(this)) throw std::logic_error("Not your turn.");
+    TraceScope trace("Player::skipTurn", "player");
     if (extraAction) {
-        extraAction = false;
+        setExtraAction(false);
         return;
     }
     game->nextTurn();
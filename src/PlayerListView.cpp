@@ -0,0 +1,128 @@
+// orel2744@gmail.com
+// PlayerListView.cpp - Implementation of the virtualised player list model used by the GUI.
+#include "PlayerListView.hpp"
+#include "Player.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Constructs a view for a panel of the given viewport height.
+ * @param rowHeight Height of a single row in pixels.
+ * @param viewportHeight Height of the visible area in pixels.
+ * @throws std::invalid_argument if either height is not positive.
+ */
+PlayerListView::PlayerListView(float rowHeight, float viewportHeight)
+    : rowHeight(rowHeight), viewportHeight(viewportHeight) {
+    if (rowHeight <= 0.f || viewportHeight <= 0.f)
+        throw std::invalid_argument("Player list dimensions must be positive");
+}
+
+/**
+ * @brief Shows only players with the given role. Role::Unknown shows everyone.
+ * @param role The role to filter by.
+ */
+void PlayerListView::setRoleFilter(Role role) {
+    if (role == roleFilter) return;
+    roleFilter = role;
+    scroll = 0.f;
+    dirty = true;
+}
+
+/**
+ * @brief Sets the sort key and direction of the list.
+ * @param key The key to sort by.
+ * @param desc True to sort from high to low.
+ */
+void PlayerListView::setSort(SortKey key, bool desc) {
+    if (key == sortKey && desc == descending) return;
+    sortKey = key;
+    descending = desc;
+    dirty = true;
+}
+
+/**
+ * @brief Recomputes the filtered/sorted index if it is stale.
+ *        Dead players are never listed. Ties keep seat order, so the list does not jump between frames.
+ * @param players All seats of the game, in seat order.
+ */
+void PlayerListView::rebuild(const std::vector<Player*>& players) {
+    if (!dirty) return;
+    rows.clear();
+    for (Player* p : players) {
+        if (!p->isAlive()) continue;
+        if (roleFilter != Role::Unknown && p->getRole() != roleFilter) continue;
+        rows.push_back(p);
+    }
+    if (sortKey == SortKey::Coins) {
+        std::stable_sort(rows.begin(), rows.end(), [this](const Player* a, const Player* b) {
+            return descending ? a->getCoins() > b->getCoins() : a->getCoins() < b->getCoins();
+        });
+    } else if (sortKey == SortKey::Role) {
+        std::stable_sort(rows.begin(), rows.end(), [this](const Player* a, const Player* b) {
+            int ra = static_cast<int>(a->getRole()), rb = static_cast<int>(b->getRole());
+            return descending ? ra > rb : ra < rb;
+        });
+    } else if (descending) {
+        std::reverse(rows.begin(), rows.end());
+    }
+    scroll = std::min(scroll, maxScroll());
+    dirty = false;
+}
+
+/**
+ * @brief Scrolls the list by a number of pixels, clamped to the content.
+ * @param dy Pixels to scroll (positive scrolls down).
+ */
+void PlayerListView::scrollBy(float dy) {
+    scroll = std::max(0.f, std::min(scroll + dy, maxScroll()));
+}
+
+/**
+ * @brief Scrolls so that the given player is inside the viewport, if it is listed.
+ * @param p The player to reveal.
+ */
+void PlayerListView::scrollTo(const Player* p) {
+    auto it = std::find(rows.begin(), rows.end(), p);
+    if (it == rows.end()) return;
+    float top = static_cast<float>(it - rows.begin()) * rowHeight;
+    if (top < scroll) scroll = top;
+    else if (top + rowHeight > scroll + viewportHeight) scroll = top + rowHeight - viewportHeight;
+    scroll = std::max(0.f, std::min(scroll, maxScroll()));
+}
+
+/**
+ * @brief Returns the index of the first row inside the viewport.
+ */
+size_t PlayerListView::firstVisible() const {
+    return std::min(rows.size(), static_cast<size_t>(scroll / rowHeight));
+}
+
+/**
+ * @brief Returns the number of rows inside the viewport, including a partially visible last row.
+ */
+size_t PlayerListView::visibleCount() const {
+    return std::min(rows.size() - firstVisible(), maxVisibleRows());
+}
+
+/**
+ * @brief Returns the y offset of a row relative to the top of the viewport.
+ * @param row Row index.
+ */
+float PlayerListView::rowOffset(size_t row) const {
+    return static_cast<float>(row) * rowHeight - scroll;
+}
+
+/**
+ * @brief Returns the largest number of rows that can be visible at once.
+ */
+size_t PlayerListView::maxVisibleRows() const {
+    return static_cast<size_t>(viewportHeight / rowHeight) + 1;
+}
+
+/**
+ * @brief Returns the largest valid scroll offset for the current content.
+ */
+float PlayerListView::maxScroll() const {
+    float content = static_cast<float>(rows.size()) * rowHeight;
+    return std::max(0.f, content - viewportHeight);
+}
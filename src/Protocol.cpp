@@ -0,0 +1,231 @@
+// orel2744@gmail.com
+// Protocol.cpp - Encoding and decoding of coup_server frames.
+#include "Protocol.hpp"
+#include <cstring>
+
+namespace {
+// Little-endian append helpers
+void put8(std::vector<uint8_t>& out, uint8_t v) { out.push_back(v); }
+void put16(std::vector<uint8_t>& out, uint16_t v) { out.push_back(v & 0xff); out.push_back(v >> 8); }
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+uint32_t load32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+// Bounds-checked reader over one payload
+class Reader {
+public:
+    Reader(const uint8_t* p, size_t n) : p(p), n(n) {}
+    uint8_t u8() { need(1); return p[i++]; }
+    uint16_t u16() { need(2); uint16_t v = static_cast<uint16_t>(p[i] | p[i + 1] << 8); i += 2; return v; }
+    uint32_t u32() { need(4); uint32_t v = load32(p + i); i += 4; return v; }
+    std::string str() {
+        uint16_t len = u16();
+        need(len);
+        std::string s(reinterpret_cast<const char*>(p + i), len);
+        i += len;
+        return s;
+    }
+    bool done() const { return i == n; }
+
+private:
+    const uint8_t* p;
+    size_t n;
+    size_t i = 0;
+    void need(size_t k) const { if (n - i < k) throw ProtocolError("Truncated message"); }
+};
+
+void putString(std::vector<uint8_t>& out, const std::string& s) {
+    if (s.size() > 0xffff) throw ProtocolError("String too long");
+    put16(out, static_cast<uint16_t>(s.size()));
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+void putState(std::vector<uint8_t>& out, const TableState& st) {
+    put8(out, st.status);
+    put16(out, static_cast<uint16_t>(st.bank));
+    put8(out, static_cast<uint8_t>(st.turn));
+    put8(out, static_cast<uint8_t>(st.seats.size()));
+    for (const SeatState& s : st.seats) {
+        put16(out, static_cast<uint16_t>(s.coins));
+        put8(out, s.alive ? 1 : 0);
+    }
+}
+
+void putDelta(std::vector<uint8_t>& out, const StateDelta& d) {
+    put8(out, d.fields);
+    if (d.fields & StateDelta::STATUS) put8(out, d.status);
+    if (d.fields & StateDelta::BANK) put16(out, static_cast<uint16_t>(d.bank));
+    if (d.fields & StateDelta::TURN) put8(out, static_cast<uint8_t>(d.turn));
+    put8(out, static_cast<uint8_t>(d.seats.size()));
+    for (const SeatChange& c : d.seats) {
+        put8(out, c.seat);
+        put16(out, static_cast<uint16_t>(c.state.coins));
+        put8(out, c.state.alive ? 1 : 0);
+    }
+}
+
+StateDelta readDelta(Reader& r) {
+    StateDelta d;
+    d.fields = r.u8();
+    if (d.fields & ~(StateDelta::STATUS | StateDelta::BANK | StateDelta::TURN)) throw ProtocolError("Unknown delta fields");
+    if (d.fields & StateDelta::STATUS) d.status = r.u8();
+    if (d.fields & StateDelta::BANK) d.bank = static_cast<int16_t>(r.u16());
+    if (d.fields & StateDelta::TURN) d.turn = static_cast<int8_t>(r.u8());
+    uint8_t n = r.u8();
+    d.seats.resize(n);
+    for (SeatChange& c : d.seats) {
+        c.seat = r.u8();
+        c.state.coins = static_cast<int16_t>(r.u16());
+        c.state.alive = r.u8() != 0;
+    }
+    return d;
+}
+
+TableState readState(Reader& r) {
+    TableState st;
+    st.status = r.u8();
+    st.bank = static_cast<int16_t>(r.u16());
+    st.turn = static_cast<int8_t>(r.u8());
+    uint8_t n = r.u8();
+    st.seats.resize(n);
+    for (SeatState& s : st.seats) {
+        s.coins = static_cast<int16_t>(r.u16());
+        s.alive = r.u8() != 0;
+    }
+    return st;
+}
+}
+
+/**
+ * @brief Appends one encoded frame for `msg` to `out`.
+ * @param msg The message.
+ * @param out Buffer to append to.
+ * @throws ProtocolError if the message type is unknown.
+ */
+void encodeMessage(const Message& msg, std::vector<uint8_t>& out) {
+    size_t start = out.size();
+    put32(out, 0); // length, patched below
+    put8(out, static_cast<uint8_t>(msg.type));
+    put32(out, msg.tag);
+    switch (msg.type) {
+        case MsgType::CreateTable: put8(out, msg.count); break;
+        case MsgType::JoinTable: put32(out, msg.table); put8(out, msg.seat); break;
+        case MsgType::Act:
+            put32(out, msg.table);
+            put8(out, static_cast<uint8_t>(msg.action.type));
+            put8(out, static_cast<uint8_t>(msg.action.actor));
+            put8(out, static_cast<uint8_t>(static_cast<int8_t>(msg.action.target)));
+            break;
+        case MsgType::GetState:
+        case MsgType::CloseTable:
+        case MsgType::Watch:
+        case MsgType::TableCreated:
+        case MsgType::Watching:
+        case MsgType::Closed: put32(out, msg.table); break;
+        case MsgType::Joined: put32(out, msg.table); put8(out, msg.seat); put8(out, static_cast<uint8_t>(msg.role)); break;
+        case MsgType::ActResult: put32(out, msg.table); putString(out, msg.text); putState(out, msg.state); break;
+        case MsgType::State: put32(out, msg.table); putState(out, msg.state); break;
+        case MsgType::Keyframe: put32(out, msg.table); put32(out, msg.sequence); putState(out, msg.state); break;
+        case MsgType::Delta: put32(out, msg.table); put32(out, msg.sequence); putDelta(out, msg.delta); break;
+        case MsgType::Error: putString(out, msg.text); break;
+        default: throw ProtocolError("Unknown message type");
+    }
+    uint32_t len = static_cast<uint32_t>(out.size() - start - FRAME_HEADER_SIZE);
+    for (int i = 0; i < 4; ++i) out[start + i] = static_cast<uint8_t>(len >> (8 * i));
+}
+
+/**
+ * @brief Decodes one frame from the start of a buffer.
+ * @param data Buffer start.
+ * @param len Bytes available.
+ * @param msg Receives the message.
+ * @return Bytes consumed, or 0 if the buffer does not yet hold a complete frame.
+ * @throws ProtocolError if the frame is malformed or too large.
+ */
+size_t decodeMessage(const uint8_t* data, size_t len, Message& msg) {
+    if (len < FRAME_HEADER_SIZE) return 0;
+    uint32_t payload = load32(data);
+    if (payload > MAX_FRAME_SIZE) throw ProtocolError("Frame too large");
+    if (len - FRAME_HEADER_SIZE < payload) return 0;
+    Reader r(data + FRAME_HEADER_SIZE, payload);
+    msg = Message();
+    msg.type = static_cast<MsgType>(r.u8());
+    msg.tag = r.u32();
+    switch (msg.type) {
+        case MsgType::CreateTable: msg.count = r.u8(); break;
+        case MsgType::JoinTable: msg.table = r.u32(); msg.seat = r.u8(); break;
+        case MsgType::Act: {
+            msg.table = r.u32();
+            uint8_t type = r.u8();
+            if (type >= ACTION_TYPE_COUNT) throw ProtocolError("Unknown action type");
+            msg.action.type = static_cast<ActionType>(type);
+            msg.action.actor = r.u8();
+            msg.action.target = static_cast<int8_t>(r.u8());
+            break;
+        }
+        case MsgType::GetState:
+        case MsgType::CloseTable:
+        case MsgType::Watch:
+        case MsgType::TableCreated:
+        case MsgType::Watching:
+        case MsgType::Closed: msg.table = r.u32(); break;
+        case MsgType::Joined: {
+            msg.table = r.u32();
+            msg.seat = r.u8();
+            uint8_t role = r.u8();
+            if (role > static_cast<uint8_t>(Role::Unknown)) throw ProtocolError("Unknown role");
+            msg.role = static_cast<Role>(role);
+            break;
+        }
+        case MsgType::ActResult: msg.table = r.u32(); msg.text = r.str(); msg.state = readState(r); break;
+        case MsgType::State: msg.table = r.u32(); msg.state = readState(r); break;
+        case MsgType::Keyframe: msg.table = r.u32(); msg.sequence = r.u32(); msg.state = readState(r); break;
+        case MsgType::Delta: msg.table = r.u32(); msg.sequence = r.u32(); msg.delta = readDelta(r); break;
+        case MsgType::Error: msg.text = r.str(); break;
+        default: throw ProtocolError("Unknown message type");
+    }
+    if (!r.done()) throw ProtocolError("Trailing bytes in message");
+    return FRAME_HEADER_SIZE + payload;
+}
+
+/**
+ * @brief Computes the delta that turns `before` into `after`.
+ * @param before Previous state.
+ * @param after Current state (same number of seats).
+ * @return The delta (empty when nothing changed).
+ * @throws std::invalid_argument if the seat counts differ.
+ */
+StateDelta diffState(const TableState& before, const TableState& after) {
+    if (before.seats.size() != after.seats.size()) throw std::invalid_argument("States have different seat counts");
+    StateDelta d;
+    if (before.status != after.status) { d.fields |= StateDelta::STATUS; d.status = after.status; }
+    if (before.bank != after.bank) { d.fields |= StateDelta::BANK; d.bank = after.bank; }
+    if (before.turn != after.turn) { d.fields |= StateDelta::TURN; d.turn = after.turn; }
+    for (size_t i = 0; i < after.seats.size(); ++i) {
+        const SeatState& a = before.seats[i];
+        const SeatState& b = after.seats[i];
+        if (a.coins != b.coins || a.alive != b.alive) d.seats.push_back({static_cast<uint8_t>(i), b});
+    }
+    return d;
+}
+
+/**
+ * @brief Applies a delta to a state in place.
+ * @param state State at the delta's previous sequence number.
+ * @param delta The delta.
+ * @throws ProtocolError if the delta names a seat the state does not have.
+ */
+void applyDelta(TableState& state, const StateDelta& delta) {
+    for (const SeatChange& c : delta.seats) {
+        if (c.seat >= state.seats.size()) throw ProtocolError("Delta names an unknown seat");
+    }
+    if (delta.fields & StateDelta::STATUS) state.status = delta.status;
+    if (delta.fields & StateDelta::BANK) state.bank = delta.bank;
+    if (delta.fields & StateDelta::TURN) state.turn = delta.turn;
+    for (const SeatChange& c : delta.seats) state.seats[c.seat] = c.state;
+}
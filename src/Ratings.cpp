@@ -0,0 +1,173 @@
+// orel2744@gmail.com
+// Ratings.cpp - TrueSkill-style free-for-all ratings (Weng-Lin Thurstone-Mosteller full pairs).
+#include "Ratings.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+const double MIN_SHRINK = 1e-4;  // variance never shrinks below this share in one game
+
+double pdf(double x) { return std::exp(-0.5 * x * x) / std::sqrt(2.0 * M_PI); }
+
+double cdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+// Mean and variance corrections when the first performance beat the second by more than e (t = mean gap)
+double vWin(double t, double e) {
+    double d = cdf(t - e);
+    return d < 1e-12 ? e - t : pdf(t - e) / d;
+}
+
+double wWin(double t, double e) {
+    double v = vWin(t, e);
+    return v * (v + t - e);
+}
+
+// The same when the performances were within e of each other
+double vDraw(double t, double e) {
+    double d = cdf(e - t) - cdf(-e - t);
+    if (d < 1e-12) return t < 0 ? -t - e : -t + e;
+    return (pdf(-e - t) - pdf(e - t)) / d;
+}
+
+double wDraw(double t, double e) {
+    double d = cdf(e - t) - cdf(-e - t);
+    if (d < 1e-12) return 1.0;
+    double v = vDraw(t, e);
+    return v * v + ((e - t) * pdf(e - t) + (e + t) * pdf(e + t)) / d;
+}
+}
+
+/**
+ * @brief Returns each seat's finishing rank (0 = best) in a game.
+ * @param result The game's outcome.
+ * @param seats Number of seats.
+ * @throws std::invalid_argument if the elimination order names a seat that does not exist.
+ */
+std::vector<int> finishingRanks(const GameResult& result, size_t seats) {
+    if (result.eliminationOrder.size() > seats) throw std::invalid_argument("Elimination order names no seat");
+    std::vector<int> ranks(seats, 0);
+    const int survivors = static_cast<int>(seats - result.eliminationOrder.size());
+    const int out = static_cast<int>(result.eliminationOrder.size());
+    for (int j = 0; j < out; ++j) {
+        int seat = result.eliminationOrder[j];
+        if (seat < 0 || static_cast<size_t>(seat) >= seats) throw std::invalid_argument("Elimination order names no seat");
+        ranks[seat] = survivors + (out - 1 - j);
+    }
+    return ranks;
+}
+
+/**
+ * @brief Creates an engine with no players.
+ * @param cfg Prior and noise.
+ * @throws std::invalid_argument if a deviation is not positive or the draw margin is negative.
+ */
+RatingEngine::RatingEngine(const RatingConfig& cfg) : config(cfg) {
+    if (!(config.sigma > 0) || !(config.beta > 0) || config.tau < 0) throw std::invalid_argument("Deviations must be positive");
+    if (config.drawMargin < 0) throw std::invalid_argument("Draw margin must not be negative");
+}
+
+/**
+ * @brief Adds a player with the prior rating.
+ * @param name Display name.
+ * @return The player's id.
+ */
+int RatingEngine::addPlayer(const std::string& name) {
+    int id = static_cast<int>(ratings.size());
+    ratings.push_back({config.mu, config.sigma});
+    names.push_back(name);
+    board.set(id, ratings.back().conservative());
+    return id;
+}
+
+/**
+ * @brief Records a game from its finishing ranks.
+ *
+ * Every participant i is compared with every other q, with c = sqrt(sigma_i^2 + sigma_q^2 + 2 beta^2):
+ * mu_i moves by sigma_i^2 / c * v and sigma_i^2 shrinks by sigma_i / c * sigma_i^2 / c^2 * w, where v and w
+ * are the win or draw corrections of the Gaussian performance gap. All updates use the ratings before the game.
+ * @param players Player id of each participant.
+ * @param ranks Rank of each participant (0 = best; equal ranks are ties).
+ * @throws std::invalid_argument if the sizes differ, fewer than 2 or repeated players take part, or a rank is negative.
+ * @throws std::out_of_range if a player id does not exist.
+ */
+void RatingEngine::record(const std::vector<int>& players, const std::vector<int>& ranks) {
+    const size_t n = players.size();
+    if (ranks.size() != n) throw std::invalid_argument("Need one rank per player");
+    if (n < 2) throw std::invalid_argument("A game needs at least 2 players");
+    for (size_t i = 0; i < n; ++i) {
+        if (players[i] < 0 || static_cast<size_t>(players[i]) >= ratings.size()) throw std::out_of_range("No such player");
+        if (ranks[i] < 0) throw std::invalid_argument("Ranks must not be negative");
+        for (size_t j = 0; j < i; ++j) {
+            if (players[j] == players[i]) throw std::invalid_argument("A player cannot take two seats");
+        }
+    }
+
+    variance.assign(n, 0.0);
+    meanStep.assign(n, 0.0);
+    varianceShrink.assign(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        double s = ratings[players[i]].sigma;
+        variance[i] = s * s + config.tau * config.tau;
+    }
+    const double beta2 = config.beta * config.beta;
+    for (size_t i = 0; i < n; ++i) {
+        const double mu = ratings[players[i]].mu;
+        for (size_t q = 0; q < n; ++q) {
+            if (q == i) continue;
+            const double c = std::sqrt(variance[i] + variance[q] + 2.0 * beta2);
+            const double t = (mu - ratings[players[q]].mu) / c, e = config.drawMargin / c;
+            const double gamma = std::sqrt(variance[i]) / c;
+            double v, w;
+            if (ranks[i] < ranks[q]) {
+                v = vWin(t, e);
+                w = wWin(t, e);
+            } else if (ranks[i] > ranks[q]) {
+                v = -vWin(-t, e);
+                w = wWin(-t, e);
+            } else {
+                v = vDraw(t, e);
+                w = wDraw(t, e);
+            }
+            meanStep[i] += variance[i] / c * v;
+            varianceShrink[i] += gamma * variance[i] / (c * c) * w;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        Rating& r = ratings[players[i]];
+        r.mu += meanStep[i];
+        r.sigma = std::sqrt(variance[i] * std::max(1.0 - varianceShrink[i], MIN_SHRINK));
+        board.set(players[i], r.conservative());
+    }
+    ++games;
+}
+
+/**
+ * @brief Records a simulated game.
+ * @param seats Player id of each seat.
+ * @param result The game's outcome.
+ * @throws std::invalid_argument or std::out_of_range as record(players, ranks).
+ */
+void RatingEngine::record(const std::vector<int>& seats, const GameResult& result) {
+    record(seats, finishingRanks(result, seats.size()));
+}
+
+/**
+ * @brief Returns a player's rating.
+ * @param id Player id.
+ * @throws std::out_of_range if the player does not exist.
+ */
+const Rating& RatingEngine::rating(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= ratings.size()) throw std::out_of_range("No such player");
+    return ratings[id];
+}
+
+/**
+ * @brief Returns a player's name.
+ * @param id Player id.
+ * @throws std::out_of_range if the player does not exist.
+ */
+const std::string& RatingEngine::name(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= names.size()) throw std::out_of_range("No such player");
+    return names[id];
+}
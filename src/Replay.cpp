@@ -0,0 +1,160 @@
+// orel2744@gmail.com
+// Replay.cpp - Implementation of game recordings and the keyframe-indexed replay viewer.
+#include "Replay.hpp"
+#include "Player.hpp"
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+const char* const REPLAY_MAGIC = "COUP-REPLAY";
+const int REPLAY_VERSION = 1;
+}
+
+/**
+ * @brief Adds the next seat of the recorded game.
+ * @param name Player name.
+ * @param role Player role.
+ */
+void Replay::addSeat(const std::string& name, Role role) {
+    seats.push_back({name, role});
+}
+
+/**
+ * @brief Appends an attempted action to the recording.
+ * @param action The action.
+ */
+void Replay::record(const Action& action) {
+    actions.push_back(action);
+}
+
+/**
+ * @brief Removes all seats and actions.
+ */
+void Replay::clear() {
+    seats.clear();
+    actions.clear();
+}
+
+/**
+ * @brief Writes the recording. Format:
+ *        "COUP-REPLAY 1", "seats N", N lines of "<role> <name>", "actions M", M lines of "<action> <actor> <target>".
+ * @param out Output stream.
+ */
+void Replay::save(std::ostream& out) const {
+    out << REPLAY_MAGIC << ' ' << REPLAY_VERSION << '\n';
+    out << "seats " << seats.size() << '\n';
+    for (const Seat& s : seats) out << roleToString(s.role) << ' ' << s.name << '\n';
+    out << "actions " << actions.size() << '\n';
+    for (const Action& a : actions) out << actionTypeToString(a.type) << ' ' << a.actor << ' ' << a.target << '\n';
+}
+
+/**
+ * @brief Reads a recording written by save().
+ * @param in Input stream.
+ * @return The loaded replay.
+ * @throws std::runtime_error if the input is not a valid replay.
+ */
+Replay Replay::load(std::istream& in) {
+    Replay r;
+    std::string word;
+    int version = 0;
+    size_t count = 0;
+    if (!(in >> word >> version) || word != REPLAY_MAGIC || version != REPLAY_VERSION)
+        throw std::runtime_error("Not a replay file (bad header)");
+    if (!(in >> word >> count) || word != "seats") throw std::runtime_error("Replay: missing seats");
+    for (size_t i = 0; i < count; ++i) {
+        std::string roleName, name;
+        if (!(in >> roleName) || !std::getline(in, name) || name.size() < 2)
+            throw std::runtime_error("Replay: truncated seat list");
+        Role role = roleFromString(roleName);
+        if (role == Role::Unknown) throw std::runtime_error("Replay: unknown role " + roleName);
+        r.addSeat(name.substr(1), role);
+    }
+    if (!(in >> word >> count) || word != "actions") throw std::runtime_error("Replay: missing actions");
+    r.actions.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Action a;
+        if (!(in >> word >> a.actor >> a.target)) throw std::runtime_error("Replay: truncated action list");
+        try { a.type = actionTypeFromString(word); }
+        catch (const std::invalid_argument& e) { throw std::runtime_error(std::string("Replay: ") + e.what()); }
+        if (a.actor < 0 || static_cast<size_t>(a.actor) >= r.seats.size() ||
+            a.target < -1 || a.target >= static_cast<int>(r.seats.size()))
+            throw std::runtime_error("Replay: action refers to a missing seat");
+        r.record(a);
+    }
+    return r;
+}
+
+/**
+ * @brief Builds the viewer and its keyframes; the viewer starts at step 0.
+ * @param rep The recording to play (copied).
+ * @param keyframeInterval Actions between keyframes.
+ * @throws std::invalid_argument if the replay has fewer than 2 seats or the interval is zero.
+ */
+ReplayViewer::ReplayViewer(const Replay& rep, size_t keyframeInterval)
+    : replay(rep), interval(keyframeInterval) {
+    if (interval == 0) throw std::invalid_argument("Keyframe interval must be positive");
+    if (replay.getSeats().size() < 2) throw std::invalid_argument("Replay needs at least 2 seats");
+    game.setLogging(false);
+    for (const Replay::Seat& s : replay.getSeats())
+        owned.emplace_back(Game::createPlayerWithRole(s.name, &game, s.role));
+
+    keyframes.reserve(length() / interval + 1);
+    keyframes.push_back(game.snapshot());
+    while (pos < length()) {
+        applyNext();
+        if (pos % interval == 0) keyframes.push_back(game.snapshot());
+    }
+    seek(0);
+}
+
+ReplayViewer::~ReplayViewer() = default;
+
+/**
+ * @brief Moves to the state after `step` actions (clamped to length()).
+ *        Steps forward directly when the target is within one keyframe interval ahead,
+ *        otherwise restores the nearest keyframe at or before the target.
+ * @param target Target position.
+ */
+void ReplayViewer::seek(size_t target) {
+    if (target > length()) target = length();
+    if (target < pos || target - pos >= interval) {
+        size_t k = target / interval;
+        game.restore(keyframes[k]);
+        pos = k * interval;
+        error.clear();
+    }
+    while (pos < target) applyNext();
+}
+
+/**
+ * @brief Applies the next action.
+ * @return False if already at the end.
+ */
+bool ReplayViewer::step() {
+    if (pos >= length()) return false;
+    applyNext();
+    return true;
+}
+
+/**
+ * @brief Returns the last applied action, or nullptr at step 0.
+ */
+const Action* ReplayViewer::lastAction() const {
+    return pos == 0 ? nullptr : &replay.getActions()[pos - 1];
+}
+
+/**
+ * @brief Applies the action at the current position, remembering why it was rejected if it threw.
+ */
+void ReplayViewer::applyNext() {
+    error.clear();
+    try {
+        applyAction(game, replay.getActions()[pos]);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    ++pos;
+}
@@ -0,0 +1,128 @@
+// orel2744@gmail.com
+// RoleBeliefs.cpp - Bayesian role beliefs with rule-derived likelihoods (one replay per role and seat).
+#include "RoleBeliefs.hpp"
+#include <stdexcept>
+
+namespace {
+// True if the action, tried on `trial`, does what was observed (roles aside, everything is public)
+bool reproduces(LaneState trial, const Action& action, bool accepted, const LaneState& after) {
+    if (trial.apply(action) != accepted) return false;
+    for (int p = 0; p < LaneState::MAX_SEATS; ++p) trial.role[p] = after.role[p];
+    return trial == after;
+}
+
+RoleBeliefs::Distribution certain(int role) {
+    RoleBeliefs::Distribution d = {};
+    d[role] = 1.0f;
+    return d;
+}
+}
+
+/**
+ * @brief Starts from the deal.
+ * @param state The game.
+ * @param observer The observing seat, or -1 for a spectator.
+ * @throws std::out_of_range if the observer seat does not exist.
+ */
+RoleBeliefs::RoleBeliefs(const LaneState& state, int observer) : seats(state.seats) {
+    if (observer < -1 || observer >= state.seats) throw std::out_of_range("No such seat.");
+    for (int p = 0; p < seats; ++p) {
+        if (p == observer || !state.alive[p]) beliefs[p] = certain(state.role[p]);
+        else beliefs[p].fill(1.0f / ROLES);
+    }
+}
+
+/**
+ * @brief Multiplies seat s's distribution by the likelihood of each role and renormalises.
+ * @param s Seat index.
+ * @param likelihood Called with each role of positive probability; returns the likelihood of the evidence.
+ */
+template <class Likelihood>
+void RoleBeliefs::update(int s, Likelihood&& likelihood) {
+    Distribution next = {};
+    float total = 0.0f;
+    for (int r = 0; r < ROLES; ++r) {
+        if (beliefs[s][r] <= 0.0f) continue;
+        next[r] = beliefs[s][r] * likelihood(r);
+        total += next[r];
+    }
+    if (total <= 0.0f) return;
+    for (float& p : next) p /= total;
+    beliefs[s] = next;
+}
+
+/**
+ * @brief Updates the actor's and target's beliefs after an action was tried.
+ * @param before The game before the action.
+ * @param action The action.
+ * @param accepted Whether the rules accepted it.
+ * @param after The game after the action.
+ */
+void RoleBeliefs::observe(const LaneState& before, const Action& action, bool accepted, const LaneState& after) {
+    const int actor = action.actor;
+    int target = actionNeedsTarget(action.type) ? action.target : -1;
+    if (target >= seats) target = -1;
+    if (actor >= 0 && actor < seats) {
+        LaneState trial = before;
+        if (target >= 0) trial.role[target] = static_cast<uint8_t>(mostLikely(target));
+        update(actor, [&](int r) {
+            trial.role[actor] = static_cast<uint8_t>(r);
+            return reproduces(trial, action, accepted, after) ? 1.0f : 0.0f;
+        });
+        if (target >= 0 && target != actor) {
+            trial = before;
+            trial.role[actor] = static_cast<uint8_t>(mostLikely(actor));
+            update(target, [&](int r) {
+                trial.role[target] = static_cast<uint8_t>(r);
+                return reproduces(trial, action, accepted, after) ? 1.0f : 0.0f;
+            });
+        }
+    }
+    for (int p = 0; p < seats; ++p) {
+        if (!after.alive[p]) beliefs[p] = certain(after.role[p]);
+    }
+}
+
+/**
+ * @brief Returns the most likely role of seat s (lowest Role on ties).
+ * @param s Seat index.
+ */
+Role RoleBeliefs::mostLikely(int s) const {
+    int best = 0;
+    for (int r = 1; r < ROLES; ++r) {
+        if (beliefs[s][r] > beliefs[s][best]) best = r;
+    }
+    return static_cast<Role>(best);
+}
+
+/**
+ * @brief Returns the mask of roles seat s may hold.
+ * @param s Seat index.
+ */
+uint8_t RoleBeliefs::support(int s) const {
+    uint8_t mask = 0;
+    for (int r = 0; r < ROLES; ++r) {
+        if (beliefs[s][r] > 0.0f) mask |= static_cast<uint8_t>(1u << r);
+    }
+    return mask;
+}
+
+/**
+ * @brief Returns a copy of the state with every uncertain role drawn from its distribution.
+ * @param state The game.
+ * @param rng Random source.
+ */
+LaneState RoleBeliefs::sample(const LaneState& state, std::mt19937_64& rng) const {
+    LaneState s = state;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int p = 0; p < seats; ++p) {
+        float u = unit(rng);
+        int r = 0;
+        for (; r < ROLES - 1; ++r) {
+            if (beliefs[p][r] > 0.0f && (u -= beliefs[p][r]) < 0.0f) break;
+        }
+        while (beliefs[p][r] <= 0.0f && r > 0) --r;  // rounding left u just above 0
+        s.role[p] = static_cast<uint8_t>(r);
+    }
+    return s;
+}
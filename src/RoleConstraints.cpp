@@ -0,0 +1,109 @@
+// orel2744@gmail.com
+// RoleConstraints.cpp - Role elimination by replaying observed actions under each remaining role.
+#include "RoleConstraints.hpp"
+#include <stdexcept>
+
+namespace {
+// True if two states differ at most in their roles (everything else is public)
+bool samePublic(const LaneState& a, LaneState b) {
+    for (int p = 0; p < LaneState::MAX_SEATS; ++p) b.role[p] = a.role[p];
+    return a == b;
+}
+
+int roleCount(uint8_t mask) {
+    int count = 0;
+    for (; mask; mask &= static_cast<uint8_t>(mask - 1)) ++count;
+    return count;
+}
+}
+
+/**
+ * @brief Starts from the observer's knowledge at the deal: its own role and eliminated seats' roles.
+ * @param state The game.
+ * @param observer The observing seat.
+ * @throws std::out_of_range if the seat does not exist.
+ */
+RoleConstraints::RoleConstraints(const LaneState& state, int observer) : seat(observer) {
+    if (observer < 0 || observer >= state.seats) throw std::out_of_range("No such seat.");
+    for (int p = 0; p < state.seats; ++p) {
+        bool shown = p == observer || !state.alive[p];
+        masks[p] = shown ? static_cast<uint8_t>(1u << state.role[p]) : ALL_ROLES;
+    }
+}
+
+/**
+ * @brief Narrows the actor's and target's roles after an action was tried.
+ * @param before The game before the action.
+ * @param action The action.
+ * @param accepted Whether the rules accepted it.
+ * @param after The game after the action.
+ */
+void RoleConstraints::observe(const LaneState& before, const Action& action, bool accepted, const LaneState& after) {
+    const int n = before.seats;
+    const int actor = action.actor;
+    int target = actionNeedsTarget(action.type) ? action.target : -1;
+    if (actor >= 0 && actor < n) {
+        if (target >= n) target = -1;
+        const uint8_t actorMask = masks[actor];
+        const uint8_t targetMask = target >= 0 ? masks[target] : 1;
+        uint8_t keepActor = 0, keepTarget = 0;
+        for (int ra = 0; ra < 6; ++ra) {
+            if (!(actorMask & (1u << ra))) continue;
+            for (int rt = 0; rt < 6; ++rt) {
+                if (!(targetMask & (1u << rt)) || (target == actor && rt != ra)) continue;
+                LaneState trial = before;
+                trial.role[actor] = static_cast<uint8_t>(ra);
+                if (target >= 0) trial.role[target] = static_cast<uint8_t>(rt);
+                if (trial.apply(action) != accepted || !samePublic(trial, after)) continue;
+                keepActor |= static_cast<uint8_t>(1u << ra);
+                keepTarget |= static_cast<uint8_t>(1u << rt);
+            }
+        }
+        // Nothing consistent means the observation was not made under these rules; keep what we had
+        if (keepActor) masks[actor] = keepActor;
+        if (target >= 0 && keepTarget) masks[target] = keepTarget;
+    }
+    for (int p = 0; p < n; ++p) {
+        if (!after.alive[p]) masks[p] = static_cast<uint8_t>(1u << after.role[p]);
+    }
+}
+
+/**
+ * @brief Returns the role of seat s if only one remains, otherwise Role::Unknown.
+ * @param s Seat index.
+ */
+Role RoleConstraints::known(int s) const {
+    if (roleCount(masks[s]) != 1) return Role::Unknown;
+    int r = 0;
+    while (!(masks[s] & (1u << r))) ++r;
+    return static_cast<Role>(r);
+}
+
+/**
+ * @brief Returns a copy of the state with every hidden role drawn uniformly from its allowed set.
+ * @param state The game.
+ * @param rng Random source.
+ */
+LaneState RoleConstraints::determinise(const LaneState& state, std::mt19937_64& rng) const {
+    LaneState s = state;
+    for (int p = 0; p < s.seats; ++p) {
+        int count = roleCount(masks[p]);
+        int pick = count > 1 ? std::uniform_int_distribution<int>(0, count - 1)(rng) : 0;
+        for (int r = 0; r < 6; ++r) {
+            if (!(masks[p] & (1u << r)) || pick-- > 0) continue;
+            s.role[p] = static_cast<uint8_t>(r);
+            break;
+        }
+    }
+    return s;
+}
+
+/**
+ * @brief Returns a copy of the state with roles the observer does not know set to Role::Unknown.
+ * @param state The game.
+ */
+LaneState RoleConstraints::hide(const LaneState& state) const {
+    LaneState s = state;
+    for (int p = 0; p < s.seats; ++p) s.role[p] = static_cast<uint8_t>(known(p));
+    return s;
+}
@@ -0,0 +1,261 @@
+// orel2744@gmail.com
+// SimdKernels.cpp - Scalar, SSE2 and AVX2 legality-mask and coin kernels with runtime dispatch.
+#include "SimdKernels.hpp"
+#include "Action.hpp"
+#include "Role.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define COUP_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+constexpr uint16_t bit(ActionType t) { return static_cast<uint16_t>(1u << static_cast<unsigned>(t)); }
+
+const uint8_t GOVERNOR = static_cast<uint8_t>(Role::Governor), SPY = static_cast<uint8_t>(Role::Spy),
+              BARON = static_cast<uint8_t>(Role::Baron), GENERAL = static_cast<uint8_t>(Role::General),
+              JUDGE = static_cast<uint8_t>(Role::Judge);
+
+// Mirrors the actor-side checks of Player (see seatActionMasks)
+uint16_t maskOf(int coins, int bank, int sanction, int alive, int extra, int pending, int role) {
+    if (!alive) return 0;
+    uint16_t m = bit(ActionType::Arrest) | bit(ActionType::SkipTurn);
+    bool unsanctioned = sanction < 0;
+    if (unsanctioned && bank > 0) m |= bit(ActionType::Gather);
+    if (unsanctioned && pending == 0 && bank >= (role == GOVERNOR ? 3 : 2)) m |= bit(ActionType::Tax);
+    if (bank >= 4 && coins >= 4 && !extra && pending == 0) m |= bit(ActionType::Bribe);
+    if (bank >= 3 && coins >= 3) m |= bit(ActionType::Sanction);
+    if (bank >= 7 && coins >= 7) m |= bit(ActionType::Coup);
+    if (role == BARON && coins >= 3 && bank >= 3) m |= bit(ActionType::Invest);
+    if (role == SPY) m |= bit(ActionType::SpyOn);
+    if (role == GENERAL && coins >= 5) m |= bit(ActionType::PreventCoup);
+    if (role == JUDGE) m |= bit(ActionType::JudgeBribe);
+    if (role == GOVERNOR) m |= bit(ActionType::BlockTax);
+    return m;
+}
+
+void masksScalar(const SeatColumns& c, int seat, uint16_t* out, size_t begin, size_t n) {
+    for (size_t i = begin; i < n; ++i) {
+        if (c.turn[i] != seat) continue;
+        out[i] = maskOf(c.coins[i], c.bank[i], c.sanction[i], c.alive[i], c.extra[i], c.pending[i], c.role[i]);
+    }
+}
+
+void payScalar(int16_t* coins, int16_t* bank, const int8_t* turn, int seat, const int16_t* amount, size_t begin, size_t n) {
+    for (size_t i = begin; i < n; ++i) {
+        int16_t d = turn[i] == seat ? amount[i] : 0;
+        coins[i] = static_cast<int16_t>(coins[i] + d);
+        bank[i] = static_cast<int16_t>(bank[i] - d);
+    }
+}
+
+void masksScalarAll(const SeatColumns& c, int seat, uint16_t* out, size_t n) { masksScalar(c, seat, out, 0, n); }
+void payScalarAll(int16_t* coins, int16_t* bank, const int8_t* turn, int seat, const int16_t* amount, size_t n) {
+    payScalar(coins, bank, turn, seat, amount, 0, n);
+}
+
+#ifdef COUP_SIMD_X86
+// SSE2: 8 lanes of int16 per iteration; bytes are widened with unpack (signed ones by an arithmetic shift)
+__attribute__((target("sse2")))
+void masksSse2(const SeatColumns& c, int seat, uint16_t* out, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+#define U8(p) _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>((p) + i)), zero)
+#define S8(p) _mm_srai_epi16(_mm_unpacklo_epi8(zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>((p) + i))), 8)
+#define GE(v, k) _mm_cmpgt_epi16((v), _mm_set1_epi16((k) - 1))
+#define IS(v, k) _mm_cmpeq_epi16((v), _mm_set1_epi16(k))
+#define BIT(cond, t) _mm_and_si128((cond), _mm_set1_epi16(static_cast<short>(bit(t))))
+        __m128i coins = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.coins + i));
+        __m128i bank = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.bank + i));
+        __m128i turn = S8(c.turn);
+        __m128i sanction = S8(c.sanction);
+        __m128i alive = U8(c.alive), extra = U8(c.extra), pending = U8(c.pending), role = U8(c.role);
+
+        __m128i unsanctioned = _mm_cmpgt_epi16(zero, sanction);
+        __m128i idle = _mm_cmpeq_epi16(pending, zero);
+        __m128i gov = IS(role, GOVERNOR);
+        __m128i taxNeed = _mm_sub_epi16(_mm_set1_epi16(2), gov); // gov lanes are -1, so 3
+        __m128i m = _mm_set1_epi16(static_cast<short>(bit(ActionType::Arrest) | bit(ActionType::SkipTurn)));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(unsanctioned, _mm_cmpgt_epi16(bank, zero)), ActionType::Gather));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(_mm_and_si128(unsanctioned, idle), _mm_cmpgt_epi16(bank, _mm_sub_epi16(taxNeed, one))), ActionType::Tax));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(_mm_and_si128(GE(bank, 4), GE(coins, 4)), _mm_and_si128(_mm_cmpeq_epi16(extra, zero), idle)), ActionType::Bribe));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(GE(bank, 3), GE(coins, 3)), ActionType::Sanction));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(GE(bank, 7), GE(coins, 7)), ActionType::Coup));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(IS(role, BARON), _mm_and_si128(GE(coins, 3), GE(bank, 3))), ActionType::Invest));
+        m = _mm_or_si128(m, BIT(IS(role, SPY), ActionType::SpyOn));
+        m = _mm_or_si128(m, BIT(_mm_and_si128(IS(role, GENERAL), GE(coins, 5)), ActionType::PreventCoup));
+        m = _mm_or_si128(m, BIT(IS(role, JUDGE), ActionType::JudgeBribe));
+        m = _mm_or_si128(m, BIT(gov, ActionType::BlockTax));
+        m = _mm_and_si128(m, _mm_cmpgt_epi16(alive, zero));
+
+        __m128i sel = IS(turn, seat);
+        __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(out + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(_mm_and_si128(sel, m), _mm_andnot_si128(sel, old)));
+#undef U8
+#undef S8
+#undef GE
+#undef IS
+#undef BIT
+    }
+    masksScalar(c, seat, out, i, n);
+}
+
+__attribute__((target("sse2")))
+void paySse2(int16_t* coins, int16_t* bank, const int8_t* turn, int seat, const int16_t* amount, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i who = _mm_set1_epi16(static_cast<short>(seat));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i t = _mm_srai_epi16(_mm_unpacklo_epi8(zero, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(turn + i))), 8);
+        __m128i d = _mm_and_si128(_mm_cmpeq_epi16(t, who), _mm_loadu_si128(reinterpret_cast<const __m128i*>(amount + i)));
+        __m128i* cp = reinterpret_cast<__m128i*>(coins + i);
+        __m128i* bp = reinterpret_cast<__m128i*>(bank + i);
+        _mm_storeu_si128(cp, _mm_add_epi16(_mm_loadu_si128(cp), d));
+        _mm_storeu_si128(bp, _mm_sub_epi16(_mm_loadu_si128(bp), d));
+    }
+    payScalar(coins, bank, turn, seat, amount, i, n);
+}
+
+// AVX2: 16 lanes of int16 per iteration; bytes are widened with vpmovzx/vpmovsx
+__attribute__((target("avx2")))
+void masksAvx2(const SeatColumns& c, int seat, uint16_t* out, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+#define U8(p) _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>((p) + i)))
+#define S8(p) _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>((p) + i)))
+#define GE(v, k) _mm256_cmpgt_epi16((v), _mm256_set1_epi16((k) - 1))
+#define IS(v, k) _mm256_cmpeq_epi16((v), _mm256_set1_epi16(k))
+#define BIT(cond, t) _mm256_and_si256((cond), _mm256_set1_epi16(static_cast<short>(bit(t))))
+        __m256i coins = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.coins + i));
+        __m256i bank = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c.bank + i));
+        __m256i turn = S8(c.turn);
+        __m256i sanction = S8(c.sanction);
+        __m256i alive = U8(c.alive), extra = U8(c.extra), pending = U8(c.pending), role = U8(c.role);
+
+        __m256i unsanctioned = _mm256_cmpgt_epi16(zero, sanction);
+        __m256i idle = _mm256_cmpeq_epi16(pending, zero);
+        __m256i gov = IS(role, GOVERNOR);
+        __m256i taxNeed = _mm256_sub_epi16(_mm256_set1_epi16(2), gov);
+        __m256i m = _mm256_set1_epi16(static_cast<short>(bit(ActionType::Arrest) | bit(ActionType::SkipTurn)));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(unsanctioned, _mm256_cmpgt_epi16(bank, zero)), ActionType::Gather));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(_mm256_and_si256(unsanctioned, idle), _mm256_cmpgt_epi16(bank, _mm256_sub_epi16(taxNeed, one))), ActionType::Tax));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(_mm256_and_si256(GE(bank, 4), GE(coins, 4)), _mm256_and_si256(_mm256_cmpeq_epi16(extra, zero), idle)), ActionType::Bribe));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(GE(bank, 3), GE(coins, 3)), ActionType::Sanction));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(GE(bank, 7), GE(coins, 7)), ActionType::Coup));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(IS(role, BARON), _mm256_and_si256(GE(coins, 3), GE(bank, 3))), ActionType::Invest));
+        m = _mm256_or_si256(m, BIT(IS(role, SPY), ActionType::SpyOn));
+        m = _mm256_or_si256(m, BIT(_mm256_and_si256(IS(role, GENERAL), GE(coins, 5)), ActionType::PreventCoup));
+        m = _mm256_or_si256(m, BIT(IS(role, JUDGE), ActionType::JudgeBribe));
+        m = _mm256_or_si256(m, BIT(gov, ActionType::BlockTax));
+        m = _mm256_and_si256(m, _mm256_cmpgt_epi16(alive, zero));
+
+        __m256i sel = IS(turn, seat);
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_blendv_epi8(old, m, sel));
+#undef U8
+#undef S8
+#undef GE
+#undef IS
+#undef BIT
+    }
+    masksScalar(c, seat, out, i, n);
+}
+
+__attribute__((target("avx2")))
+void payAvx2(int16_t* coins, int16_t* bank, const int8_t* turn, int seat, const int16_t* amount, size_t n) {
+    const __m256i who = _mm256_set1_epi16(static_cast<short>(seat));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i t = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(turn + i)));
+        __m256i d = _mm256_and_si256(_mm256_cmpeq_epi16(t, who), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amount + i)));
+        __m256i* cp = reinterpret_cast<__m256i*>(coins + i);
+        __m256i* bp = reinterpret_cast<__m256i*>(bank + i);
+        _mm256_storeu_si256(cp, _mm256_add_epi16(_mm256_loadu_si256(cp), d));
+        _mm256_storeu_si256(bp, _mm256_sub_epi16(_mm256_loadu_si256(bp), d));
+    }
+    payScalar(coins, bank, turn, seat, amount, i, n);
+}
+#endif
+
+/**
+ * @brief The kernel table for one SimdLevel.
+ */
+struct Kernels {
+    SimdLevel level;
+    void (*masks)(const SeatColumns&, int, uint16_t*, size_t);
+    void (*pay)(int16_t*, int16_t*, const int8_t*, int, const int16_t*, size_t);
+};
+
+Kernels kernelsFor(SimdLevel level) {
+#ifdef COUP_SIMD_X86
+    if (level == SimdLevel::AVX2) return {SimdLevel::AVX2, masksAvx2, payAvx2};
+    if (level == SimdLevel::SSE2) return {SimdLevel::SSE2, masksSse2, paySse2};
+#endif
+    return {SimdLevel::Scalar, masksScalarAll, payScalarAll};
+}
+
+Kernels& active() {
+    static Kernels k = kernelsFor(detectSimdLevel());
+    return k;
+}
+}
+
+/**
+ * @brief Returns the widest implementation this CPU supports.
+ */
+SimdLevel detectSimdLevel() {
+#ifdef COUP_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel activeSimdLevel() { return active().level; }
+
+/**
+ * @brief Selects the kernel implementation; not thread-safe.
+ * @param level Requested level; clamped to what the CPU supports.
+ * @return The level actually selected.
+ */
+SimdLevel setSimdLevel(SimdLevel level) {
+    SimdLevel best = detectSimdLevel();
+    if (static_cast<uint8_t>(level) > static_cast<uint8_t>(best)) level = best;
+    active() = kernelsFor(level);
+    return active().level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * @brief For every lane where it is `seat`'s turn, writes that seat's action mask.
+ * @param c Columns of `seat`.
+ * @param seat The seat.
+ * @param out One mask per lane.
+ * @param n Number of lanes.
+ */
+void seatActionMasks(const SeatColumns& c, int seat, uint16_t* out, size_t n) { active().masks(c, seat, out, n); }
+
+/**
+ * @brief For every lane where it is `seat`'s turn, moves amount[i] coins from the lane's bank to the seat.
+ * @param coins Coins column of `seat`.
+ * @param bank Bank of every lane.
+ * @param turn Seat to act in every lane.
+ * @param seat The seat.
+ * @param amount Coins per lane.
+ * @param n Number of lanes.
+ */
+void payFromBank(int16_t* coins, int16_t* bank, const int8_t* turn, int seat, const int16_t* amount, size_t n) {
+    active().pay(coins, bank, turn, seat, amount, n);
+}
@@ -0,0 +1,103 @@
+// orel2744@gmail.com
+// Simulation.cpp - Headless play of complete games with a simple randomised policy.
+#include "Simulation.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include "Trace.hpp"
+#include <memory>
+#include <stdexcept>
+
+namespace {
+// Picks a random alive opponent of the observer
+int randomOpponent(const Observation& view, std::mt19937_64& rng) {
+    int alive = 0;
+    for (int s = 0; s < view.seatCount(); ++s) alive += (view.alive(s) && s != view.getSeat()) ? 1 : 0;
+    if (alive == 0) return -1;
+    int pick = static_cast<int>(std::uniform_int_distribution<int>(0, alive - 1)(rng));
+    for (int s = 0; s < view.seatCount(); ++s) {
+        if (!view.alive(s) || s == view.getSeat()) continue;
+        if (pick-- == 0) return s;
+    }
+    return -1;
+}
+}
+
+/**
+ * @brief Picks an action for the player whose turn it is, using a simple randomised heuristic.
+ *        The policy only reads the acting seat's Observation, so it never sees hidden roles.
+ * @param game The game (must have a current player).
+ * @param rng Random source.
+ * @return The chosen action; it may still be rejected by the rules.
+ */
+Action chooseSimpleAction(const Game& game, std::mt19937_64& rng) {
+    TraceScope trace("chooseSimpleAction", "bot");
+    Observation view = game.viewFor(game.currentPlayer()->getSeat());
+    int coins = view.coins(view.getSeat());
+    Action a{ActionType::Gather, view.getSeat(), -1};
+    double r = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    if (coins >= 10 || (coins >= 7 && r < 0.6)) {
+        a.type = ActionType::Coup;
+    } else if (view.myRole() == Role::Baron && coins >= 3 && r < 0.5) {
+        a.type = ActionType::Invest;
+    } else if (r < 0.35) {
+        a.type = ActionType::Tax;
+    } else if (r < 0.6) {
+        a.type = ActionType::Gather;
+    } else if (r < 0.75) {
+        a.type = ActionType::Arrest;
+    } else if (r < 0.85 && coins >= 3) {
+        a.type = ActionType::Sanction;
+    }
+    if (actionNeedsTarget(a.type)) a.target = randomOpponent(view, rng);
+    return a;
+}
+
+/**
+ * @brief Plays one game to completion (or to the action cap) with chooseSimpleAction for every seat.
+ * @param roles Role of each seat, in seat order (at least 2).
+ * @param seed Seed of the policy's random source.
+ * @param maxActions Cap on attempted actions.
+ * @return The game's outcome.
+ * @throws std::invalid_argument if fewer than 2 roles are given.
+ */
+GameResult playGame(const std::vector<Role>& roles, uint64_t seed, size_t maxActions) {
+    TraceScope trace("playGame", "sim");
+    if (roles.size() < 2) throw std::invalid_argument("A game needs at least 2 players");
+    Game game;
+    game.setLogging(false);
+    std::vector<std::unique_ptr<Player>> seats;
+    seats.reserve(roles.size());
+    for (size_t i = 0; i < roles.size(); ++i)
+        seats.emplace_back(Game::createPlayerWithRole("Seat " + std::to_string(i + 1), &game, roles[i]));
+
+    std::mt19937_64 rng(seed);
+    GameResult result;
+    auto aliveCount = [&seats]() {
+        size_t alive = 0;
+        for (const auto& p : seats) alive += p->isAlive() ? 1 : 0;
+        return alive;
+    };
+    while (aliveCount() > 1 && result.actions < maxActions) {
+        Action a = chooseSimpleAction(game, rng);
+        ++result.actions;
+        try {
+            applyAction(game, a);
+        } catch (const std::exception&) {
+            try {
+                applyAction(game, {ActionType::Gather, a.actor, -1});
+            } catch (const std::exception&) {
+                applyAction(game, {ActionType::SkipTurn, a.actor, -1});
+            }
+        }
+    }
+    result.eliminationOrder = game.getEliminationOrder();
+    if (aliveCount() == 1) {
+        for (size_t i = 0; i < seats.size(); ++i) {
+            if (seats[i]->isAlive()) {
+                result.winner = static_cast<int>(i);
+                result.winnerRole = roles[i];
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,563 @@
+// orel2744@gmail.com
+// Solver.cpp - Exact 2-player solver: parallel state enumeration into a concurrent hash table,
+// then level-by-level retrograde labelling over the reversed move graph.
+#include "Solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+const int MAX_CAP = 120;          // children of a capped state must still fit 7 bits (+7 at most per action)
+const int MAX_MOVES = 21;         // 5 untargeted + 8 targeted action types x 2 seats
+const int SEAT_BITS = 23;
+const uint64_t OCCUPIED = 1ULL << 63;
+const uint8_t FINAL = 2;          // decider of a final state
+// The one action without a turn check each role has, by Role (SkipTurn: none)
+const ActionType REACTION_OF[] = {ActionType::BlockTax, ActionType::SpyOn, ActionType::SkipTurn,
+                                  ActionType::PreventCoup, ActionType::JudgeBribe, ActionType::SkipTurn};
+
+/**
+ * @brief Packs a 2-seat state and its window flag into 55 bits (roles are fixed per solve).
+ */
+uint64_t pack(const LaneState& s, bool reacting) {
+    uint64_t k = (reacting ? 1u : 0u) | (static_cast<uint64_t>(s.turn) << 1) | (static_cast<uint64_t>(s.bank) << 2);
+    for (int p = 0; p < 2; ++p) {
+        uint64_t v = static_cast<uint64_t>(s.coins[p]) | (static_cast<uint64_t>(s.alive[p]) << 7) |
+                     (static_cast<uint64_t>(s.extra[p]) << 8) | (static_cast<uint64_t>(s.pending[p]) << 9);
+        const int8_t small[] = {s.sanction[p], s.arrestBlock[p], s.coupBlock[p], s.bribe[p], s.tax[p], s.arrestTarget[p]};
+        for (int f = 0; f < 6; ++f) v |= static_cast<uint64_t>(small[f] + 1) << (11 + 2 * f);
+        k |= v << (9 + SEAT_BITS * p);
+    }
+    return k;
+}
+
+/**
+ * @brief Unpacks a key into a copy of the dealt state.
+ */
+LaneState unpack(uint64_t k, const LaneState& dealt) {
+    LaneState s = dealt;
+    s.turn = static_cast<int8_t>((k >> 1) & 1);
+    s.bank = static_cast<int16_t>((k >> 2) & 127);
+    for (int p = 0; p < 2; ++p) {
+        uint64_t v = k >> (9 + SEAT_BITS * p);
+        s.coins[p] = static_cast<int16_t>(v & 127);
+        s.alive[p] = (v >> 7) & 1;
+        s.extra[p] = (v >> 8) & 1;
+        s.pending[p] = (v >> 9) & 3;
+        int8_t* small[] = {&s.sanction[p], &s.arrestBlock[p], &s.coupBlock[p], &s.bribe[p], &s.tax[p], &s.arrestTarget[p]};
+        for (int f = 0; f < 6; ++f) *small[f] = static_cast<int8_t>(static_cast<int>((v >> (11 + 2 * f)) & 3) - 1);
+    }
+    return s;
+}
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+const size_t PARALLEL_CHUNK = 256;
+
+/**
+ * @brief Runs fn(worker, begin, end) over [0, n) in chunks of PARALLEL_CHUNK claimed by up to `threads` threads
+ *        (chunks start at multiples of PARALLEL_CHUNK).
+ */
+template <class F>
+void parallelFor(size_t n, unsigned threads, F&& fn) {
+    std::atomic<size_t> next{0};
+    auto worker = [&](unsigned me) {
+        for (size_t b; (b = next.fetch_add(PARALLEL_CHUNK)) < n;) fn(me, b, std::min(n, b + PARALLEL_CHUNK));
+    };
+    unsigned count = static_cast<unsigned>(std::min<size_t>(threads, (n + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < count; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& t : pool) t.join();
+}
+
+/**
+ * @brief Open-addressing set of keys with lock-free inserts; grows only between parallel phases.
+ *        Each slot also holds the id of its state once ids are assigned.
+ */
+class StateTable {
+public:
+    explicit StateTable(size_t capacity) { rehash(capacity); }
+
+    size_t capacity() const { return mask + 1; }
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    // Returns the slot of key, inserting it if absent; `inserted` tells which.
+    size_t insert(uint64_t key, bool& inserted) {
+        const uint64_t tagged = key | OCCUPIED;
+        for (size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            uint64_t seen = keys[i].load(std::memory_order_relaxed);
+            if (seen == 0 && keys[i].compare_exchange_strong(seen, tagged, std::memory_order_relaxed)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                inserted = true;
+                return i;
+            }
+            if (seen == tagged) {
+                inserted = false;
+                return i;
+            }
+        }
+    }
+
+    // Returns the id stored for key, or -1 if absent.
+    int64_t find(uint64_t key) const {
+        const uint64_t tagged = key | OCCUPIED;
+        for (size_t i = mix(key) & mask;; i = (i + 1) & mask) {
+            uint64_t seen = keys[i].load(std::memory_order_relaxed);
+            if (seen == tagged) return ids[i];
+            if (seen == 0) return -1;
+        }
+    }
+
+    uint64_t keyAt(size_t slot) const { return keys[slot].load(std::memory_order_relaxed) & ~OCCUPIED; }
+    void setId(size_t slot, uint32_t id) { ids[slot] = id; }
+
+    // Grows to `capacity` slots (a power of two) and re-inserts every key with its id.
+    void rehash(size_t capacity) {
+        size_t old = keys ? mask + 1 : 0;
+        std::unique_ptr<std::atomic<uint64_t>[]> oldKeys = std::move(keys);
+        std::vector<uint32_t> oldIds = std::move(ids);
+        keys.reset(new std::atomic<uint64_t>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) keys[i].store(0, std::memory_order_relaxed);
+        ids.assign(capacity, 0);
+        mask = capacity - 1;
+        for (size_t s = 0; s < old; ++s) {
+            uint64_t k = oldKeys[s].load(std::memory_order_relaxed);
+            if (!k) continue;
+            size_t i = mix(k & ~OCCUPIED) & mask;
+            while (keys[i].load(std::memory_order_relaxed)) i = (i + 1) & mask;
+            keys[i].store(k, std::memory_order_relaxed);
+            ids[i] = oldIds[s];
+        }
+    }
+
+    size_t bytes() const { return capacity() * (sizeof(uint64_t) + sizeof(uint32_t)); }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> keys;
+    std::vector<uint32_t> ids;
+    size_t mask = 0;
+    std::atomic<size_t> count{0};
+};
+}
+
+struct TwoPlayerSolver::Impl {
+    const LaneState& dealt;
+    int16_t cap;
+    unsigned threads;
+
+    StateTable table{1 << 12};
+    std::vector<uint64_t> nodeKeys;   // id -> key
+    std::vector<uint8_t> decider;     // id -> seat deciding, or FINAL
+    std::vector<uint64_t> offsets;    // prefix sums of the distinct successor counts
+    std::vector<uint64_t> rOffsets;   // CSR of predecessors
+    std::vector<uint32_t> rEdges;
+    std::unique_ptr<std::atomic<uint8_t>[]> outcome;   // 0 unresolved, else winner + 1
+    std::vector<uint16_t> plies;
+    std::vector<uint8_t> exact;       // id -> 0 if the value depends on capped leaves
+    uint64_t capped = 0;
+    size_t peak = 0;
+    double seconds = 0.0;
+    bool solved = false;
+
+    Impl(const LaneState& dealt, int16_t cap, unsigned threads) : dealt(dealt), cap(cap), threads(threads) {}
+
+    bool overCap(const LaneState& s) const {
+        return s.bank > cap || s.coins[0] > cap || s.coins[1] > cap;
+    }
+
+    bool hasReaction(const LaneState& s) const {
+        int r = 1 - s.currentSeat();
+        ActionType t = REACTION_OF[s.role[r]];
+        if (t == ActionType::SkipTurn) return false;
+        for (int target = 0; target < 2; ++target) {
+            LaneState copy = s;
+            if (copy.apply({t, r, target})) return true;
+        }
+        return false;
+    }
+
+    // Key of the decision that follows a move by the seat to act
+    uint64_t afterAct(const LaneState& s) const {
+        return pack(s, s.winner() < 0 && hasReaction(s));
+    }
+
+    /**
+     * @brief Calls f(action, pass, childKey) for every decision of a state; nothing for final or capped states.
+     */
+    template <class F>
+    void forEachMove(uint64_t key, F&& f) const {
+        LaneState s = unpack(key, dealt);
+        if (s.winner() >= 0 || overCap(s)) return;
+        const int cur = s.currentSeat();
+        if (key & 1) {
+            f(Action{}, true, pack(s, false));
+            ActionType t = REACTION_OF[s.role[1 - cur]];
+            for (int target = 0; target < 2 && t != ActionType::SkipTurn; ++target) {
+                LaneState copy = s;
+                Action a{t, 1 - cur, target};
+                if (copy.apply(a)) f(a, false, pack(copy, false));
+            }
+            return;
+        }
+        for (int t = 0; t < ACTION_TYPE_COUNT; ++t) {
+            ActionType type = static_cast<ActionType>(t);
+            bool targeted = actionNeedsTarget(type);
+            for (int target = targeted ? 0 : -1; target < (targeted ? 2 : 0); ++target) {
+                LaneState copy = s;
+                Action a{type, cur, target};
+                if (copy.apply(a)) f(a, false, afterAct(copy));
+            }
+        }
+    }
+
+    uint32_t addNode(size_t slot) {
+        uint32_t id = static_cast<uint32_t>(nodeKeys.size());
+        uint64_t key = table.keyAt(slot);
+        table.setId(slot, id);
+        nodeKeys.push_back(key);
+        LaneState s = unpack(key, dealt);
+        if (s.winner() >= 0) decider.push_back(FINAL);
+        else decider.push_back(static_cast<uint8_t>((key & 1) ? 1 - s.currentSeat() : s.currentSeat()));
+        if (s.winner() < 0 && overCap(s)) ++capped;
+        return id;
+    }
+
+    // Breadth-first enumeration; each level is expanded in parallel chunks the table has room for
+    void enumerate(const std::vector<uint64_t>& roots) {
+        std::vector<uint32_t> frontier;
+        for (uint64_t key : roots) {
+            bool inserted = false;
+            size_t slot = table.insert(key, inserted);
+            if (inserted) frontier.push_back(addNode(slot));
+        }
+        std::vector<std::vector<uint64_t>> found(threads);
+        while (!frontier.empty()) {
+            std::vector<uint32_t> next;
+            for (size_t done = 0; done < frontier.size();) {
+                const size_t room = table.capacity() * 7 / 10;
+                if (room < table.size() + 1024 * MAX_MOVES) {
+                    table.rehash(table.capacity() * 2);
+                    continue;
+                }
+                size_t chunk = std::min(frontier.size() - done, (room - table.size()) / MAX_MOVES);
+                parallelFor(chunk, threads, [&](unsigned me, size_t b, size_t e) {
+                    for (size_t i = b; i < e; ++i) {
+                        forEachMove(nodeKeys[frontier[done + i]], [&](const Action&, bool, uint64_t child) {
+                            bool fresh = false;
+                            size_t slot = table.insert(child, fresh);
+                            if (fresh) found[me].push_back(slot);
+                        });
+                    }
+                });
+                for (std::vector<uint64_t>& slots : found) {
+                    for (uint64_t slot : slots) next.push_back(addNode(slot));
+                    slots.clear();
+                }
+                done += chunk;
+            }
+            frontier.swap(next);
+        }
+    }
+
+    // Distinct successor ids of every state (one expansion each), then the reversed graph;
+    // labelling needs only the out-degrees and the predecessors, so the forward edges are dropped
+    void buildGraph() {
+        const size_t n = nodeKeys.size();
+        std::vector<std::vector<uint32_t>> parts((n + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK);
+        offsets.assign(n + 1, 0);
+        parallelFor(n, threads, [&](unsigned, size_t b, size_t e) {
+            std::vector<uint32_t>& part = parts[b / PARALLEL_CHUNK];
+            for (size_t i = b; i < e; ++i) {
+                size_t first = part.size();
+                forEachMove(nodeKeys[i], [&](const Action&, bool, uint64_t child) {
+                    part.push_back(static_cast<uint32_t>(table.find(child)));
+                });
+                std::sort(part.begin() + static_cast<std::ptrdiff_t>(first), part.end());
+                part.erase(std::unique(part.begin() + static_cast<std::ptrdiff_t>(first), part.end()), part.end());
+                offsets[i + 1] = part.size() - first;
+            }
+        });
+        for (size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+        std::vector<uint32_t> edges;
+        edges.reserve(offsets[n]);
+        for (std::vector<uint32_t>& part : parts) {
+            edges.insert(edges.end(), part.begin(), part.end());
+            std::vector<uint32_t>().swap(part);
+        }
+
+        rOffsets.assign(n + 1, 0);
+        for (uint32_t child : edges) ++rOffsets[child + 1];
+        for (size_t i = 0; i < n; ++i) rOffsets[i + 1] += rOffsets[i];
+        rEdges.resize(edges.size());
+        std::vector<uint64_t> fill(rOffsets.begin(), rOffsets.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            for (uint64_t k = offsets[i]; k < offsets[i + 1]; ++k) rEdges[fill[edges[k]]++] = static_cast<uint32_t>(i);
+        }
+        peak = std::max(peak, bytes() + edges.capacity() * sizeof(uint32_t) + fill.capacity() * sizeof(uint64_t));
+    }
+
+    // Bytes currently held by the table, the states, the graph and the labels
+    size_t bytes() const {
+        return table.bytes() + nodeKeys.capacity() * sizeof(uint64_t) + decider.capacity() +
+               (offsets.capacity() + rOffsets.capacity()) * sizeof(uint64_t) + rEdges.capacity() * sizeof(uint32_t) +
+               (outcome ? nodeKeys.size() : 0) + plies.capacity() * sizeof(uint16_t) + exact.capacity();
+    }
+
+    // Retrograde labelling into `into`: level L resolves states decided L plies before the end. Capped leaves
+    // count as wins for `cappedWinner` (-1: never resolved); `depth`, if given, receives each state's level
+    void propagate(std::atomic<uint8_t>* into, int cappedWinner, std::vector<uint16_t>* depth) {
+        const size_t n = nodeKeys.size();
+        std::unique_ptr<std::atomic<uint32_t>[]> remaining(new std::atomic<uint32_t>[n]);
+        std::vector<uint32_t> frontier;
+        for (size_t i = 0; i < n; ++i) {
+            remaining[i].store(static_cast<uint32_t>(offsets[i + 1] - offsets[i]), std::memory_order_relaxed);
+            uint8_t o = 0;
+            if (decider[i] == FINAL) o = static_cast<uint8_t>(unpack(nodeKeys[i], dealt).winner() + 1);
+            else if (cappedWinner >= 0 && overCap(unpack(nodeKeys[i], dealt))) o = static_cast<uint8_t>(cappedWinner + 1);
+            if (o) frontier.push_back(static_cast<uint32_t>(i));
+            into[i].store(o, std::memory_order_relaxed);
+        }
+        peak = std::max(peak, bytes() + n * sizeof(uint32_t));
+        for (uint16_t level = 1; !frontier.empty(); ++level) {
+            std::vector<std::vector<uint32_t>> next(threads);
+            parallelFor(frontier.size(), threads, [&](unsigned me, size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    uint32_t v = frontier[i];
+                    uint8_t won = into[v].load(std::memory_order_relaxed);
+                    for (uint64_t k = rOffsets[v]; k < rOffsets[v + 1]; ++k) {
+                        uint32_t p = rEdges[k];
+                        if (into[p].load(std::memory_order_relaxed)) continue;
+                        // The decider takes a winning move, or loses once every move is lost
+                        bool resolves = decider[p] + 1 == won || remaining[p].fetch_sub(1, std::memory_order_relaxed) == 1;
+                        uint8_t expected = 0;
+                        if (resolves && into[p].compare_exchange_strong(expected, won, std::memory_order_relaxed)) {
+                            if (depth) (*depth)[p] = level;
+                            next[me].push_back(p);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for (const std::vector<uint32_t>& part : next) frontier.insert(frontier.end(), part.begin(), part.end());
+        }
+    }
+
+    // Labels every state with capped leaves unresolved, then marks the ones whose value depends on them.
+    // A value only moves towards a seat when capped leaves do, so a state that stays unresolved both when
+    // every capped leaf is won by seat 0 and when every one is won by seat 1 is a draw at any cap.
+    // Forced wins never rest on a capped leaf and are always exact.
+    void label() {
+        const size_t n = nodeKeys.size();
+        outcome.reset(new std::atomic<uint8_t>[n]);
+        plies.assign(n, 0);
+        exact.assign(n, 1);
+        propagate(outcome.get(), -1, &plies);
+        if (capped == 0) return;
+        std::unique_ptr<std::atomic<uint8_t>[]> bound(new std::atomic<uint8_t>[n]);
+        for (int seat = 0; seat < 2; ++seat) {
+            propagate(bound.get(), seat, nullptr);
+            for (size_t i = 0; i < n; ++i) {
+                if (!outcome[i].load(std::memory_order_relaxed) && bound[i].load(std::memory_order_relaxed)) exact[i] = 0;
+            }
+        }
+        peak = std::max(peak, bytes() + n);
+    }
+
+    uint32_t idOf(const LaneState& s, bool reacting) const {
+        if (!solved) throw std::logic_error("Call solve() first");
+        // States with other roles or fields that do not fit the key cannot have been reached
+        uint64_t key = pack(s, reacting);
+        int64_t id = s.seats == 2 && unpack(key, dealt) == s ? table.find(key) : -1;
+        if (id < 0) throw std::out_of_range("State was not reached by this solve");
+        return static_cast<uint32_t>(id);
+    }
+
+    SolvedValue valueOf(uint32_t id) const {
+        SolvedValue v;
+        v.winner = outcome[id].load(std::memory_order_relaxed) - 1;
+        v.plies = v.winner < 0 ? 0 : plies[id];
+        v.exact = exact[id] != 0;
+        return v;
+    }
+};
+
+/**
+ * @brief Prepares a solve.
+ * @param first Role of seat 0.
+ * @param second Role of seat 1.
+ * @param config Bank, coin cap and threads.
+ * @throws std::invalid_argument if a role is Unknown, the bank is negative or above the cap, or the cap is above 120.
+ */
+TwoPlayerSolver::TwoPlayerSolver(Role first, Role second, const SolverConfig& cfg) : config(cfg) {
+    if (config.coinCap < 0 || config.coinCap > MAX_CAP) throw std::invalid_argument("Coin cap must be 0 to 120");
+    if (config.bank < 0 || config.bank > config.coinCap) throw std::invalid_argument("Bank must be 0 to the coin cap");
+    root = LaneState::deal({first, second});
+    root.bank = config.bank;
+    if (config.threads == 0) config.threads = std::max(1u, std::thread::hardware_concurrency());
+    impl.reset(new Impl(root, config.coinCap, config.threads));
+}
+
+TwoPlayerSolver::~TwoPlayerSolver() = default;
+
+/**
+ * @brief Enumerates and labels every state reachable from the deal (once).
+ */
+void TwoPlayerSolver::solve() {
+    solve(std::vector<LaneState>{root});
+}
+
+/**
+ * @brief Enumerates and labels every state reachable from the given states (once).
+ * @param roots 2-seat states with this pairing's roles, the seat to act about to decide.
+ * @throws std::invalid_argument if a root has other roles or seats, or a field beyond the coin cap.
+ */
+void TwoPlayerSolver::solve(const std::vector<LaneState>& roots) {
+    if (impl->solved) return;
+    std::vector<uint64_t> keys;
+    for (const LaneState& s : roots) {
+        uint64_t key = pack(s, false);
+        if (s.seats != 2 || unpack(key, root) != s) throw std::invalid_argument("Root has other roles, seats or fields");
+        if (impl->overCap(s)) throw std::invalid_argument("Root is beyond the coin cap");
+        keys.push_back(key);
+    }
+    auto begin = std::chrono::steady_clock::now();
+    impl->enumerate(keys);
+    impl->buildGraph();
+    impl->label();
+    impl->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    impl->solved = true;
+}
+
+/**
+ * @brief Returns the value of a state.
+ * @param state A state reached by the solve.
+ * @param reacting True for the opponent's reaction window.
+ * @throws std::logic_error if solve() has not run.
+ * @throws std::out_of_range if the state was not reached.
+ */
+SolvedValue TwoPlayerSolver::value(const LaneState& state, bool reacting) const {
+    return impl->valueOf(impl->idOf(state, reacting));
+}
+
+/**
+ * @brief Finds an optimal decision: the fastest win, else a move that keeps a draw, else the slowest loss.
+ * @param state A non-final state reached by the solve.
+ * @param reacting True for the opponent's reaction window.
+ * @param out Receives the action.
+ * @return False if the best decision is to pass.
+ * @throws std::logic_error if solve() has not run or the game is over.
+ * @throws std::out_of_range if the state was not reached.
+ */
+bool TwoPlayerSolver::bestMove(const LaneState& state, bool reacting, Action& out) const {
+    uint32_t id = impl->idOf(state, reacting);
+    const int me = impl->decider[id];
+    if (me == FINAL) throw std::logic_error("The game is over");
+    const SolvedValue here = impl->valueOf(id);
+
+    bool found = false, pass = false;
+    int bestPlies = 0;
+    impl->forEachMove(impl->nodeKeys[id], [&](const Action& a, bool isPass, uint64_t childKey) {
+        SolvedValue v = impl->valueOf(static_cast<uint32_t>(impl->table.find(childKey)));
+        if (v.winner != here.winner) return;
+        bool better = !found || (here.winner == me ? v.plies < bestPlies : v.plies > bestPlies);
+        if (!better) return;
+        found = true;
+        bestPlies = v.plies;
+        pass = isPass;
+        out = a;
+    });
+    if (!found) throw std::logic_error("State is capped; no move is known");
+    return !pass;
+}
+
+/**
+ * @brief Calls f(state, reacting, value) for every solved state, in no particular order.
+ * @param f The callback.
+ * @throws std::logic_error if solve() has not run.
+ */
+void TwoPlayerSolver::forEachState(const std::function<void(const LaneState&, bool, const SolvedValue&)>& f) const {
+    if (!impl->solved) throw std::logic_error("Call solve() first");
+    for (size_t id = 0; id < impl->nodeKeys.size(); ++id) {
+        uint64_t key = impl->nodeKeys[id];
+        f(unpack(key, root), (key & 1) != 0, impl->valueOf(static_cast<uint32_t>(id)));
+    }
+}
+
+/**
+ * @brief Returns true if the opponent of the seat to act gets a reaction window in this state.
+ * @param state A state of this pairing.
+ */
+bool TwoPlayerSolver::reactionWindow(const LaneState& state) const {
+    return state.winner() < 0 && impl->hasReaction(state);
+}
+
+uint64_t TwoPlayerSolver::stateCount() const { return impl->nodeKeys.size(); }
+
+uint64_t TwoPlayerSolver::cappedStates() const { return impl->capped; }
+
+double TwoPlayerSolver::seconds() const { return impl->seconds; }
+
+double TwoPlayerSolver::statesPerSecond() const {
+    return impl->seconds > 0 ? static_cast<double>(stateCount()) / impl->seconds : 0.0;
+}
+
+/**
+ * @brief Returns the peak bytes held by the hash table, the move graph and the labels during solve().
+ */
+size_t TwoPlayerSolver::memoryBytes() const { return impl->peak; }
+
+/**
+ * @brief Solves every ordered pairing of the 6 roles.
+ * @param config Bank, coin cap and threads.
+ * @return One result per pairing, first role major.
+ */
+std::vector<PairingResult> solveRolePairings(const SolverConfig& config) {
+    std::vector<PairingResult> results;
+    for (int a = 0; a < 6; ++a) {
+        for (int b = 0; b < 6; ++b) {
+            TwoPlayerSolver solver(static_cast<Role>(a), static_cast<Role>(b), config);
+            solver.solve();
+            PairingResult r;
+            r.first = static_cast<Role>(a);
+            r.second = static_cast<Role>(b);
+            r.start = solver.value(solver.start());
+            r.states = solver.stateCount();
+            r.capped = solver.cappedStates();
+            r.seconds = solver.seconds();
+            r.bytes = solver.memoryBytes();
+            results.push_back(r);
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Returns how often role a beats role b with optimal play, averaged over who acts first.
+ * @param results Output of solveRolePairings().
+ * @param a A role.
+ * @param b A role.
+ * @throws std::invalid_argument if a pairing is missing.
+ */
+double pairingWinProbability(const std::vector<PairingResult>& results, Role a, Role b) {
+    const PairingResult* aFirst = nullptr;
+    const PairingResult* bFirst = nullptr;
+    for (const PairingResult& r : results) {
+        if (r.first == a && r.second == b) aFirst = &r;
+        if (r.first == b && r.second == a) bFirst = &r;
+    }
+    if (!aFirst || !bFirst) throw std::invalid_argument("Pairing was not solved");
+    auto score = [](const PairingResult& r, int seat) {
+        return r.start.winner < 0 ? 0.5 : (r.start.winner == seat ? 1.0 : 0.0);
+    };
+    return 0.5 * (score(*aFirst, 0) + score(*bFirst, 1));
+}
@@ -0,0 +1,266 @@
+// orel2744@gmail.com
+// StreamingStats.cpp - Welford moments, log-bucketed quantiles, count-min counts and their lock-free hand-off.
+#include "StreamingStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Probabilities studentTQuantile knows, their normal quantiles, and t(p, df) for df = 1..30
+const double T_PROBABILITIES[4] = {0.95, 0.975, 0.99, 0.995};
+const double NORMAL_QUANTILES[4] = {1.644854, 1.959964, 2.326348, 2.575829};
+const double T_TABLE[30][4] = {
+    {6.3138, 12.7062, 31.8205, 63.6567}, {2.9200, 4.3027, 6.9646, 9.9248}, {2.3534, 3.1824, 4.5407, 5.8409},
+    {2.1318, 2.7764, 3.7469, 4.6041},    {2.0150, 2.5706, 3.3649, 4.0321}, {1.9432, 2.4469, 3.1427, 3.7074},
+    {1.8946, 2.3646, 2.9980, 3.4995},    {1.8595, 2.3060, 2.8965, 3.3554}, {1.8331, 2.2622, 2.8214, 3.2498},
+    {1.8125, 2.2281, 2.7638, 3.1693},    {1.7959, 2.2010, 2.7181, 3.1058}, {1.7823, 2.1788, 2.6810, 3.0545},
+    {1.7709, 2.1604, 2.6503, 3.0123},    {1.7613, 2.1448, 2.6245, 2.9768}, {1.7531, 2.1314, 2.6025, 2.9467},
+    {1.7459, 2.1199, 2.5835, 2.9208},    {1.7396, 2.1098, 2.5669, 2.8982}, {1.7341, 2.1009, 2.5524, 2.8784},
+    {1.7291, 2.0930, 2.5395, 2.8609},    {1.7247, 2.0860, 2.5280, 2.8453}, {1.7207, 2.0796, 2.5176, 2.8314},
+    {1.7171, 2.0739, 2.5083, 2.8188},    {1.7139, 2.0687, 2.4999, 2.8073}, {1.7109, 2.0639, 2.4922, 2.7969},
+    {1.7081, 2.0595, 2.4851, 2.7874},    {1.7056, 2.0555, 2.4786, 2.7787}, {1.7033, 2.0518, 2.4727, 2.7707},
+    {1.7011, 2.0484, 2.4671, 2.7633},    {1.6991, 2.0452, 2.4620, 2.7564}, {1.6973, 2.0423, 2.4573, 2.7500},
+};
+
+// Buckets below index 0 hold values under 1; this many of them
+const int NEGATIVE_BUCKETS = 256;
+
+// An accepted action by a player of some role, as a small code (0 = none)
+int actionCode(int role, ActionType type) { return 1 + role * ACTION_TYPE_COUNT + static_cast<int>(type); }
+
+uint64_t sequenceKey(int first, int second, int third) {
+    return (static_cast<uint64_t>(first) << 16) | (static_cast<uint64_t>(second) << 8) | static_cast<uint64_t>(third);
+}
+}
+
+void RunningMoments::add(double value) {
+    if (n == 0) lowest = highest = value;
+    lowest = std::min(lowest, value);
+    highest = std::max(highest, value);
+    ++n;
+    const double delta = value - average;
+    average += delta / static_cast<double>(n);
+    m2 += delta * (value - average);
+}
+
+/**
+ * @brief Adds another stream's moments, as if its values had been added here (Chan et al.).
+ */
+void RunningMoments::merge(const RunningMoments& other) {
+    if (other.n == 0) return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    const double total = static_cast<double>(n + other.n);
+    const double delta = other.average - average;
+    average += delta * static_cast<double>(other.n) / total;
+    m2 += other.m2 + delta * delta * static_cast<double>(n) * static_cast<double>(other.n) / total;
+    n += other.n;
+    lowest = std::min(lowest, other.lowest);
+    highest = std::max(highest, other.highest);
+}
+
+double RunningMoments::stddev() const { return std::sqrt(variance()); }
+
+double studentTQuantile(double p, double df) {
+    int column = -1;
+    for (int i = 0; i < 4; ++i)
+        if (std::fabs(p - T_PROBABILITIES[i]) < 1e-9) column = i;
+    if (column < 0) throw std::invalid_argument("No t quantile tabulated for this probability");
+    if (!(df >= 1.0)) throw std::invalid_argument("Degrees of freedom must be at least 1");
+    if (df <= 30.0) {
+        const int below = static_cast<int>(df);
+        const double low = T_TABLE[below - 1][column];
+        if (below == 30 || df == below) return low;
+        const double high = T_TABLE[below][column];
+        // The quantile is close to linear in 1/df
+        const double w = (1.0 / below - 1.0 / df) / (1.0 / below - 1.0 / (below + 1));
+        return low + w * (high - low);
+    }
+    const double z = NORMAL_QUANTILES[column], z3 = z * z * z, z5 = z3 * z * z;
+    return z + (z3 + z) / (4 * df) + (5 * z5 + 16 * z3 + 3 * z) / (96 * df * df);
+}
+
+/**
+ * @brief Creates an empty sketch.
+ * @param accuracy Relative error of quantiles, in (0, 0.5).
+ * @throws std::invalid_argument if the accuracy is out of range.
+ */
+QuantileSketch::QuantileSketch(double accuracy) : relativeAccuracy(accuracy) {
+    if (!(accuracy > 0.0 && accuracy < 0.5)) throw std::invalid_argument("Sketch accuracy must be in (0, 0.5)");
+    gamma = (1.0 + accuracy) / (1.0 - accuracy);
+    logGamma = std::log(gamma);
+}
+
+void QuantileSketch::add(double value, uint64_t count) {
+    total += count;
+    if (!(value > 0.0)) {
+        zeros += count;
+        return;
+    }
+    const double index = std::ceil(std::log(value) / logGamma) + NEGATIVE_BUCKETS;
+    buckets[static_cast<size_t>(std::min<double>(BUCKETS - 1, std::max(0.0, index)))] += count;
+}
+
+/**
+ * @brief Adds another sketch's values.
+ * @throws std::invalid_argument if the sketches have different accuracies.
+ */
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.relativeAccuracy != relativeAccuracy) throw std::invalid_argument("Sketches have different accuracies");
+    for (int b = 0; b < BUCKETS; ++b) buckets[b] += other.buckets[b];
+    zeros += other.zeros;
+    total += other.total;
+}
+
+/**
+ * @brief Returns the q-quantile (0 = minimum, 1 = maximum), or 0 if empty.
+ * @param q Quantile, clamped to [0, 1].
+ */
+double QuantileSketch::quantile(double q) const {
+    if (total == 0) return 0.0;
+    const uint64_t rank = static_cast<uint64_t>(std::max(0.0, std::min(1.0, q)) * static_cast<double>(total - 1));
+    uint64_t seen = zeros;
+    if (rank < seen) return 0.0;
+    for (int b = 0; b < BUCKETS; ++b) {
+        seen += buckets[b];
+        // Bucket b holds (gamma^(i-1), gamma^i]; this point is within the relative error of all of it
+        if (rank < seen) return 2.0 * std::pow(gamma, b - NEGATIVE_BUCKETS) / (gamma + 1.0);
+    }
+    return 2.0 * std::pow(gamma, BUCKETS - 1 - NEGATIVE_BUCKETS) / (gamma + 1.0);
+}
+
+void CountMinSketch::add(uint64_t key, uint64_t count) {
+    added += count;
+    for (int row = 0; row < DEPTH; ++row) counters[row * WIDTH + mix(key + static_cast<uint64_t>(row) * 0x5851F42D4C957F2DULL) % WIDTH] += count;
+}
+
+void CountMinSketch::merge(const CountMinSketch& other) {
+    for (size_t c = 0; c < counters.size(); ++c) counters[c] += other.counters[c];
+    added += other.added;
+}
+
+/**
+ * @brief Returns the estimated count of a key (the smallest of its counters).
+ */
+uint64_t CountMinSketch::estimate(uint64_t key) const {
+    uint64_t best = UINT64_MAX;
+    for (int row = 0; row < DEPTH; ++row)
+        best = std::min(best, counters[row * WIDTH + mix(key + static_cast<uint64_t>(row) * 0x5851F42D4C957F2DULL) % WIDTH]);
+    return best;
+}
+
+/**
+ * @brief Records an action tried in the current game (only accepted actions are counted).
+ */
+void GameStats::observe(const LaneState& before, const Action& action, bool accepted, const LaneState& after) {
+    for (int p = 0; p < before.seats; ++p) {
+        // Coins held at the moment of elimination; a General who blocks the coup survives it
+        if (before.alive[p] && !after.alive[p]) {
+            coins.add(before.coins[p]);
+            coinsSketch.add(before.coins[p]);
+        }
+    }
+    if (!accepted || action.actor < 0 || action.actor >= before.seats) return;
+    const int role = before.role[action.actor];
+    if (role >= ROLES) return;
+    ++actions[role][static_cast<int>(action.type)];
+    const int code = actionCode(role, action.type);
+    if (recent[0] > 0) sequences.add(sequenceKey(recent[0], recent[1], code));
+    recent[0] = recent[1];
+    recent[1] = code;
+}
+
+/**
+ * @brief Closes the current game.
+ * @param final The game at its end.
+ * @param attempted Actions attempted in the game.
+ */
+void GameStats::endGame(const LaneState& final, size_t attempted) {
+    length.add(static_cast<double>(attempted));
+    lengthSketch.add(static_cast<double>(attempted));
+    const int winner = final.winner();
+    for (int p = 0; p < final.seats; ++p) {
+        if (final.role[p] >= ROLES) continue;
+        ++dealt[final.role[p]];
+        if (p == winner) ++wins[final.role[p]];
+    }
+    recent[0] = recent[1] = -1;
+}
+
+void GameStats::merge(const GameStats& other) {
+    length.merge(other.length);
+    lengthSketch.merge(other.lengthSketch);
+    coins.merge(other.coins);
+    coinsSketch.merge(other.coinsSketch);
+    for (int r = 0; r < ROLES; ++r) {
+        dealt[r] += other.dealt[r];
+        wins[r] += other.wins[r];
+        for (int t = 0; t < ACTION_TYPE_COUNT; ++t) actions[r][t] += other.actions[r][t];
+    }
+    sequences.merge(other.sequences);
+}
+
+double GameStats::winRate(Role role) const {
+    const int r = static_cast<int>(role);
+    if (r < 0 || r >= ROLES || dealt[r] == 0) return 0.0;
+    return static_cast<double>(wins[r]) / static_cast<double>(dealt[r]);
+}
+
+/**
+ * @brief Returns the estimated count of three consecutive accepted actions in a game.
+ */
+uint64_t GameStats::sequenceCount(const std::array<Role, 3>& roles, const std::array<ActionType, 3>& types) const {
+    int code[3];
+    for (int i = 0; i < 3; ++i) {
+        const int r = static_cast<int>(roles[i]);
+        if (r < 0 || r >= ROLES) return 0;
+        code[i] = actionCode(r, types[i]);
+    }
+    return sequences.estimate(sequenceKey(code[0], code[1], code[2]));
+}
+
+StatsHub::~StatsHub() {
+    Node* node = head.exchange(nullptr);
+    while (node) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+/**
+ * @brief Hands an accumulator over (safe from any thread): one compare-and-swap push.
+ */
+void StatsHub::publish(std::unique_ptr<GameStats> stats) {
+    if (!stats) return;
+    Node* node = new Node{std::move(stats), head.load(std::memory_order_relaxed)};
+    while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Merges every accumulator published so far into `into` and frees them.
+ * @return How many accumulators were merged.
+ */
+size_t StatsHub::drain(GameStats& into) {
+    // Taking the whole list at once means no node is ever popped while another thread pushes (no ABA)
+    Node* node = head.exchange(nullptr, std::memory_order_acquire);
+    size_t merged = 0;
+    while (node) {
+        Node* next = node->next;
+        into.merge(*node->stats);
+        delete node;
+        node = next;
+        ++merged;
+    }
+    return merged;
+}
@@ -0,0 +1,113 @@
+// orel2744@gmail.com
+// Table.cpp - Implementation of the hosted table state machine.
+#include "Table.hpp"
+#include "Player.hpp"
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Creates a table with one seat per role.
+ * @param id Table id.
+ * @param roles Role of each seat (2 to 6 seats).
+ * @throws std::invalid_argument if the number of seats is out of range.
+ */
+Table::Table(uint32_t id, const std::vector<Role>& roles) : id(id), owners(roles.size(), 0) {
+    if (roles.size() < 2 || roles.size() > 6) throw std::invalid_argument("A table has 2 to 6 seats");
+    game.setLogging(false);
+    players.reserve(roles.size());
+    for (size_t i = 0; i < roles.size(); ++i)
+        players.emplace_back(Game::createPlayerWithRole("Seat " + std::to_string(i + 1), &game, roles[i]));
+    published = state();
+}
+
+Table::~Table() = default;
+
+/**
+ * @brief Claims a seat for an owner. Starts the game when the last seat is claimed.
+ * @param seat The seat to claim.
+ * @param owner Opaque id of the claiming client (non-zero).
+ * @return The role of the claimed seat.
+ * @throws std::logic_error if the table is not in the lobby or the seat is taken.
+ * @throws std::out_of_range if the seat does not exist.
+ */
+Role Table::join(int seat, uint64_t owner) {
+    if (status != Status::Lobby) throw std::logic_error("Table is not accepting players");
+    if (seat < 0 || static_cast<size_t>(seat) >= players.size()) throw std::out_of_range("No such seat");
+    if (owners[seat] != 0) throw std::logic_error("Seat already taken");
+    owners[seat] = owner;
+    if (++claimed == players.size()) status = Status::Playing;
+    return players[seat]->getRole();
+}
+
+/**
+ * @brief Applies an action on behalf of an owner and finishes the table when one player remains.
+ * @param action The action; its actor must be a seat the owner holds.
+ * @param owner Opaque id of the acting client.
+ * @throws std::logic_error if the table is not playing, the owner does not hold the seat, or the rules reject the action.
+ */
+void Table::act(const Action& action, uint64_t owner) {
+    if (status != Status::Playing) throw std::logic_error("Table is not playing");
+    if (action.actor < 0 || static_cast<size_t>(action.actor) >= players.size() || owners[action.actor] != owner)
+        throw std::logic_error("You do not hold that seat");
+    applyAction(game, action);
+    if (aliveCount() <= 1) status = Status::Finished;
+}
+
+/**
+ * @brief Releases every seat held by an owner. While playing, each of its seats still alive forfeits:
+ *        it is eliminated (passing the turn on if it was to move), and the table finishes when one player remains.
+ * @param owner Opaque id of the client.
+ * @return True if a seat forfeited, i.e. the public state changed.
+ */
+bool Table::release(uint64_t owner) {
+    if (owner == 0) return false;
+    bool forfeited = false;
+    for (size_t seat = 0; seat < owners.size(); ++seat) {
+        if (owners[seat] != owner) continue;
+        owners[seat] = 0;
+        if (status == Status::Lobby) --claimed;
+        // The last player alive keeps the win, even if the same client held it
+        if (status == Status::Playing && players[seat]->isAlive() && aliveCount() > 1) {
+            game.eliminate(players[seat].get());
+            forfeited = true;
+        }
+    }
+    if (status == Status::Playing && aliveCount() <= 1) status = Status::Finished;
+    return forfeited;
+}
+
+/**
+ * @brief Returns the number of players still alive.
+ */
+int Table::aliveCount() const {
+    int alive = 0;
+    for (const auto& p : players) alive += p->isAlive() ? 1 : 0;
+    return alive;
+}
+
+/**
+ * @brief Returns the public state of the table (coins are public in Coup; roles are not).
+ */
+TableState Table::state() const {
+    TableState st;
+    st.status = static_cast<uint8_t>(status);
+    st.bank = static_cast<int16_t>(game.getBank());
+    st.seats.reserve(players.size());
+    for (const auto& p : players) st.seats.push_back({static_cast<int16_t>(p->getCoins()), p->isAlive()});
+    if (status == Status::Playing) st.turn = static_cast<int8_t>(game.currentPlayer()->getSeat());
+    return st;
+}
+
+/**
+ * @brief Diffs the public state against the last published one and advances the sequence if it changed.
+ * @return The delta since the previous publish (empty if nothing changed).
+ */
+StateDelta Table::publish() {
+    TableState now = state();
+    StateDelta delta = diffState(published, now);
+    if (!delta.empty()) {
+        published = std::move(now);
+        ++sequence;
+    }
+    return delta;
+}
@@ -0,0 +1,343 @@
+// orel2744@gmail.com
+// Tablebase.cpp - Endgame tablebase generation (retrograde solve of every pairing) and memory-mapped probing.
+#include "Tablebase.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COUP_TABLEBASE_MMAP
+#endif
+
+namespace {
+const char MAGIC[8] = {'C', 'O', 'U', 'P', 'T', 'B', '1', '\0'};
+const uint32_t VERSION = 2;  // 1 stored values that depend on the coin cap as draws
+const int PAIRINGS = 36;
+const int MAX_CAP = 120;
+const uint16_t PLIES_MASK = 0x3FFF;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t coinCap;
+    uint32_t pairings;
+    uint32_t reserved;
+};
+
+struct DirEntry {
+    uint8_t first, second, pad[6];
+    uint64_t cells, keys, values;  ///< Section offsets from the start of the file
+    uint64_t positions;
+};
+
+const size_t DIR_OFFSET = sizeof(FileHeader);
+const size_t DATA_OFFSET = DIR_OFFSET + PAIRINGS * sizeof(DirEntry);
+
+// True if `count` items of `width` bytes from `offset` end at or before `limit`
+bool fits(uint64_t offset, uint64_t count, uint64_t width, uint64_t limit) {
+    return offset <= limit && count <= (limit - offset) / width;
+}
+
+size_t cellCount(int cap) {
+    size_t side = static_cast<size_t>(cap) + 1;
+    return 4 * side * side * side;
+}
+
+// Cell of a position within the coin cap, or -1
+int64_t cellOf(const LaneState& s, bool reacting, int cap) {
+    if (s.turn < 0 || s.turn > 1 || s.bank < 0 || s.bank > cap) return -1;
+    for (int p = 0; p < 2; ++p) {
+        if (s.coins[p] < 0 || s.coins[p] > cap) return -1;
+    }
+    int64_t side = cap + 1;
+    return (((((reacting ? 2 : 0) + s.turn) * side + s.bank) * side + s.coins[0]) * side) + s.coins[1];
+}
+
+// The fields a cell does not fix, 16 bits per seat, or -1 if one is out of range
+int64_t keyOf(const LaneState& s) {
+    uint32_t key = 0;
+    for (int p = 0; p < 2; ++p) {
+        if (s.alive[p] > 1 || s.extra[p] > 1 || s.pending[p] > 2) return -1;
+        uint32_t v = s.alive[p] | (s.extra[p] << 1) | (s.pending[p] << 2);
+        const int8_t refs[] = {s.sanction[p], s.arrestBlock[p], s.coupBlock[p], s.bribe[p], s.tax[p], s.arrestTarget[p]};
+        for (int f = 0; f < 6; ++f) {
+            if (refs[f] < -1 || refs[f] > 1) return -1;
+            v |= static_cast<uint32_t>(refs[f] + 1) << (4 + 2 * f);
+        }
+        key |= v << (16 * p);
+    }
+    return key;
+}
+
+void writeAligned(std::ofstream& out, const void* bytes, size_t count) {
+    out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+    static const char zeros[8] = {};
+    out.write(zeros, static_cast<std::streamsize>((8 - count % 8) % 8));
+}
+}
+
+/**
+ * @brief Solves every role pairing from every 2-player position with cleared flags and writes the file.
+ * @param path Output file.
+ * @param config Coin cap and threads.
+ * @return Number of positions written.
+ * @throws std::invalid_argument if the coin cap is out of range or a role is Unknown.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+uint64_t Tablebase::generate(const std::string& path, const TablebaseConfig& config) {
+    const int cap = config.coinCap;
+    if (cap < 0 || cap > MAX_CAP) throw std::invalid_argument("Coin cap must be 0 to 120");
+    std::vector<Role> roles = config.roles;
+    if (roles.empty()) {
+        for (int r = 0; r < 6; ++r) roles.push_back(static_cast<Role>(r));
+    }
+    for (Role r : roles) {
+        if (r == Role::Unknown) throw std::invalid_argument("Cannot tabulate an Unknown role");
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot write tablebase " + path);
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.coinCap = static_cast<uint32_t>(cap);
+    header.pairings = PAIRINGS;
+    DirEntry dir[PAIRINGS] = {};
+    for (int i = 0; i < PAIRINGS; ++i) {
+        dir[i].first = static_cast<uint8_t>(i / 6);
+        dir[i].second = static_cast<uint8_t>(i % 6);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(dir), sizeof(dir));
+
+    SolverConfig solverConfig;
+    solverConfig.bank = 0;
+    solverConfig.coinCap = static_cast<int16_t>(cap);
+    solverConfig.threads = config.threads;
+    uint64_t total = 0;
+    uint64_t offset = DATA_OFFSET;
+    for (Role a : roles) {
+        for (Role b : roles) {
+            // Every coin split and bank with the seat to act about to decide and no flags set
+            std::vector<LaneState> roots;
+            LaneState dealt = LaneState::deal({a, b});
+            for (int turn = 0; turn < 2; ++turn) {
+                for (int bank = 0; bank <= cap; ++bank) {
+                    for (int c0 = 0; c0 <= cap; ++c0) {
+                        for (int c1 = 0; c1 <= cap; ++c1) {
+                            LaneState s = dealt;
+                            s.turn = static_cast<int8_t>(turn);
+                            s.bank = static_cast<int16_t>(bank);
+                            s.coins[0] = static_cast<int16_t>(c0);
+                            s.coins[1] = static_cast<int16_t>(c1);
+                            roots.push_back(s);
+                        }
+                    }
+                }
+            }
+            TwoPlayerSolver solver(a, b, solverConfig);
+            solver.solve(roots);
+
+            // (cell << 32 | key) and value of every exact position within the cap, sorted
+            std::vector<std::pair<uint64_t, uint16_t>> rows;
+            solver.forEachState([&](const LaneState& s, bool reacting, const SolvedValue& v) {
+                int64_t cell = cellOf(s, reacting, cap);
+                if (cell < 0 || !v.exact) return;
+                uint16_t value = static_cast<uint16_t>(((v.winner + 1) << 14) | std::min(v.plies, static_cast<int>(PLIES_MASK)));
+                rows.emplace_back(static_cast<uint64_t>(cell) << 32 | static_cast<uint64_t>(keyOf(s)), value);
+            });
+            std::sort(rows.begin(), rows.end());
+
+            std::vector<uint32_t> cells(cellCount(cap) + 1, 0);
+            std::vector<uint32_t> keys(rows.size());
+            std::vector<uint16_t> values(rows.size());
+            for (size_t i = 0; i < rows.size(); ++i) {
+                ++cells[(rows[i].first >> 32) + 1];
+                keys[i] = static_cast<uint32_t>(rows[i].first);
+                values[i] = rows[i].second;
+            }
+            for (size_t c = 1; c < cells.size(); ++c) cells[c] += cells[c - 1];
+
+            DirEntry& e = dir[static_cast<int>(a) * 6 + static_cast<int>(b)];
+            auto padded = [](uint64_t n) { return (n + 7) / 8 * 8; };
+            e.cells = offset;
+            e.keys = e.cells + padded(cells.size() * sizeof(uint32_t));
+            e.values = e.keys + padded(keys.size() * sizeof(uint32_t));
+            e.positions = rows.size();
+            offset = e.values + padded(values.size() * sizeof(uint16_t));
+            writeAligned(out, cells.data(), cells.size() * sizeof(uint32_t));
+            writeAligned(out, keys.data(), keys.size() * sizeof(uint32_t));
+            writeAligned(out, values.data(), values.size() * sizeof(uint16_t));
+            total += rows.size();
+        }
+    }
+    out.seekp(static_cast<std::streamoff>(DIR_OFFSET));
+    out.write(reinterpret_cast<const char*>(dir), sizeof(dir));
+    if (!out.flush()) throw std::runtime_error("Cannot write tablebase " + path);
+    return total;
+}
+
+/**
+ * @brief Maps a tablebase file (or reads it into memory where mmap is unavailable) and validates it.
+ * @param path File written by generate().
+ * @throws std::runtime_error if the file cannot be read or is not a valid tablebase.
+ */
+Tablebase::Tablebase(const std::string& path) {
+#ifdef COUP_TABLEBASE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open tablebase " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(DATA_OFFSET)) {
+        ::close(fd);
+        throw std::runtime_error("Not a tablebase file (too short): " + path);
+    }
+    size = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("Cannot map tablebase " + path);
+    data = static_cast<const uint8_t*>(p);
+    mapped = true;
+    const bool read = true;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw std::runtime_error("Cannot open tablebase " + path);
+    size = static_cast<size_t>(in.tellg());
+    uint8_t* buffer = new uint8_t[size > 0 ? size : 1];
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    data = buffer;
+    const bool read = static_cast<bool>(in);
+#endif
+
+    FileHeader header;
+    bool valid = read && size >= DATA_OFFSET;
+    if (valid) {
+        std::memcpy(&header, data, sizeof(header));
+        valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+                header.pairings == PAIRINGS && header.coinCap <= static_cast<uint32_t>(MAX_CAP);
+    }
+    for (int i = 0; valid && i < PAIRINGS; ++i) {
+        DirEntry e;
+        std::memcpy(&e, data + DIR_OFFSET + i * sizeof(DirEntry), sizeof(e));
+        if (e.positions == 0) continue;
+        // Every section inside the file and after the directory, in order, without overflowing
+        const uint64_t cells = cellCount(static_cast<int>(header.coinCap)) + 1;
+        valid = e.first == i / 6 && e.second == i % 6 && e.cells % 8 == 0 && e.keys % 8 == 0 && e.values % 8 == 0 &&
+                e.cells >= DATA_OFFSET && fits(e.cells, cells, sizeof(uint32_t), e.keys) &&
+                fits(e.keys, e.positions, sizeof(uint32_t), e.values) && fits(e.values, e.positions, sizeof(uint16_t), size);
+        // Cell offsets start at 0, never decrease and end at the position count, so every probe stays in keys
+        uint32_t previous = 0;
+        for (uint64_t c = 0; valid && c < cells; ++c) {
+            uint32_t offset;
+            std::memcpy(&offset, data + e.cells + c * sizeof(uint32_t), sizeof(offset));
+            valid = (c == 0 ? offset == 0 : offset >= previous) && offset <= e.positions;
+            previous = offset;
+        }
+        valid = valid && previous == e.positions;
+    }
+    if (!valid) {
+        release();
+        throw std::runtime_error("Not a valid tablebase file: " + path);
+    }
+    cap = static_cast<int>(header.coinCap);
+}
+
+Tablebase::~Tablebase() { release(); }
+
+/**
+ * @brief Unmaps (or frees) the file contents.
+ */
+void Tablebase::release() {
+#ifdef COUP_TABLEBASE_MMAP
+    if (mapped && data) ::munmap(const_cast<uint8_t*>(data), size);
+#else
+    delete[] data;
+#endif
+    data = nullptr;
+    mapped = false;
+}
+
+/**
+ * @brief Looks up a 2-seat position.
+ * @param state The position.
+ * @param reacting True for the opponent's reaction window.
+ * @param out Receives the value if found.
+ * @return False if the position is not covered.
+ */
+bool Tablebase::probe(const LaneState& state, bool reacting, SolvedValue& out) const {
+    if (state.seats != 2 || state.role[0] > 5 || state.role[1] > 5) return false;
+    int64_t cell = cellOf(state, reacting, cap);
+    int64_t key = keyOf(state);
+    if (cell < 0 || key < 0) return false;
+
+    DirEntry e;
+    std::memcpy(&e, data + DIR_OFFSET + (state.role[0] * 6 + state.role[1]) * sizeof(DirEntry), sizeof(e));
+    if (e.positions == 0) return false;
+    const uint32_t* cells = reinterpret_cast<const uint32_t*>(data + e.cells);
+    const uint32_t* keys = reinterpret_cast<const uint32_t*>(data + e.keys);
+    const uint16_t* values = reinterpret_cast<const uint16_t*>(data + e.values);
+    const uint32_t* begin = keys + cells[cell];
+    const uint32_t* end = keys + cells[cell + 1];
+    const uint32_t* it = std::lower_bound(begin, end, static_cast<uint32_t>(key));
+    if (it == end || *it != static_cast<uint32_t>(key)) return false;
+    uint16_t v = values[it - keys];
+    out.winner = (v >> 14) - 1;
+    out.plies = v & PLIES_MASK;
+    return true;
+}
+
+/**
+ * @brief Converts a position with exactly two players alive to a 2-seat position.
+ *
+ * Turn-index fields (sanction, blocks, bribe, tax) only matter while set, except a bribe, which always
+ * names its holder; ones naming an eliminated seat are mapped to the holder's opponent. An arrest
+ * target that was eliminated is cleared, since it can no longer be arrested again.
+ * @param state The position.
+ * @throws std::invalid_argument if not exactly two players are alive.
+ */
+LaneState Tablebase::endgameOf(const LaneState& state) {
+    if (state.aliveCount() != 2) throw std::invalid_argument("An endgame has exactly two players alive");
+    int seat[2], n = 0;
+    for (int p = 0; p < state.seats; ++p) {
+        if (state.alive[p]) seat[n++] = p;
+    }
+    LaneState s = LaneState::deal({static_cast<Role>(state.role[seat[0]]), static_cast<Role>(state.role[seat[1]])});
+    s.bank = state.bank;
+    s.turn = static_cast<int8_t>(state.currentSeat() == seat[0] ? 0 : 1);
+    auto remap = [&](int8_t ref, int holder, bool clearDead) -> int8_t {
+        if (ref < 0) return -1;
+        if (ref == seat[0]) return 0;
+        if (ref == seat[1]) return 1;
+        return static_cast<int8_t>(clearDead ? -1 : 1 - holder);
+    };
+    for (int i = 0; i < 2; ++i) {
+        int p = seat[i];
+        s.coins[i] = state.coins[p];
+        s.extra[i] = state.extra[p];
+        s.pending[i] = state.pending[p];
+        s.sanction[i] = remap(state.sanction[p], i, false);
+        s.arrestBlock[i] = remap(state.arrestBlock[p], i, false);
+        s.coupBlock[i] = remap(state.coupBlock[p], i, false);
+        s.bribe[i] = remap(state.bribe[p], i, false);
+        s.tax[i] = remap(state.tax[p], i, false);
+        s.arrestTarget[i] = remap(state.arrestTarget[p], i, true);
+    }
+    return s;
+}
+
+/**
+ * @brief Returns the number of positions stored.
+ */
+uint64_t Tablebase::positions() const {
+    uint64_t total = 0;
+    for (int i = 0; i < PAIRINGS; ++i) {
+        DirEntry e;
+        std::memcpy(&e, data + DIR_OFFSET + i * sizeof(DirEntry), sizeof(e));
+        total += e.positions;
+    }
+    return total;
+}
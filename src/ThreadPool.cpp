@@ -0,0 +1,72 @@
+// orel2744@gmail.com
+// ThreadPool.cpp - Fixed worker threads over a shared task queue.
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+
+/**
+ * @brief Starts the workers.
+ * @param threads Worker count (0 = one per core).
+ */
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 0; t < threads; ++t) workers.emplace_back(&ThreadPool::work, this);
+}
+
+/**
+ * @brief Finishes the queued tasks, then joins the workers.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+/**
+ * @brief Queues a task.
+ * @param task The task.
+ */
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(task));
+    }
+    ready.notify_one();
+}
+
+/**
+ * @brief Blocks until every submitted task has finished.
+ * @throws The first exception a task threw since the last wait().
+ */
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return queue.empty() && running == 0; });
+    if (failure) {
+        std::exception_ptr e = failure;
+        failure = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void ThreadPool::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        ready.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;  // stopping with nothing left to do
+        std::function<void()> task = std::move(queue.front());
+        queue.pop_front();
+        ++running;
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!failure) failure = std::current_exception();
+        }
+        lock.lock();
+        if (--running == 0 && queue.empty()) idle.notify_all();
+    }
+}
@@ -0,0 +1,202 @@
+// orel2744@gmail.com
+// Tournament.cpp - Round-robin, Swiss and random tournaments with seat balancing, played on a thread pool.
+#include "Tournament.hpp"
+#include "Ratings.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t pairKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+}
+}
+
+/**
+ * @brief Prepares a tournament.
+ * @param count Number of entrants (at least 2).
+ * @param cfg Format and table size.
+ * @throws std::invalid_argument if there are fewer than 2 entrants or the table size is out of range.
+ */
+TournamentScheduler::TournamentScheduler(size_t count, const TournamentConfig& cfg)
+    : config(cfg), entrants(count), score(count, 0), seats(count * MAX_TABLE, 0), order(count), rng(cfg.seed) {
+    if (entrants < 2) throw std::invalid_argument("A tournament needs at least 2 entrants");
+    if (config.tableSize < 2 || config.tableSize > MAX_TABLE) throw std::invalid_argument("Tables have 2 to 6 seats");
+    if (config.gamesPerTable == 0) throw std::invalid_argument("Tables must play at least one game");
+    // The circle method needs an even count; the extra slot is a bye
+    totalRounds = config.format == TournamentFormat::RoundRobin ? entrants + (entrants % 2) - 1 : config.rounds;
+}
+
+// Fills `order` with the entrants in the order they are cut into tables
+void TournamentScheduler::dealOrder() {
+    const size_t round = dealt;
+    if (config.format == TournamentFormat::RoundRobin) {
+        // Entrant 0 stays put and the rest rotate; slot i plays slot n - 1 - i (the pair with the bye goes last)
+        const size_t n = entrants + (entrants % 2);
+        auto at = [&](size_t slot) -> int {
+            size_t e = slot == 0 ? 0 : 1 + (slot - 1 + round) % (n - 1);
+            return e < entrants ? static_cast<int>(e) : -1;
+        };
+        order.clear();
+        int byePartner = -1;
+        for (size_t i = 0; i < n / 2; ++i) {
+            int a = at(i), b = at(n - 1 - i);
+            if (a < 0 || b < 0) {
+                byePartner = a < 0 ? b : a;
+                continue;
+            }
+            order.push_back(a);
+            order.push_back(b);
+        }
+        if (byePartner >= 0) order.push_back(byePartner);
+        return;
+    }
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    if (config.format == TournamentFormat::Swiss) {
+        // Shuffled first, so entrants on equal points meet in a random order
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return score[a] > score[b]; });
+        avoidRematches();
+    }
+}
+
+// At 2-seat tables, swaps in the nearest lower entrant not yet met
+void TournamentScheduler::avoidRematches() {
+    const size_t LOOKAHEAD = 8;
+    if (config.tableSize != 2) return;
+    for (size_t i = 0; i + 1 < order.size(); i += 2) {
+        if (!met.count(pairKey(order[i], order[i + 1]))) continue;
+        for (size_t j = i + 2; j < order.size() && j < i + 2 + LOOKAHEAD; ++j) {
+            if (!met.count(pairKey(order[i], order[j]))) {
+                std::swap(order[i + 1], order[j]);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Rotates a table so its entrants sit where they have sat least, and counts the seats.
+ *        Game g of the table seats table[(q + g) % size] at seat q.
+ */
+void TournamentScheduler::seat(std::vector<int>& table) {
+    const int m = static_cast<int>(table.size());
+    const int games = static_cast<int>(config.gamesPerTable);
+    int bestShift = 0;
+    uint64_t bestCost = UINT64_MAX;
+    for (int shift = 0; shift < m; ++shift) {
+        uint64_t cost = 0;
+        for (int p = 0; p < m; ++p) {
+            for (int g = 0; g < games && g < m; ++g) cost += seatCount(table[(p + shift) % m], ((p - g) % m + m) % m);
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestShift = shift;
+        }
+    }
+    std::rotate(table.begin(), table.begin() + bestShift, table.end());
+    for (int p = 0; p < m; ++p) {
+        for (int g = 0; g < games; ++g) ++seats[static_cast<size_t>(table[p]) * MAX_TABLE + ((p - g) % m + m) % m];
+    }
+    if (m == 2) met.insert(pairKey(table[0], table[1]));
+}
+
+/**
+ * @brief Deals the next round: tables of entrant ids in seat order. An entrant left alone sits out.
+ * @throws std::logic_error once every round was dealt.
+ */
+std::vector<std::vector<int>> TournamentScheduler::nextRound() {
+    if (dealt >= totalRounds) throw std::logic_error("Every round has been dealt");
+    dealOrder();
+    ++dealt;
+    std::vector<std::vector<int>> tables;
+    const size_t k = static_cast<size_t>(config.tableSize);
+    for (size_t first = 0; first + 1 < order.size(); first += k) {
+        tables.emplace_back(order.begin() + first, order.begin() + std::min(order.size(), first + k));
+        seat(tables.back());
+    }
+    return tables;
+}
+
+/**
+ * @brief Credits a finished game: tableSize - 1 - rank points to each seat, scaled to 0..1.
+ * @param table Entrant ids in seat order.
+ * @param ranks Finishing rank per seat.
+ * @throws std::invalid_argument if the sizes differ or an entrant does not exist.
+ */
+void TournamentScheduler::report(const std::vector<int>& table, const std::vector<int>& ranks) {
+    if (table.size() != ranks.size() || table.size() < 2) throw std::invalid_argument("Need one rank per seat");
+    const int worst = static_cast<int>(table.size()) - 1;
+    for (size_t q = 0; q < table.size(); ++q) {
+        if (table[q] < 0 || static_cast<size_t>(table[q]) >= entrants) throw std::invalid_argument("No such entrant");
+    }
+    for (size_t q = 0; q < table.size(); ++q) score[table[q]] += static_cast<uint64_t>(std::max(0, worst - ranks[q]) * POINT / worst);
+}
+
+/**
+ * @brief Plays a tournament between bots on a thread pool.
+ * @param bots One bot per entrant.
+ * @param config Format and size.
+ * @param onGame Called once per finished game, never concurrently, in completion order.
+ * @return The scheduler, with points and seat counts.
+ * @throws std::invalid_argument as TournamentScheduler.
+ */
+TournamentScheduler playTournament(const std::vector<BotWeights>& bots, const TournamentConfig& config,
+                                   const std::function<void(const TournamentGame&)>& onGame) {
+    TournamentScheduler scheduler(bots.size(), config);
+    ThreadPool pool(config.threads);
+    std::mutex resultLock;
+
+    auto queueRound = [&](size_t round, const std::vector<std::vector<int>>& tables) {
+        for (size_t t = 0; t < tables.size(); ++t) {
+            pool.submit([&, round, t, table = tables[t]]() {
+                std::mt19937_64 rng(mix(config.seed ^ mix(round * 0x10000 + t)));
+                const int m = static_cast<int>(table.size());
+                LaneState dealt = LaneState::deal(std::vector<Role>(table.size(), Role::Governor));
+                for (int q = 0; q < m; ++q) dealt.role[q] = static_cast<uint8_t>(std::uniform_int_distribution<int>(0, 5)(rng));
+                TournamentGame game;
+                game.round = round;
+                game.table = t;
+                game.seats.resize(table.size());
+                const BotWeights* seated[LaneState::MAX_SEATS];
+                for (size_t g = 0; g < config.gamesPerTable; ++g) {
+                    for (int q = 0; q < m; ++q) {
+                        game.seats[q] = table[(q + g) % m];
+                        seated[q] = &bots[game.seats[q]];
+                    }
+                    LaneState state = dealt;
+                    game.result.winner = playHeuristicGame(state, seated, rng, config.maxActions, &game.result.eliminationOrder);
+                    game.result.winnerRole = game.result.winner >= 0 ? static_cast<Role>(state.role[game.result.winner]) : Role::Unknown;
+                    std::lock_guard<std::mutex> lock(resultLock);
+                    scheduler.report(game.seats, finishingRanks(game.result, table.size()));
+                    onGame(game);
+                }
+            });
+        }
+    };
+
+    if (config.format == TournamentFormat::Swiss) {
+        // Each round is dealt from the points of the rounds before it
+        while (scheduler.round() < scheduler.rounds()) {
+            size_t round = scheduler.round();
+            queueRound(round, scheduler.nextRound());
+            pool.wait();
+        }
+    } else {
+        std::vector<std::vector<std::vector<int>>> rounds;
+        while (scheduler.round() < scheduler.rounds()) rounds.push_back(scheduler.nextRound());
+        for (size_t r = 0; r < rounds.size(); ++r) queueRound(r, rounds[r]);
+        pool.wait();
+    }
+    return scheduler;
+}
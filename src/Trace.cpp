@@ -0,0 +1,176 @@
+// orel2744@gmail.com
+// Trace.cpp - Per-thread lock-free ring buffers of trace events and their Chrome trace-event JSON export.
+#include "Trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+/**
+ * @brief One event slot. Fields are relaxed atomics, so a reader racing the owning thread sees stale or new
+ *        values but never undefined behaviour; the sequence tells it whether the copy it made is whole.
+ */
+struct Slot {
+    std::atomic<uint64_t> sequence{0};  ///< Index + 1 of the event held, 0 while being written
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> duration{0};
+};
+
+struct ThreadBuffer {
+    std::atomic<uint64_t> written{0};  ///< Events ever recorded; slot i lives at i % EVENTS_PER_THREAD
+    std::unique_ptr<Slot[]> slots{new Slot[Trace::EVENTS_PER_THREAD]};
+    int tid = 0;
+    std::string name;  ///< Guarded by registryLock()
+};
+
+std::mutex& registryLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+// Buffers are kept after their thread exits, so its events can still be exported
+std::vector<std::unique_ptr<ThreadBuffer>>& registry() {
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+thread_local ThreadBuffer* mine = nullptr;
+
+ThreadBuffer& threadBuffer() {
+    if (!mine) {
+        std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer);
+        std::lock_guard<std::mutex> lock(registryLock());
+        buffer->tid = static_cast<int>(registry().size()) + 1;
+        buffer->name = "thread " + std::to_string(buffer->tid);
+        mine = buffer.get();
+        registry().push_back(std::move(buffer));
+    }
+    return *mine;
+}
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+void writeString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        if (static_cast<unsigned char>(*s) >= 0x20) out << *s;
+    }
+    out << '"';
+}
+
+// Chrome traces count in microseconds; keep the nanoseconds as decimals
+void writeMicros(std::ostream& out, uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+    out << buf;
+}
+}
+
+uint64_t Trace::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+/**
+ * @brief Records a complete event on the calling thread (no locks after the thread's first event).
+ */
+void Trace::record(const char* name, const char* category, uint64_t start, uint64_t end) {
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index % EVENTS_PER_THREAD];
+    // A seqlock per slot: marked busy before the fields change, stamped with the event after
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(end > start ? end - start : 0, std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Trace::nameThread(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryLock());
+    buffer.name = name;
+}
+
+/**
+ * @brief Writes every thread's buffered events as Chrome trace-event JSON ("X" complete events, microseconds).
+ * @return Number of events written.
+ */
+size_t Trace::writeChromeJson(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(registryLock());
+    size_t count = 0;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry()) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":";
+        writeString(out, buffer->name.c_str());
+        out << "}}";
+        first = false;
+
+        const uint64_t end = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        struct Event {
+            const char* name;
+            const char* category;
+            uint64_t start, duration;
+        };
+        std::vector<Event> events;
+        events.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot& slot = buffer->slots[i % EVENTS_PER_THREAD];
+            // Keep the copy only if the slot held event i, untouched, from before to after it
+            const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            Event e{slot.name.load(std::memory_order_relaxed), slot.category.load(std::memory_order_relaxed),
+                    slot.start.load(std::memory_order_relaxed), slot.duration.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (before == i + 1 && slot.sequence.load(std::memory_order_relaxed) == before && e.name) events.push_back(e);
+        }
+        for (const Event& e : events) {
+            out << ",\n{\"name\":";
+            writeString(out, e.name);
+            out << ",\"cat\":";
+            writeString(out, e.category ? e.category : "");
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            writeMicros(out, e.start);
+            out << ",\"dur\":";
+            writeMicros(out, e.duration);
+            out << "}";
+            ++count;
+        }
+    }
+    out << "\n]}\n";
+    return count;
+}
+
+/**
+ * @brief Writes the trace to a file.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+size_t Trace::writeChromeJson(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write trace " + path);
+    size_t count = writeChromeJson(out);
+    if (!out) throw std::runtime_error("Cannot write trace " + path);
+    return count;
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock(registryLock());
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry()) {
+        for (size_t i = 0; i < EVENTS_PER_THREAD; ++i) {
+            buffer->slots[i].sequence.store(0, std::memory_order_relaxed);
+            buffer->slots[i].name.store(nullptr, std::memory_order_relaxed);
+        }
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
@@ -0,0 +1,123 @@
+// orel2744@gmail.com
+// TranspositionTable.cpp - Lock-free bucketed transposition table with XOR-validated slots.
+#include "TranspositionTable.hpp"
+#include <stdexcept>
+
+namespace {
+// Packed entry: value 0-15, depth 16-23, bound 24-25, has move 26, move type 27-30, actor 31-34,
+// target + 1 35-38, generation 39-46, and bit 63 set so a stored entry is never 0
+constexpr uint64_t USED = 1ULL << 63;
+
+uint64_t pack(const TTEntry& e, uint8_t generation) {
+    uint64_t d = static_cast<uint16_t>(e.value);
+    d |= static_cast<uint64_t>(e.depth) << 16;
+    d |= static_cast<uint64_t>(e.bound) << 24;
+    if (e.hasMove) {
+        d |= 1ULL << 26;
+        d |= static_cast<uint64_t>(static_cast<uint8_t>(e.move.type) & 0xF) << 27;
+        d |= static_cast<uint64_t>(e.move.actor & 0xF) << 31;
+        d |= static_cast<uint64_t>((e.move.target + 1) & 0xF) << 35;
+    }
+    d |= static_cast<uint64_t>(generation) << 39;
+    return d | USED;
+}
+
+TTEntry unpack(uint64_t d) {
+    TTEntry e;
+    e.value = static_cast<int16_t>(d & 0xFFFF);
+    e.depth = static_cast<uint8_t>(d >> 16);
+    e.bound = static_cast<TTBound>((d >> 24) & 3);
+    e.hasMove = (d >> 26) & 1;
+    if (e.hasMove) {
+        e.move.type = static_cast<ActionType>((d >> 27) & 0xF);
+        e.move.actor = static_cast<int>((d >> 31) & 0xF);
+        e.move.target = static_cast<int>((d >> 35) & 0xF) - 1;
+    }
+    return e;
+}
+
+uint8_t generationOf(uint64_t d) { return static_cast<uint8_t>(d >> 39); }
+
+// Move bits (has move, type, actor, target)
+constexpr uint64_t MOVE_BITS = ((1ULL << 13) - 1) << 26;
+}
+
+/**
+ * @brief Allocates an empty table.
+ * @param megabytes Size in MiB, rounded down to a power-of-two number of buckets.
+ * @throws std::invalid_argument if the size is below one bucket.
+ */
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    size_t wanted = (megabytes << 20) / sizeof(Bucket);
+    if (wanted == 0) throw std::invalid_argument("Transposition table needs at least 1 MiB");
+    bucketCount = 1;
+    while (bucketCount * 2 <= wanted) bucketCount *= 2;
+    buckets.reset(new Bucket[bucketCount]);
+    clear();
+}
+
+/**
+ * @brief Empties the table (not safe while other threads use it).
+ */
+void TranspositionTable::clear() {
+    for (size_t b = 0; b < bucketCount; ++b) {
+        for (Slot& s : buckets[b].slots) {
+            s.check.store(0, std::memory_order_relaxed);
+            s.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Looks up a position.
+ * @param key The position's Zobrist hash.
+ * @param out Receives the entry if found.
+ * @return True if the position is stored.
+ */
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) const {
+    const Bucket& bucket = buckets[key & (bucketCount - 1)];
+    for (const Slot& s : bucket.slots) {
+        uint64_t d = s.data.load(std::memory_order_relaxed);
+        if (d != 0 && (s.check.load(std::memory_order_relaxed) ^ d) == key) {
+            out = unpack(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Stores a search result, keeping the previous best move if the new entry has none.
+ * @param key The position's Zobrist hash.
+ * @param entry The result.
+ */
+void TranspositionTable::store(uint64_t key, const TTEntry& entry) {
+    Bucket& bucket = buckets[key & (bucketCount - 1)];
+    const uint8_t now = generation.load(std::memory_order_relaxed);
+    uint64_t d = pack(entry, now);
+
+    Slot* own = nullptr;
+    Slot* empty = nullptr;
+    Slot* shallowest = nullptr;
+    int shallowestScore = 0;
+    for (Slot& s : bucket.slots) {
+        uint64_t old = s.data.load(std::memory_order_relaxed);
+        if (old == 0) {
+            if (!empty) empty = &s;
+            continue;
+        }
+        if ((s.check.load(std::memory_order_relaxed) ^ old) == key) {
+            if (!entry.hasMove) d |= old & MOVE_BITS;
+            own = &s;
+            break;
+        }
+        // Each search since the entry was stored counts as 4 plies of depth lost
+        int age = static_cast<uint8_t>(now - generationOf(old));
+        int score = static_cast<int>((old >> 16) & 0xFF) - 4 * age;
+        if (!shallowest || score < shallowestScore) shallowest = &s, shallowestScore = score;
+    }
+    Slot* victim = own ? own : empty ? empty : shallowest;
+    victim->data.store(d, std::memory_order_relaxed);
+    victim->check.store(key ^ d, std::memory_order_relaxed);
+}
@@ -0,0 +1,189 @@
+// orel2744@gmail.com
+// VecGame.cpp - Structure-of-arrays batch of games stepped with the LaneState rules.
+#include "VecGame.hpp"
+#include "SimdKernels.hpp"
+#include <stdexcept>
+
+/**
+ * @brief Creates and deals the lanes.
+ * @param n Number of games.
+ * @param seatsPerGame Seats per game (2 to LaneState::MAX_SEATS).
+ * @param seed Seed for dealing roles.
+ * @throws std::invalid_argument if n is 0 or the seat count is out of range.
+ */
+VecGame::VecGame(size_t n, int seatsPerGame, uint64_t seed) : lanes(n), seats(seatsPerGame), rng(seed) {
+    if (lanes == 0) throw std::invalid_argument("VecGame needs at least one lane");
+    if (seats < 2 || seats > LaneState::MAX_SEATS) throw std::invalid_argument("A lane has 2 to 6 seats");
+    const size_t cells = lanes * static_cast<size_t>(seats);
+    seatCounts.assign(lanes, static_cast<uint8_t>(seats));
+    turn.resize(lanes);
+    bank.resize(lanes);
+    aliveCount.resize(lanes);
+    for (auto* column : {&role, &alive, &extra, &pending}) column->resize(cells);
+    coins.resize(cells);
+    for (auto* column : {&sanction, &arrestBlock, &coupBlock, &bribe, &tax, &arrestTarget}) column->resize(cells);
+    for (size_t i = 0; i < lanes; ++i) reset(i);
+}
+
+/**
+ * @brief Builds the strided reference of one lane.
+ * @param i Lane index.
+ */
+LaneRef VecGame::lane(size_t i) {
+    LaneRef r;
+    r.stride = lanes;
+    r.seats = &seatCounts[i];
+    r.turn = &turn[i];
+    r.bank = &bank[i];
+    r.role = &role[i];
+    r.coins = &coins[i];
+    r.alive = &alive[i];
+    r.extra = &extra[i];
+    r.pending = &pending[i];
+    r.sanction = &sanction[i];
+    r.arrestBlock = &arrestBlock[i];
+    r.coupBlock = &coupBlock[i];
+    r.bribe = &bribe[i];
+    r.tax = &tax[i];
+    r.arrestTarget = &arrestTarget[i];
+    return r;
+}
+
+/**
+ * @brief Applies one action per lane, then resets the lanes that finished.
+ * @param actions One action per lane.
+ * @param accepted If non-null, receives 1 per accepted action, else 0.
+ * @param winners If non-null, receives the winner of each lane that finished on this step, else -1.
+ */
+void VecGame::step(const Action* actions, uint8_t* accepted, int8_t* winners) {
+    for (size_t i = 0; i < lanes; ++i) {
+        bool ok = applyLaneAction(lane(i), actions[i]);
+        if (accepted) accepted[i] = ok ? 1 : 0;
+    }
+
+    // Count survivors seat column by seat column (contiguous, branch-free)
+    uint8_t* count = aliveCount.data();
+    for (size_t i = 0; i < lanes; ++i) count[i] = 0;
+    for (int p = 0; p < seats; ++p) {
+        const uint8_t* column = &alive[static_cast<size_t>(p) * lanes];
+        for (size_t i = 0; i < lanes; ++i) count[i] = static_cast<uint8_t>(count[i] + column[i]);
+    }
+
+    for (size_t i = 0; i < lanes; ++i) {
+        int8_t w = -1;
+        if (count[i] <= 1) {
+            for (int p = 0; p < seats; ++p) {
+                if (alive[static_cast<size_t>(p) * lanes + i]) w = static_cast<int8_t>(p);
+            }
+            ++finished;
+            reset(i);
+        }
+        if (winners) winners[i] = w;
+    }
+}
+
+/**
+ * @brief Writes, for every lane, the action mask of the seat to act.
+ * @param out One mask per lane.
+ */
+void VecGame::legalMasks(uint16_t* out) const {
+    for (int p = 0; p < seats; ++p) {
+        size_t k = static_cast<size_t>(p) * lanes;
+        SeatColumns c;
+        c.coins = &coins[k];
+        c.bank = bank.data();
+        c.turn = turn.data();
+        c.sanction = &sanction[k];
+        c.alive = &alive[k];
+        c.extra = &extra[k];
+        c.pending = &pending[k];
+        c.role = &role[k];
+        seatActionMasks(c, p, out, lanes);
+    }
+}
+
+/**
+ * @brief Moves amount[i] coins from lane i's bank to the seat to act.
+ * @param amount Coins per lane.
+ */
+void VecGame::payFromBank(const int16_t* amount) {
+    for (int p = 0; p < seats; ++p)
+        ::payFromBank(&coins[static_cast<size_t>(p) * lanes], bank.data(), turn.data(), p, amount, lanes);
+}
+
+/**
+ * @brief Re-deals one lane with random roles.
+ * @param i Lane index.
+ */
+void VecGame::reset(size_t i) {
+    std::uniform_int_distribution<int> dist(0, 5);
+    std::vector<Role> roles(static_cast<size_t>(seats));
+    for (Role& r : roles) r = static_cast<Role>(dist(rng));
+    reset(i, roles);
+}
+
+/**
+ * @brief Re-deals one lane with the given roles.
+ * @param i Lane index.
+ * @param roles One role per seat.
+ * @throws std::invalid_argument if the number of roles is not seatCount().
+ */
+void VecGame::reset(size_t i, const std::vector<Role>& roles) {
+    if (roles.size() != static_cast<size_t>(seats)) throw std::invalid_argument("Wrong number of roles for this VecGame");
+    set(i, LaneState::deal(roles));
+}
+
+/**
+ * @brief Returns a copy of one lane's state.
+ * @param i Lane index.
+ */
+LaneState VecGame::get(size_t i) const {
+    LaneState s;
+    s.seats = static_cast<uint8_t>(seats);
+    s.turn = turn[i];
+    s.bank = bank[i];
+    for (int p = 0; p < LaneState::MAX_SEATS; ++p) {
+        s.sanction[p] = s.arrestBlock[p] = s.coupBlock[p] = s.bribe[p] = s.tax[p] = s.arrestTarget[p] = -1;
+    }
+    for (int p = 0; p < seats; ++p) {
+        size_t k = static_cast<size_t>(p) * lanes + i;
+        s.role[p] = role[k];
+        s.coins[p] = coins[k];
+        s.alive[p] = alive[k];
+        s.extra[p] = extra[k];
+        s.pending[p] = pending[k];
+        s.sanction[p] = sanction[k];
+        s.arrestBlock[p] = arrestBlock[k];
+        s.coupBlock[p] = coupBlock[k];
+        s.bribe[p] = bribe[k];
+        s.tax[p] = tax[k];
+        s.arrestTarget[p] = arrestTarget[k];
+    }
+    return s;
+}
+
+/**
+ * @brief Overwrites one lane's state.
+ * @param i Lane index.
+ * @param s A state with seatCount() seats.
+ * @throws std::invalid_argument if the seat count differs.
+ */
+void VecGame::set(size_t i, const LaneState& s) {
+    if (s.seats != seats) throw std::invalid_argument("Lane state has the wrong number of seats");
+    turn[i] = s.turn;
+    bank[i] = s.bank;
+    for (int p = 0; p < seats; ++p) {
+        size_t k = static_cast<size_t>(p) * lanes + i;
+        role[k] = s.role[p];
+        coins[k] = s.coins[p];
+        alive[k] = s.alive[p];
+        extra[k] = s.extra[p];
+        pending[k] = s.pending[p];
+        sanction[k] = s.sanction[p];
+        arrestBlock[k] = s.arrestBlock[p];
+        coupBlock[k] = s.coupBlock[p];
+        bribe[k] = s.bribe[p];
+        tax[k] = s.tax[p];
+        arrestTarget[k] = s.arrestTarget[p];
+    }
+}
@@ -0,0 +1,25 @@
+// orel2744@gmail.com
+// Zobrist.cpp - Zobrist hash of a LaneState, field for field the same as Game's incremental hash.
+#include "Zobrist.hpp"
+
+/**
+ * @brief Returns the hash of a lane state, equal to Game::hash() of the same game.
+ * @param state The state.
+ */
+uint64_t zobristHash(const LaneState& state) {
+    uint64_t h = zobristKey(ZobristField::Bank, -1, state.bank) ^ zobristKey(ZobristField::Turn, -1, state.turn);
+    for (int p = 0; p < state.seats; ++p) {
+        h ^= zobristKey(ZobristField::Role, p, state.role[p]);
+        h ^= zobristKey(ZobristField::Coins, p, state.coins[p]);
+        h ^= zobristKey(ZobristField::Alive, p, state.alive[p]);
+        h ^= zobristKey(ZobristField::Extra, p, state.extra[p]);
+        h ^= zobristKey(ZobristField::Pending, p, state.pending[p]);
+        if (state.sanction[p] >= 0) h ^= zobristKey(ZobristField::Sanction, p, state.sanction[p]);
+        if (state.arrestBlock[p] >= 0) h ^= zobristKey(ZobristField::ArrestBlock, p, state.arrestBlock[p]);
+        if (state.coupBlock[p] >= 0) h ^= zobristKey(ZobristField::CoupBlock, p, state.coupBlock[p]);
+        if (state.bribe[p] >= 0) h ^= zobristKey(ZobristField::Bribe, p, state.bribe[p]);
+        if (state.tax[p] >= 0) h ^= zobristKey(ZobristField::Tax, p, state.tax[p]);
+        if (state.arrestTarget[p] >= 0) h ^= zobristKey(ZobristField::ArrestTarget, p, state.arrestTarget[p]);
+    }
+    return h;
+}
@@ -8,8 +8,13 @@
 #include "Governor.hpp"
 #include "Spy.hpp"
 #include "Baron.hpp"
+#include "Trace.hpp"
+#include <cstring>
 
-int main() {
+int main(int argc, char** argv) {
+    // "--trace FILE" records the demo's trace points and writes them as a Chrome trace at the end
+    const char* tracePath = argc > 2 && std::strcmp(argv[1], "--trace") == 0 ? argv[2] : nullptr;
+    Trace::enable(tracePath != nullptr);
     Game game;
     std::vector<std::unique_ptr<Player>> players;
     std::vector<std::string> names = {"Avichay", "Shachar", "Dani"};
@@ -22,7 +27,10 @@ int main() {
 
     // Example: let the first player take a turn (demonstration only)
     std::cout << "\nTurn: " << game.turn() << std::endl;
-    players[0]->gather();
+    {
+        TraceScope trace("demo turn", "driver");
+        players[0]->gather();
+    }
 
     // Show who's still alive
     std::cout << "\n--- Remaining Players ---\n";
@@ -30,5 +38,15 @@ int main() {
         std::cout << "- " << name << std::endl;
     }
 
+    if (tracePath) {
+        try {
+            size_t events = Trace::writeChromeJson(std::string(tracePath));
+            std::cout << "\n" << events << " trace events written to " << tracePath << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,157 @@
+// orel2744@gmail.com
+// main_allocs.cpp - allocation profile of headless play: plays games like playGame() with every policy call,
+// action and rule check in its own AllocScope, then probes Game calls suspected of allocating, and prints
+// allocations and bytes per call for each. Built with -DCOUP_TRACK_ALLOCS (make allocs).
+// Usage: allocs.exe [--games N] [--seats S] [--seed X]
+#include "AllocTracker.hpp"
+#include "Game.hpp"
+#include "LaneState.hpp"
+#include "Player.hpp"
+#include "Simulation.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+/**
+ * @brief Applies an action under the tag of its type and outcome. The outcome is decided first on a
+ *        LaneState copy, outside any scope, so the tag is known before the Game is touched.
+ * @return True if the Game accepted the action.
+ */
+bool tracedApply(Game& game, const Action& action, const std::vector<int>& accepted, const std::vector<int>& rejected,
+                 size_t& disagreements) {
+    LaneState lane = LaneState::fromGame(game);
+    const bool legal = lane.apply(action);
+    bool ok = true;
+    {
+        AllocScope scope((legal ? accepted : rejected)[static_cast<int>(action.type)]);
+        try {
+            applyAction(game, action);
+        } catch (const std::exception&) {
+            ok = false;
+        }
+    }
+    if (ok != legal) ++disagreements;
+    return ok;
+}
+}
+
+int main(int argc, char** argv) {
+    size_t games = 2000;
+    int seats = 4;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seats") == 0 && hasValue) seats = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--games N] [--seats S] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+    if (!AllocTracker::enabled()) {
+        std::cerr << "allocs: built without -DCOUP_TRACK_ALLOCS; use make allocs" << std::endl;
+        return 1;
+    }
+    if (seats < 2 || seats > LaneState::MAX_SEATS) {
+        std::cerr << "allocs: seats must be 2 to " << LaneState::MAX_SEATS << std::endl;
+        return 1;
+    }
+
+    try {
+        std::vector<int> accepted(ACTION_TYPE_COUNT), rejected(ACTION_TYPE_COUNT);
+        for (int t = 0; t < ACTION_TYPE_COUNT; ++t) {
+            accepted[t] = AllocTracker::tag(actionTypeToString(static_cast<ActionType>(t)));
+            rejected[t] = AllocTracker::tag(actionTypeToString(static_cast<ActionType>(t)) + " (rejected)");
+        }
+        const int setupTag = AllocTracker::tag("game setup");
+        const int policyTag = AllocTracker::tag("chooseSimpleAction");
+        const int namesTag = AllocTracker::tag("Game::playersNames");
+        const int turnTag = AllocTracker::tag("Game::turn");
+        const int missTag = AllocTracker::tag("Game::getPlayer (miss)");
+        const int hitTag = AllocTracker::tag("Game::getPlayer (hit)");
+        AllocTracker::reset();
+
+        std::mt19937_64 rng(seed);
+        size_t disagreements = 0, actions = 0;
+        for (size_t g = 0; g < games; ++g) {
+            std::unique_ptr<Game> game;
+            std::vector<std::unique_ptr<Player>> players;
+            {
+                AllocScope scope(setupTag);
+                game.reset(new Game);
+                game->setLogging(false);
+                for (int s = 0; s < seats; ++s)
+                    players.emplace_back(Game::createPlayerWithRole("Seat " + std::to_string(s + 1), game.get(),
+                                                                    static_cast<Role>(rng() % 6)));
+            }
+            auto alive = [&players] {
+                return std::count_if(players.begin(), players.end(), [](const std::unique_ptr<Player>& p) { return p->isAlive(); });
+            };
+            for (size_t n = 0; n < 1000 && alive() > 1; ++n, ++actions) {
+                Action a;
+                {
+                    AllocScope scope(policyTag);
+                    a = chooseSimpleAction(*game, rng);
+                }
+                if (tracedApply(*game, a, accepted, rejected, disagreements)) continue;
+                if (!tracedApply(*game, {ActionType::Gather, a.actor, -1}, accepted, rejected, disagreements))
+                    tracedApply(*game, {ActionType::SkipTurn, a.actor, -1}, accepted, rejected, disagreements);
+            }
+            // Calls that build strings or vectors on the way
+            for (int probe = 0; probe < 10; ++probe) {
+                {
+                    AllocScope scope(namesTag);
+                    game->playersNames();
+                }
+                {
+                    AllocScope scope(turnTag);
+                    if (alive() > 0) game->turn();
+                }
+                const std::string name = "Seat 1", missing = "Nobody";
+                {
+                    AllocScope scope(hitTag);
+                    game->getPlayer(name);
+                }
+                {
+                    AllocScope scope(missTag);
+                    try {
+                        game->getPlayer(missing);
+                    } catch (const std::logic_error&) {
+                    }
+                }
+            }
+        }
+
+        std::cout << games << " games, " << actions << " turns, " << seats << " seats";
+        if (disagreements) std::cout << " (" << disagreements << " actions where LaneState and Game disagreed)";
+        std::cout << "\n" << std::setw(28) << std::left << "tag" << std::right << std::setw(10) << "calls" << std::setw(12)
+                  << "allocs/call" << std::setw(12) << "bytes/call" << std::setw(12) << "frees/call" << "\n";
+        uint64_t actionScopes = 0, actionAllocations = 0;
+        for (int t = 0; t < AllocTracker::tagCount(); ++t) {
+            AllocTracker::Counts c = AllocTracker::counts(t);
+            if (c.scopes == 0) continue;
+            if (std::find(accepted.begin(), accepted.end(), t) != accepted.end() ||
+                std::find(rejected.begin(), rejected.end(), t) != rejected.end()) {
+                actionScopes += c.scopes;
+                actionAllocations += c.allocations;
+            }
+            const double calls = static_cast<double>(c.scopes);
+            std::cout << std::setw(28) << std::left << AllocTracker::name(t) << std::right << std::setw(10) << c.scopes
+                      << std::fixed << std::setprecision(2) << std::setw(12) << c.allocations / calls << std::setw(12)
+                      << c.bytes / calls << std::setw(12) << c.frees / calls << "\n";
+        }
+        std::cout << "allocations per applied action: " << std::setprecision(3)
+                  << static_cast<double>(actionAllocations) / std::max<uint64_t>(1, actionScopes) << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "allocs: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
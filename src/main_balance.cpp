@@ -0,0 +1,71 @@
+// orel2744@gmail.com
+// main_balance.cpp - balance tool: estimates each role's win rate from a batch of simulated games,
+// dealt independently and stratified, and reports how many games each mode needs for a given precision.
+// Usage: balance.exe [--seats K] [--games N] [--seed S] [--half-width E]
+#include "Dealing.hpp"
+#include "Simulation.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+// Plays every dealt game of a batch; game i uses seed + i for its policy
+std::vector<RoleEstimate> runBatch(const BatchDealer& dealer, uint64_t seed) {
+    std::vector<GameResult> results;
+    results.reserve(dealer.getDeals().size());
+    for (size_t i = 0; i < dealer.getDeals().size(); ++i)
+        results.push_back(playGame(dealer.getDeals()[i].roles, seed + i));
+    return estimateRoleWinRates(dealer, results);
+}
+}
+
+int main(int argc, char** argv) {
+    size_t seats = 4, games = 20000;
+    uint64_t seed = 1;
+    double halfWidth = 0.005;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--seats") == 0 && hasValue) seats = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--games") == 0 && hasValue) games = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--half-width") == 0 && hasValue) halfWidth = std::atof(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--seats K] [--games N] [--seed S] [--half-width E]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        BatchDealer independent(seats, games, DealMode::Independent, seed);
+        BatchDealer stratified(seats, games, DealMode::Stratified, seed);
+        std::vector<RoleEstimate> ind = runBatch(independent, seed);
+        std::vector<RoleEstimate> str = runBatch(stratified, seed);
+
+        std::cout << games << " games of " << seats << " seats, " << stratified.strataCount()
+                  << " role compositions; games needed for +/-" << halfWidth << " at 95%\n";
+        std::cout << std::left << std::setw(10) << "role" << std::right
+                  << std::setw(18) << "independent" << std::setw(18) << "stratified"
+                  << std::setw(12) << "need ind" << std::setw(12) << "need strat" << std::setw(10) << "saving" << "\n";
+        std::cout << std::fixed;
+        for (size_t r = 0; r < ind.size(); ++r) {
+            double needInd = ind[r].gamesNeeded(halfWidth);
+            double needStr = str[r].gamesNeeded(halfWidth);
+            std::cout << std::left << std::setw(10) << roleToString(ind[r].role) << std::right
+                      << std::setprecision(4) << std::setw(9) << ind[r].winRate << " +/- " << std::setw(4)
+                      << std::setprecision(4) << std::sqrt(ind[r].variance)
+                      << std::setw(9) << str[r].winRate << " +/- " << std::setw(4) << std::sqrt(str[r].variance)
+                      << std::setprecision(0) << std::setw(12) << needInd << std::setw(12) << needStr;
+            // A role with no variance under independent deals has nothing to save
+            if (needInd > 0)
+                std::cout << std::setprecision(1) << std::setw(9) << 100.0 * (1.0 - needStr / needInd) << "%\n";
+            else
+                std::cout << std::setw(10) << "n/a" << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "balance: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+// orel2744@gmail.com
+// main_cfr.cpp - cfr tool: trains MCCFR on the abstract 2-player game and reports iterations per second and an
+// estimate of the average strategy's exploitability in the abstraction over time, optionally checkpointing
+// (and resuming) the tables.
+// Usage: cfr.exe [--iterations N] [--every N] [--threads T] [--horizon H] [--checkpoint PATH] [--seed X]
+#include "Cfr.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 200000, every = 50000;
+    std::string checkpoint;
+    CfrConfig config;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--iterations") == 0 && hasValue) iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--every") == 0 && hasValue) every = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--horizon") == 0 && hasValue) config.horizon = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--checkpoint") == 0 && hasValue) checkpoint = argv[++i];
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--iterations N] [--every N] [--threads T] [--horizon H] [--checkpoint PATH] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+    if (every == 0) every = iterations;
+
+    try {
+        CfrTrainer trainer(config);
+        if (!checkpoint.empty() && std::ifstream(checkpoint)) {
+            trainer.load(checkpoint);
+            std::cout << "Resumed " << checkpoint << " at " << trainer.iterations() << " iterations\n";
+        }
+        std::cout << std::fixed << "horizon " << config.horizon << ", " << trainer.getConfig().threads << " threads\n"
+                  << "exploitability: best-response gain in the abstract game, a lower bound (coin buckets forget)\n"
+                  << std::setw(12) << "iterations" << std::setw(12) << "infosets" << std::setw(12) << "it/s"
+                  << std::setw(16) << "exploitability" << "\n"
+                  << std::setw(12) << trainer.iterations() << std::setw(12) << trainer.infoSets() << std::setw(12) << "-"
+                  << std::setw(16) << std::setprecision(4) << trainer.exploitability() << std::endl;
+        for (uint64_t done = 0; done < iterations; done += every) {
+            trainer.train(std::min(every, iterations - done));
+            std::cout << std::setw(12) << trainer.iterations() << std::setw(12) << trainer.infoSets() << std::setw(12)
+                      << std::setprecision(0) << trainer.iterationsPerSecond() << std::setw(16) << std::setprecision(4)
+                      << trainer.exploitability() << std::endl;
+            if (!checkpoint.empty()) trainer.save(checkpoint);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "cfr: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+// orel2744@gmail.com
+// main_evolve.cpp - evolve tool: tunes HeuristicBot weights with the genetic algorithm, printing each
+// generation's best and mean win rate and games per second, then the champion's weights and a fresh
+// measurement of its win rate against the baseline.
+// Usage: evolve.exe [--generations G] [--population P] [--games N] [--seats S] [--threads T] [--seed X]
+#include "Evolution.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+const char* const GENE_NAMES[BotWeights::COUNT] = {"tax", "gather", "arrest", "sanction", "bribe", "invest",
+                                                   "coupAt", "coupChance", "coupRichest", "arrestRichest",
+                                                   "sanctionRichest", "sanctionReserve"};
+}
+
+int main(int argc, char** argv) {
+    int generationCount = 20;
+    EvolutionConfig config;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--generations") == 0 && hasValue) generationCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--population") == 0 && hasValue) config.population = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--games") == 0 && hasValue) config.gamesPerGenome = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seats") == 0 && hasValue) config.seats = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--generations G] [--population P] [--games N] [--seats S] [--threads T] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        Evolution evolution(config);
+        std::cout << std::fixed << config.population << " genomes x " << config.gamesPerGenome << " games, "
+                  << config.seats << " seats, " << evolution.getConfig().threads << " threads ("
+                  << std::setprecision(1) << 100.0 / config.seats << "% wins expected by chance)\n"
+                  << std::setw(10) << "generation" << std::setw(10) << "best" << std::setw(10) << "mean"
+                  << std::setw(12) << "games/s" << "\n";
+        for (int g = 0; g < generationCount; ++g) {
+            GenerationStats stats = evolution.step();
+            std::cout << std::setw(10) << stats.generation << std::setw(10) << std::setprecision(3) << stats.best
+                      << std::setw(10) << stats.mean << std::setw(12) << std::setprecision(0) << stats.gamesPerSecond()
+                      << std::endl;
+        }
+        if (generationCount < 1) return 0;
+        const Genome& champion = evolution.best();
+        std::cout << "champion:";
+        for (int g = 0; g < BotWeights::COUNT; ++g)
+            std::cout << " " << GENE_NAMES[g] << "=" << std::setprecision(2) << champion.weights[g];
+        const size_t games = 20 * config.gamesPerGenome;
+        std::cout << "\nchampion vs baseline over " << games << " new games: " << std::setprecision(1)
+                  << 100.0 * evolution.winRate(champion.weights, games, config.seed + 0xC4A3) << "% wins\n";
+    } catch (const std::exception& e) {
+        std::cerr << "evolve: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
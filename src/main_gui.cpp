@@ -9,6 +9,10 @@
  *
  * Features:
  * - Displays player list, coins, and current turn
+ * - Scrollable, virtualised player list with sort/filter (large exhibition tables)
+ * - Performance overlay (F3): frame time, draw calls, action time, click-to-frame latency
+ * - Tracing (F4): starts recording trace points; F4 again writes them to coup_trace.json (Chrome/Perfetto)
+ * - Records every game to last_game.replay; "--replay <file>" opens the replay viewer
  * - Allows actions: Gather, Tax, Bribe, Coup, Sanction, Invest (Baron), Spy (Spy)
  * - Handles target selection for actions that require it
  * - Shows game result and error messages
@@ -28,16 +32,179 @@
 #include "Spy.hpp"
 #include "General.hpp"
 #include "Merchant.hpp"
+#include "PlayerListView.hpp"
+#include "PerfStats.hpp"
+#include "Replay.hpp"
+#include "Trace.hpp"
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+/**
+ * @brief Replay viewer mode: plays a recorded game with a scrub bar and 1x-1000x playback.
+ *        Space plays/pauses, Left/Right step, Up/Down change speed by 10x, Home/End jump,
+ *        clicking or dragging on the bar seeks (keyframe-indexed, so any step is instant).
+ * @param window Window to draw into.
+ * @param font Font for all text.
+ * @param path Replay file to load.
+ * @return Process exit code.
+ */
+static int runReplayViewer(sf::RenderWindow& window, const sf::Font& font, const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << " Failed to open replay '" << path << "'!" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<ReplayViewer> viewer;
+    try {
+        viewer.reset(new ReplayViewer(Replay::load(in)));
+    } catch (const std::exception& e) {
+        std::cerr << " Failed to load replay: " << e.what() << std::endl;
+        return 1;
+    }
+
+    const float barX = 50, barY = 600, barWidth = 1000, barHeight = 16;
+    const double baseStepsPerSecond = 2.0; // speed 1x
+    sf::Color textColor(230, 230, 230), highlightColor(255, 215, 0), playerListBg(30, 30, 30, 200);
+    sf::RectangleShape barTrack(sf::Vector2f(barWidth, barHeight));
+    barTrack.setPosition(barX, barY);
+    barTrack.setFillColor(sf::Color(70, 70, 70));
+    sf::RectangleShape barFill, barHandle(sf::Vector2f(6, barHeight + 10));
+    barFill.setPosition(barX, barY);
+    barFill.setFillColor(sf::Color(180, 140, 40));
+    barHandle.setFillColor(highlightColor);
+    sf::Text statusText("", font, 24), actionText("", font, 20), errorText("", font, 18), infoText("", font, 20);
+    statusText.setPosition(50, 20); statusText.setFillColor(highlightColor);
+    actionText.setPosition(50, 70); actionText.setFillColor(textColor);
+    errorText.setPosition(50, 100); errorText.setFillColor(sf::Color::Red);
+    infoText.setPosition(50, 150); infoText.setFillColor(textColor);
+    sf::RectangleShape listBg(sf::Vector2f(250, 560));
+    listBg.setPosition(830, 20);
+    listBg.setFillColor(playerListBg);
+    PlayerListView list(30, 520);
+    std::vector<sf::Text> rowTexts(list.maxVisibleRows(), sf::Text("", font, 18));
+
+    bool playing = false, dragging = false;
+    int speed = 1;
+    double pendingSteps = 0;
+    sf::Clock clock;
+    auto seekToMouse = [&](float x) {
+        double frac = std::max(0.0, std::min(1.0, static_cast<double>(x - barX) / barWidth));
+        viewer->seek(static_cast<size_t>(frac * viewer->length() + 0.5));
+    };
+
+    while (window.isOpen()) {
+        size_t before = viewer->position();
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+            if (event.type == sf::Event::KeyPressed) {
+                switch (event.key.code) {
+                    case sf::Keyboard::Space: playing = !playing; pendingSteps = 0; break;
+                    case sf::Keyboard::Right: viewer->step(); break;
+                    case sf::Keyboard::Left: if (viewer->position() > 0) viewer->seek(viewer->position() - 1); break;
+                    case sf::Keyboard::Up: speed = std::min(1000, speed * 10); break;
+                    case sf::Keyboard::Down: speed = std::max(1, speed / 10); break;
+                    case sf::Keyboard::Home: viewer->seek(0); break;
+                    case sf::Keyboard::End: viewer->seek(viewer->length()); break;
+                    default: break;
+                }
+            }
+            if (event.type == sf::Event::MouseWheelScrolled) list.scrollBy(-event.mouseWheelScroll.delta * 90);
+            if (event.type == sf::Event::MouseButtonPressed &&
+                event.mouseButton.y >= barY - 8 && event.mouseButton.y <= barY + barHeight + 8) {
+                dragging = true;
+                seekToMouse(static_cast<float>(event.mouseButton.x));
+            }
+            if (event.type == sf::Event::MouseMoved && dragging) seekToMouse(static_cast<float>(event.mouseMove.x));
+            if (event.type == sf::Event::MouseButtonReleased) dragging = false;
+        }
+
+        double dt = clock.restart().asSeconds();
+        if (playing && !dragging) {
+            pendingSteps += dt * baseStepsPerSecond * speed;
+            size_t n = static_cast<size_t>(pendingSteps);
+            pendingSteps -= static_cast<double>(n);
+            viewer->seek(viewer->position() + n);
+            if (viewer->position() == viewer->length()) playing = false;
+        }
+        if (viewer->position() != before) list.markDirty();
+
+        const Game& game = viewer->getGame();
+        std::string winner, turnName;
+        try { winner = game.winner(); } catch (const std::exception&) {}
+        try { turnName = game.turn(); } catch (const std::exception&) {}
+        statusText.setString("Replay  step " + std::to_string(viewer->position()) + " / " +
+                             std::to_string(viewer->length()) + "   " + std::to_string(speed) + "x  " +
+                             (playing ? "playing" : "paused"));
+        const Action* last = viewer->lastAction();
+        actionText.setString(last ? game.playerAt(last->actor)->getName() + ": " + actionTypeToString(last->type) +
+                                        (last->target >= 0 ? " -> " + game.playerAt(last->target)->getName() : "")
+                                  : "Start of game");
+        errorText.setString(viewer->lastError().empty() ? "" : "Rejected: " + viewer->lastError());
+        infoText.setString("Bank: " + std::to_string(game.getBank()) + " coins\n" +
+                           (winner.empty() ? "Turn: " + turnName : "Winner: " + winner));
+        float frac = viewer->length() ? static_cast<float>(viewer->position()) / viewer->length() : 0.f;
+        barFill.setSize(sf::Vector2f(frac * barWidth, barHeight));
+        barHandle.setPosition(barX + frac * barWidth - 3, barY - 5);
+
+        window.clear(sf::Color(25, 25, 35));
+        window.draw(statusText); window.draw(actionText); window.draw(errorText); window.draw(infoText);
+        window.draw(barTrack); window.draw(barFill); window.draw(barHandle);
+        window.draw(listBg);
+        list.rebuild(viewer->getPlayers());
+        size_t first = list.firstVisible();
+        for (size_t i = 0; i < list.visibleCount(); ++i) {
+            Player* p = list.rowAt(first + i);
+            float y = list.rowOffset(first + i);
+            if (y < 0) continue;
+            sf::Text& t = rowTexts[i];
+            t.setString(p->getName() + " [" + roleToString(p->getRole()) + "] - " + std::to_string(p->getCoins()));
+            t.setPosition(840, 40 + y);
+            t.setFillColor(winner.empty() && p->getName() == turnName ? highlightColor : textColor);
+            window.draw(t);
+        }
+        window.display();
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::strcmp(argv[1], "--replay") == 0) {
+        sf::RenderWindow window(sf::VideoMode(1100, 650), "Coup Game - Replay");
+        sf::Font font;
+        if (!font.loadFromFile("assets/DejaVuSans-Bold.ttf")) {
+            std::cerr << " Failed to load font 'assets/DejaVuSans-Bold.ttf'!" << std::endl;
+            return 1;
+        }
+        return runReplayViewer(window, font, argv[2]);
+    }
 
-int main() {
     Game game;
     std::vector<Player*> players;
     std::vector<std::string> names = {"Orel", "Avi", "Alon", "Shachar", "Avicii"};
-    for (const auto& name : names) {
-        Role role = Game::getRandomRole();
-        players.push_back(Game::createPlayerWithRole(name, &game, role));
-        std::cout << name << " assigned role: " << roleToString(role) << std::endl;
+    // Optional table size for exhibition games, e.g. "game_gui.exe 200"
+    if (argc > 1) {
+        size_t seats = static_cast<size_t>(std::max(2, std::atoi(argv[1])));
+        names.resize(std::min(seats, names.size()));
+        for (size_t i = names.size(); i < seats; ++i) names.push_back("Seat " + std::to_string(i + 1));
     }
+    // Every game is recorded and saved to last_game.replay when it ends
+    Replay recording;
+    const char* replayPath = "last_game.replay";
+    auto dealPlayers = [&]() {
+        recording.clear();
+        for (const auto& name : names) {
+            Role role = Game::getRandomRole();
+            players.push_back(Game::createPlayerWithRole(name, &game, role));
+            recording.addSeat(name, role);
+            std::cout << name << " assigned role: " << roleToString(role) << std::endl;
+        }
+    };
+    dealPlayers();
 
     sf::RenderWindow window(sf::VideoMode(1100, 650), "Coup Game - GUI");
     sf::Font font;
@@ -84,8 +251,37 @@ int main() {
     for (auto* t : {&gatherText, &taxText, &bribeText, &coupText, &sanctionText, &investText, &spyText})
         t->setFillColor(sf::Color::White);
 
+    // Target picker, virtualised like the player list: only the rows inside its viewport are laid out and drawn
+    const float targetY = 470, targetRowHeight = 50, targetWidth = 200, targetHeight = 650 - targetY;
+    PlayerListView targetList(targetRowHeight, targetHeight);
+    std::vector<Player*> targetCandidates;
     std::vector<sf::RectangleShape> targetButtons;
     std::vector<sf::Text> targetTexts;
+    float targetX = 300;
+    auto openTargets = [&](Player* current, float x, sf::Color color) {
+        targetCandidates.clear();
+        for (Player* p : players) if (p != current) targetCandidates.push_back(p);
+        targetList = PlayerListView(targetRowHeight, targetHeight);
+        targetList.rebuild(targetCandidates);
+        targetX = x;
+        sf::RectangleShape btn({targetWidth, 40}); btn.setFillColor(color);
+        sf::Text txt("", font, 20); txt.setFillColor(sf::Color::White);
+        targetButtons.assign(targetList.maxVisibleRows(), btn);
+        targetTexts.assign(targetList.maxVisibleRows(), txt);
+    };
+    auto overTargets = [&](sf::Vector2f mouse) {
+        return mouse.x >= targetX && mouse.x < targetX + targetWidth && mouse.y >= targetY && mouse.y < targetY + targetHeight;
+    };
+    // The target whose button is under the mouse, or null
+    auto targetAt = [&](sf::Vector2f mouse) -> Player* {
+        if (!overTargets(mouse)) return nullptr;
+        size_t first = targetList.firstVisible();
+        for (size_t i = 0; i < targetList.visibleCount(); ++i) {
+            float top = targetY + targetList.rowOffset(first + i);
+            if (mouse.y >= top && mouse.y < top + 40) return targetList.rowAt(first + i);
+        }
+        return nullptr;
+    };
     bool choosingTarget = false, choosingSanction = false, choosingSpy = false;
     bool gameOver = false, mustCoup = false;
     std::string winnerName = "";
@@ -142,10 +338,114 @@ int main() {
     restartText.setPosition(restartBtnX + (restartBtnWidth - rt.width) / 2.f - rt.left,
                            restartBtnY + (restartBtnHeight - rt.height) / 2.f - rt.top);
 
+    // --- Player list panel (virtualised: only rows inside the viewport are laid out and drawn) ---
+    // Spectator mode shows every role and uses a taller panel; it starts on for tables larger than 6.
+    const float listX = 840, listY = 20, listWidth = 230, listRowHeight = 30, listHeaderHeight = 40;
+    bool spectator = names.size() > 6;
+    auto listHeight = [&]() { return spectator ? 610.f : 300.f; };
+    PlayerListView playerList(listRowHeight, listHeight() - listHeaderHeight);
+    std::vector<sf::Text> listRowTexts;
+    auto resetPlayerList = [&]() {
+        Role filter = playerList.getRoleFilter();
+        PlayerListView::SortKey key = playerList.getSortKey();
+        playerList = PlayerListView(listRowHeight, listHeight() - listHeaderHeight);
+        playerList.setRoleFilter(filter);
+        playerList.setSort(key, key == PlayerListView::SortKey::Coins);
+        listRowTexts.assign(playerList.maxVisibleRows(), sf::Text("", font, 18));
+    };
+    resetPlayerList();
+    Player* listFollows = nullptr; // player the list last scrolled to
+
+    // --- Performance overlay (F3) ---
+    // Samples are always recorded (O(1) each); percentiles are only computed while the overlay is shown.
+    bool showPerf = false;
+    RollingSamples frameSamples, drawSamples, actionSamples, feedbackSamples;
+    size_t drawCalls = 0, framesSincePerfText = 0;
+    auto draw = [&](const sf::Drawable& d) { window.draw(d); ++drawCalls; };
+    sf::Clock frameClock;
+    // Frame phases as trace events while tracing is on (F4)
+    const char* tracePath = "coup_trace.json";
+    auto traceStart = [] { return Trace::enabled() ? Trace::now() : 0; };
+    auto traceSince = [](const char* name, uint64_t start) {
+        if (start && Trace::enabled()) Trace::record(name, "gui", start, Trace::now());
+    };
+    bool clickPending = false;
+    std::chrono::steady_clock::time_point clickTime;
+    const float perfX = 520, perfY = 20, perfWidth = 300, perfHeight = 150, perfGraphHeight = 40;
+    sf::RectangleShape perfBg(sf::Vector2f(perfWidth, perfHeight));
+    perfBg.setPosition(perfX, perfY);
+    perfBg.setFillColor(sf::Color(0, 0, 0, 170));
+    sf::Text perfText("", font, 13);
+    perfText.setPosition(perfX + 8, perfY + 6);
+    perfText.setFillColor(sf::Color(180, 255, 180));
+    sf::VertexArray perfGraph(sf::Lines, 2 * frameSamples.capacity());
+    // Records an action into the replay, then applies it (timed for the overlay)
+    auto act = [&](Player* actor, ActionType type, Player* target) {
+        Action a{type, actor->getSeat(), target ? target->getSeat() : -1};
+        recording.record(a);
+        TraceScope trace("gui action", "gui");
+        ScopedSample timing(actionSamples);
+        applyAction(game, a);
+    };
+    auto formatStat = [](const char* label, const RollingSamples& h, double scale, const char* unit) {
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "%-8s p50 %7.2f  p99 %7.2f %s\n", label,
+                      h.percentile(50) * scale, h.percentile(99) * scale, unit);
+        return std::string(buf);
+    };
+
     while (window.isOpen()) {
+        TraceScope frameTrace("frame", "gui");
+        const uint64_t eventsStart = traceStart();
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) window.close();
+            // Player list controls: wheel scrolls (the target picker when over it), Tab toggles spectator mode,
+            // C/R/N sort by coins/role/seat, F cycles the role filter.
+            if (event.type == sf::Event::MouseWheelScrolled) {
+                sf::Vector2f at(static_cast<float>(event.mouseWheelScroll.x), static_cast<float>(event.mouseWheelScroll.y));
+                if ((choosingTarget || choosingSanction || choosingSpy) && overTargets(at))
+                    targetList.scrollBy(-event.mouseWheelScroll.delta * targetRowHeight);
+                else
+                    playerList.scrollBy(-event.mouseWheelScroll.delta * listRowHeight * 3);
+                continue;
+            }
+            if (event.type == sf::Event::KeyPressed) {
+                switch (event.key.code) {
+                    case sf::Keyboard::F3: showPerf = !showPerf; framesSincePerfText = 0; break;
+                    case sf::Keyboard::F4:
+                        if (!Trace::enabled()) {
+                            Trace::clear();
+                            Trace::enable(true);
+                            std::cout << "Tracing..." << std::endl;
+                            break;
+                        }
+                        Trace::enable(false);
+                        try {
+                            size_t events = Trace::writeChromeJson(std::string(tracePath));
+                            std::cout << events << " trace events written to " << tracePath << std::endl;
+                        } catch (const std::exception& e) {
+                            std::cerr << e.what() << std::endl;
+                        }
+                        break;
+                    case sf::Keyboard::Tab: spectator = !spectator; resetPlayerList(); break;
+                    case sf::Keyboard::C: playerList.setSort(PlayerListView::SortKey::Coins, true); break;
+                    case sf::Keyboard::R: playerList.setSort(PlayerListView::SortKey::Role, false); break;
+                    case sf::Keyboard::N: playerList.setSort(PlayerListView::SortKey::Seat, false); break;
+                    case sf::Keyboard::F: {
+                        int next = (static_cast<int>(playerList.getRoleFilter()) + 1) % (static_cast<int>(Role::Unknown) + 1);
+                        playerList.setRoleFilter(static_cast<Role>(next));
+                        break;
+                    }
+                    default: break;
+                }
+                continue;
+            }
+            if (event.type == sf::Event::MouseButtonPressed) {
+                playerList.markDirty();
+                clickPending = true;
+                clickTime = std::chrono::steady_clock::now();
+            }
             if (gameOver) {
                 if (event.type == sf::Event::MouseButtonPressed) {
                     sf::Vector2f mouse(sf::Mouse::getPosition(window));
@@ -154,12 +454,8 @@ int main() {
                         for (Player* p : players) delete p;
                         players.clear();
                         game = Game();
-                        std::vector<std::string> names = {"Orel", "Avi", "Alon", "Shachar", "Avicii"};
-                        for (const auto& name : names) {
-                            Role role = Game::getRandomRole();
-                            players.push_back(Game::createPlayerWithRole(name, &game, role));
-                            std::cout << name << " assigned role: " << roleToString(role) << std::endl;
-                        }
+                        dealPlayers();
+                        playerList.markDirty();
                         winnerName = "";
                         gameOver = false;
                         mustCoup = false;
@@ -175,97 +471,71 @@ int main() {
 
             if (mustCoup && !choosingTarget) {
                 choosingTarget = true;
-                targetButtons.clear(); targetTexts.clear();
-                int y = 470;
-                for (Player* p : players) {
-                    if (p->isAlive() && p != current) {
-                        sf::RectangleShape btn({200, 40}); btn.setPosition(300, y); btn.setFillColor(sf::Color(60, 60, 60));
-                        sf::Text txt(p->getName(), font, 20); txt.setPosition(310, y + 5); txt.setFillColor(sf::Color::White);
-                        targetButtons.push_back(btn); targetTexts.push_back(txt); y += 50;
-                    }
-                }
+                openTargets(current, 300, sf::Color(60, 60, 60));
                 resultText.setString("You have 10+ coins. Must coup!");
                 resultText.setFillColor(sf::Color::Red);
             }
 
             if (event.type == sf::Event::MouseButtonPressed) {
                 if (choosingTarget || choosingSanction || choosingSpy) {
-                    for (size_t i = 0; i < targetButtons.size(); ++i) {
-                        if (targetButtons[i].getGlobalBounds().contains(mouse)) {
-                            Player* target = game.getPlayer(targetTexts[i].getString());
-                            try {
-                                if (choosingTarget) current->coup(*target);
-                                else if (choosingSanction) current->sanction(*target);
-                                else if (choosingSpy) current->spyOn(*target);
-                                resultText.setString("Action successful.");
-                                resultText.setFillColor(sf::Color::Green);
-                            } catch (const std::exception& e) {
-                                resultText.setString(e.what());
-                                resultText.setFillColor(sf::Color::Red);
-                            }
-                            choosingTarget = choosingSanction = choosingSpy = false;
-                            break;
+                    if (Player* target = targetAt(mouse)) {
+                        try {
+                            if (choosingTarget) act(current, ActionType::Coup, target);
+                            else if (choosingSanction) act(current, ActionType::Sanction, target);
+                            else if (choosingSpy) act(current, ActionType::SpyOn, target);
+                            resultText.setString("Action successful.");
+                            resultText.setFillColor(sf::Color::Green);
+                        } catch (const std::exception& e) {
+                            resultText.setString(e.what());
+                            resultText.setFillColor(sf::Color::Red);
                         }
+                        choosingTarget = choosingSanction = choosingSpy = false;
                     }
                 } else if (gatherBtn.getGlobalBounds().contains(mouse)) {
-                    try { current->gather(); resultText.setString(current->getName() + " gathered 1 coin."); }
+                    try { act(current, ActionType::Gather, nullptr); resultText.setString(current->getName() + " gathered 1 coin."); }
                     catch (const std::exception& e) { resultText.setString(e.what()); resultText.setFillColor(sf::Color::Red); }
                 } else if (taxBtn.getGlobalBounds().contains(mouse)) {
-                    try { current->tax(); resultText.setString(current->getName() + " taxed."); }
+                    try { act(current, ActionType::Tax, nullptr); resultText.setString(current->getName() + " taxed."); }
                     catch (const std::exception& e) { resultText.setString(e.what()); resultText.setFillColor(sf::Color::Red); }
                 } else if (bribeBtn.getGlobalBounds().contains(mouse)) {
-                    try { current->bribe(); resultText.setString(current->getName() + " bribed."); }
+                    try { act(current, ActionType::Bribe, nullptr); resultText.setString(current->getName() + " bribed."); }
                     catch (const std::exception& e) { resultText.setString(e.what()); resultText.setFillColor(sf::Color::Red); }
                 } else if (coupBtn.getGlobalBounds().contains(mouse) && current->getCoins() >= 7) {
                     choosingTarget = true;
-                    targetButtons.clear(); targetTexts.clear();
-                    int y = 470;
-                    for (Player* p : players) {
-                        if (p->isAlive() && p != current) {
-                            sf::RectangleShape btn({200, 40}); btn.setPosition(300, y); btn.setFillColor(sf::Color(60, 60, 60));
-                            sf::Text txt(p->getName(), font, 20); txt.setPosition(310, y + 5); txt.setFillColor(sf::Color::White);
-                            targetButtons.push_back(btn); targetTexts.push_back(txt); y += 50;
-                        }
-                    }
+                    openTargets(current, 300, sf::Color(60, 60, 60));
                     resultText.setString("Choose player to coup");
                 } else if (sanctionBtn.getGlobalBounds().contains(mouse) && current->getCoins() >= 3) {
                     choosingSanction = true;
-                    targetButtons.clear(); targetTexts.clear();
-                    int y = 470;
-                    for (Player* p : players) {
-                        if (p->isAlive() && p != current) {
-                            sf::RectangleShape btn({200, 40}); btn.setPosition(550, y); btn.setFillColor(sf::Color(120, 0, 120));
-                            sf::Text txt(p->getName(), font, 20); txt.setPosition(560, y + 5); txt.setFillColor(sf::Color::White);
-                            targetButtons.push_back(btn); targetTexts.push_back(txt); y += 50;
-                        }
-                    }
+                    openTargets(current, 550, sf::Color(120, 0, 120));
                     resultText.setString("Choose player to sanction");
                 } else if (spyBtn.getGlobalBounds().contains(mouse) && current->getRole() == Role::Spy) {
                     choosingSpy = true;
-                    targetButtons.clear(); targetTexts.clear();
-                    int y = 470;
-                    for (Player* p : players) {
-                        if (p->isAlive() && p != current) {
-                            sf::RectangleShape btn({200, 40}); btn.setPosition(800, y); btn.setFillColor(sf::Color(80, 80, 80));
-                            sf::Text txt(p->getName(), font, 20); txt.setPosition(810, y + 5); txt.setFillColor(sf::Color::White);
-                            targetButtons.push_back(btn); targetTexts.push_back(txt); y += 50;
-                        }
-                    }
+                    openTargets(current, 800, sf::Color(80, 80, 80));
                     resultText.setString("Choose player to spy on");
                 }
             }
         }
+        traceSince("events", eventsStart);
 
+        const uint64_t drawStart = traceStart();
         window.clear();
         Player* current = nullptr;
         if (!gameOver) {
-            try { winnerName = game.winner(); gameOver = true; }
+            try {
+                winnerName = game.winner();
+                gameOver = true;
+                std::ofstream out(replayPath);
+                recording.save(out);
+                out.close();
+                if (out) std::cout << "Game recorded to " << replayPath << std::endl;
+                else std::cerr << " Failed to write replay '" << replayPath << "'!" << std::endl;
+            }
             catch (...) { current = game.currentPlayer(); mustCoup = current->getCoins() >= 10; }
         }
 
         if (gameOver) {
-            window.draw(backgroundSprite);
-            window.draw(brightOverlay); // Draw overlay to brighten background
+            draw(backgroundSprite);
+            draw(brightOverlay); // Draw overlay to brighten background
             sf::Text winText("Winner: " + winnerName, font, 54); // Larger font size
             winText.setFillColor(winnerColor); // Professional green for winner
             winText.setOutlineColor(highlightColor);
@@ -275,63 +545,124 @@ int main() {
             float x = (window.getSize().x - textRect.width) / 2.f;
             float y = 80; // Higher up
             winText.setPosition(x, y);
-            window.draw(winText);
+            draw(winText);
             // Draw restart button
-            window.draw(restartBtn);
-            window.draw(restartText);
+            draw(restartBtn);
+            draw(restartText);
         } else {
-            window.draw(backgroundSprite);
-            window.draw(brightOverlay);
-            window.draw(turnText);
-            window.draw(roleText);
-            window.draw(resultText);
+            draw(backgroundSprite);
+            draw(brightOverlay);
+            draw(turnText);
+            draw(roleText);
+            draw(resultText);
 
             if (!mustCoup && !choosingTarget && !choosingSanction && !choosingSpy) {
-                window.draw(gatherBtn); window.draw(gatherText);
-                window.draw(taxBtn); window.draw(taxText);
-                window.draw(bribeBtn); window.draw(bribeText);
-                window.draw(coupBtn); window.draw(coupText);
-                window.draw(sanctionBtn); window.draw(sanctionText);
-                if (current->getRole() == Role::Baron) { window.draw(investBtn); window.draw(investText); }
-                if (current->getRole() == Role::Spy) { window.draw(spyBtn); window.draw(spyText); }
+                draw(gatherBtn); draw(gatherText);
+                draw(taxBtn); draw(taxText);
+                draw(bribeBtn); draw(bribeText);
+                draw(coupBtn); draw(coupText);
+                draw(sanctionBtn); draw(sanctionText);
+                if (current->getRole() == Role::Baron) { draw(investBtn); draw(investText); }
+                if (current->getRole() == Role::Spy) { draw(spyBtn); draw(spyText); }
             }
 
-            for (size_t i = 0; i < targetButtons.size(); ++i) {
-                window.draw(targetButtons[i]);
-                window.draw(targetTexts[i]);
+            if (choosingTarget || choosingSanction || choosingSpy) {
+                // Clipped like the player list; only the visible rows are laid out
+                sf::View targetView(sf::FloatRect(0, 0, targetWidth, targetHeight));
+                targetView.setViewport(sf::FloatRect(targetX / window.getSize().x, targetY / window.getSize().y,
+                                                     targetWidth / window.getSize().x, targetHeight / window.getSize().y));
+                window.setView(targetView);
+                size_t first = targetList.firstVisible();
+                for (size_t i = 0; i < targetList.visibleCount(); ++i) {
+                    float ty = targetList.rowOffset(first + i);
+                    targetButtons[i].setPosition(0, ty);
+                    targetTexts[i].setString(targetList.rowAt(first + i)->getName());
+                    targetTexts[i].setPosition(10, ty + 5);
+                    draw(targetButtons[i]);
+                    draw(targetTexts[i]);
+                }
+                window.setView(window.getDefaultView());
             }
 
             // Player list background
-            sf::RectangleShape playerListRect(sf::Vector2f(230, 300));
-            playerListRect.setPosition(840, 20);
+            sf::RectangleShape playerListRect(sf::Vector2f(listWidth, listHeight()));
+            playerListRect.setPosition(listX, listY);
             playerListRect.setFillColor(playerListBg);
-            window.draw(playerListRect);
+            draw(playerListRect);
 
-            sf::Text playerListTitle("Players:", font, 20);
-            playerListTitle.setPosition(850, 30);
+            std::string title = "Players (" + std::to_string(playerList.rowCount()) + ")";
+            if (playerList.getRoleFilter() != Role::Unknown) title += " " + roleToString(playerList.getRoleFilter());
+            sf::Text playerListTitle(title, font, 20);
+            playerListTitle.setPosition(listX + 10, listY + 10);
             playerListTitle.setFillColor(highlightColor);
-            window.draw(playerListTitle);
+            draw(playerListTitle);
+
+            // Re-sort only after actions, and keep the current player in view when the turn moves
+            playerList.rebuild(players);
+            if (current != listFollows) { playerList.scrollTo(current); listFollows = current; }
 
-            int py = 60;
-            for (Player* p : players) {
-                if (!p->isAlive()) continue;
-                sf::Text pText(p->getName() + " - " + std::to_string(p->getCoins()) + " coins", font, 18);
-                pText.setPosition(850, py); pText.setFillColor(textColor);
+            // Clip rows to the panel with a view, so partially scrolled rows are cut at the border
+            sf::View listView(sf::FloatRect(0, 0, listWidth, listHeight() - listHeaderHeight));
+            listView.setViewport(sf::FloatRect(listX / window.getSize().x, (listY + listHeaderHeight) / window.getSize().y,
+                                               listWidth / window.getSize().x, (listHeight() - listHeaderHeight) / window.getSize().y));
+            window.setView(listView);
+            size_t first = playerList.firstVisible();
+            for (size_t i = 0; i < playerList.visibleCount(); ++i) {
+                Player* p = playerList.rowAt(first + i);
+                float py = playerList.rowOffset(first + i);
+                sf::Text& pText = listRowTexts[i];
+                std::string label = p->getName();
+                if (spectator) label += " [" + roleToString(p->getRole()) + "]";
+                pText.setString(label + " - " + std::to_string(p->getCoins()) + " coins");
+                pText.setPosition(10, py + 2); pText.setFillColor(textColor);
                 // Highlight current player's name with yellow background
                 if (!gameOver && p == current) {
-                    sf::RectangleShape nameBg(sf::Vector2f(220, 28));
-                    nameBg.setPosition(845, py - 2);
+                    sf::RectangleShape nameBg(sf::Vector2f(listWidth - 10, 28));
+                    nameBg.setPosition(5, py);
                     nameBg.setFillColor(sf::Color(255, 255, 120, 220)); // Soft yellow
                     nameBg.setOutlineColor(sf::Color(200, 180, 0));
                     nameBg.setOutlineThickness(2);
-                    window.draw(nameBg);
+                    draw(nameBg);
                     pText.setFillColor(sf::Color(60, 60, 0)); // Darker text for contrast
                 }
-                window.draw(pText); py += 30;
+                draw(pText);
             }
+            window.setView(window.getDefaultView());
         }
 
+        if (showPerf) {
+            // Refresh the text a few times per second; the graph is one vertex array (one draw call)
+            if (framesSincePerfText++ % 15 == 0) {
+                perfText.setString(formatStat("frame", frameSamples, 1e-3, "ms") +
+                                   formatStat("draws", drawSamples, 1.0, "") +
+                                   formatStat("action", actionSamples, 1.0, "us") +
+                                   formatStat("click", feedbackSamples, 1e-3, "ms"));
+            }
+            double peak = std::max(frameSamples.max(), 1.0);
+            for (size_t i = 0; i < frameSamples.capacity(); ++i) {
+                double v = i < frameSamples.size() ? frameSamples.sampleAt(i) : 0.0;
+                float x = perfX + 8 + static_cast<float>(i) * (perfWidth - 16) / frameSamples.capacity();
+                float base = perfY + perfHeight - 6;
+                perfGraph[2 * i].position = sf::Vector2f(x, base);
+                perfGraph[2 * i + 1].position = sf::Vector2f(x, base - static_cast<float>(v / peak) * perfGraphHeight);
+                perfGraph[2 * i].color = perfGraph[2 * i + 1].color = v > 20000 ? sf::Color::Red : sf::Color::Green;
+            }
+            draw(perfBg);
+            draw(perfText);
+            draw(perfGraph);
+        }
+
+        traceSince("draw", drawStart);
+        const uint64_t displayStart = traceStart();
         window.display();
+        traceSince("display", displayStart);
+        frameSamples.record(frameClock.restart().asMicroseconds());
+        drawSamples.record(static_cast<double>(drawCalls));
+        drawCalls = 0;
+        if (clickPending) {
+            feedbackSamples.record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - clickTime).count());
+            clickPending = false;
+        }
     }
 
     return 0;
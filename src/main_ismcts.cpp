@@ -0,0 +1,90 @@
+// orel2744@gmail.com
+// main_ismcts.cpp - ismcts tool: seats an ISMCTS player (seat 0, hidden roles determinised from what it has
+// observed) against the simple policy, and reports its win rate and determinisations per second.
+// Usage: ismcts.exe [--games N] [--seats S] [--dets D] [--threads T] [--seed X]
+#include "Game.hpp"
+#include "Ismcts.hpp"
+#include "Player.hpp"
+#include "Simulation.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace {
+/**
+ * @brief Tries an action on the game and lets the observer's constraints learn from it.
+ */
+bool attempt(Game& game, const Action& a, RoleConstraints& knowledge) {
+    LaneState before = LaneState::fromGame(game);
+    bool ok = true;
+    try { applyAction(game, a); } catch (const std::exception&) { ok = false; }
+    knowledge.observe(before, a, ok, LaneState::fromGame(game));
+    return ok;
+}
+}
+
+int main(int argc, char** argv) {
+    int games = 20, seats = 3;
+    uint64_t seed = 1;
+    IsmctsConfig config;
+    config.determinisations = 1000;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) games = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seats") == 0 && hasValue) seats = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--dets") == 0 && hasValue) config.determinisations = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--games N] [--seats S] [--dets D] [--threads T] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+    if (games < 1 || seats < 2 || seats > LaneState::MAX_SEATS) {
+        std::cerr << "ismcts: need at least 1 game and 2 to 6 seats" << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 rng(seed);
+    int wins = 0, decided = 0;
+    uint64_t determinisations = 0;
+    double searchSeconds = 0.0;
+    for (int gameNo = 0; gameNo < games; ++gameNo) {
+        Game game;
+        game.setLogging(false);
+        std::vector<std::unique_ptr<Player>> players;
+        for (int p = 0; p < seats; ++p) {
+            Role role = static_cast<Role>(std::uniform_int_distribution<int>(0, 5)(rng));
+            players.emplace_back(Game::createPlayerWithRole("P" + std::to_string(p), &game, role));
+        }
+        RoleConstraints knowledge(LaneState::fromGame(game), 0);
+        for (int actions = 0; actions < 1000; ++actions) {
+            LaneState state = LaneState::fromGame(game);
+            if (state.winner() >= 0) break;
+            Action a;
+            if (state.currentSeat() == 0) {
+                config.seed = rng();
+                IsmctsResult r = ismctsSearch(state, knowledge, config);
+                determinisations += r.determinisations;
+                searchSeconds += r.seconds;
+                a = r.best;
+            } else {
+                a = chooseSimpleAction(game, rng);
+            }
+            if (!attempt(game, a, knowledge) && !attempt(game, {ActionType::Gather, a.actor, -1}, knowledge))
+                attempt(game, {ActionType::SkipTurn, a.actor, -1}, knowledge);
+        }
+        int winner = LaneState::fromGame(game).winner();
+        decided += winner >= 0;
+        wins += winner == 0;
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << "ISMCTS (seat 0) won " << wins << " of " << games << " games ("
+              << decided << " decided; " << 100.0 / seats << "% expected by chance)\n"
+              << determinisations << " determinisations in " << std::setprecision(2) << searchSeconds << " s: "
+              << std::setprecision(0) << (searchSeconds > 0 ? determinisations / searchSeconds : 0.0)
+              << " determinisations/s\n";
+    return 0;
+}
@@ -0,0 +1,133 @@
+// orel2744@gmail.com
+// main_perf.cpp - hardware counters per million actions for the two rule engines: records random games on
+// LaneState, then replays exactly the same actions through Game/Player (virtual calls, hash-map logs) and
+// through LaneState (flat arrays), each inside a PerfCounters region; seating the games is measured apart.
+// Without counters it reports wall time.
+// Usage: perf.exe [--games N] [--seats S] [--seed X]
+#include "Game.hpp"
+#include "LaneState.hpp"
+#include "PerfCounters.hpp"
+#include "Player.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+struct RecordedGame {
+    std::vector<Role> roles;
+    std::vector<Action> actions;
+};
+
+// Random legal actions until someone wins (or the cap), so every replayed action is accepted
+std::vector<RecordedGame> recordGames(size_t games, int seats, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<RecordedGame> recorded(games);
+    Action legal[LaneState::MAX_ACTIONS];
+    for (RecordedGame& game : recorded) {
+        for (int s = 0; s < seats; ++s) game.roles.push_back(static_cast<Role>(rng() % 6));
+        LaneState state = LaneState::deal(game.roles);
+        for (int n = 0; n < 400 && state.winner() < 0; ++n) {
+            int count = state.legalActions(legal);
+            if (count == 0) break;
+            game.actions.push_back(legal[rng() % count]);
+            state.apply(game.actions.back());
+        }
+    }
+    return recorded;
+}
+}
+
+int main(int argc, char** argv) {
+    size_t games = 20000;
+    int seats = 4;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seats") == 0 && hasValue) seats = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--games N] [--seats S] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+    if (seats < 2 || seats > LaneState::MAX_SEATS) {
+        std::cerr << "perf: seats must be 2 to " << LaneState::MAX_SEATS << std::endl;
+        return 1;
+    }
+
+    try {
+        const std::vector<RecordedGame> recorded = recordGames(games, seats, seed);
+        uint64_t actions = 0;
+        for (const RecordedGame& game : recorded) actions += game.actions.size();
+        PerfCounters counters;
+        std::cout << games << " games, " << actions << " actions, " << seats << " seats\n";
+        if (!counters.unavailableReason().empty())
+            std::cout << "some counters are unavailable (" << counters.unavailableReason() << ")\n";
+
+        // Seating is measured on its own, so the action regions count only the rules: every Game and every
+        // LaneState is set up before its engine's actions run, and torn down after
+        struct Table {
+            std::unique_ptr<Game> game;
+            std::vector<std::unique_ptr<Player>> players;
+        };
+        std::vector<Table> tables(recorded.size());
+        auto setupLine = [&](const PerfSample& setup) {
+            char line[96];
+            std::snprintf(line, sizeof(line), "  %-24s%12.1f ns/game\n", "setup (not counted above)",
+                          games ? setup.seconds * 1e9 / static_cast<double>(games) : 0.0);
+            return std::string(line);
+        };
+        PerfSample objectSetup = counters.measure([&] {
+            for (size_t i = 0; i < recorded.size(); ++i) {
+                Table& t = tables[i];
+                t.game.reset(new Game);
+                t.game->setLogging(false);
+                for (size_t s = 0; s < recorded[i].roles.size(); ++s)
+                    t.players.emplace_back(Game::createPlayerWithRole("Seat " + std::to_string(s + 1), t.game.get(), recorded[i].roles[s]));
+            }
+        });
+        size_t rejected = 0;
+        PerfSample objects = counters.measure([&] {
+            for (size_t i = 0; i < recorded.size(); ++i) {
+                for (const Action& a : recorded[i].actions) {
+                    try {
+                        applyAction(*tables[i].game, a);
+                    } catch (const std::exception&) {
+                        ++rejected;
+                    }
+                }
+            }
+        });
+        tables.clear();
+        std::cout << "\nGame/Player (objects, virtual calls, hash-map logs):\n" << formatPerfSample(objects, actions)
+                  << setupLine(objectSetup);
+
+        std::vector<LaneState> states;
+        states.reserve(recorded.size());
+        PerfSample flatSetup = counters.measure([&] {
+            for (const RecordedGame& game : recorded) states.push_back(LaneState::deal(game.roles));
+        });
+        uint64_t checksum = 0;
+        PerfSample flat = counters.measure([&] {
+            for (size_t i = 0; i < recorded.size(); ++i) {
+                for (const Action& a : recorded[i].actions) rejected += states[i].apply(a) ? 0 : 1;
+                checksum += static_cast<uint64_t>(states[i].bank);
+            }
+        });
+        std::cout << "\nLaneState (flat arrays, no virtual calls):\n" << formatPerfSample(flat, actions)
+                  << setupLine(flatSetup);
+        if (flat.seconds > 0) std::cout << "\nLaneState is " << objects.seconds / flat.seconds << "x faster per action";
+        if (objects.ipc() > 0 && flat.ipc() > 0) std::cout << ", IPC " << objects.ipc() << " -> " << flat.ipc();
+        std::cout << " (checksum " << checksum << ")" << std::endl;
+        if (rejected) std::cout << rejected << " replayed actions were rejected (the engines disagree)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "perf: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+// orel2744@gmail.com
+// main_simstats.cpp - long-running statistics tool: plays heuristic-bot games on every core, each worker
+// folding its games into its own GameStats and publishing it every few thousand games; the main thread
+// drains the published accumulators once a second and prints the running totals in constant memory.
+// Usage: simstats.exe [--games N] [--seats S] [--batch B] [--threads T] [--seed X]
+#include "HeuristicBot.hpp"
+#include "StreamingStats.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+void printTotals(const GameStats& totals, double seconds) {
+    const QuantileSketch& length = totals.gameLengthQuantiles();
+    const QuantileSketch& coins = totals.coinsAtEliminationQuantiles();
+    std::cout << std::fixed << std::setprecision(0) << totals.games() << " games, "
+              << totals.games() / std::max(seconds, 1e-9) << " games/s; length mean " << std::setprecision(1)
+              << totals.gameLength().mean() << " sd " << totals.gameLength().stddev() << " p50/p90/p99 "
+              << std::setprecision(0) << length.quantile(0.5) << "/" << length.quantile(0.9) << "/"
+              << length.quantile(0.99) << "; coins at elimination p50/p90 " << coins.quantile(0.5) << "/"
+              << coins.quantile(0.9) << std::endl;
+}
+}
+
+int main(int argc, char** argv) {
+    uint64_t games = 1000000;
+    int seats = 4;
+    uint64_t batch = 4096;
+    unsigned threads = 0;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seats") == 0 && hasValue) seats = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--batch") == 0 && hasValue) batch = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--games N] [--seats S] [--batch B] [--threads T] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+    if (seats < 2 || seats > LaneState::MAX_SEATS) {
+        std::cerr << "simstats: seats must be 2 to " << LaneState::MAX_SEATS << std::endl;
+        return 1;
+    }
+
+    try {
+        StatsHub hub;
+        GameStats totals;
+        std::atomic<uint64_t> claimed{0};
+        std::atomic<unsigned> finished{0};
+        const BotWeights bot = BotWeights::defaults();
+        ThreadPool pool(threads);
+        auto begin = std::chrono::steady_clock::now();
+        for (unsigned w = 0; w < pool.size(); ++w) {
+            pool.submit([&, w]() {
+                std::mt19937_64 rng(seed * 0x9E3779B97F4A7C15ULL + w);
+                std::uniform_int_distribution<int> anyRole(0, GameStats::ROLES - 1);
+                std::unique_ptr<GameStats> local(new GameStats);
+                // Workers claim whole batches, so the published accumulators stay few and full
+                for (uint64_t first; (first = claimed.fetch_add(batch)) < games;) {
+                    const uint64_t last = std::min(games, first + batch);
+                    for (uint64_t g = first; g < last; ++g) {
+                        LaneState state = LaneState::deal(std::vector<Role>(seats, Role::Governor));
+                        for (int p = 0; p < seats; ++p) state.role[p] = static_cast<uint8_t>(anyRole(rng));
+                        size_t attempted = 0;
+                        for (; attempted < 1000 && state.winner() < 0 && state.currentSeat() >= 0; ++attempted) {
+                            const int me = state.currentSeat();
+                            const LaneState before = state;
+                            Action a = chooseHeuristicAction(state, bot, rng);
+                            if (!state.apply(a)) {
+                                a = {ActionType::Gather, me, -1};
+                                if (!state.apply(a)) {
+                                    a = {ActionType::SkipTurn, me, -1};
+                                    state.apply(a);
+                                }
+                            }
+                            local->observe(before, a, true, state);
+                        }
+                        local->endGame(state, attempted);
+                    }
+                    hub.publish(std::move(local));
+                    local.reset(new GameStats);
+                }
+                ++finished;
+            });
+        }
+
+        const unsigned workers = static_cast<unsigned>(pool.size());
+        auto lastPrint = begin;
+        while (finished.load() < workers) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastPrint < std::chrono::seconds(1)) continue;
+            lastPrint = now;
+            hub.drain(totals);
+            printTotals(totals, std::chrono::duration<double>(now - begin).count());
+        }
+        pool.wait();
+        hub.drain(totals);
+        printTotals(totals, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+
+        std::cout << std::setw(10) << "role" << std::setw(8) << "seats" << std::setw(8) << "win%";
+        for (int t = 0; t < ACTION_TYPE_COUNT; ++t) {
+            if (static_cast<ActionType>(t) == ActionType::GeneralBlockCoup) continue;
+            std::cout << std::setw(8) << actionTypeToString(static_cast<ActionType>(t)).substr(0, 7);
+        }
+        std::cout << "\n";
+        for (int r = 0; r < GameStats::ROLES; ++r) {
+            const Role role = static_cast<Role>(r);
+            uint64_t acted = 0;
+            for (int t = 0; t < ACTION_TYPE_COUNT; ++t) acted += totals.actionCount(role, static_cast<ActionType>(t));
+            std::cout << std::setw(10) << roleToString(role) << std::setw(8) << totals.seatsDealt(role) << std::setprecision(1)
+                      << std::setw(8) << 100.0 * totals.winRate(role);
+            for (int t = 0; t < ACTION_TYPE_COUNT; ++t) {
+                if (static_cast<ActionType>(t) == ActionType::GeneralBlockCoup) continue;
+                std::cout << std::setw(8) << 100.0 * totals.actionCount(role, static_cast<ActionType>(t)) / std::max<uint64_t>(1, acted);
+            }
+            std::cout << "\n";
+        }
+        // The sketch cannot list its keys, but every (role, action) triple can be asked for
+        std::vector<std::pair<uint64_t, int>> common;
+        const int codes = GameStats::ROLES * ACTION_TYPE_COUNT;
+        for (int c = 0; c < codes * codes * codes; ++c) {
+            const int code[3] = {c / (codes * codes), c / codes % codes, c % codes};
+            std::array<Role, 3> roles;
+            std::array<ActionType, 3> types;
+            for (int i = 0; i < 3; ++i) {
+                roles[i] = static_cast<Role>(code[i] / ACTION_TYPE_COUNT);
+                types[i] = static_cast<ActionType>(code[i] % ACTION_TYPE_COUNT);
+            }
+            common.emplace_back(totals.sequenceCount(roles, types), c);
+        }
+        const size_t shown = std::min<size_t>(5, common.size());
+        std::partial_sort(common.begin(), common.begin() + shown, common.end(), std::greater<std::pair<uint64_t, int>>());
+        std::cout << "most common three-action sequences:\n";
+        for (size_t k = 0; k < shown; ++k) {
+            std::cout << "  ~" << common[k].first << " ";
+            for (int i = 0, c = common[k].second; i < 3; ++i) {
+                const int code = i == 0 ? c / (codes * codes) : i == 1 ? c / codes % codes : c % codes;
+                std::cout << (i ? ", " : "") << roleToString(static_cast<Role>(code / ACTION_TYPE_COUNT)) << " "
+                          << actionTypeToString(static_cast<ActionType>(code % ACTION_TYPE_COUNT));
+            }
+            std::cout << "\n";
+        }
+        std::cout << std::flush;
+    } catch (const std::exception& e) {
+        std::cerr << "simstats: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// orel2744@gmail.com
+// main_solver.cpp - solver tool: solves 2-player games exactly for one role pairing or all 36,
+// and prints the outcome, states/sec and memory of each solve plus the role-vs-role win matrix.
+// Usage: solver.exe [--bank B] [--cap C] [--threads T] [--first ROLE --second ROLE]
+#include "Solver.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+Role parseRole(const std::string& name) {
+    for (int r = 0; r < 6; ++r) {
+        if (roleToString(static_cast<Role>(r)) == name) return static_cast<Role>(r);
+    }
+    throw std::invalid_argument("Unknown role: " + name);
+}
+
+void printSolve(const PairingResult& r) {
+    std::string outcome = !r.start.exact ? "over cap" : r.start.winner < 0 ? "draw" : (r.start.winner == 0 ? "first wins" : "second wins");
+    std::cout << std::left << std::setw(10) << roleToString(r.first) << std::setw(10) << roleToString(r.second)
+              << std::setw(13) << outcome << std::right << std::setw(7) << r.start.plies << std::setw(11) << r.states
+              << std::setw(8) << r.capped << std::setw(13) << std::setprecision(0)
+              << (r.seconds > 0 ? static_cast<double>(r.states) / r.seconds : 0.0) << std::setw(10)
+              << std::setprecision(1) << static_cast<double>(r.bytes) / (1024.0 * 1024.0) << "\n";
+}
+}
+
+int main(int argc, char** argv) {
+    SolverConfig config;
+    std::string first, second;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--bank") == 0 && hasValue) config.bank = static_cast<int16_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--cap") == 0 && hasValue) config.coinCap = static_cast<int16_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--first") == 0 && hasValue) first = argv[++i];
+        else if (std::strcmp(argv[i], "--second") == 0 && hasValue) second = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--bank B] [--cap C] [--threads T] [--first ROLE --second ROLE]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::cout << "bank " << config.bank << ", coin cap " << config.coinCap << "\n";
+        std::cout << std::left << std::setw(10) << "first" << std::setw(10) << "second" << std::setw(13) << "outcome"
+                  << std::right << std::setw(7) << "plies" << std::setw(11) << "states" << std::setw(8) << "capped"
+                  << std::setw(13) << "states/s" << std::setw(10) << "MiB" << "\n";
+        std::cout << std::fixed;
+        if (!first.empty() || !second.empty()) {
+            TwoPlayerSolver solver(parseRole(first), parseRole(second), config);
+            solver.solve();
+            PairingResult r;
+            r.first = parseRole(first);
+            r.second = parseRole(second);
+            r.start = solver.value(solver.start());
+            r.states = solver.stateCount();
+            r.capped = solver.cappedStates();
+            r.seconds = solver.seconds();
+            r.bytes = solver.memoryBytes();
+            printSolve(r);
+            return 0;
+        }
+
+        std::vector<PairingResult> results = solveRolePairings(config);
+        uint64_t states = 0;
+        double seconds = 0.0;
+        for (const PairingResult& r : results) {
+            printSolve(r);
+            states += r.states;
+            seconds += r.seconds;
+        }
+        std::cout << "\n" << states << " states in " << std::setprecision(2) << seconds << " s ("
+                  << std::setprecision(0) << (seconds > 0 ? static_cast<double>(states) / seconds : 0.0) << " states/s)\n";
+        std::cout << "\nP(row role beats column role), averaged over who acts first\n" << std::setw(10) << "";
+        for (int b = 0; b < 6; ++b) std::cout << std::setw(10) << roleToString(static_cast<Role>(b));
+        std::cout << "\n" << std::setprecision(2);
+        for (int a = 0; a < 6; ++a) {
+            std::cout << std::left << std::setw(10) << roleToString(static_cast<Role>(a)) << std::right;
+            for (int b = 0; b < 6; ++b)
+                std::cout << std::setw(10) << pairingWinProbability(results, static_cast<Role>(a), static_cast<Role>(b));
+            std::cout << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "solver: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// orel2744@gmail.com
+// main_tournament.cpp - tournament tool: plays a tournament between the baseline heuristic bot and random
+// variants, streams every game into the rating engine, and prints the leaderboard, games per second and
+// how evenly the entrants were spread over the seats.
+// Usage: tournament.exe [--format swiss|roundrobin|random] [--bots K] [--table S] [--rounds R]
+//                       [--games G] [--threads T] [--seed X]
+#include "Ratings.hpp"
+#include "Tournament.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    size_t botCount = 64;
+    TournamentConfig config;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--format") == 0 && hasValue) {
+            std::string format = argv[++i];
+            if (format == "swiss") config.format = TournamentFormat::Swiss;
+            else if (format == "roundrobin") config.format = TournamentFormat::RoundRobin;
+            else if (format == "random") config.format = TournamentFormat::Random;
+            else {
+                std::cerr << "tournament: unknown format " << format << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--bots") == 0 && hasValue) botCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--table") == 0 && hasValue) config.tableSize = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rounds") == 0 && hasValue) config.rounds = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--games") == 0 && hasValue) config.gamesPerTable = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--format swiss|roundrobin|random] [--bots K] [--table S] [--rounds R]"
+                      << " [--games G] [--threads T] [--seed X]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::mt19937_64 rng(config.seed);
+        std::vector<BotWeights> bots;
+        RatingEngine ratings;
+        for (size_t b = 0; b < botCount; ++b) {
+            bots.push_back(b == 0 ? BotWeights::defaults() : BotWeights::random(rng));
+            ratings.addPlayer(b == 0 ? "baseline" : "bot" + std::to_string(b));
+        }
+        auto begin = std::chrono::steady_clock::now();
+        TournamentScheduler schedule = playTournament(bots, config, [&](const TournamentGame& game) {
+            ratings.record(game.seats, game.result);
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        std::cout << std::fixed << ratings.gamesRecorded() << " games in " << schedule.rounds() << " rounds, "
+                  << std::setprecision(2) << seconds << " s (" << std::setprecision(0)
+                  << ratings.gamesRecorded() / std::max(seconds, 1e-9) << " games/s)\n";
+        uint32_t fewest = UINT32_MAX, most = 0;
+        for (size_t b = 0; b < botCount; ++b) {
+            for (int s = 0; s < config.tableSize; ++s) {
+                fewest = std::min(fewest, schedule.seatCount(static_cast<int>(b), s));
+                most = std::max(most, schedule.seatCount(static_cast<int>(b), s));
+            }
+        }
+        std::cout << "games per entrant and seat: " << fewest << " to " << most << "\n"
+                  << std::setw(6) << "rank" << std::setw(12) << "bot" << std::setw(9) << "mu" << std::setw(9) << "sigma"
+                  << std::setw(9) << "points" << "\n";
+        for (size_t r = 0; r < std::min<size_t>(10, botCount); ++r) {
+            int id = ratings.atRank(r);
+            std::cout << std::setw(6) << r + 1 << std::setw(12) << ratings.name(id) << std::setprecision(2) << std::setw(9)
+                      << ratings.rating(id).mu << std::setw(9) << ratings.rating(id).sigma << std::setprecision(1)
+                      << std::setw(9) << schedule.points(id) << "\n";
+        }
+        std::cout << "baseline ranks " << ratings.rankOf(0) + 1 << " of " << botCount << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "tournament: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,548 @@
+// orel2744@gmail.com
+// Server.cpp - epoll reactors of coup_server (Linux only).
+#include "Server.hpp"
+#include "Protocol.hpp"
+#include "Table.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+// epoll data ids below FIRST_CONNECTION_ID are reserved for the reactor's own descriptors
+const uint64_t TCP_LISTENER = 1, UNIX_LISTENER = 2, WAKEUP = 3;
+const int MAX_IOV = 64;
+
+// An encoded frame (or run of frames); push frames are shared by every connection they are queued on
+using Frame = std::shared_ptr<const std::vector<uint8_t>>;
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+Message errorReply(uint32_t tag, const std::string& text) {
+    Message m;
+    m.type = MsgType::Error;
+    m.tag = tag;
+    m.text = text;
+    return m;
+}
+}
+
+/**
+ * @brief One event loop: its connections, its shard of tables, and an inbox for work handed over by other reactors.
+ */
+struct Server::Reactor {
+    /**
+     * @brief Work passed between reactors: a request for a table this reactor owns,
+     *        a reply for a connection this reactor owns, a disconnect notice, or a push frame
+     *        for spectators connected to this reactor.
+     */
+    struct Envelope {
+        enum class Kind { Request, Reply, Release, Push } kind;
+        size_t origin;       ///< Reactor owning the connection
+        uint64_t connection;
+        Message msg;
+        Frame frame = nullptr;               ///< Push only
+        std::vector<uint64_t> targets = {};  ///< Push only: recipient connections
+    };
+
+    struct Connection {
+        int fd;
+        std::vector<uint8_t> in;
+        std::vector<uint8_t> staging;   ///< Replies encoded since the last seal
+        std::deque<Frame> out;          ///< Sealed output in send order
+        size_t outPos = 0;              ///< Bytes of out.front() already sent
+        size_t queued = 0;              ///< Unsent bytes in out
+        bool waitingWritable = false;
+        bool dropped = false;           ///< Fell too far behind; shut down and awaiting close
+    };
+
+    /**
+     * @brief A spectator of a table: a connection and the reactor that owns it.
+     */
+    struct Watcher {
+        size_t origin;
+        uint64_t connection;
+    };
+
+    Server& server;
+    size_t index;
+    int epfd = -1;
+    int wakeFd = -1;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::unordered_map<uint64_t, Connection> conns;
+    std::unordered_map<uint32_t, std::unique_ptr<Table>> tables;
+    std::unordered_map<uint32_t, std::vector<Watcher>> watchers;   ///< Spectators per owned table
+    std::vector<uint64_t> dirty;         ///< Connections with unflushed output
+    std::mutex inboxMutex;
+    std::vector<Envelope> inbox;
+    std::vector<Envelope> draining;      ///< Swapped with inbox so the lock is held only briefly
+    std::mt19937 rng;
+
+    Reactor(Server& server, size_t index) : server(server), index(index), rng(std::random_device{}() + index) {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd < 0) fail("epoll_create1");
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) fail("eventfd");
+        watch(wakeFd, WAKEUP, EPOLLIN);
+        if (server.tcpFd >= 0) watch(server.tcpFd, TCP_LISTENER, EPOLLIN | EPOLLEXCLUSIVE);
+        if (server.unixFd >= 0) watch(server.unixFd, UNIX_LISTENER, EPOLLIN | EPOLLEXCLUSIVE);
+    }
+
+    ~Reactor() {
+        for (auto& kv : conns) ::close(kv.second.fd);
+        server.connections -= conns.size();
+        server.tables -= tables.size();
+        if (wakeFd >= 0) ::close(wakeFd);
+        if (epfd >= 0) ::close(epfd);
+    }
+
+    void watch(int fd, uint64_t id, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = id;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0) fail("epoll_ctl");
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t r = ::write(wakeFd, &one, sizeof(one));
+        (void)r;
+    }
+
+    void post(Envelope&& env) {
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            inbox.push_back(std::move(env));
+        }
+        wake();
+    }
+
+    void run() {
+        epoll_event events[256];
+        while (running.load(std::memory_order_relaxed)) {
+            int n = epoll_wait(epfd, events, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                uint64_t id = events[i].data.u64;
+                if (id == TCP_LISTENER) acceptAll(server.tcpFd, true);
+                else if (id == UNIX_LISTENER) acceptAll(server.unixFd, false);
+                else if (id == WAKEUP) drainInbox();
+                else onConnectionEvent(id, events[i].events);
+            }
+            flushDirty();
+        }
+    }
+
+    void acceptAll(int listenFd, bool tcp) {
+        for (;;) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN: another reactor took it, or the backlog is empty
+            if (tcp) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+            uint64_t id = server.nextConnectionId++;
+            conns.emplace(id, Connection{fd, {}, {}, {}, 0, 0, false, false});
+            watch(fd, id, EPOLLIN | EPOLLRDHUP);
+            ++server.connections;
+        }
+    }
+
+    void drainInbox() {
+        uint64_t count;
+        while (::read(wakeFd, &count, sizeof(count)) > 0) {}
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            draining.swap(inbox);
+        }
+        for (Envelope& env : draining) {
+            if (env.kind == Envelope::Kind::Request) handleTableRequest(env.origin, env.connection, env.msg);
+            else if (env.kind == Envelope::Kind::Reply) sendTo(env.connection, env.msg);
+            else if (env.kind == Envelope::Kind::Push) { for (uint64_t id : env.targets) pushTo(id, env.frame); }
+            else releaseOwner(env.connection);
+        }
+        draining.clear();
+    }
+
+    void onConnectionEvent(uint64_t id, uint32_t events) {
+        auto it = conns.find(id);
+        if (it == conns.end()) return;
+        Connection& c = it->second;
+        if (events & EPOLLOUT) {
+            c.waitingWritable = false;
+            if (!flush(id, c)) return;
+        }
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            uint8_t buf[16 * 1024];
+            for (;;) {
+                ssize_t r = ::recv(c.fd, buf, sizeof(buf), 0);
+                if (r > 0) { c.in.insert(c.in.end(), buf, buf + r); continue; }
+                if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                if (r < 0 && errno == EINTR) continue;
+                closeConnection(id);
+                return;
+            }
+            size_t used = 0;
+            try {
+                Message msg;
+                while (size_t n = decodeMessage(c.in.data() + used, c.in.size() - used, msg)) {
+                    used += n;
+                    route(id, msg);
+                }
+            } catch (const ProtocolError& e) {
+                closeConnection(id);
+                return;
+            }
+            c.in.erase(c.in.begin(), c.in.begin() + used);
+        }
+    }
+
+    // Sends a request to the reactor owning its table (or handles it here)
+    void route(uint64_t conn, Message& msg) {
+        if (msg.type == MsgType::CreateTable) msg.table = server.nextTableId++;
+        else if (msg.type != MsgType::JoinTable && msg.type != MsgType::Act && msg.type != MsgType::GetState &&
+                 msg.type != MsgType::CloseTable && msg.type != MsgType::Watch) {
+            sendTo(conn, errorReply(msg.tag, "Not a request"));
+            return;
+        }
+        size_t owner = msg.table % server.reactors.size();
+        if (owner == index) handleTableRequest(index, conn, msg);
+        else server.reactors[owner]->post({Envelope::Kind::Request, index, conn, std::move(msg)});
+    }
+
+    // Runs on the table's owning reactor; the reply goes back to the connection's reactor
+    void handleTableRequest(size_t origin, uint64_t conn, const Message& req) {
+        Message reply;
+        reply.tag = req.tag;
+        reply.table = req.table;
+        Table* changed = nullptr;   // table whose state may have changed
+        Message keyframe;           // sent after the reply to a new spectator
+        try {
+            if (req.type == MsgType::CreateTable) {
+                std::uniform_int_distribution<int> roleDist(0, 5);
+                std::vector<Role> roles(req.count);
+                for (Role& r : roles) r = static_cast<Role>(roleDist(rng));
+                tables.emplace(req.table, std::unique_ptr<Table>(new Table(req.table, roles)));
+                ++server.tables;
+                reply.type = MsgType::TableCreated;
+            } else {
+                auto it = tables.find(req.table);
+                if (it == tables.end()) throw std::logic_error("No such table");
+                Table& t = *it->second;
+                switch (req.type) {
+                    case MsgType::JoinTable:
+                        reply.type = MsgType::Joined;
+                        reply.seat = req.seat;
+                        reply.role = t.join(req.seat, conn);
+                        changed = &t;
+                        break;
+                    case MsgType::Act:
+                        reply.type = MsgType::ActResult;
+                        try { t.act(req.action, conn); }
+                        catch (const std::exception& e) { reply.text = e.what(); }
+                        reply.state = t.state();
+                        changed = &t; // rejected actions can still have side effects
+                        break;
+                    case MsgType::GetState:
+                        reply.type = MsgType::State;
+                        reply.state = t.state();
+                        break;
+                    case MsgType::Watch: {
+                        std::vector<Watcher>& list = watchers[req.table];
+                        bool known = false;
+                        for (const Watcher& w : list) known = known || w.connection == conn;
+                        if (!known) list.push_back({origin, conn});
+                        reply.type = MsgType::Watching;
+                        keyframe.type = MsgType::Keyframe;
+                        keyframe.table = req.table;
+                        keyframe.sequence = t.getSequence();
+                        keyframe.state = t.getPublished();
+                        break;
+                    }
+                    default: { // CloseTable
+                        Message closed;
+                        closed.type = MsgType::Closed;
+                        closed.table = req.table;
+                        broadcast(req.table, closed);
+                        watchers.erase(req.table);
+                        tables.erase(it);
+                        --server.tables;
+                        reply.type = MsgType::Closed;
+                        break;
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            reply = errorReply(req.tag, e.what());
+        }
+        if (origin == index) sendTo(conn, reply);
+        else server.reactors[origin]->post({Envelope::Kind::Reply, origin, conn, std::move(reply)});
+        if (keyframe.type == MsgType::Keyframe) {
+            if (origin == index) sendTo(conn, keyframe);
+            else server.reactors[origin]->post({Envelope::Kind::Reply, origin, conn, std::move(keyframe)});
+        }
+        if (changed) publish(*changed);
+    }
+
+    // Publishes a table's latest change to its spectators: a Delta, or a Keyframe every keyframeInterval updates
+    void publish(Table& t) {
+        StateDelta delta = t.publish();
+        if (delta.empty()) return;
+        auto it = watchers.find(t.getId());
+        if (it == watchers.end() || it->second.empty()) return;
+        Message m;
+        m.table = t.getId();
+        m.sequence = t.getSequence();
+        if (server.config.keyframeInterval > 0 && m.sequence % server.config.keyframeInterval == 0) {
+            m.type = MsgType::Keyframe;
+            m.state = t.getPublished();
+        } else {
+            m.type = MsgType::Delta;
+            m.delta = std::move(delta);
+        }
+        broadcast(t.getId(), m);
+    }
+
+    // Encodes a message once and queues the same buffer on every spectator of a table
+    void broadcast(uint32_t table, const Message& msg) {
+        auto it = watchers.find(table);
+        if (it == watchers.end() || it->second.empty()) return;
+        std::vector<uint8_t> bytes;
+        encodeMessage(msg, bytes);
+        Frame frame = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+        ++server.framesEncoded;
+        std::vector<std::vector<uint64_t>> byReactor(server.reactors.size());
+        for (const Watcher& w : it->second) byReactor[w.origin].push_back(w.connection);
+        for (size_t r = 0; r < byReactor.size(); ++r) {
+            if (byReactor[r].empty()) continue;
+            if (r == index) { for (uint64_t id : byReactor[r]) pushTo(id, frame); }
+            else server.reactors[r]->post({Envelope::Kind::Push, r, 0, Message(), frame, std::move(byReactor[r])});
+        }
+    }
+
+    void releaseOwner(uint64_t conn) {
+        for (auto& kv : tables) {
+            if (kv.second->release(conn)) publish(*kv.second);
+        }
+        for (auto& kv : watchers) {
+            std::vector<Watcher>& list = kv.second;
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (list[i].connection != conn) continue;
+                list[i] = list.back();
+                list.pop_back();
+                break;
+            }
+        }
+    }
+
+    void sendTo(uint64_t id, const Message& msg) {
+        auto it = conns.find(id);
+        if (it == conns.end()) return; // client went away
+        Connection& c = it->second;
+        bool idle = c.out.empty() && c.staging.empty();
+        encodeMessage(msg, c.staging);
+        if (idle) dirty.push_back(id);
+    }
+
+    // Queues a shared push frame without copying it
+    void pushTo(uint64_t id, const Frame& frame) {
+        auto it = conns.find(id);
+        if (it == conns.end() || it->second.dropped) return;
+        Connection& c = it->second;
+        if (c.queued + c.staging.size() + frame->size() > server.config.maxQueuedBytes) {
+            // A spectator this far behind would only ever catch up from a keyframe; drop it instead
+            c.dropped = true;
+            ::shutdown(c.fd, SHUT_RDWR);
+            return;
+        }
+        bool idle = c.out.empty() && c.staging.empty();
+        seal(c);
+        c.out.push_back(frame);
+        c.queued += frame->size();
+        ++server.framesDelivered;
+        if (idle) dirty.push_back(id);
+    }
+
+    // Moves staged replies into the output queue so later push frames keep their order
+    void seal(Connection& c) {
+        if (c.staging.empty()) return;
+        c.queued += c.staging.size();
+        c.out.push_back(std::make_shared<const std::vector<uint8_t>>(std::move(c.staging)));
+        c.staging.clear();
+    }
+
+    // Drops `sent` bytes from the front of the output queue
+    void consume(Connection& c, size_t sent) {
+        c.queued -= sent;
+        while (sent > 0) {
+            size_t left = c.out.front()->size() - c.outPos;
+            if (sent < left) { c.outPos += sent; return; }
+            sent -= left;
+            c.out.pop_front();
+            c.outPos = 0;
+        }
+    }
+
+    void flushDirty() {
+        for (uint64_t id : dirty) {
+            auto it = conns.find(id);
+            if (it != conns.end() && !it->second.waitingWritable) flush(id, it->second);
+        }
+        dirty.clear();
+    }
+
+    // Writes as much buffered output as the socket takes; returns false if the connection was closed
+    bool flush(uint64_t id, Connection& c) {
+        seal(c);
+        while (!c.out.empty()) {
+            iovec iov[MAX_IOV];
+            int n = 0;
+            for (auto f = c.out.begin(); f != c.out.end() && n < MAX_IOV; ++f, ++n) {
+                size_t skip = n == 0 ? c.outPos : 0;
+                iov[n].iov_base = const_cast<uint8_t*>((*f)->data() + skip);
+                iov[n].iov_len = (*f)->size() - skip;
+            }
+            msghdr mh{};
+            mh.msg_iov = iov;
+            mh.msg_iovlen = static_cast<size_t>(n);
+            ssize_t w = ::sendmsg(c.fd, &mh, MSG_NOSIGNAL);
+            if (w > 0) { consume(c, static_cast<size_t>(w)); continue; }
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                c.waitingWritable = true;
+                epoll_event ev{};
+                ev.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT;
+                ev.data.u64 = id;
+                epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+                return true;
+            }
+            closeConnection(id);
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = id;
+        epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+        return true;
+    }
+
+    void closeConnection(uint64_t id) {
+        auto it = conns.find(id);
+        if (it == conns.end()) return;
+        ::close(it->second.fd);
+        conns.erase(it);
+        --server.connections;
+        for (auto& r : server.reactors) {
+            if (r.get() == this) releaseOwner(id);
+            else r->post({Envelope::Kind::Release, index, id, Message()});
+        }
+    }
+};
+
+/**
+ * @brief Opens the listening sockets.
+ * @param cfg Endpoints and thread count.
+ * @throws std::runtime_error if a socket cannot be created or bound.
+ */
+Server::Server(const ServerConfig& cfg) : config(cfg) {
+    if (config.threads < 1) throw std::invalid_argument("Server needs at least one thread");
+    if (config.tcpPort < 0 && config.unixPath.empty()) throw std::invalid_argument("Server needs a TCP port or a Unix socket path");
+    try {
+        if (config.tcpPort >= 0) {
+            tcpFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (tcpFd < 0) fail("socket");
+            int one = 1;
+            setsockopt(tcpFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(config.tcpPort));
+            if (inet_pton(AF_INET, config.tcpHost.c_str(), &addr.sin_addr) != 1)
+                throw std::runtime_error("Bad TCP host: " + config.tcpHost);
+            if (bind(tcpFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) fail("bind tcp");
+            if (listen(tcpFd, 1024) < 0) fail("listen tcp");
+            socklen_t len = sizeof(addr);
+            getsockname(tcpFd, reinterpret_cast<sockaddr*>(&addr), &len);
+            boundPort = ntohs(addr.sin_port);
+        }
+        if (!config.unixPath.empty()) {
+            sockaddr_un addr{};
+            if (config.unixPath.size() >= sizeof(addr.sun_path)) throw std::runtime_error("Unix socket path too long");
+            unixFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (unixFd < 0) fail("socket");
+            addr.sun_family = AF_UNIX;
+            std::strcpy(addr.sun_path, config.unixPath.c_str());
+            ::unlink(config.unixPath.c_str());
+            if (bind(unixFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) fail("bind unix");
+            if (listen(unixFd, 1024) < 0) fail("listen unix");
+        }
+        for (int i = 0; i < config.threads; ++i) reactors.emplace_back(new Reactor(*this, i));
+    } catch (...) {
+        reactors.clear();
+        if (tcpFd >= 0) ::close(tcpFd);
+        if (unixFd >= 0) { ::close(unixFd); ::unlink(config.unixPath.c_str()); }
+        throw;
+    }
+}
+
+/**
+ * @brief Stops the reactors and closes all sockets.
+ */
+Server::~Server() {
+    stop();
+    reactors.clear();
+    if (tcpFd >= 0) ::close(tcpFd);
+    if (unixFd >= 0) {
+        ::close(unixFd);
+        ::unlink(config.unixPath.c_str());
+    }
+}
+
+/**
+ * @brief Starts the reactor threads. Returns immediately.
+ */
+void Server::start() {
+    if (started) return;
+    started = true;
+    for (auto& r : reactors) {
+        r->running = true;
+        Reactor* reactor = r.get();
+        r->thread = std::thread([reactor] { reactor->run(); });
+    }
+}
+
+/**
+ * @brief Signals the reactors to stop and waits for them.
+ */
+void Server::stop() {
+    if (!started) return;
+    for (auto& r : reactors) {
+        r->running = false;
+        r->wake();
+    }
+    for (auto& r : reactors) {
+        if (r->thread.joinable()) r->thread.join();
+    }
+    started = false;
+}
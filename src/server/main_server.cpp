@@ -0,0 +1,48 @@
+// orel2744@gmail.com
+// main_server.cpp - coup_server entry point.
+// Usage: coup_server.exe [--tcp PORT] [--host ADDR] [--unix PATH] [--threads N] [--keyframe N]
+#include "Server.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+volatile std::sig_atomic_t stopRequested = 0;
+void onSignal(int) { stopRequested = 1; }
+}
+
+int main(int argc, char** argv) {
+    ServerConfig config;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--tcp") == 0 && hasValue) config.tcpPort = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--host") == 0 && hasValue) config.tcpHost = argv[++i];
+        else if (std::strcmp(argv[i], "--unix") == 0 && hasValue) config.unixPath = argv[++i];
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) config.threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--keyframe") == 0 && hasValue) config.keyframeInterval = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--tcp PORT] [--host ADDR] [--unix PATH] [--threads N] [--keyframe N]" << std::endl;
+            return 1;
+        }
+    }
+    if (config.tcpPort < 0 && config.unixPath.empty()) config.tcpPort = 7777;
+
+    try {
+        Server server(config);
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+        server.start();
+        std::cout << "coup_server listening";
+        if (server.tcpPort() >= 0) std::cout << " on " << config.tcpHost << ":" << server.tcpPort();
+        if (!config.unixPath.empty()) std::cout << " on " << config.unixPath;
+        std::cout << " with " << config.threads << " reactor thread(s)" << std::endl;
+        while (!stopRequested) pause();
+        server.stop();
+    } catch (const std::exception& e) {
+        std::cerr << "coup_server: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
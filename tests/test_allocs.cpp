@@ -0,0 +1,89 @@
+/**
+ * @file test_allocs.cpp
+ * @brief Tests for the counting operator new/delete of AllocTracker: built with -DCOUP_TRACK_ALLOCS, unlike
+ *        the other suites, so the replaced allocation functions are the ones under test.
+ *
+ * Run with: make test_allocs
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "AllocTracker.hpp"
+#include "TranspositionTable.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+struct alignas(64) CacheLine {
+    char bytes[64];
+};
+
+struct alignas(256) Page {
+    char bytes[256];
+};
+
+bool alignedTo(const void* p, size_t alignment) { return reinterpret_cast<uintptr_t>(p) % alignment == 0; }
+}
+
+/**
+ * @brief Tests that plain allocations are charged to the innermost scope and frees to the scope they happen in.
+ */
+TEST_CASE("Allocations are charged to the innermost scope") {
+    REQUIRE(AllocTracker::enabled());
+    const int outer = AllocTracker::tag("allocs outer");
+    const int inner = AllocTracker::tag("allocs inner");
+    AllocTracker::reset();
+    {
+        AllocScope a(outer);
+        std::vector<int> grown(1000, 1);
+        for (int i = 0; i < 3; ++i) {
+            AllocScope b(inner);
+            std::string s(100, 'x');
+        }
+    }
+    CHECK(AllocTracker::counts(outer).allocations == 1);
+    CHECK(AllocTracker::counts(outer).bytes == 1000 * sizeof(int));
+    CHECK(AllocTracker::counts(outer).frees == 1);
+    CHECK(AllocTracker::counts(inner).allocations == 3);
+    CHECK(AllocTracker::counts(inner).frees == 3);
+}
+
+/**
+ * @brief Tests that over-aligned types, which use the std::align_val_t overloads, are counted and aligned.
+ */
+TEST_CASE("Over-aligned allocations are counted") {
+    const int tag = AllocTracker::tag("allocs aligned");
+    AllocTracker::reset();
+    {
+        AllocScope scope(tag);
+        std::unique_ptr<CacheLine> line(new CacheLine);
+        std::unique_ptr<CacheLine[]> lines(new CacheLine[4]);
+        std::unique_ptr<Page> page(new (std::nothrow) Page);
+        REQUIRE(page);
+        CHECK(alignedTo(line.get(), 64));
+        CHECK(alignedTo(lines.get(), 64));
+        CHECK(alignedTo(page.get(), 256));
+    }
+    CHECK(AllocTracker::counts(tag).allocations == 3);
+    CHECK(AllocTracker::counts(tag).bytes >= 64 + 4 * 64 + 256);
+    CHECK(AllocTracker::counts(tag).frees == 3);
+}
+
+/**
+ * @brief Tests that the transposition table's cache-line buckets, one of the largest allocations, are counted.
+ */
+TEST_CASE("Transposition table buckets are counted") {
+    const int tag = AllocTracker::tag("allocs transposition table");
+    AllocTracker::reset();
+    {
+        AllocScope scope(tag);
+        TranspositionTable tt(1);
+    }
+    CHECK(AllocTracker::counts(tag).allocations >= 1);
+    CHECK(AllocTracker::counts(tag).bytes >= (1u << 20));
+    CHECK(AllocTracker::counts(tag).frees == AllocTracker::counts(tag).allocations);
+}
@@ -15,6 +15,42 @@
 #include "General.hpp"
 #include "Judge.hpp"
 #include "Merchant.hpp"
+#include "PlayerListView.hpp"
+#include "PerfStats.hpp"
+#include "Replay.hpp"
+#include "Simulation.hpp"
+#include "Dealing.hpp"
+#include "ObservationEncoder.hpp"
+#include "LaneState.hpp"
+#include "VecGame.hpp"
+#include "SimdKernels.hpp"
+#include "Solver.hpp"
+#include "Tablebase.hpp"
+#include "Zobrist.hpp"
+#include "TranspositionTable.hpp"
+#include "RoleConstraints.hpp"
+#include "Ismcts.hpp"
+#include "RoleBeliefs.hpp"
+#include "Cfr.hpp"
+#include "Evolution.hpp"
+#include "Ratings.hpp"
+#include "Tournament.hpp"
+#include "ThreadPool.hpp"
+#include "StreamingStats.hpp"
+#include "AllocTracker.hpp"
+#include "Trace.hpp"
+#include "PerfCounters.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 /**
  * @brief Tests player initialization: name, role, coins, and alive status.
@@ -432,3 +468,1583 @@ TEST_CASE("Cannot sanction self") {
     CHECK_THROWS(a.sanction(a));
 }
 
+
+/**
+ * @brief Tests that the virtualised player list only exposes the rows inside the viewport.
+ */
+TEST_CASE("Player list view virtualises large tables") {
+    Game g;
+    std::vector<std::unique_ptr<Player>> seats;
+    for (int i = 0; i < 200; ++i)
+        seats.emplace_back(Game::createPlayerWithRole("P" + std::to_string(i), &g, Role::Merchant));
+    std::vector<Player*> players;
+    for (auto& p : seats) players.push_back(p.get());
+
+    PlayerListView view(30, 300);
+    view.rebuild(players);
+    CHECK(view.rowCount() == 200);
+    CHECK(view.firstVisible() == 0);
+    CHECK(view.visibleCount() == view.maxVisibleRows());
+    CHECK(view.maxVisibleRows() == 11);
+
+    view.scrollBy(30 * 100);
+    CHECK(view.firstVisible() == 100);
+    CHECK(view.rowAt(100) == players[100]);
+
+    view.scrollBy(1e9f); // clamped to the last page
+    CHECK(view.firstVisible() + view.visibleCount() == 200);
+    view.scrollBy(-1e9f);
+    CHECK(view.getScroll() == 0.f);
+
+    view.scrollTo(players[150]);
+    CHECK(view.firstVisible() <= 150);
+    CHECK(view.firstVisible() + view.visibleCount() > 150);
+}
+
+/**
+ * @brief Tests sorting by coins and filtering by role in the player list view.
+ */
+TEST_CASE("Player list view sorts and filters") {
+    Game g;
+    Governor gov("Gov", &g);
+    Baron baron("Baron", &g);
+    Spy spy("Spy", &g);
+    gov.tax();     // 3 coins
+    baron.gather(); // 1 coin
+    spy.tax();     // 2 coins
+    std::vector<Player*> players = {&gov, &baron, &spy};
+
+    PlayerListView view(30, 300);
+    view.setSort(PlayerListView::SortKey::Coins, true);
+    view.rebuild(players);
+    REQUIRE(view.rowCount() == 3);
+    CHECK(view.rowAt(0) == &gov);
+    CHECK(view.rowAt(1) == &spy);
+    CHECK(view.rowAt(2) == &baron);
+
+    view.setRoleFilter(Role::Spy);
+    view.rebuild(players);
+    REQUIRE(view.rowCount() == 1);
+    CHECK(view.rowAt(0) == &spy);
+
+    // Dead players drop out only after the next rebuild
+    view.setRoleFilter(Role::Unknown);
+    view.rebuild(players);
+    g.eliminate(&baron);
+    CHECK(view.rowCount() == 3);
+    view.markDirty();
+    view.rebuild(players);
+    CHECK(view.rowCount() == 2);
+}
+
+/**
+ * @brief Tests the rolling sample window and percentiles used by the performance overlay.
+ */
+TEST_CASE("Rolling sample window percentiles") {
+    RollingSamples h(100);
+    CHECK(h.percentile(50) == 0.0);
+    for (int i = 1; i <= 100; ++i) h.record(i);
+    CHECK(h.size() == 100);
+    CHECK(h.percentile(50) == 50.0);
+    CHECK(h.percentile(99) == 99.0);
+    CHECK(h.max() == 100.0);
+
+    // Old samples fall out of the window
+    for (int i = 0; i < 50; ++i) h.record(1000);
+    CHECK(h.size() == 100);
+    CHECK(h.sampleAt(0) == 51.0);
+    CHECK(h.latest() == 1000.0);
+    CHECK(h.percentile(50) == 100.0);
+    CHECK(h.percentile(51) == 1000.0);
+    CHECK_THROWS(h.sampleAt(100));
+}
+
+// Sorts the map-derived parts of a snapshot so two snapshots can be compared field by field
+static GameSnapshot normalized(GameSnapshot s) {
+    for (auto* v : {&s.sanctions, &s.arrestBlocks, &s.coupBlocks, &s.bribeLog, &s.taxLog, &s.attemptedCoup, &s.arrestLog})
+        std::sort(v->begin(), v->end());
+    std::sort(s.recentCoupTargets.begin(), s.recentCoupTargets.end());
+    return s;
+}
+
+static bool sameState(const GameSnapshot& a, const GameSnapshot& b) {
+    GameSnapshot x = normalized(a), y = normalized(b);
+    if (x.seats.size() != y.seats.size()) return false;
+    for (size_t i = 0; i < x.seats.size(); ++i) {
+        if (x.seats[i].coins != y.seats[i].coins || x.seats[i].alive != y.seats[i].alive ||
+            x.seats[i].extraAction != y.seats[i].extraAction || x.seats[i].pendingAction != y.seats[i].pendingAction)
+            return false;
+    }
+    return x.currentTurnIndex == y.currentTurnIndex && x.bank == y.bank && x.sanctions == y.sanctions &&
+           x.arrestBlocks == y.arrestBlocks && x.coupBlocks == y.coupBlocks && x.bribeLog == y.bribeLog &&
+           x.taxLog == y.taxLog && x.recentCoupTargets == y.recentCoupTargets &&
+           x.attemptedCoup == y.attemptedCoup && x.arrestLog == y.arrestLog;
+}
+
+/**
+ * @brief Tests that restoring a snapshot puts players and game logs back exactly.
+ */
+TEST_CASE("Game snapshot and restore") {
+    Game g;
+    g.setLogging(false);
+    Governor gov("Gov", &g);
+    Spy spy("Spy", &g);
+    Merchant mer("Mer", &g);
+    CHECK(gov.getSeat() == 0);
+    CHECK(mer.getSeat() == 2);
+    CHECK(g.playerAt(1) == &spy);
+    CHECK_THROWS(g.playerAt(3));
+
+    gov.tax(); spy.gather(); mer.tax();
+    GameSnapshot before = g.snapshot();
+    gov.gather(); spy.spyOn(gov); spy.arrest(mer);
+    CHECK_FALSE(sameState(before, g.snapshot()));
+
+    g.restore(before);
+    CHECK(sameState(before, g.snapshot()));
+    CHECK(gov.getCoins() == 3);
+    CHECK(mer.getCoins() == 2);
+    CHECK(g.getBank() == 50 - 6);
+    CHECK(g.turn() == "Gov");
+}
+
+/**
+ * @brief Tests that applyAction dispatches to the player methods with their usual rule checks.
+ */
+TEST_CASE("Apply seat-indexed actions") {
+    Game g;
+    g.setLogging(false);
+    Baron baron("Baron", &g);
+    General general("General", &g);
+    applyAction(g, {ActionType::Gather, 0, -1});
+    CHECK(baron.getCoins() == 1);
+    CHECK_THROWS_AS(applyAction(g, {ActionType::Gather, 0, -1}), std::logic_error); // not Baron's turn
+    CHECK_THROWS_AS(applyAction(g, {ActionType::Arrest, 1, -1}), std::invalid_argument);
+    CHECK_THROWS_AS(applyAction(g, {ActionType::Arrest, 1, 5}), std::out_of_range);
+    CHECK(actionTypeFromString(actionTypeToString(ActionType::GeneralBlockCoup)) == ActionType::GeneralBlockCoup);
+    CHECK_THROWS(actionTypeFromString("fly"));
+}
+
+/**
+ * @brief Tests that a replay survives save/load and that seeking anywhere matches stepping from the start.
+ */
+TEST_CASE("Replay keyframe seeking matches sequential play") {
+    // Play a long pseudo-random game, recording every attempted action and the state after it
+    Game g;
+    g.setLogging(false);
+    Replay rec;
+    std::vector<std::unique_ptr<Player>> seats;
+    const Role roles[] = {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant};
+    for (int i = 0; i < 6; ++i) {
+        seats.emplace_back(Game::createPlayerWithRole("Player " + std::to_string(i), &g, roles[i]));
+        rec.addSeat(seats.back()->getName(), roles[i]);
+    }
+    std::vector<GameSnapshot> expected = {g.snapshot()};
+    unsigned state = 12345;
+    auto next = [&state](unsigned n) { state = state * 1103515245u + 12345u; return (state >> 16) % n; };
+    for (int i = 0; i < 1000; ++i) {
+        Action a;
+        a.actor = g.currentPlayer() ? g.currentPlayer()->getSeat() : 0;
+        if (next(8) == 0) a.actor = static_cast<int>(next(6)); // occasional out-of-turn/reactive action
+        a.type = static_cast<ActionType>(next(ACTION_TYPE_COUNT));
+        a.target = actionNeedsTarget(a.type) ? static_cast<int>(next(6)) : -1;
+        rec.record(a);
+        try { applyAction(g, a); } catch (const std::exception&) {}
+        expected.push_back(g.snapshot());
+        try { g.winner(); break; } catch (const std::exception&) {}
+    }
+
+    std::stringstream file;
+    rec.save(file);
+    Replay loaded = Replay::load(file);
+    REQUIRE(loaded.getSeats().size() == 6);
+    CHECK(loaded.getSeats()[3].name == "Player 3");
+    REQUIRE(loaded.getActions().size() == rec.getActions().size());
+
+    ReplayViewer viewer(loaded, 16);
+    REQUIRE(viewer.length() >= 100);
+    CHECK(viewer.position() == 0);
+    CHECK(viewer.keyframeCount() == viewer.length() / 16 + 1);
+    CHECK(sameState(viewer.getGame().snapshot(), expected[0]));
+    for (size_t target : {viewer.length(), size_t(17), size_t(3), size_t(900), size_t(16), size_t(15), size_t(0), size_t(500)}) {
+        viewer.seek(target);
+        size_t at = std::min(target, viewer.length());
+        CHECK(viewer.position() == at);
+        CHECK(sameState(viewer.getGame().snapshot(), expected[at]));
+    }
+    viewer.seek(0);
+    while (viewer.step()) {}
+    CHECK(sameState(viewer.getGame().snapshot(), expected.back()));
+
+    std::stringstream bad("COUP-REPLAY 1\nseats 1\nWizard Merlin\n");
+    CHECK_THROWS_AS(Replay::load(bad), std::runtime_error);
+}
+
+/**
+ * @brief Tests headless games: same roles and seed replay identically, and results are consistent.
+ */
+TEST_CASE("Simulated games are deterministic") {
+    std::vector<Role> roles = {Role::Baron, Role::General, Role::Judge, Role::Merchant};
+    GameResult a = playGame(roles, 42);
+    GameResult b = playGame(roles, 42);
+    CHECK(a.winner == b.winner);
+    CHECK(a.actions == b.actions);
+    CHECK(a.eliminationOrder == b.eliminationOrder);
+    REQUIRE(a.winner >= 0);
+    CHECK(a.winnerRole == roles[a.winner]);
+    CHECK(a.eliminationOrder.size() == roles.size() - 1);
+    CHECK(std::find(a.eliminationOrder.begin(), a.eliminationOrder.end(), a.winner) == a.eliminationOrder.end());
+    CHECK_THROWS_AS(playGame({Role::Spy}, 1), std::invalid_argument);
+}
+
+/**
+ * @brief Tests stratified dealing: every composition is covered, weights match the composition
+ *        probabilities, and rotation balances roles over seats.
+ */
+TEST_CASE("Stratified batch dealing") {
+    CHECK(BatchDealer::compositions(2).size() == 21);
+    CHECK(BatchDealer::compositions(4).size() == 126);
+    CHECK_THROWS_AS(BatchDealer(3, 10, DealMode::Stratified, 1), std::invalid_argument);
+    CHECK_THROWS_AS(BatchDealer(7, 100, DealMode::Independent, 1), std::invalid_argument);
+
+    BatchDealer dealer(3, 560, DealMode::Stratified, 7);
+    REQUIRE(dealer.getDeals().size() == 560);
+    double total = 0, totalProbability = 0;
+    std::vector<double> stratumWeight(dealer.strataCount(), 0);
+    std::vector<int> stratumGames(dealer.strataCount(), 0);
+    for (const Deal& d : dealer.getDeals()) {
+        REQUIRE(d.roles.size() == 3);
+        total += d.weight;
+        stratumWeight[d.stratum] += d.weight;
+        ++stratumGames[d.stratum];
+        std::vector<Role> sorted = d.roles;
+        std::sort(sorted.begin(), sorted.end());
+        CHECK(sorted == BatchDealer::compositions(3)[d.stratum]);
+    }
+    CHECK(total == doctest::Approx(1.0));
+    for (size_t h = 0; h < dealer.strataCount(); ++h) {
+        totalProbability += dealer.stratumProbability(h);
+        CHECK(stratumGames[h] >= 1);
+        CHECK(stratumWeight[h] == doctest::Approx(dealer.stratumProbability(h)));
+    }
+    CHECK(totalProbability == doctest::Approx(1.0));
+
+    // Weighted role-per-seat frequencies match independent dealing (1/6 each)
+    for (int seat = 0; seat < 3; ++seat) {
+        for (Role role : {Role::Governor, Role::Spy, Role::Baron, Role::General, Role::Judge, Role::Merchant}) {
+            double share = 0;
+            for (const Deal& d : dealer.getDeals()) share += d.roles[seat] == role ? d.weight : 0.0;
+            CHECK(share == doctest::Approx(1.0 / 6).epsilon(0.15));
+        }
+    }
+
+    std::vector<GameResult> results;
+    for (const Deal& d : dealer.getDeals()) {
+        GameResult r;
+        r.winner = 0;
+        r.winnerRole = d.roles[0];
+        results.push_back(r);
+    }
+    std::vector<RoleEstimate> est = estimateRoleWinRates(dealer, results);
+    REQUIRE(est.size() == 6);
+    double rateSum = 0;
+    for (const RoleEstimate& e : est) rateSum += e.winRate;
+    CHECK(rateSum == doctest::Approx(1.0));
+    results.pop_back();
+    CHECK_THROWS_AS(estimateRoleWinRates(dealer, results), std::invalid_argument);
+}
+
+/**
+ * @brief Tests per-seat observations: own role only, live public state, roles revealed on elimination.
+ */
+TEST_CASE("Game::viewFor hides other players' roles") {
+    Game g;
+    g.setLogging(false);
+    Governor gov("Gov", &g);
+    Spy spy("Spy", &g);
+    General gen("Gen", &g);
+
+    Observation mine = g.viewFor(1);
+    CHECK(mine.getSeat() == 1);
+    CHECK(mine.seatCount() == 3);
+    CHECK(mine.myRole() == Role::Spy);
+    CHECK(mine.role(1) == Role::Spy);
+    CHECK(mine.role(0) == Role::Unknown);
+    CHECK(mine.role(2) == Role::Unknown);
+    CHECK(mine.name(2) == "Gen");
+    CHECK(mine.turn() == 0);
+    CHECK_FALSE(mine.isMyTurn());
+
+    // Views read the live game, so they follow every action without being rebuilt
+    gov.gather();
+    CHECK(mine.coins(0) == 1);
+    CHECK(mine.bank() == 49);
+    CHECK(mine.isMyTurn());
+    spy.spyOn(gen);
+    CHECK(mine.arrestBlocked(2));
+    spy.gather();
+    gen.addCoins(7);
+    gen.coup(gov);
+    CHECK_FALSE(mine.alive(0));
+    CHECK(mine.role(0) == Role::Governor); // eliminated cards are public
+    CHECK(g.viewFor(2).role(1) == Role::Unknown);
+    CHECK(g.viewFor(2).myRole() == Role::General);
+
+    CHECK_THROWS_AS(g.viewFor(3), std::out_of_range);
+    CHECK_THROWS_AS(mine.coins(-1), std::out_of_range);
+}
+
+/**
+ * @brief Tests the fixed tensor layout: relative seat slots, arrest history, pending tax, hidden roles,
+ *        zero padding past the seat count, and identical float/uint8 encodings.
+ */
+TEST_CASE("Observation tensor encoding") {
+    Game g;
+    g.setLogging(false);
+    Governor gov("Gov", &g);
+    Spy spy("Spy", &g);
+    General gen("Gen", &g);
+    gov.gather();
+    spy.gather();
+    gen.gather();
+    gov.arrest(spy); // spy 1 -> 0, gov 1 -> 2
+    spy.tax();       // spy 0 -> 2, tax pending
+
+    typedef ObservationEncoder E;
+    std::vector<float> f(E::SIZE + 1, -1.0f);
+    std::vector<uint8_t> b(E::SIZE, 99);
+    E::encode(g.viewFor(1), f.data());
+    E::encode(g.viewFor(1), b.data());
+    CHECK(f[E::SIZE] == -1.0f); // nothing written past the layout
+    for (size_t i = 0; i < E::SIZE; ++i) CHECK(static_cast<float>(b[i]) == f[i]);
+
+    CHECK(f[E::SEAT_COUNT] == 3);
+    CHECK(f[E::ALIVE_COUNT] == 3);
+    CHECK(f[E::BANK] == g.getBank());
+    CHECK(f[E::MY_TURN] == 0);
+    CHECK(f[E::MY_ROLE + static_cast<size_t>(Role::Spy)] == 1);
+    // slot 0 = Spy (observer), slot 1 = General, slot 2 = Governor
+    CHECK(f[E::slotOffset(0, E::SLOT_COINS)] == 2);
+    CHECK(f[E::slotOffset(0, E::SLOT_TAX_PENDING)] == 1);
+    CHECK(f[E::slotOffset(0, E::SLOT_ROLE + static_cast<size_t>(Role::Spy))] == 1);
+    CHECK(f[E::slotOffset(1, E::SLOT_TURN)] == 1);
+    CHECK(f[E::slotOffset(2, E::SLOT_COINS)] == 2);
+    CHECK(f[E::slotOffset(2, E::SLOT_ARRESTED_ME)] == 1);
+    CHECK(f[E::slotOffset(2, E::SLOT_ARRESTED_BY_ME)] == 0);
+    for (int k = 1; k < 3; ++k) {
+        for (size_t r = 0; r < E::ROLE_COUNT; ++r) CHECK(f[E::slotOffset(k, E::SLOT_ROLE + r)] == 0);
+    }
+    for (size_t i = E::slotOffset(3, 0); i < E::SIZE; ++i) CHECK(f[i] == 0);
+
+    // From the Governor's seat the same arrest is its own
+    E::encode(g.viewFor(0), f.data());
+    CHECK(f[E::slotOffset(1, E::SLOT_ARRESTED_BY_ME)] == 1);
+    CHECK(f[E::slotOffset(1, E::SLOT_TAX_PENDING)] == 1);
+}
+
+// Random (often illegal) action for differential tests: mostly the current seat, any type, any target
+static Action randomAction(const LaneState& s, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> pct(0, 99);
+    int n = s.seats;
+    int actor = s.currentSeat();
+    if (pct(rng) < 25) actor = std::uniform_int_distribution<int>(-1, n)(rng);
+    int target = std::uniform_int_distribution<int>(-1, n)(rng);
+    ActionType type = static_cast<ActionType>(std::uniform_int_distribution<int>(0, ACTION_TYPE_COUNT - 1)(rng));
+    if (actor >= 0 && actor < n && s.coins[actor] >= 7 && pct(rng) < 50) type = ActionType::Coup;
+    return {type, actor, target};
+}
+
+/**
+ * @brief Differential test: the flat LaneState rules accept and reject exactly what Game does and
+ *        leave exactly the same state, over thousands of random legal and illegal actions.
+ */
+TEST_CASE("LaneState rules agree with Game") {
+    std::mt19937_64 rng(2024);
+    size_t compared = 0, accepted = 0, finishedGames = 0;
+    for (int gameNo = 0; gameNo < 300; ++gameNo) {
+        int n = std::uniform_int_distribution<int>(2, 6)(rng);
+        std::vector<Role> roles;
+        for (int i = 0; i < n; ++i) roles.push_back(static_cast<Role>(std::uniform_int_distribution<int>(0, 5)(rng)));
+        Game g;
+        g.setLogging(false);
+        std::vector<std::unique_ptr<Player>> players;
+        for (int i = 0; i < n; ++i) players.emplace_back(Game::createPlayerWithRole("P" + std::to_string(i), &g, roles[i]));
+        LaneState lane = LaneState::deal(roles);
+        REQUIRE(lane == LaneState::fromGame(g));
+
+        for (int step = 0; step < 400 && lane.aliveCount() > 1; ++step) {
+            Action a = randomAction(lane, rng);
+            bool gameOk = true;
+            try { applyAction(g, a); } catch (const std::exception&) { gameOk = false; }
+            bool laneOk = lane.apply(a);
+            CHECK(laneOk == gameOk);
+            LaneState expected = LaneState::fromGame(g);
+            if (lane != expected) {
+                FAIL_CHECK("Lane diverged after " << actionTypeToString(a.type) << " " << a.actor << " " << a.target);
+                break;
+            }
+            ++compared;
+            accepted += laneOk ? 1 : 0;
+        }
+        finishedGames += lane.aliveCount() == 1 ? 1 : 0;
+
+        // Round trip through a snapshot
+        Game copy;
+        copy.setLogging(false);
+        std::vector<std::unique_ptr<Player>> copyPlayers;
+        for (int i = 0; i < n; ++i) copyPlayers.emplace_back(Game::createPlayerWithRole("P" + std::to_string(i), &copy, roles[i]));
+        copy.restore(lane.toSnapshot());
+        CHECK(LaneState::fromGame(copy) == lane);
+    }
+    CHECK(compared > 20000);
+    CHECK(accepted > 5000);
+    CHECK(finishedGames > 100);
+    CHECK_THROWS_AS(LaneState::deal({Role::Spy}), std::invalid_argument);
+}
+
+/**
+ * @brief Tests VecGame against per-lane LaneStates: same acceptance, same states, and automatic
+ *        reset of finished lanes with their winners reported.
+ */
+TEST_CASE("VecGame steps lanes like scalar LaneStates") {
+    const size_t LANES = 64;
+    VecGame vec(LANES, 4, 99);
+    std::vector<LaneState> mirror;
+    for (size_t i = 0; i < LANES; ++i) mirror.push_back(vec.get(i));
+    CHECK(vec.coinsOf(0)[5] == 0);
+    CHECK(vec.banks()[7] == 50);
+
+    std::mt19937_64 rng(5);
+    std::vector<Action> actions(LANES);
+    std::vector<uint8_t> ok(LANES);
+    std::vector<int8_t> winners(LANES);
+    int resets = 0;
+    for (int step = 0; step < 500; ++step) {
+        for (size_t i = 0; i < LANES; ++i) actions[i] = randomAction(mirror[i], rng);
+        vec.step(actions.data(), ok.data(), winners.data());
+        for (size_t i = 0; i < LANES; ++i) {
+            CHECK(ok[i] == (mirror[i].apply(actions[i]) ? 1 : 0));
+            if (mirror[i].aliveCount() <= 1) {
+                CHECK(winners[i] == mirror[i].winner());
+                mirror[i] = vec.get(i);
+                CHECK(mirror[i].aliveCount() == 4);
+                ++resets;
+            } else {
+                CHECK(winners[i] == -1);
+                REQUIRE(vec.get(i) == mirror[i]);
+            }
+        }
+    }
+    CHECK(resets > 0);
+    CHECK(vec.gamesFinished() == static_cast<uint64_t>(resets));
+    CHECK_THROWS_AS(VecGame(0, 4, 1), std::invalid_argument);
+    CHECK_THROWS_AS(vec.reset(0, {Role::Spy}), std::invalid_argument);
+}
+
+/**
+ * @brief Tests that the scalar, SSE2 and AVX2 kernels produce identical masks and coin updates
+ *        (including the scalar tail of lane counts that are not a multiple of the vector width).
+ */
+TEST_CASE("SIMD kernels agree with the scalar path") {
+    const size_t N = 1013;
+    std::mt19937_64 rng(3);
+    std::vector<int16_t> coins(N), bank(N), amount(N);
+    std::vector<int8_t> turn(N), sanction(N);
+    std::vector<uint8_t> alive(N), extra(N), pending(N), role(N);
+    for (size_t i = 0; i < N; ++i) {
+        coins[i] = static_cast<int16_t>(rng() % 14);
+        bank[i] = static_cast<int16_t>(rng() % 12);
+        amount[i] = static_cast<int16_t>(static_cast<int>(rng() % 7) - 3);
+        turn[i] = static_cast<int8_t>(rng() % 4);
+        sanction[i] = static_cast<int8_t>(static_cast<int>(rng() % 3) - 1);
+        alive[i] = rng() % 5 != 0;
+        extra[i] = rng() % 4 == 0;
+        pending[i] = static_cast<uint8_t>(rng() % 3);
+        role[i] = static_cast<uint8_t>(rng() % 6);
+    }
+    SeatColumns c;
+    c.coins = coins.data();
+    c.bank = bank.data();
+    c.turn = turn.data();
+    c.sanction = sanction.data();
+    c.alive = alive.data();
+    c.extra = extra.data();
+    c.pending = pending.data();
+    c.role = role.data();
+
+    SimdLevel original = activeSimdLevel();
+    std::vector<std::vector<uint16_t>> masks;
+    std::vector<std::vector<int16_t>> paidCoins, paidBank;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (setSimdLevel(level) != level) continue; // not supported here
+        std::vector<uint16_t> out(N, 0xBEEF);
+        seatActionMasks(c, 2, out.data(), N);
+        masks.push_back(out);
+        std::vector<int16_t> pc = coins, pb = bank;
+        payFromBank(pc.data(), pb.data(), turn.data(), 1, amount.data(), N);
+        paidCoins.push_back(pc);
+        paidBank.push_back(pb);
+    }
+    setSimdLevel(original);
+    REQUIRE(!masks.empty());
+    for (size_t k = 1; k < masks.size(); ++k) {
+        CHECK(masks[k] == masks[0]);
+        CHECK(paidCoins[k] == paidCoins[0]);
+        CHECK(paidBank[k] == paidBank[0]);
+    }
+    for (size_t i = 0; i < N; ++i) {
+        if (turn[i] != 2) CHECK(masks[0][i] == 0xBEEF);
+        int16_t d = turn[i] == 1 ? amount[i] : 0;
+        CHECK(paidCoins[0][i] == coins[i] + d);
+        CHECK(paidBank[0][i] == bank[i] - d);
+    }
+}
+
+/**
+ * @brief Tests that VecGame::legalMasks matches the rules exactly for untargeted actions on
+ *        states reached by random play.
+ */
+TEST_CASE("VecGame legality masks match the rules") {
+    const size_t LANES = 200;
+    VecGame vec(LANES, 5, 17);
+    std::mt19937_64 rng(8);
+    std::vector<uint16_t> masks(LANES);
+    std::vector<Action> actions(LANES);
+    const ActionType untargeted[] = {ActionType::Gather, ActionType::Tax, ActionType::Bribe, ActionType::Invest, ActionType::SkipTurn};
+    size_t checked = 0, legal = 0;
+    for (int step = 0; step < 150; ++step) {
+        vec.legalMasks(masks.data());
+        for (size_t i = 0; i < LANES; ++i) {
+            LaneState s = vec.get(i);
+            for (ActionType t : untargeted) {
+                LaneState copy = s;
+                bool ok = copy.apply({t, s.currentSeat(), -1});
+                CHECK(ok == ((masks[i] >> static_cast<int>(t)) & 1));
+                ++checked;
+                legal += ok ? 1 : 0;
+            }
+            actions[i] = randomAction(s, rng);
+        }
+        vec.step(actions.data());
+    }
+    CHECK(legal > checked / 4);
+    CHECK(legal < checked);
+
+    std::vector<int16_t> bonus(LANES, 2);
+    LaneState before = vec.get(3);
+    vec.payFromBank(bonus.data());
+    LaneState after = vec.get(3);
+    CHECK(after.coins[before.currentSeat()] == before.coins[before.currentSeat()] + 2);
+    CHECK(after.bank == before.bank - 2);
+}
+
+/**
+ * @brief Tests that the solver finds a forced coup, and that along random play every solved value is
+ *        backed by the move bestMove() picks (fastest win one ply sooner, draws stay draws).
+ */
+TEST_CASE("Two-player solver values are consistent with the moves") {
+    SolverConfig config;
+    config.bank = 14;
+    config.coinCap = 14;
+    config.threads = 2;
+    TwoPlayerSolver solver(Role::Governor, Role::Baron, config);
+    CHECK_THROWS_AS(solver.value(solver.start()), std::logic_error);
+    solver.solve();
+    CHECK(solver.stateCount() > 1000);
+    CHECK(solver.cappedStates() == 0);
+    CHECK(solver.memoryBytes() > 0);
+
+    // Governor taxes to 7 coins while the Baron skips; with 7 left in the bank the coup is forced
+    LaneState s = solver.start();
+    for (ActionType t : {ActionType::Tax, ActionType::Gather, ActionType::Tax}) {
+        REQUIRE(s.apply({t, 0, -1}));
+        REQUIRE(s.apply({ActionType::SkipTurn, 1, -1}));
+    }
+    REQUIRE(s.coins[0] == 7);
+    REQUIRE(s.bank == 7);
+    SolvedValue v = solver.value(s);
+    CHECK(v.winner == 0);
+    CHECK(v.plies == 1);
+    Action best;
+    REQUIRE(solver.bestMove(s, false, best));
+    CHECK(best.type == ActionType::Coup);
+    CHECK(best.target == 1);
+
+    std::mt19937_64 rng(4);
+    LaneState state = solver.start();
+    bool reacting = false;
+    for (int step = 0; step < 300 && state.winner() < 0; ++step) {
+        SolvedValue here = solver.value(state, reacting);
+        Action a;
+        LaneState next = state;
+        bool moved = solver.bestMove(state, reacting, a);
+        if (moved) REQUIRE(next.apply(a));
+        bool nextReacting = moved && !reacting && solver.reactionWindow(next);
+        SolvedValue after = solver.value(next, nextReacting);
+        CHECK(after.winner == here.winner);
+        if (here.winner >= 0) CHECK(after.plies == here.plies - 1);
+
+        // Continue with a random accepted move, so the walk visits many kinds of states
+        if (reacting) {
+            reacting = false;
+            continue;
+        }
+        Action r = randomAction(state, rng);
+        LaneState copy = state;
+        if (copy.apply(r) && r.actor == state.currentSeat()) {
+            state = copy;
+            reacting = solver.reactionWindow(state);
+        }
+    }
+}
+
+/**
+ * @brief Tests that values resting on states beyond the coin cap are flagged rather than read as draws:
+ *        every exact value at a low cap matches a solve with a higher cap, and some flagged ones are wins there.
+ */
+TEST_CASE("Solver flags values that depend on the coin cap") {
+    std::vector<LaneState> roots;
+    for (int turn = 0; turn < 2; ++turn)
+        for (int bank = 0; bank <= 7; ++bank)
+            for (int c0 = 0; c0 <= 7; ++c0)
+                for (int c1 = 0; c1 <= 7; ++c1) {
+                    LaneState r = LaneState::deal({Role::Merchant, Role::Baron});
+                    r.turn = static_cast<int8_t>(turn);
+                    r.bank = static_cast<int16_t>(bank);
+                    r.coins[0] = static_cast<int16_t>(c0);
+                    r.coins[1] = static_cast<int16_t>(c1);
+                    roots.push_back(r);
+                }
+    SolverConfig low;
+    low.bank = 0;
+    low.coinCap = 7;
+    low.threads = 2;
+    SolverConfig high = low;
+    high.coinCap = 8;
+    TwoPlayerSolver capped(Role::Merchant, Role::Baron, low), wider(Role::Merchant, Role::Baron, high);
+    capped.solve(roots);
+    wider.solve(roots);
+    REQUIRE(capped.cappedStates() > 0);
+
+    size_t inexact = 0, draws = 0, resolvedHigher = 0, mismatched = 0;
+    capped.forEachState([&](const LaneState& state, bool reacting, const SolvedValue& v) {
+        if (state.bank > 7 || state.coins[0] > 7 || state.coins[1] > 7) return;
+        SolvedValue w = wider.value(state, reacting);
+        if (!v.exact) {
+            CHECK(v.winner == -1);
+            ++inexact;
+            resolvedHigher += w.winner >= 0;
+            return;
+        }
+        draws += v.winner < 0;
+        if (w.winner != v.winner || w.plies != v.plies || !w.exact) ++mismatched;
+    });
+    CHECK(inexact > 0);
+    CHECK(draws > 0);
+    CHECK(resolvedHigher > 0);
+    CHECK(mismatched == 0);
+}
+
+/**
+ * @brief Tests that a generated tablebase maps back and answers exactly what the solver computed,
+ *        and that endgameOf() compacts a larger table.
+ */
+TEST_CASE("Endgame tablebase round-trips solver values") {
+    const std::string path = "build/test_endgame.tb";
+    TablebaseConfig config;
+    config.coinCap = 7;
+    config.threads = 2;
+    config.roles = {Role::Governor, Role::Baron};
+    uint64_t written = Tablebase::generate(path, config);
+    Tablebase tb(path);
+    CHECK(tb.coinCap() == 7);
+    CHECK(tb.positions() == written);
+
+    // 7 coins with 7 in the bank: the coup wins on the spot
+    LaneState s = LaneState::deal({Role::Governor, Role::Baron});
+    s.coins[0] = 7;
+    s.bank = 7;
+    SolvedValue v;
+    REQUIRE(tb.probe(s, false, v));
+    CHECK(v.winner == 0);
+    CHECK(v.plies == 1);
+    CHECK_FALSE(tb.probe(LaneState::deal({Role::Spy, Role::Baron}), false, v));
+    s.coins[1] = 8;
+    CHECK_FALSE(tb.probe(s, false, v));
+
+    // Every position within the cap matches a direct solve of the same pairing
+    SolverConfig sc;
+    sc.bank = 0;
+    sc.coinCap = 7;
+    TwoPlayerSolver solver(Role::Baron, Role::Governor, sc);
+    std::vector<LaneState> roots;
+    for (int turn = 0; turn < 2; ++turn)
+        for (int bank = 0; bank <= 7; ++bank)
+            for (int c0 = 0; c0 <= 7; ++c0)
+                for (int c1 = 0; c1 <= 7; ++c1) {
+                    LaneState r = LaneState::deal({Role::Baron, Role::Governor});
+                    r.turn = static_cast<int8_t>(turn);
+                    r.bank = static_cast<int16_t>(bank);
+                    r.coins[0] = static_cast<int16_t>(c0);
+                    r.coins[1] = static_cast<int16_t>(c1);
+                    roots.push_back(r);
+                }
+    solver.solve(roots);
+    size_t compared = 0, mismatched = 0, wins = 0;
+    solver.forEachState([&](const LaneState& state, bool reacting, const SolvedValue& expected) {
+        if (state.bank > 7 || state.coins[0] > 7 || state.coins[1] > 7) return;
+        SolvedValue got;
+        bool found = tb.probe(state, reacting, got);
+        if (found != expected.exact || (found && (got.winner != expected.winner || got.plies != expected.plies))) ++mismatched;
+        ++compared;
+        wins += expected.winner >= 0;
+    });
+    CHECK(compared > 10000);
+    CHECK(wins > 0);
+    CHECK(mismatched == 0);
+
+    // A 3-seat table down to seats 0 and 2
+    LaneState big = LaneState::deal({Role::Baron, Role::Spy, Role::Governor});
+    big.alive[1] = 0;
+    big.turn = 2;
+    big.coins[2] = 4;
+    big.arrestTarget[0] = 1;
+    big.sanction[2] = 1;
+    LaneState small = Tablebase::endgameOf(big);
+    CHECK(small.seats == 2);
+    CHECK(small.role[1] == static_cast<uint8_t>(Role::Governor));
+    CHECK(small.currentSeat() == 1);
+    CHECK(small.coins[1] == 4);
+    CHECK(small.arrestTarget[0] == -1);
+    CHECK(small.sanction[1] == 0);
+    CHECK_THROWS_AS(Tablebase::endgameOf(LaneState::deal({Role::Baron, Role::Spy, Role::Governor})), std::invalid_argument);
+
+    // Corrupted copies fail to load: a truncated file, and cell offsets that go backwards
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto loads = [&](const std::string& contents) {
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << contents;
+        }
+        try {
+            Tablebase t(path);
+            return true;
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+    };
+    CHECK(loads(bytes));
+    CHECK_FALSE(loads(bytes.substr(0, bytes.size() - 16)));  // past the 8-byte padding, into the values
+    // Directory entries follow the 24-byte header, 40 bytes each: roles, cells, keys, values, positions
+    size_t entry = 24;
+    uint64_t positions = 0, cells = 0;
+    for (; entry < 24 + 36 * 40 && positions == 0; entry += 40) {
+        std::memcpy(&positions, bytes.data() + entry + 32, sizeof(positions));
+        std::memcpy(&cells, bytes.data() + entry + 8, sizeof(cells));
+    }
+    REQUIRE(positions > 0);
+    std::string backwards = bytes;
+    const uint32_t high = static_cast<uint32_t>(positions);
+    std::memcpy(&backwards[cells + 4], &high, sizeof(high));  // cell 1 ends at the last position, cell 2 starts earlier
+    CHECK_FALSE(loads(backwards));
+
+    {
+        std::ofstream bad(path, std::ios::binary | std::ios::trunc);
+        bad << "not a tablebase";
+    }
+    CHECK_THROWS_AS(Tablebase bad(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Tests that the incrementally maintained Zobrist hash always equals a from-scratch hash and the
+ *        LaneState hash of the same state, survives restore, and tells distinct states apart.
+ */
+TEST_CASE("Zobrist hash follows every mutation") {
+    std::mt19937_64 rng(38);
+    std::unordered_map<uint64_t, LaneState> seen;
+    size_t checked = 0, collisions = 0;
+    for (int gameNo = 0; gameNo < 100; ++gameNo) {
+        int n = std::uniform_int_distribution<int>(2, 6)(rng);
+        std::vector<Role> roles;
+        for (int i = 0; i < n; ++i) roles.push_back(static_cast<Role>(std::uniform_int_distribution<int>(0, 5)(rng)));
+        Game g;
+        g.setLogging(false);
+        std::vector<std::unique_ptr<Player>> players;
+        for (int i = 0; i < n; ++i) players.emplace_back(Game::createPlayerWithRole("P" + std::to_string(i), &g, roles[i]));
+        LaneState lane = LaneState::deal(roles);
+        CHECK(g.hash() == zobristHash(lane));
+
+        for (int step = 0; step < 300 && lane.aliveCount() > 1; ++step) {
+            Action a = randomAction(lane, rng);
+            try { applyAction(g, a); } catch (const std::exception&) {}
+            lane.apply(a);
+            if (g.hash() != g.computeHash() || g.hash() != zobristHash(LaneState::fromGame(g))) {
+                FAIL_CHECK("Hash diverged after " << actionTypeToString(a.type) << " " << a.actor << " " << a.target);
+                break;
+            }
+            auto it = seen.emplace(g.hash(), lane).first;
+            collisions += it->second != lane ? 1 : 0;
+            ++checked;
+        }
+
+        Game copy;
+        copy.setLogging(false);
+        std::vector<std::unique_ptr<Player>> copyPlayers;
+        for (int i = 0; i < n; ++i) copyPlayers.emplace_back(Game::createPlayerWithRole("Q" + std::to_string(i), &copy, roles[i]));
+        copy.restore(g.snapshot());
+        CHECK(copy.hash() == g.hash());
+    }
+    CHECK(checked > 5000);
+    CHECK(seen.size() > 1000);
+    CHECK(collisions == 0);
+
+    // Same coins, different roles or turn: different hashes
+    CHECK(zobristHash(LaneState::deal({Role::Spy, Role::Baron})) != zobristHash(LaneState::deal({Role::Baron, Role::Spy})));
+    LaneState turned = LaneState::deal({Role::Spy, Role::Baron});
+    turned.turn = 1;
+    CHECK(zobristHash(turned) != zobristHash(LaneState::deal({Role::Spy, Role::Baron})));
+}
+
+/**
+ * @brief Tests the transposition table: round trip, move retention, replacement within a bucket,
+ *        and that concurrent writers never make a probe return another key's entry.
+ */
+TEST_CASE("Transposition table stores and replaces entries") {
+    TranspositionTable tt(1);
+    CHECK(tt.capacity() == (1u << 20) / 64 * 4);
+    CHECK_THROWS_AS(TranspositionTable(0), std::invalid_argument);
+
+    TTEntry e;
+    e.value = -1234;
+    e.depth = 9;
+    e.bound = TTBound::Lower;
+    e.hasMove = true;
+    e.move = {ActionType::Arrest, 5, 3};
+    tt.store(42, e);
+    TTEntry out;
+    REQUIRE(tt.probe(42, out));
+    CHECK(out.value == -1234);
+    CHECK(out.depth == 9);
+    CHECK(out.bound == TTBound::Lower);
+    CHECK(out.hasMove);
+    CHECK(out.move == Action{ActionType::Arrest, 5, 3});
+    CHECK_FALSE(tt.probe(43, out));
+
+    // A move-less update keeps the best move
+    TTEntry update;
+    update.value = 7;
+    update.depth = 10;
+    update.bound = TTBound::Exact;
+    tt.store(42, update);
+    REQUIRE(tt.probe(42, out));
+    CHECK(out.value == 7);
+    CHECK(out.move == Action{ActionType::Arrest, 5, 3});
+
+    // Five keys in one bucket: the shallowest is evicted, and after newSearch() old entries go first
+    const uint64_t stride = tt.capacity() / 4;
+    for (uint64_t k = 1; k <= 4; ++k) {
+        TTEntry d;
+        d.depth = static_cast<uint8_t>(10 + k);
+        tt.store(k * stride, d);
+    }
+    TTEntry deep;
+    deep.depth = 20;
+    tt.store(5 * stride, deep);
+    CHECK_FALSE(tt.probe(1 * stride, out));
+    for (uint64_t k = 2; k <= 5; ++k) CHECK(tt.probe(k * stride, out));
+    for (int i = 0; i < 5; ++i) tt.newSearch();
+    TTEntry fresh;
+    fresh.depth = 1;
+    for (uint64_t k = 6; k <= 9; ++k) tt.store(k * stride, fresh);
+    for (uint64_t k = 6; k <= 9; ++k) CHECK(tt.probe(k * stride, out));
+    CHECK_FALSE(tt.probe(5 * stride, out));
+
+    tt.clear();
+    CHECK_FALSE(tt.probe(42, out));
+
+    // Writers on overlapping keys: every hit carries its own key's value
+    std::atomic<size_t> wrong{0}, hits{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 r(t);
+            for (int i = 0; i < 200000; ++i) {
+                uint64_t key = r() % 4096 * 0x9E3779B97F4A7C15ULL;
+                TTEntry w;
+                w.value = static_cast<int16_t>(key >> 48);
+                w.depth = static_cast<uint8_t>(key >> 40);
+                tt.store(key, w);
+                TTEntry got;
+                uint64_t probeKey = r() % 4096 * 0x9E3779B97F4A7C15ULL;
+                if (tt.probe(probeKey, got)) {
+                    ++hits;
+                    if (got.value != static_cast<int16_t>(probeKey >> 48)) ++wrong;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    CHECK(hits > 0);
+    CHECK(wrong == 0);
+}
+
+/**
+ * @brief Tests that observed actions rule out roles, that determinisations respect what is known,
+ *        and that legalActions() lists exactly the accepted actions.
+ */
+TEST_CASE("Role constraints narrow hidden roles") {
+    LaneState s = LaneState::deal({Role::Spy, Role::Governor, Role::Merchant});
+    s.coins[2] = 3;
+    RoleConstraints k(s, 0);
+    CHECK(k.known(0) == Role::Spy);
+    CHECK(k.allowed(1) == RoleConstraints::ALL_ROLES);
+
+    auto play = [&](const Action& a) {
+        LaneState before = s;
+        bool ok = s.apply(a);
+        k.observe(before, a, ok, s);
+        return ok;
+    };
+    REQUIRE(play({ActionType::Gather, 0, -1}));
+    REQUIRE(play({ActionType::Tax, 1, -1}));     // 3 coins: only a Governor
+    CHECK(k.known(1) == Role::Governor);
+    REQUIRE(play({ActionType::Gather, 2, -1}));  // 2 coins at 3+: the Merchant bonus
+    CHECK(k.known(2) == Role::Merchant);
+    CHECK_FALSE(play({ActionType::Invest, 0, -1})); // rejected actions teach nothing new about a known seat
+    CHECK(k.known(0) == Role::Spy);
+
+    LaneState t = LaneState::deal({Role::Baron, Role::Judge, Role::General});
+    RoleConstraints j(t, 0);
+    LaneState before = t;
+    t.apply({ActionType::Gather, 0, -1});
+    j.observe(before, {ActionType::Gather, 0, -1}, true, t);
+    before = t;
+    REQUIRE(t.apply({ActionType::Gather, 1, -1}));
+    j.observe(before, {ActionType::Gather, 1, -1}, true, t); // nothing to learn below 3 coins
+    CHECK(j.allowed(1) == RoleConstraints::ALL_ROLES);
+    std::mt19937_64 rng(5);
+    int seen[6] = {};
+    for (int i = 0; i < 600; ++i) {
+        LaneState d = j.determinise(t, rng);
+        CHECK(d.role[0] == static_cast<uint8_t>(Role::Baron));
+        ++seen[d.role[1]];
+    }
+    for (int r = 0; r < 6; ++r) CHECK(seen[r] > 50);
+    CHECK(j.hide(t).role[2] == static_cast<uint8_t>(Role::Unknown));
+
+    // legalActions() against trying every action
+    for (int i = 0; i < 200 && t.winner() < 0; ++i) {
+        Action moves[LaneState::MAX_ACTIONS];
+        int n = t.legalActions(moves);
+        int expected = 0;
+        for (int type = 0; type < ACTION_TYPE_COUNT; ++type)
+            for (int target = -1; target < t.seats; ++target) {
+                if (actionNeedsTarget(static_cast<ActionType>(type)) != (target >= 0)) continue;
+                LaneState copy = t;
+                expected += copy.apply({static_cast<ActionType>(type), t.currentSeat(), target}) ? 1 : 0;
+            }
+        CHECK(n == expected);
+        REQUIRE(n > 0);
+        t.apply(moves[rng() % n]);
+    }
+}
+
+/**
+ * @brief Tests ISMCTS: it takes a winning coup, never reads hidden roles, and reports its throughput.
+ */
+TEST_CASE("ISMCTS searches over determinised roles") {
+    IsmctsConfig config;
+    config.determinisations = 400;
+    config.threads = 2;
+    LaneState s = LaneState::deal({Role::Baron, Role::Spy});
+    s.coins[0] = s.coins[1] = 7;  // coup now, or be couped
+    IsmctsResult r = ismctsSearch(s, RoleConstraints(s, 0), config);
+    CHECK(r.best == Action{ActionType::Coup, 0, 1});
+    CHECK(r.determinisations == 400);
+    CHECK(r.determinisationsPerSecond() > 0);
+    CHECK(r.infoSets > 1);
+    uint64_t visits = 0;
+    for (const IsmctsMove& m : r.moves) visits += m.visits;
+    CHECK(visits >= 400);  // more if skipTurn loops lead back to the root
+
+    // Games that differ only in roles the observer cannot see search identically
+    config.threads = 1;
+    LaneState a = LaneState::deal({Role::Governor, Role::Judge, Role::Baron});
+    LaneState b = LaneState::deal({Role::Governor, Role::General, Role::Merchant});
+    IsmctsResult ra = ismctsSearch(a, RoleConstraints(a, 0), config);
+    IsmctsResult rb = ismctsSearch(b, RoleConstraints(b, 0), config);
+    REQUIRE(ra.moves.size() == rb.moves.size());
+    for (size_t i = 0; i < ra.moves.size(); ++i) {
+        CHECK(ra.moves[i].action == rb.moves[i].action);
+        CHECK(ra.moves[i].visits == rb.moves[i].visits);
+    }
+    CHECK_THROWS_AS(ismctsSearch(a, RoleConstraints(a, 1), config), std::invalid_argument);
+}
+
+/**
+ * @brief Tests role beliefs: the prior, exact updates from role-revealing actions, and agreement of their
+ *        support with the pairwise RoleConstraints over random games.
+ */
+TEST_CASE("Role beliefs update per action") {
+    LaneState s = LaneState::deal({Role::Baron, Role::Merchant, Role::Judge});
+    RoleBeliefs b(s, -1);
+    CHECK(b.probability(0, Role::Spy) == doctest::Approx(1.0 / 6));
+    auto play = [&](const Action& a) {
+        LaneState before = s;
+        bool ok = s.apply(a);
+        b.observe(before, a, ok, s);
+        return ok;
+    };
+    s.coins[0] = 3;
+    s.coins[1] = 3;
+    REQUIRE(play({ActionType::Invest, 0, -1}));      // only a Baron can invest
+    CHECK(b.probability(0, Role::Baron) == 1.0);
+    REQUIRE(play({ActionType::Gather, 1, -1}));      // bonus coin at 3+: Merchant
+    CHECK(b.probability(1, Role::Merchant) == 1.0);
+    REQUIRE(play({ActionType::Gather, 2, -1}));      // below 3 coins: no evidence
+    CHECK(b.probability(2, Role::Judge) == doctest::Approx(1.0 / 6));
+    REQUIRE(play({ActionType::Sanction, 0, 2}));     // the bank gains 1 more from a sanctioned Judge
+    CHECK(b.probability(2, Role::Judge) == 1.0);
+    CHECK(b.mostLikely(2) == Role::Judge);
+
+    // A seat that gathers at 3+ coins without a bonus is not a Merchant
+    LaneState t = LaneState::deal({Role::Spy, Role::General});
+    t.coins[0] = 3;
+    RoleBeliefs c(t, 1);
+    CHECK(c.probability(1, Role::General) == 1.0);
+    LaneState before = t;
+    REQUIRE(t.apply({ActionType::Gather, 0, -1}));
+    c.observe(before, {ActionType::Gather, 0, -1}, true, t);
+    CHECK(c.probability(0, Role::Merchant) == 0.0);
+    CHECK(c.probability(0, Role::Spy) == doctest::Approx(0.2));
+    std::mt19937_64 rng(40);
+    for (int i = 0; i < 100; ++i) CHECK(c.sample(t, rng).role[0] != static_cast<uint8_t>(Role::Merchant));
+
+    // Two replays per role match the 36-pair elimination, seat by seat, over random play
+    size_t compared = 0, narrowed = 0;
+    for (int gameNo = 0; gameNo < 60; ++gameNo) {
+        int n = std::uniform_int_distribution<int>(2, 6)(rng);
+        std::vector<Role> roles;
+        for (int i = 0; i < n; ++i) roles.push_back(static_cast<Role>(std::uniform_int_distribution<int>(0, 5)(rng)));
+        LaneState g = LaneState::deal(roles);
+        RoleBeliefs beliefs(g, 0);
+        RoleConstraints constraints(g, 0);
+        for (int step = 0; step < 300 && g.aliveCount() > 1; ++step) {
+            Action a = randomAction(g, rng);
+            LaneState prev = g;
+            bool ok = g.apply(a);
+            beliefs.observe(prev, a, ok, g);
+            constraints.observe(prev, a, ok, g);
+            for (int p = 0; p < n; ++p) {
+                CHECK(beliefs.support(p) == constraints.allowed(p));
+                CHECK(((beliefs.support(p) >> g.role[p]) & 1) == 1);
+                narrowed += beliefs.support(p) != RoleConstraints::ALL_ROLES;
+                ++compared;
+            }
+        }
+    }
+    CHECK(compared > 10000);
+    CHECK(narrowed > compared / 2);
+}
+
+/**
+ * @brief MCCFR lowers exploitability, and its tables survive a checkpoint round trip.
+ */
+TEST_CASE("MCCFR training and checkpoints") {
+    CfrConfig config;
+    config.horizon = 3;
+    config.threads = 2;
+    config.tableBits = 12;
+    CHECK_THROWS_AS(CfrTrainer(CfrConfig{5, 50, 0}), std::invalid_argument);
+
+    CfrTrainer trainer(config);
+    const double untrained = trainer.exploitability();
+    trainer.train(20000);
+    CHECK(trainer.iterations() == 20000);
+    CHECK(trainer.infoSets() > 100);
+    const double trained = trainer.exploitability();
+    CHECK(trained >= 0.0);
+    CHECK(trained < untrained / 3);
+
+    CfrPosition root = trainer.root(Role::Baron, Role::Spy);
+    auto strategy = trainer.averageStrategy(root);
+    double total = 0.0;
+    for (const auto& move : strategy) total += move.second;
+    CHECK(total == doctest::Approx(1.0));
+
+    // A position past the horizon is terminal
+    CfrPosition end = root;
+    for (int i = 0; i < config.horizon; ++i) REQUIRE(end.play({ActionType::Gather, end.state.currentSeat(), -1}));
+    CHECK_THROWS_AS(trainer.averageStrategy(end), std::invalid_argument);
+
+    const std::string path = "build/test_cfr.bin";
+    trainer.save(path);
+    CfrTrainer restored(config);
+    restored.load(path);
+    CHECK(restored.iterations() == 20000);
+    CHECK(restored.infoSets() == trainer.infoSets());
+    CHECK(restored.exploitability() == doctest::Approx(trained));
+    auto again = restored.averageStrategy(root);
+    REQUIRE(again.size() == strategy.size());
+    for (size_t i = 0; i < again.size(); ++i) CHECK(again[i].second == doctest::Approx(strategy[i].second));
+
+    CfrConfig other = config;
+    other.horizon = 4;
+    CfrTrainer mismatched(other);
+    CHECK_THROWS_AS(mismatched.load(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief The genetic algorithm improves on the baseline bot, and fitness does not depend on threads.
+ */
+TEST_CASE("Evolution tunes heuristic bot weights") {
+    std::mt19937_64 rng(42);
+    BotWeights w = BotWeights::random(rng);
+    w[BotWeights::CoupAt] = 20.0f;
+    w.clamp();
+    CHECK(w[BotWeights::CoupAt] == BotWeights::highest(BotWeights::CoupAt));
+
+    // A bot must coup at 10 coins and never invests without being a Baron
+    LaneState s = LaneState::deal({Role::Governor, Role::Spy});
+    s.coins[0] = 10;
+    CHECK(chooseHeuristicAction(s, BotWeights::defaults(), rng) == Action{ActionType::Coup, 0, 1});
+    s.coins[0] = 5;
+    for (int i = 0; i < 200; ++i) CHECK(chooseHeuristicAction(s, BotWeights::defaults(), rng).type != ActionType::Invest);
+
+    EvolutionConfig config;
+    config.population = 12;
+    config.gamesPerGenome = 150;
+    config.threads = 3;
+    CHECK_THROWS_AS(Evolution(EvolutionConfig{1}), std::invalid_argument);
+    Evolution evolution(config);
+    CHECK(evolution.population().empty());
+    CHECK_THROWS_AS(evolution.best(), std::logic_error);
+    GenerationStats first = evolution.step();
+    for (int g = 0; g < 5; ++g) evolution.step();
+    CHECK(evolution.generation() == 6);
+    CHECK(first.games == 12 * 150);
+    REQUIRE(evolution.population().size() == 12);
+    CHECK(evolution.best().fitness >= evolution.population().back().fitness);
+
+    // Same seed, same games: the win rate is exact whatever the thread count
+    const double baseline = evolution.winRate(BotWeights::defaults(), 1500, 7);
+    const double champion = evolution.winRate(evolution.best().weights, 1500, 7);
+    config.threads = 1;
+    CHECK(Evolution(config).winRate(evolution.best().weights, 1500, 7) == champion);
+    CHECK(baseline == doctest::Approx(1.0 / 3).epsilon(0.25));
+    CHECK(champion > baseline + 0.04);
+}
+
+/**
+ * @brief The leaderboard treap answers rank queries exactly as a sorted list would.
+ */
+TEST_CASE("Leaderboard ranks by score") {
+    Leaderboard board;
+    CHECK(board.size() == 0);
+    CHECK_THROWS_AS(board.rankOf(0), std::out_of_range);
+    CHECK_THROWS_AS(board.set(-1, 0.0), std::out_of_range);
+    std::mt19937_64 rng(43);
+    std::vector<double> scores(300, 0.0);
+    std::vector<bool> present(300, false);
+    for (int step = 0; step < 5000; ++step) {
+        int id = std::uniform_int_distribution<int>(0, 299)(rng);
+        if (std::uniform_int_distribution<int>(0, 9)(rng) == 0) {
+            board.erase(id);
+            present[id] = false;
+        } else {
+            scores[id] = std::uniform_int_distribution<int>(0, 50)(rng);  // many ties
+            board.set(id, scores[id]);
+            present[id] = true;
+        }
+    }
+    std::vector<int> expected;
+    for (int id = 0; id < 300; ++id) {
+        if (present[id]) expected.push_back(id);
+    }
+    std::sort(expected.begin(), expected.end(), [&](int a, int b) { return scores[a] != scores[b] ? scores[a] > scores[b] : a < b; });
+    REQUIRE(board.size() == expected.size());
+    for (size_t r = 0; r < expected.size(); ++r) {
+        CHECK(board.atRank(r) == expected[r]);
+        CHECK(board.rankOf(expected[r]) == r);
+    }
+    CHECK(board.top(3) == std::vector<int>(expected.begin(), expected.begin() + 3));
+}
+
+/**
+ * @brief Ratings follow finishing order, taken from the game's elimination order.
+ */
+TEST_CASE("Ratings from streamed game results") {
+    // The game records who was eliminated and when
+    Game g;
+    g.setLogging(false);
+    std::unique_ptr<Player> a(Game::createPlayerWithRole("A", &g, Role::Governor));
+    std::unique_ptr<Player> b(Game::createPlayerWithRole("B", &g, Role::Spy));
+    std::unique_ptr<Player> c(Game::createPlayerWithRole("C", &g, Role::Baron));
+    g.eliminate(b.get());
+    g.eliminate(a.get());
+    CHECK(g.getEliminationOrder() == std::vector<int>{1, 0});
+    GameResult played = playGame({Role::Governor, Role::Spy, Role::Judge, Role::Merchant}, 5);
+    REQUIRE(played.winner >= 0);
+    CHECK(played.eliminationOrder.size() == 3);
+    CHECK(finishingRanks(played, 4)[played.winner] == 0);
+    CHECK(finishingRanks(played, 4)[played.eliminationOrder[0]] == 3);
+
+    RatingEngine engine;
+    int first = engine.addPlayer("first"), second = engine.addPlayer("second"), third = engine.addPlayer("third");
+    CHECK(engine.name(second) == "second");
+    CHECK_THROWS_AS(engine.record({first, first}, std::vector<int>{0, 1}), std::invalid_argument);
+    CHECK_THROWS_AS(engine.record({first, 7}, std::vector<int>{0, 1}), std::out_of_range);
+    GameResult result;
+    result.winner = 0;
+    result.eliminationOrder = {2, 1};
+    engine.record({first, second, third}, result);
+    CHECK(engine.rating(first).mu > 25.0);
+    CHECK(engine.rating(third).mu < engine.rating(second).mu);
+    CHECK(engine.rating(second).sigma < 25.0 / 3);
+    CHECK(engine.atRank(0) == first);
+    CHECK(engine.rankOf(third) == 2);
+
+    // Bots of increasing strength end up ranked by strength (up to the noise between neighbours)
+    RatingEngine league;
+    for (int i = 0; i < 8; ++i) league.addPlayer("bot" + std::to_string(i));
+    std::mt19937_64 rng(44);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (int game = 0; game < 4000; ++game) {
+        std::vector<int> seats;
+        while (seats.size() < 4) {
+            int id = std::uniform_int_distribution<int>(0, 7)(rng);
+            if (std::find(seats.begin(), seats.end(), id) == seats.end()) seats.push_back(id);
+        }
+        std::vector<double> performance;
+        for (int id : seats) performance.push_back(id * 0.5 + noise(rng));
+        std::vector<int> ranks(4, 0);
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j) ranks[i] += performance[j] > performance[i];
+        league.record(seats, ranks);
+    }
+    CHECK(league.gamesRecorded() == 4000);
+    CHECK(league.atRank(0) == 7);
+    for (int weak = 0; weak < 8; ++weak)
+        for (int strong = weak + 3; strong < 8; ++strong) CHECK(league.rankOf(strong) < league.rankOf(weak));
+    CHECK(league.rating(7).sigma < 2.0);
+}
+
+/**
+ * @brief Round-robin pairs everyone once, Swiss and random rounds balance seats, and games stream in.
+ */
+TEST_CASE("Tournament scheduling and play") {
+    TournamentConfig config;
+    config.format = TournamentFormat::RoundRobin;
+    config.tableSize = 2;
+    CHECK_THROWS_AS(TournamentScheduler(1, config), std::invalid_argument);
+    TournamentScheduler roundRobin(7, config);
+    REQUIRE(roundRobin.rounds() == 7);
+    std::set<std::pair<int, int>> pairs;
+    for (size_t r = 0; r < roundRobin.rounds(); ++r) {
+        std::vector<int> seen(7, 0);
+        for (const auto& table : roundRobin.nextRound()) {
+            REQUIRE(table.size() == 2);
+            for (int e : table) ++seen[e];
+            CHECK(pairs.insert({std::min(table[0], table[1]), std::max(table[0], table[1])}).second);
+        }
+        CHECK(std::count(seen.begin(), seen.end(), 0) == 1);  // one bye per round
+        CHECK(*std::max_element(seen.begin(), seen.end()) == 1);
+    }
+    CHECK(pairs.size() == 21);
+    CHECK_THROWS_AS(roundRobin.nextRound(), std::logic_error);
+    for (int e = 0; e < 7; ++e) CHECK(std::abs(static_cast<int>(roundRobin.seatCount(e, 0)) - static_cast<int>(roundRobin.seatCount(e, 1))) <= 2);
+
+    // Seat rotation within a table spreads every entrant evenly over the seats
+    config.format = TournamentFormat::Swiss;
+    config.tableSize = 4;
+    config.rounds = 6;
+    config.gamesPerTable = 4;
+    config.threads = 3;
+    std::vector<BotWeights> bots;
+    std::mt19937_64 rng(45);
+    for (int b = 0; b < 10; ++b) bots.push_back(b == 0 ? BotWeights::defaults() : BotWeights::random(rng));
+    size_t games = 0;
+    RatingEngine ratings;
+    for (int b = 0; b < 10; ++b) ratings.addPlayer("bot" + std::to_string(b));
+    TournamentScheduler swiss = playTournament(bots, config, [&](const TournamentGame& game) {
+        CHECK(game.round < 6);
+        ratings.record(game.seats, game.result);
+        ++games;
+    });
+    CHECK(games == 6 * 3 * 4);  // 10 entrants: tables of 4, 4 and 2
+    CHECK(ratings.gamesRecorded() == games);
+    double total = 0.0;
+    for (int e = 0; e < 10; ++e) total += swiss.points(e);
+    CHECK(total >= 6 * (4 * 2.0 + 4 * 2.0 + 4 * 1.0) - 1e-9);  // a decided game hands out size / 2 points
+    for (int e = 0; e < 10; ++e) {
+        CHECK(swiss.seatCount(e, 1) == swiss.seatCount(e, 0));
+        CHECK(swiss.seatCount(e, 3) == swiss.seatCount(e, 2));
+        CHECK(swiss.seatCount(e, 0) + swiss.seatCount(e, 1) + swiss.seatCount(e, 2) + swiss.seatCount(e, 3) == 6 * 4);
+    }
+
+    // The results do not depend on the number of threads
+    config.threads = 1;
+    TournamentScheduler again = playTournament(bots, config, [](const TournamentGame&) {});
+    for (int e = 0; e < 10; ++e) CHECK(again.points(e) == swiss.points(e));
+
+    ThreadPool pool(2);
+    pool.submit([] { throw std::runtime_error("task failed"); });
+    CHECK_THROWS_AS(pool.wait(), std::runtime_error);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 100; ++i) pool.submit([&ran] { ++ran; });
+    pool.wait();
+    CHECK(ran == 100);
+}
+
+/**
+ * @brief Moments, quantiles and counts merge to the totals of one stream, and GameStats sees whole games.
+ */
+TEST_CASE("Streaming statistics merge") {
+    RunningMoments all, left, right;
+    QuantileSketch sketch, sketchLeft, sketchRight;
+    for (int v = 1; v <= 10000; ++v) {
+        all.add(v);
+        (v % 3 ? left : right).add(v);
+        sketch.add(v);
+        (v % 3 ? sketchLeft : sketchRight).add(v);
+    }
+    left.merge(right);
+    CHECK(left.count() == 10000);
+    CHECK(left.mean() == doctest::Approx(all.mean()));
+    CHECK(left.variance() == doctest::Approx(all.variance()));
+    CHECK(left.variance() == doctest::Approx(10000.0 * 10001.0 / 12.0));
+    CHECK(left.min() == 1);
+    CHECK(left.max() == 10000);
+    sketchLeft.merge(sketchRight);
+    for (double q : {0.01, 0.5, 0.9, 0.99}) {
+        CHECK(std::fabs(sketchLeft.quantile(q) - q * 9999 - 1) <= 0.011 * (q * 9999 + 1));
+        CHECK(sketchLeft.quantile(q) == sketch.quantile(q));
+    }
+    CHECK(QuantileSketch().quantile(0.5) == 0.0);
+    CHECK_THROWS_AS(QuantileSketch(0.0), std::invalid_argument);
+    CHECK_THROWS_AS(sketch.merge(QuantileSketch(0.02)), std::invalid_argument);
+
+    CountMinSketch counts, more;
+    for (uint64_t k = 0; k < 5000; ++k) counts.add(k, k % 7 + 1);
+    more.add(42, 100);
+    counts.merge(more);
+    CHECK(counts.estimate(42) >= 100 + 42 % 7 + 1);
+    for (uint64_t k = 0; k < 5000; k += 97) CHECK(counts.estimate(k) >= k % 7 + 1);
+
+    // Three workers publish their games; the reader's totals are those of all of them
+    StatsHub hub;
+    std::vector<std::thread> workers;
+    for (int w = 0; w < 3; ++w) {
+        workers.emplace_back([&hub, w] {
+            std::mt19937_64 rng(w);
+            const BotWeights bot = BotWeights::defaults();
+            for (int batch = 0; batch < 4; ++batch) {
+                std::unique_ptr<GameStats> local(new GameStats);
+                for (int g = 0; g < 25; ++g) {
+                    LaneState state = LaneState::deal({Role::Governor, Role::Baron, Role::Spy});
+                    size_t attempted = 0;
+                    for (; attempted < 1000 && state.winner() < 0; ++attempted) {
+                        const LaneState before = state;
+                        Action a = chooseHeuristicAction(state, bot, rng);
+                        if (!state.apply(a)) {
+                            a = {ActionType::SkipTurn, before.currentSeat(), -1};
+                            state.apply(a);
+                        }
+                        local->observe(before, a, true, state);
+                    }
+                    local->endGame(state, attempted);
+                }
+                hub.publish(std::move(local));
+            }
+        });
+    }
+    for (std::thread& t : workers) t.join();
+    GameStats totals;
+    CHECK(hub.drain(totals) == 12);
+    CHECK(hub.drain(totals) == 0);
+    CHECK(totals.games() == 300);
+    CHECK(totals.seatsDealt(Role::Baron) == 300);
+    CHECK(totals.seatsDealt(Role::Judge) == 0);
+    CHECK(totals.winRate(Role::Governor) + totals.winRate(Role::Baron) + totals.winRate(Role::Spy) == doctest::Approx(1.0));
+    CHECK(totals.coinsAtElimination().count() == 600);
+    CHECK(totals.actionCount(Role::Baron, ActionType::Invest) > 0);
+    CHECK(totals.actionCount(Role::Spy, ActionType::Invest) == 0);
+    CHECK(totals.gameLengthQuantiles().quantile(0.5) >= totals.gameLength().min() * 0.99);
+    CHECK(totals.sequenceCount({Role::Governor, Role::Baron, Role::Spy}, {ActionType::Gather, ActionType::Gather, ActionType::Gather}) > 0);
+}
+
+/**
+ * @brief Student t quantiles match the published table for small df and approach the normal for large df.
+ */
+TEST_CASE("Student t quantiles") {
+    CHECK(studentTQuantile(0.975, 5) == doctest::Approx(2.571).epsilon(1e-3));
+    CHECK(studentTQuantile(0.975, 1) == doctest::Approx(12.706).epsilon(1e-3));
+    CHECK(studentTQuantile(0.99, 14) == doctest::Approx(2.624).epsilon(1e-3));
+    CHECK(studentTQuantile(0.95, 30) == doctest::Approx(1.697).epsilon(1e-3));
+    // Above the table: t(0.975, 60) = 2.000 and t(0.99, 120) = 2.358
+    CHECK(studentTQuantile(0.975, 60) == doctest::Approx(2.000).epsilon(1e-3));
+    CHECK(studentTQuantile(0.99, 120) == doctest::Approx(2.358).epsilon(1e-3));
+    // Fractional df lie between their neighbours
+    CHECK(studentTQuantile(0.975, 5.5) < studentTQuantile(0.975, 5));
+    CHECK(studentTQuantile(0.975, 5.5) > studentTQuantile(0.975, 6));
+    CHECK_THROWS_AS(studentTQuantile(0.9, 5), std::invalid_argument);
+    CHECK_THROWS_AS(studentTQuantile(0.975, 0.5), std::invalid_argument);
+}
+
+/**
+ * @brief Allocation tags register once and scopes nest; without -DCOUP_TRACK_ALLOCS nothing is counted.
+ */
+TEST_CASE("Allocation tags and scopes") {
+    const int outer = AllocTracker::tag("test outer");
+    const int inner = AllocTracker::tag("test inner");
+    CHECK(AllocTracker::tag("test outer") == outer);
+    CHECK(outer != inner);
+    CHECK(outer != AllocTracker::UNTAGGED);
+    CHECK(AllocTracker::name(inner) == "test inner");
+    CHECK(AllocTracker::name(AllocTracker::UNTAGGED) == "untagged");
+    CHECK_THROWS_AS(AllocTracker::name(AllocTracker::tagCount()), std::out_of_range);
+    CHECK_THROWS_AS(AllocScope(-1), std::out_of_range);
+
+    AllocTracker::reset();
+    const AllocTracker::Counts before = AllocTracker::thisThread();
+    {
+        AllocScope a(outer);
+        std::vector<int> grown(1000, 1);
+        for (int i = 0; i < 3; ++i) {
+            AllocScope b(inner);
+            std::string s(100, 'x');
+        }
+        std::vector<int> more(10, 2);
+    }
+    CHECK(AllocTracker::counts(outer).scopes == 1);
+    CHECK(AllocTracker::counts(inner).scopes == 3);
+    CHECK(AllocTracker::thisThread().scopes == before.scopes + 4);
+    if (AllocTracker::enabled()) {
+        CHECK(AllocTracker::counts(outer).allocations == 2);
+        CHECK(AllocTracker::counts(inner).allocations == 3);
+        CHECK(AllocTracker::counts(inner).bytes >= 300);
+    } else {
+        CHECK(AllocTracker::counts(outer).allocations == 0);
+        CHECK(AllocTracker::thisThread().allocations == 0);
+    }
+}
+
+/**
+ * @brief Trace points land in per-thread ring buffers and export as Chrome trace-event JSON.
+ */
+TEST_CASE("Tracing to Chrome JSON") {
+    Trace::clear();
+    {
+        TraceScope off("not recorded");
+    }
+    std::ostringstream empty;
+    CHECK(Trace::writeChromeJson(empty) == 0);
+
+    Trace::enable(true);
+    {
+        TraceScope outer("outer", "test");
+        Game g;
+        g.setLogging(false);
+        std::unique_ptr<Player> a(Game::createPlayerWithRole("A", &g, Role::Governor));
+        std::unique_ptr<Player> b(Game::createPlayerWithRole("B", &g, Role::Spy));
+        applyAction(g, {ActionType::Gather, 0, -1});
+        CHECK_THROWS(applyAction(g, {ActionType::Gather, 0, -1}));  // rejected, so not traced
+    }
+    std::thread worker([] {
+        Trace::nameThread("worker");
+        for (size_t i = 0; i < Trace::EVENTS_PER_THREAD + 10; ++i) {
+            TraceScope event("spin", "test");
+        }
+    });
+    worker.join();
+    Trace::enable(false);
+
+    std::ostringstream json;
+    const size_t events = Trace::writeChromeJson(json);
+    const std::string text = json.str();
+    // outer, the accepted Player::gather and its Game::nextTurn, plus a full ring of spins
+    CHECK(events == 3 + Trace::EVENTS_PER_THREAD);
+    CHECK(text.find("\"traceEvents\"") != std::string::npos);
+    const size_t gather = text.find("\"name\":\"Player::gather\",\"cat\":\"player\",\"ph\":\"X\"");
+    CHECK(gather != std::string::npos);
+    CHECK(text.find("\"name\":\"Player::gather\"", gather + 1) == std::string::npos);
+    CHECK(text.find("\"args\":{\"name\":\"worker\"}") != std::string::npos);
+    CHECK(text.find("not recorded") == std::string::npos);
+    CHECK(text.rfind("]}") != std::string::npos);
+
+    Trace::clear();
+    std::ostringstream cleared;
+    CHECK(Trace::writeChromeJson(cleared) == 0);
+}
+
+/**
+ * @brief Exports taken while another thread keeps overwriting its ring never contain half-written events.
+ */
+TEST_CASE("Tracing export while recording is never torn") {
+    Trace::clear();
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> recorded{0};
+    std::thread writer([&] {
+        // "short" events last 1 us and "long" ones 2 us; a torn slot would pair a name with the other duration
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            bool isLong = i % 2 == 1;
+            Trace::record(isLong ? "long" : "short", "test", i * 10000, i * 10000 + (isLong ? 2000 : 1000));
+            // Some work between events, so the exporter is not lapped on every slot
+            for (volatile int spin = 0; spin < 200; ++spin) {
+            }
+            recorded.store(i + 1, std::memory_order_relaxed);
+        }
+    });
+    // Export once the ring has wrapped, so every copy races slots being reused
+    while (recorded.load(std::memory_order_relaxed) <= Trace::EVENTS_PER_THREAD) std::this_thread::yield();
+    size_t torn = 0, exported = 0;
+    for (int round = 0; round < 10; ++round) {
+        std::ostringstream json;
+        exported += Trace::writeChromeJson(json);
+        std::istringstream lines(json.str());
+        for (std::string line; std::getline(lines, line);) {
+            if (line.find("\"name\":\"short\"") != std::string::npos && line.find("\"dur\":1.000") == std::string::npos) ++torn;
+            if (line.find("\"name\":\"long\"") != std::string::npos && line.find("\"dur\":2.000") == std::string::npos) ++torn;
+        }
+    }
+    stop = true;
+    writer.join();
+    Trace::clear();
+    CHECK(exported > 0);
+    CHECK(torn == 0);
+}
+
+/**
+ * @brief Hardware counters count a region when the kernel allows it, and otherwise say why and fall back to wall time.
+ */
+TEST_CASE("Hardware counters or graceful fallback") {
+    PerfCounters counters;
+    CHECK_THROWS_AS(counters.stop(), std::logic_error);
+
+    LaneState state = LaneState::deal({Role::Governor, Role::Spy, Role::Baron, Role::General});
+    Action legal[LaneState::MAX_ACTIONS];
+    PerfSample sample = counters.measure([&] {
+        for (int n = 0; n < 2000 && state.winner() < 0; ++n) {
+            int count = state.legalActions(legal);
+            if (count == 0) break;
+            state.apply(legal[n % count]);
+        }
+    });
+    CHECK(sample.seconds > 0);
+    if (counters.available(PerfEvent::Instructions)) {
+        CHECK(sample[PerfEvent::Instructions] > 0);
+        CHECK(sample.perMillion(PerfEvent::Instructions, 1000) > 0);
+    } else {
+        CHECK_FALSE(counters.unavailableReason().empty());
+        CHECK(sample.perMillion(PerfEvent::Instructions, 1000) == -1);
+        CHECK(sample.ipc() == 0);
+    }
+    CHECK(std::string(perfEventName(PerfEvent::BranchMisses)) == "branch-misses");
+    CHECK(formatPerfSample(sample, 1000).find("wall time") != std::string::npos);
+}
@@ -0,0 +1,406 @@
+/**
+ * @file test_server.cpp
+ * @brief Tests for coup_server: the binary protocol, the Table state machine,
+ *        and the epoll server over localhost TCP and a Unix-domain socket.
+ *
+ * Linux only. Run with: make test_server
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "Protocol.hpp"
+#include "Server.hpp"
+#include "Table.hpp"
+#include "Player.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <map>
+
+// Minimal blocking client used by the tests
+class TestClient {
+public:
+    explicit TestClient(int port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    }
+    explicit TestClient(const std::string& path) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    }
+    ~TestClient() { close(fd); }
+
+    void queue(const Message& m) { encodeMessage(m, pending); }
+    void flush() {
+        size_t off = 0;
+        while (off < pending.size()) {
+            ssize_t w = send(fd, pending.data() + off, pending.size() - off, 0);
+            REQUIRE(w > 0);
+            off += static_cast<size_t>(w);
+        }
+        pending.clear();
+    }
+    Message receive() {
+        Message m;
+        for (;;) {
+            size_t n = decodeMessage(in.data(), in.size(), m);
+            if (n) { in.erase(in.begin(), in.begin() + n); return m; }
+            uint8_t buf[4096];
+            ssize_t r = recv(fd, buf, sizeof(buf), 0);
+            REQUIRE(r > 0);
+            in.insert(in.end(), buf, buf + r);
+        }
+    }
+    Message call(const Message& m) { queue(m); flush(); return receive(); }
+
+private:
+    int fd;
+    std::vector<uint8_t> pending, in;
+};
+
+static Message request(MsgType type, uint32_t tag, uint32_t table = 0) {
+    Message m;
+    m.type = type;
+    m.tag = tag;
+    m.table = table;
+    return m;
+}
+
+/**
+ * @brief Tests that every message type survives an encode/decode round trip and that bad frames are rejected.
+ */
+TEST_CASE("Protocol round trip") {
+    Message act = request(MsgType::Act, 7, 42);
+    act.action = {ActionType::Coup, 1, 3};
+    Message result = request(MsgType::ActResult, 8, 42);
+    result.text = "Not your turn";
+    result.state.status = 1;
+    result.state.bank = 37;
+    result.state.turn = 2;
+    result.state.seats = {{5, true}, {0, false}, {12, true}};
+
+    std::vector<uint8_t> buf;
+    encodeMessage(act, buf);
+    encodeMessage(result, buf);
+    Message a, b;
+    size_t n = decodeMessage(buf.data(), buf.size(), a);
+    REQUIRE(n > 0);
+    CHECK(decodeMessage(buf.data(), n - 1, b) == 0); // incomplete frame
+    REQUIRE(decodeMessage(buf.data() + n, buf.size() - n, b) == buf.size() - n);
+    CHECK(a.type == MsgType::Act);
+    CHECK(a.tag == 7);
+    CHECK(a.table == 42);
+    CHECK(a.action == act.action);
+    CHECK(b.text == "Not your turn");
+    CHECK(b.state.bank == 37);
+    CHECK(b.state.turn == 2);
+    REQUIRE(b.state.seats.size() == 3);
+    CHECK(b.state.seats[2].coins == 12);
+    CHECK_FALSE(b.state.seats[1].alive);
+
+    std::vector<uint8_t> bad = {5, 0, 0, 0, 99, 0, 0, 0, 0};
+    CHECK_THROWS_AS(decodeMessage(bad.data(), bad.size(), a), ProtocolError);
+    std::vector<uint8_t> huge = {0xff, 0xff, 0xff, 0x7f};
+    CHECK_THROWS_AS(decodeMessage(huge.data(), huge.size(), a), ProtocolError);
+}
+
+/**
+ * @brief Tests the table lifecycle: lobby, seat ownership, playing, finished.
+ */
+TEST_CASE("Table state machine") {
+    Table t(1, {Role::Governor, Role::Merchant});
+    CHECK(t.getStatus() == Table::Status::Lobby);
+    CHECK_THROWS(t.act({ActionType::Gather, 0, -1}, 100));
+    CHECK(t.join(0, 100) == Role::Governor);
+    CHECK_THROWS(t.join(0, 200));
+    t.release(100);
+    CHECK(t.join(0, 100) == Role::Governor);
+    CHECK(t.join(1, 200) == Role::Merchant);
+    CHECK(t.getStatus() == Table::Status::Playing);
+
+    CHECK_THROWS(t.act({ActionType::Gather, 0, -1}, 200)); // not 200's seat
+    for (int i = 0; i < 7; ++i) {
+        t.act({ActionType::Gather, 0, -1}, 100);
+        t.act({ActionType::Gather, 1, -1}, 200);
+    }
+    CHECK(t.state().turn == 0);
+    t.act({ActionType::Coup, 0, 1}, 100);
+    CHECK(t.getStatus() == Table::Status::Finished);
+    CHECK_FALSE(t.state().seats[1].alive);
+    CHECK_THROWS(Table(2, {Role::Spy}));
+}
+
+/**
+ * @brief Tests that a client leaving mid-game forfeits its seats: the turn moves on and the table finishes.
+ */
+TEST_CASE("Released seats forfeit during play") {
+    Table t(1, {Role::Governor, Role::Merchant, Role::Spy});
+    CHECK_FALSE(t.release(100)); // holds nothing
+    t.join(0, 100);
+    t.join(1, 200);
+    t.join(2, 300);
+    REQUIRE(t.getStatus() == Table::Status::Playing);
+    REQUIRE(t.state().turn == 0);
+
+    // The player to move disconnects: the game goes on with the next seat
+    CHECK(t.release(100));
+    CHECK_FALSE(t.state().seats[0].alive);
+    CHECK(t.getStatus() == Table::Status::Playing);
+    CHECK(t.state().turn == 1);
+    CHECK_FALSE(t.publish().empty());
+    t.act({ActionType::Gather, 1, -1}, 200);
+    CHECK(t.state().turn == 2);
+
+    // A seat that is not on turn leaves too: one player remains and wins
+    CHECK(t.release(200));
+    CHECK(t.getStatus() == Table::Status::Finished);
+    CHECK(t.state().seats[2].alive);
+    CHECK(t.getGame().winner() == "Seat 3");
+    CHECK_FALSE(t.release(300)); // the winner leaving changes nothing
+}
+
+/**
+ * @brief Tests thousands of concurrent tables over one TCP connection, sharded across reactor threads.
+ */
+TEST_CASE("Server hosts many tables over TCP") {
+    ServerConfig cfg;
+    cfg.tcpPort = 0;
+    cfg.threads = 3;
+    Server server(cfg);
+    server.start();
+    REQUIRE(server.tcpPort() > 0);
+    TestClient client(server.tcpPort());
+
+    const int TABLES = 2000;
+    for (int i = 0; i < TABLES; ++i) {
+        Message m = request(MsgType::CreateTable, i);
+        m.count = 2;
+        client.queue(m);
+    }
+    client.flush();
+    std::map<uint32_t, uint32_t> tableOfTag;
+    for (int i = 0; i < TABLES; ++i) {
+        Message r = client.receive();
+        REQUIRE(r.type == MsgType::TableCreated);
+        tableOfTag[r.tag] = r.table;
+    }
+    REQUIRE(tableOfTag.size() == TABLES);
+    CHECK(server.tableCount() == TABLES);
+
+    // Claim both seats everywhere, then every seat 0 gathers
+    for (auto& kv : tableOfTag) {
+        for (uint8_t seat = 0; seat < 2; ++seat) {
+            Message m = request(MsgType::JoinTable, kv.first, kv.second);
+            m.seat = seat;
+            client.queue(m);
+        }
+    }
+    client.flush();
+    for (int i = 0; i < 2 * TABLES; ++i) CHECK(client.receive().type == MsgType::Joined);
+    for (auto& kv : tableOfTag) {
+        Message m = request(MsgType::Act, kv.first, kv.second);
+        m.action = {ActionType::Gather, 0, -1};
+        client.queue(m);
+    }
+    client.flush();
+    int accepted = 0;
+    for (int i = 0; i < TABLES; ++i) {
+        Message r = client.receive();
+        REQUIRE(r.type == MsgType::ActResult);
+        if (r.text.empty() && r.state.seats[0].coins == 1 && r.state.turn == 1 && r.state.bank == 49) ++accepted;
+    }
+    CHECK(accepted == TABLES);
+
+    // Rejected actions are reported, not fatal
+    uint32_t table = tableOfTag[0];
+    Message wrong = request(MsgType::Act, 1, table);
+    wrong.action = {ActionType::Gather, 0, -1};
+    Message r = client.call(wrong);
+    CHECK(r.type == MsgType::ActResult);
+    CHECK(r.text == "Not your turn.");
+    CHECK(client.call(request(MsgType::GetState, 2, 999999)).type == MsgType::Error);
+    CHECK(client.call(request(MsgType::CloseTable, 3, table)).type == MsgType::Closed);
+    CHECK(server.tableCount() == TABLES - 1);
+    server.stop();
+}
+
+/**
+ * @brief Tests that a second client cannot act for seats it does not hold, over a Unix-domain socket.
+ */
+TEST_CASE("Server over Unix-domain socket enforces seat ownership") {
+    ServerConfig cfg;
+    cfg.unixPath = "/tmp/coup_server_test_" + std::to_string(getpid()) + ".sock";
+    cfg.threads = 2;
+    Server server(cfg);
+    server.start();
+    TestClient alice(cfg.unixPath), bob(cfg.unixPath);
+
+    Message create = request(MsgType::CreateTable, 1);
+    create.count = 2;
+    Message created = alice.call(create);
+    REQUIRE(created.type == MsgType::TableCreated);
+    Message join = request(MsgType::JoinTable, 2, created.table);
+    join.seat = 0;
+    CHECK(alice.call(join).type == MsgType::Joined);
+    join.seat = 1;
+    CHECK(bob.call(join).type == MsgType::Joined);
+
+    Message act = request(MsgType::Act, 3, created.table);
+    act.action = {ActionType::Gather, 0, -1};
+    CHECK(bob.call(act).text == "You do not hold that seat");
+    CHECK(alice.call(act).text.empty());
+    Message state = bob.call(request(MsgType::GetState, 4, created.table));
+    CHECK(state.state.seats[0].coins == 1);
+    CHECK(state.state.status == static_cast<uint8_t>(Table::Status::Playing));
+}
+
+/**
+ * @brief Tests state deltas: diff/apply reproduce the target state, deltas survive the wire,
+ *        and a Table publishes one delta per change.
+ */
+TEST_CASE("State deltas") {
+    TableState a;
+    a.status = 1;
+    a.bank = 40;
+    a.turn = 0;
+    a.seats = {{3, true}, {5, true}, {2, true}};
+    TableState b = a;
+    b.bank = 38;
+    b.turn = 2;
+    b.seats[0].coins = 5;
+    b.seats[1].alive = false;
+
+    StateDelta d = diffState(a, b);
+    CHECK(d.fields == (StateDelta::BANK | StateDelta::TURN));
+    REQUIRE(d.seats.size() == 2);
+    CHECK(diffState(b, b).empty());
+    Message m = request(MsgType::Delta, 0, 9);
+    m.sequence = 77;
+    m.delta = d;
+    std::vector<uint8_t> buf;
+    encodeMessage(m, buf);
+    std::vector<uint8_t> full;
+    Message k = request(MsgType::Keyframe, 0, 9);
+    k.state = b;
+    encodeMessage(k, full);
+    CHECK(buf.size() < full.size() + 4);
+    Message got;
+    REQUIRE(decodeMessage(buf.data(), buf.size(), got) == buf.size());
+    CHECK(got.sequence == 77);
+    TableState rebuilt = a;
+    applyDelta(rebuilt, got.delta);
+    CHECK(diffState(rebuilt, b).empty());
+    TableState tiny;
+    CHECK_THROWS_AS(applyDelta(tiny, d), ProtocolError);
+    CHECK_THROWS_AS(diffState(tiny, b), std::invalid_argument);
+
+    Table t(3, {Role::Spy, Role::Judge});
+    CHECK(t.publish().empty());
+    t.join(0, 1);
+    t.join(1, 2);
+    StateDelta started = t.publish();
+    CHECK((started.fields & StateDelta::STATUS) != 0);
+    CHECK((started.fields & StateDelta::TURN) != 0);
+    CHECK(t.getSequence() == 1);
+    t.act({ActionType::Gather, 0, -1}, 1);
+    StateDelta gathered = t.publish();
+    CHECK(gathered.fields == (StateDelta::BANK | StateDelta::TURN));
+    REQUIRE(gathered.seats.size() == 1);
+    CHECK(gathered.seats[0].seat == 0);
+    CHECK(gathered.seats[0].state.coins == 1);
+    CHECK(t.getSequence() == 2);
+}
+
+// Follows a watched table's pushes until it is closed; returns the reconstructed state
+static TableState followTable(TestClient& spectator, int& keyframes) {
+    TableState st;
+    uint32_t seq = 0;
+    bool synced = false;
+    for (;;) {
+        Message m = spectator.receive();
+        if (m.type == MsgType::Closed) break;
+        if (m.type == MsgType::Keyframe) {
+            CHECK((!synced || m.sequence == seq + 1));
+            st = m.state;
+            seq = m.sequence;
+            synced = true;
+            ++keyframes;
+        } else {
+            REQUIRE(m.type == MsgType::Delta);
+            REQUIRE(synced);
+            CHECK(m.sequence == seq + 1);
+            applyDelta(st, m.delta);
+            seq = m.sequence;
+        }
+    }
+    return st;
+}
+
+/**
+ * @brief Tests spectators across reactors: early and late watchers rebuild the exact final state
+ *        from one keyframe plus deltas, and each push frame is encoded once for all of them.
+ */
+TEST_CASE("Server pushes deltas and keyframes to spectators") {
+    ServerConfig cfg;
+    cfg.tcpPort = 0;
+    cfg.threads = 3;
+    cfg.keyframeInterval = 8;
+    Server server(cfg);
+    server.start();
+    TestClient host(server.tcpPort());
+    std::vector<std::unique_ptr<TestClient>> early;
+    for (int i = 0; i < 4; ++i) early.emplace_back(new TestClient(server.tcpPort()));
+
+    Message create = request(MsgType::CreateTable, 1);
+    create.count = 4;
+    uint32_t table = host.call(create).table;
+    for (auto& s : early) {
+        REQUIRE(s->call(request(MsgType::Watch, 2, table)).type == MsgType::Watching);
+    }
+    for (uint8_t seat = 0; seat < 4; ++seat) {
+        Message join = request(MsgType::JoinTable, 3, table);
+        join.seat = seat;
+        REQUIRE(host.call(join).type == MsgType::Joined);
+    }
+
+    TestClient late(server.tcpPort());
+    TableState st = host.call(request(MsgType::GetState, 4, table)).state;
+    for (int step = 0; step < 300 && st.status == static_cast<uint8_t>(Table::Status::Playing); ++step) {
+        if (step == 20) REQUIRE(late.call(request(MsgType::Watch, 5, table)).type == MsgType::Watching);
+        Message act = request(MsgType::Act, 6, table);
+        int me = st.turn;
+        act.action = {ActionType::Gather, me, -1};
+        if (st.seats[me].coins >= 7) {
+            int target = (me + 1) % 4;
+            while (!st.seats[target].alive) target = (target + 1) % 4;
+            act.action = {ActionType::Coup, me, target};
+        }
+        st = host.call(act).state;
+    }
+    CHECK(st.status == static_cast<uint8_t>(Table::Status::Finished));
+    REQUIRE(host.call(request(MsgType::CloseTable, 7, table)).type == MsgType::Closed);
+
+    int keyframes = 0;
+    for (auto& s : early) {
+        int own = 0;
+        CHECK(diffState(followTable(*s, own), st).empty());
+        CHECK(own > 1); // the initial one plus periodic ones
+        keyframes += own;
+    }
+    int lateKeyframes = 0;
+    CHECK(diffState(followTable(late, lateKeyframes), st).empty());
+    CHECK(lateKeyframes >= 1);
+    CHECK(server.pushedDeliveries() > server.pushedFrames());
+    server.stop();
+}